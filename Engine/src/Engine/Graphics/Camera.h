@@ -20,6 +20,16 @@ namespace Graphics
 
 			cameraToWorldMatrix = Matrix3x3<double>(cu, cv, -cw);
 		}
+		//Position on the demo orbit around the origin after time seconds. Graphics feeds it the wall clock and the benchmark a fixed time step.
+		static Vector3<float> OrbitPosition(float time)
+		{
+			float x = 3.6f * sinf(time * 1.5f) + 0.5f;
+			float y = 3.0f + sinf(time * 2.0f);
+			float z = 3.6f * cosf(time * 1.0f) + 0.5f;
+
+			float mulBy = sqrtf(x * x + z * z);
+			return Vector3<float>(x / (mulBy * 0.2f), y, z / (mulBy * 0.25f));
+		}
 	public:
 		Matrix3x3<double> cameraToWorldMatrix = Matrix3x3<double>(0, 0, 0, 0, 0, 0, 0, 0, 0);
 		Vector3<double> targetPosition = Vector3<double>(0, 0, 0);
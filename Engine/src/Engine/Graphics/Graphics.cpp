@@ -5,6 +5,7 @@
 #include "Exceptions/EngineGFXInfoException.h"
 #include "Exceptions/EngineGFXDeviceRemovedException.h"
 #include "MeshManager.h"
+#include "VertexCompression.h"
 
 #include <math.h>
 #include <string>
@@ -14,8 +15,18 @@
 
 namespace Graphics
 {
-	Graphics::Graphics(HWND window, Input::Mouse* mouse, int width, int height, MeshManagement::MeshManager* meshManager) : clientWidth(width), clientHeight(height), wnd(window), uiManager(UIManager(mouse)), meshManager(meshManager), mouse(mouse)
+	//The traced pixel patterns main runs with
+	namespace Checkerboard
 	{
+#include "Shaders/Checkerboard.hlsli"
+	}
+
+	Graphics::Graphics(HWND window, Input::Mouse* mouse, int width, int height, MeshManagement::MeshManager* meshManager) : clientWidth(width), clientHeight(height), wnd(window), uiManager(UIManager(mouse)), meshManager(meshManager), mouse(mouse), governor((unsigned int)width, (unsigned int)height, MeshManagement::ResolutionGovernor::Settings())
+	{
+		MeshManagement::ResolutionGovernor::Settings resolutionSettings;
+		resolutionSettings.targetMilliseconds = frameBudget;
+		governor.SetSettings(resolutionSettings);
+
 		LoadPipeline();
 		LoadAssets();
 
@@ -322,23 +333,68 @@ namespace Graphics
 		bvhNodeBufferRootParameter.DescriptorTable = { 1, &bvhNodeBufferDescriptorRange };
 		bvhNodeBufferRootParameter.ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
 
-		//Root parameter for vertex buffer
-		D3D12_DESCRIPTOR_RANGE vertexBufferDescriptorRange;
-		ZeroMemory(&vertexBufferDescriptorRange, sizeof(vertexBufferDescriptorRange));
-		vertexBufferDescriptorRange.RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_UAV;
-		vertexBufferDescriptorRange.NumDescriptors = 1;
-		vertexBufferDescriptorRange.BaseShaderRegister = 2;
-		vertexBufferDescriptorRange.RegisterSpace = 0;
-		vertexBufferDescriptorRange.OffsetInDescriptorsFromTableStart = D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND;
-
-		D3D12_ROOT_PARAMETER vertexBufferRootParameter;
-		ZeroMemory(&vertexBufferRootParameter, sizeof(vertexBufferRootParameter));
-		vertexBufferRootParameter.ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
-		vertexBufferRootParameter.DescriptorTable = { 1, &vertexBufferDescriptorRange };
-		vertexBufferRootParameter.ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+		//Root parameter for vertex position buffer
+		D3D12_DESCRIPTOR_RANGE positionBufferDescriptorRange;
+		ZeroMemory(&positionBufferDescriptorRange, sizeof(positionBufferDescriptorRange));
+		positionBufferDescriptorRange.RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_UAV;
+		positionBufferDescriptorRange.NumDescriptors = 1;
+		positionBufferDescriptorRange.BaseShaderRegister = 2;
+		positionBufferDescriptorRange.RegisterSpace = 0;
+		positionBufferDescriptorRange.OffsetInDescriptorsFromTableStart = D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND;
+
+		D3D12_ROOT_PARAMETER positionBufferRootParameter;
+		ZeroMemory(&positionBufferRootParameter, sizeof(positionBufferRootParameter));
+		positionBufferRootParameter.ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+		positionBufferRootParameter.DescriptorTable = { 1, &positionBufferDescriptorRange };
+		positionBufferRootParameter.ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+
+		//Root parameter for vertex attribute buffer
+		D3D12_DESCRIPTOR_RANGE attributeBufferDescriptorRange;
+		ZeroMemory(&attributeBufferDescriptorRange, sizeof(attributeBufferDescriptorRange));
+		attributeBufferDescriptorRange.RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_UAV;
+		attributeBufferDescriptorRange.NumDescriptors = 1;
+		attributeBufferDescriptorRange.BaseShaderRegister = 7;
+		attributeBufferDescriptorRange.RegisterSpace = 0;
+		attributeBufferDescriptorRange.OffsetInDescriptorsFromTableStart = D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND;
+
+		D3D12_ROOT_PARAMETER attributeBufferRootParameter;
+		ZeroMemory(&attributeBufferRootParameter, sizeof(attributeBufferRootParameter));
+		attributeBufferRootParameter.ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+		attributeBufferRootParameter.DescriptorTable = { 1, &attributeBufferDescriptorRange };
+		attributeBufferRootParameter.ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+
+		//Root parameter for motion buffer
+		D3D12_DESCRIPTOR_RANGE motionBufferDescriptorRange;
+		ZeroMemory(&motionBufferDescriptorRange, sizeof(motionBufferDescriptorRange));
+		motionBufferDescriptorRange.RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_UAV;
+		motionBufferDescriptorRange.NumDescriptors = 1;
+		motionBufferDescriptorRange.BaseShaderRegister = 8;
+		motionBufferDescriptorRange.RegisterSpace = 0;
+		motionBufferDescriptorRange.OffsetInDescriptorsFromTableStart = D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND;
+
+		D3D12_ROOT_PARAMETER motionBufferRootParameter;
+		ZeroMemory(&motionBufferRootParameter, sizeof(motionBufferRootParameter));
+		motionBufferRootParameter.ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+		motionBufferRootParameter.DescriptorTable = { 1, &motionBufferDescriptorRange };
+		motionBufferRootParameter.ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+
+		//Root parameter for upscale buffer
+		D3D12_DESCRIPTOR_RANGE upscaleBufferDescriptorRange;
+		ZeroMemory(&upscaleBufferDescriptorRange, sizeof(upscaleBufferDescriptorRange));
+		upscaleBufferDescriptorRange.RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_UAV;
+		upscaleBufferDescriptorRange.NumDescriptors = 1;
+		upscaleBufferDescriptorRange.BaseShaderRegister = 9;
+		upscaleBufferDescriptorRange.RegisterSpace = 0;
+		upscaleBufferDescriptorRange.OffsetInDescriptorsFromTableStart = D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND;
+
+		D3D12_ROOT_PARAMETER upscaleBufferRootParameter;
+		ZeroMemory(&upscaleBufferRootParameter, sizeof(upscaleBufferRootParameter));
+		upscaleBufferRootParameter.ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+		upscaleBufferRootParameter.DescriptorTable = { 1, &upscaleBufferDescriptorRange };
+		upscaleBufferRootParameter.ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
 
 		//Create Root Parameter Array
-		D3D12_ROOT_PARAMETER rootParameters[10] = { renderTextureRootParameter, uiBufferRootParameter, constantsRootParameter, triangleBufferRootParameter, bvhNodeBufferRootParameter, vertexBufferRootParameter, tempTextureRootParameter, reprojectionBufferRootParameter, geomertyHistoryBufferRootParameter, temporaryGeomertyHistoryBufferRootParameter };
+		D3D12_ROOT_PARAMETER rootParameters[13] = { renderTextureRootParameter, uiBufferRootParameter, constantsRootParameter, triangleBufferRootParameter, bvhNodeBufferRootParameter, positionBufferRootParameter, tempTextureRootParameter, reprojectionBufferRootParameter, geomertyHistoryBufferRootParameter, temporaryGeomertyHistoryBufferRootParameter, attributeBufferRootParameter, motionBufferRootParameter, upscaleBufferRootParameter };
 
 		//Create Root Signature Descriptor Structure
 		D3D12_ROOT_SIGNATURE_DESC rootSignatureDescriptor;
@@ -358,22 +414,87 @@ namespace Graphics
 
 	void Graphics::CreatePipelineStateObjects()
 	{
-		HRESULT hr;
-
-		//Compile
-		UINT flags = D3DCOMPILE_ENABLE_STRICTNESS | D3DCOMPILE_OPTIMIZATION_LEVEL3 | D3DCOMPILE_DEBUG; //D3DCOMPILE_WARNINGS_ARE_ERRORS
-
 		char buffer[8];
 		_itoa_s(meshManager->GetMesh(0).rootIndex, buffer, 8, 10);
 		std::string rootNodeIndexStr = std::string(buffer);
 
 		D3D_SHADER_MACRO rootNodeIndexMacro = { "ROOT_NODE_INDEX", rootNodeIndexStr.c_str() };
+		D3D_SHADER_MACRO compressedAttributesMacro = { "COMPRESSED_ATTRIBUTES", "1" };
+
+		std::string maxDepthStr = std::to_string(std::max(maxPathDepth, 1u));
+		std::string pathSegmentsStr = std::to_string(std::max(pathSegments, 1u));
+		std::string samplerStr = std::to_string(sampler);
+		std::string checkerboardStr = std::to_string(checkerboard);
+		D3D_SHADER_MACRO checkerboardMacro = { "CHECKERBOARD", checkerboardStr.c_str() };
+
+		D3D_SHADER_MACRO defines[] = { rootNodeIndexMacro, { "SAMPLER", samplerStr.c_str() }, checkerboardMacro, { NULL, NULL }, { NULL, NULL }, { NULL, NULL }, { NULL, NULL }, { NULL, NULL } };
+		UINT defineCount = 3;
+		if (meshManager->AttributesCompressed())
+		{
+			defines[defineCount++] = compressedAttributesMacro;
+		}
+		if (pathTracing)
+		{
+			defines[defineCount++] = { "PATH_TRACING", "1" };
+			defines[defineCount++] = { "MAX_DEPTH", maxDepthStr.c_str() };
+			defines[defineCount++] = { "PATH_SEGMENTS", pathSegmentsStr.c_str() };
+		}
+
+		pRenderPipelineState = CreateComputePipelineState(L"C:/Users/Owen/Documents/C++/RaytracingEngine/Engine/src/Engine/Graphics/Shaders/RenderCompute.hlsl", defines);
+		D3D_SHADER_MACRO checkerboardDefines[] = { checkerboardMacro, { NULL, NULL } };
+		pTemporalPipelineState = CreateComputePipelineState(L"C:/Users/Owen/Documents/C++/RaytracingEngine/Engine/src/Engine/Graphics/Shaders/Temporal.hlsl", checkerboardDefines);
+		if (checkerboard != Checkerboard::checkerboardFull)
+		{
+			pCheckerboardPipelineState = CreateComputePipelineState(L"C:/Users/Owen/Documents/C++/RaytracingEngine/Engine/src/Engine/Graphics/Shaders/CheckerboardResolve.hlsl", checkerboardDefines);
+		}
+
+		if (denoise)
+		{
+			std::string denoiseIterationsStr = std::to_string(std::max(denoiseIterations, 1u));
+			D3D_SHADER_MACRO denoiseDefines[] = { { "DENOISE_ITERATIONS", denoiseIterationsStr.c_str() }, { NULL, NULL } };
+			pDenoisePipelineState = CreateComputePipelineState(L"C:/Users/Owen/Documents/C++/RaytracingEngine/Engine/src/Engine/Graphics/Shaders/Denoise.hlsl", denoiseDefines);
+		}
+
+		if (dynamicResolution)
+		{
+			D3D_SHADER_MACRO upscaleDefines[] = { { "DENOISE", "1" }, { NULL, NULL } };
+			pUpscalePipelineState = CreateComputePipelineState(L"C:/Users/Owen/Documents/C++/RaytracingEngine/Engine/src/Engine/Graphics/Shaders/Upscale.hlsl", denoise ? upscaleDefines : upscaleDefines + 1);
+		}
+	}
 
-		D3D_SHADER_MACRO defines[] = { rootNodeIndexMacro,  { NULL, NULL } };
+	void Graphics::CreatePipelineTimestampQueries()
+	{
+		HRESULT hr;
+
+		if (!dynamicResolution)
+		{
+			return;
+		}
+
+		GFX_THROW_INFO(pCommandQueue->GetTimestampFrequency(&timestampFrequency));
+
+		//Create Query Heap
+		D3D12_QUERY_HEAP_DESC queryHeapDescription = {};
+		queryHeapDescription.Type = D3D12_QUERY_HEAP_TYPE_TIMESTAMP;
+		queryHeapDescription.Count = 2;
+		GFX_THROW_INFO(pDevice->CreateQueryHeap(&queryHeapDescription, IID_PPV_ARGS(&pTimestampQueryHeap)));
+
+		//Create Readback Buffer
+		D3D12_HEAP_PROPERTIES heapProperties = { D3D12_HEAP_TYPE_READBACK, D3D12_CPU_PAGE_PROPERTY_UNKNOWN, D3D12_MEMORY_POOL_UNKNOWN, 1, 1 };
+		CD3DX12_RESOURCE_DESC resourceDescription = CD3DX12_RESOURCE_DESC::Buffer(2 * sizeof(UINT64));
+		GFX_THROW_INFO(pDevice->CreateCommittedResource(&heapProperties, D3D12_HEAP_FLAG_NONE, &resourceDescription, D3D12_RESOURCE_STATE_COPY_DEST, nullptr, IID_PPV_ARGS(&pTimestampReadbackBuffer)));
+	}
+
+	ComPtr<ID3D12PipelineState> Graphics::CreateComputePipelineState(LPCWSTR shaderPath, const D3D_SHADER_MACRO* defines)
+	{
+		HRESULT hr;
+
+		//Compile
+		UINT flags = D3DCOMPILE_ENABLE_STRICTNESS | D3DCOMPILE_OPTIMIZATION_LEVEL3 | D3DCOMPILE_DEBUG; //D3DCOMPILE_WARNINGS_ARE_ERRORS
 
 		ID3DBlob* shaderBlob = nullptr;
 		ID3DBlob* errorBlob = nullptr;
-		HRESULT shaderHR = D3DCompileFromFile(L"C:/Users/Owen/Documents/C++/RaytracingEngine/Engine/src/Engine/Graphics/Shaders/RenderCompute.hlsl", defines, D3D_COMPILE_STANDARD_FILE_INCLUDE, "main", "cs_5_1", flags, 0, &shaderBlob, &errorBlob);
+		HRESULT shaderHR = D3DCompileFromFile(shaderPath, defines, D3D_COMPILE_STANDARD_FILE_INCLUDE, "main", "cs_5_1", flags, 0, &shaderBlob, &errorBlob);
 
 		if (FAILED(shaderHR) && errorBlob)
 		{
@@ -393,7 +514,9 @@ namespace Graphics
 		renderPipelineStateDescription.Flags = D3D12_PIPELINE_STATE_FLAG_NONE;
 
 		//Create Pipeline State
-		GFX_THROW_INFO(pDevice->CreateComputePipelineState(&renderPipelineStateDescription, IID_PPV_ARGS(&pRenderPipelineState)));
+		ComPtr<ID3D12PipelineState> pipelineState;
+		GFX_THROW_INFO(pDevice->CreateComputePipelineState(&renderPipelineStateDescription, IID_PPV_ARGS(&pipelineState)));
+		return pipelineState;
 	}
 #pragma endregion
 
@@ -408,6 +531,7 @@ namespace Graphics
 		CreatePipelineSynchronizationObjects();
 		CreatePipelineRootSignature();
 		CreatePipelineStateObjects();
+		CreatePipelineTimestampQueries();
 	}
 
 	void Graphics::LoadAssets()
@@ -575,6 +699,87 @@ namespace Graphics
 			pDevice->CreateUnorderedAccessView(pHistoryBuffer.Get(), nullptr, &uavDesc, pHistoryBufferHeap->GetCPUDescriptorHandleForHeapStart());
 			pDevice->CreateUnorderedAccessView(pGeomertyHistoryBuffer.Get(), nullptr, &uavDesc, pGeomertyHistoryBufferHeap->GetCPUDescriptorHandleForHeapStart());
 		}
+
+		{
+			HRESULT hr;
+
+			//Create Resource Description Structure, full floats so motion stays sub pixel accurate at any resolution
+			D3D12_RESOURCE_DESC resourceDescription = {};
+			resourceDescription.DepthOrArraySize = 1;
+			resourceDescription.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+			resourceDescription.Format = DXGI_FORMAT_R32G32B32A32_FLOAT;
+			resourceDescription.Flags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
+			resourceDescription.Width = clientWidth;
+			resourceDescription.Height = clientHeight;
+			resourceDescription.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
+			resourceDescription.MipLevels = 1;
+			resourceDescription.SampleDesc.Count = 1;
+
+			//Create Heap Properties Structure
+			D3D12_HEAP_PROPERTIES heapProperties = {};
+			heapProperties.Type = D3D12_HEAP_TYPE_DEFAULT;
+			heapProperties.CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
+			heapProperties.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
+			heapProperties.CreationNodeMask = 0;
+			heapProperties.VisibleNodeMask = 0;
+
+			//Create Committed Resource
+			GFX_THROW_INFO(pDevice->CreateCommittedResource(&heapProperties, D3D12_HEAP_FLAG_NONE, &resourceDescription, D3D12_RESOURCE_STATE_UNORDERED_ACCESS, nullptr, IID_PPV_ARGS(&pMotionBuffer)));
+
+			//Create Descriptor Heap
+			pMotionBufferHeap = CreateDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE, 1);
+
+			//Create Unordered Access View Description Structure
+			D3D12_UNORDERED_ACCESS_VIEW_DESC uavDesc = {};
+			uavDesc.Format = DXGI_FORMAT_R32G32B32A32_FLOAT;
+			uavDesc.ViewDimension = D3D12_UAV_DIMENSION_TEXTURE2D;
+
+			//Create Render Texture
+			pDevice->CreateUnorderedAccessView(pMotionBuffer.Get(), nullptr, &uavDesc, pMotionBufferHeap->GetCPUDescriptorHandleForHeapStart());
+		}
+
+		if (dynamicResolution)
+		{
+			HRESULT hr;
+
+			//Create Resource Description Structure
+			D3D12_RESOURCE_DESC resourceDescription = {};
+			resourceDescription.DepthOrArraySize = 1;
+			resourceDescription.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+			resourceDescription.Format = DXGI_FORMAT_R16G16B16A16_FLOAT;
+			resourceDescription.Flags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
+			resourceDescription.Width = clientWidth;
+			resourceDescription.Height = clientHeight;
+			resourceDescription.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
+			resourceDescription.MipLevels = 1;
+			resourceDescription.SampleDesc.Count = 1;
+
+			//Create Heap Properties Structure
+			D3D12_HEAP_PROPERTIES heapProperties = {};
+			heapProperties.Type = D3D12_HEAP_TYPE_DEFAULT;
+			heapProperties.CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
+			heapProperties.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
+			heapProperties.CreationNodeMask = 0;
+			heapProperties.VisibleNodeMask = 0;
+
+			//Create Committed Resource
+			GFX_THROW_INFO(pDevice->CreateCommittedResource(&heapProperties, D3D12_HEAP_FLAG_NONE, &resourceDescription, D3D12_RESOURCE_STATE_UNORDERED_ACCESS, nullptr, IID_PPV_ARGS(&pUpscaleBuffer)));
+
+			//Create Descriptor Heap
+			pUpscaleBufferHeap = CreateDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE, 1);
+
+			//Create Unordered Access View Description Structure
+			D3D12_UNORDERED_ACCESS_VIEW_DESC uavDesc = {};
+			uavDesc.Format = DXGI_FORMAT_R16G16B16A16_FLOAT;
+			uavDesc.ViewDimension = D3D12_UAV_DIMENSION_TEXTURE2D;
+
+			//Create Render Texture
+			pDevice->CreateUnorderedAccessView(pUpscaleBuffer.Get(), nullptr, &uavDesc, pUpscaleBufferHeap->GetCPUDescriptorHandleForHeapStart());
+		}
+
+		//The new textures hold no history
+		previousRenderWidth = 0;
+		previousRenderHeight = 0;
 	}
 
 	void Graphics::UpdateUIBuffer()
@@ -638,8 +843,50 @@ namespace Graphics
 	{
 		HRESULT hr;
 
-		if (!meshManager->IsUpToDate())
+		meshManager->ApplyReloadedMeshes();
+
+		if (meshManager->IsUpToDate())
 		{
+			//Reloaded meshes that kept their size only need their own ranges uploaded
+			std::vector<uint16_t> dirtyMeshes = meshManager->TakeDirtyMeshes();
+			for (size_t i = 0; i < dirtyMeshes.size(); i++)
+			{
+				const Mesh& mesh = meshManager->GetLod(dirtyMeshes[i], 0);
+				MeshManagement::MeshManager::MeshRange range = meshManager->GetMeshRange(dirtyMeshes[i]);
+
+				UploadBufferRange(triangleBuffer.Get(), triangleUploadBuffer.Get(), mesh.triangles.data(), range.firstTriangle * sizeof(Mesh::Triangle), range.triangleCount * sizeof(Mesh::Triangle));
+				UploadBufferRange(positionBuffer.Get(), positionUploadBuffer.Get(), mesh.positions.data(), range.firstPosition * sizeof(Mesh::VertexPosition), range.positionCount * sizeof(Mesh::VertexPosition));
+
+				if (meshManager->AttributesCompressed())
+				{
+					UploadBufferRange(attributeBuffer.Get(), attributeUploadBuffer.Get(), mesh.compressedAttributes.data(), range.firstPosition * sizeof(Mesh::CompressedVertexAttribute), range.positionCount * sizeof(Mesh::CompressedVertexAttribute));
+				}
+				else if (mesh.attributesCompressed)
+				{
+					std::vector<Mesh::VertexAttribute> attributes(mesh.compressedAttributes.size());
+					for (size_t vert = 0; vert < attributes.size(); vert++)
+					{
+						attributes[vert] = MeshManagement::VertexCompression::Decompress(mesh.compressedAttributes[vert]);
+					}
+					UploadBufferRange(attributeBuffer.Get(), attributeUploadBuffer.Get(), attributes.data(), range.firstPosition * sizeof(Mesh::VertexAttribute), range.positionCount * sizeof(Mesh::VertexAttribute));
+				}
+				else
+				{
+					UploadBufferRange(attributeBuffer.Get(), attributeUploadBuffer.Get(), mesh.attributes.data(), range.firstPosition * sizeof(Mesh::VertexAttribute), range.positionCount * sizeof(Mesh::VertexAttribute));
+				}
+
+				//Only the first mesh's hierarchy is traced
+				if (dirtyMeshes[i] == 0)
+				{
+					std::vector<Mesh::LinkedNode> linkedNodes = mesh.GetLinkedNodeHierarchy();
+					UploadBufferRange(boundingVolumeHierarchyBuffer.Get(), boundingVolumeHierarchyUploadBuffer.Get(), linkedNodes.data(), 0, linkedNodes.size() * sizeof(Mesh::LinkedNode));
+				}
+			}
+		}
+		else
+		{
+			meshManager->TakeDirtyMeshes();
+
 			{
 				std::vector<Mesh::Triangle> triangleData = meshManager->GetTriangleArray();
 
@@ -677,37 +924,89 @@ namespace Graphics
 			}
 
 			{
-				//Update Vertex Data
-				std::vector<Mesh::Vertex> vertexData = meshManager->GetVertexArray();
+				//Update Vertex Position Data
+				std::vector<Mesh::VertexPosition> positionData = meshManager->GetPositionArray();
+
+				UINT elementSize{ static_cast<UINT>(sizeof(Mesh::VertexPosition)) };
+				UINT bufferSize{ static_cast<UINT>(positionData.size() * elementSize) };
+
+				D3D12_HEAP_PROPERTIES heapProperties = { D3D12_HEAP_TYPE_DEFAULT, D3D12_CPU_PAGE_PROPERTY_UNKNOWN, D3D12_MEMORY_POOL_UNKNOWN, 1, 1 };
+				CD3DX12_RESOURCE_DESC resourceDescription = CD3DX12_RESOURCE_DESC::Buffer(bufferSize, D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS);
+				GFX_THROW_INFO(pDevice->CreateCommittedResource(&heapProperties, D3D12_HEAP_FLAG_NONE, &resourceDescription, D3D12_RESOURCE_STATE_COPY_DEST, nullptr, IID_PPV_ARGS(&positionBuffer)));
+				positionDescriptorHeap = CreateDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE, 1);
+
+				D3D12_UNORDERED_ACCESS_VIEW_DESC bufferDescriptor;
+				ZeroMemory(&bufferDescriptor, sizeof(bufferDescriptor));
+				bufferDescriptor.Format = DXGI_FORMAT_UNKNOWN;
+				bufferDescriptor.ViewDimension = D3D12_UAV_DIMENSION_BUFFER;
+				bufferDescriptor.Buffer = { 0, (UINT)positionData.size(), elementSize, 0, D3D12_BUFFER_UAV_FLAG_NONE };
+
+				static UINT descriptorSize = pDevice->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+				pDevice->CreateUnorderedAccessView(positionBuffer.Get(), nullptr, &bufferDescriptor, positionDescriptorHeap->GetCPUDescriptorHandleForHeapStart());
+
+				heapProperties.Type = D3D12_HEAP_TYPE_UPLOAD;
+				resourceDescription.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+				GFX_THROW_INFO(pDevice->CreateCommittedResource(&heapProperties, D3D12_HEAP_FLAG_NONE, &resourceDescription, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&positionUploadBuffer)));
+
+				void* pData;
+				GFX_THROW_INFO(positionUploadBuffer->Map(0, NULL, &pData));
+				memcpy(pData, positionData.data(), bufferSize);
+				positionUploadBuffer->Unmap(0, NULL);
+				pCommandList->CopyBufferRegion(positionBuffer.Get(), 0, positionUploadBuffer.Get(), 0, bufferSize);
+				auto barrier = CD3DX12_RESOURCE_BARRIER::Transition(positionBuffer.Get(), D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+				pCommandList->ResourceBarrier(1, &barrier);
+			}
 
-				UINT elementSize{ static_cast<UINT>(sizeof(Mesh::Vertex)) };
-				UINT bufferSize{ static_cast<UINT>(vertexData.size() * elementSize) };
+			{
+				//Update Vertex Attribute Data, compressed when every mesh was imported with compressed attributes
+				std::vector<Mesh::VertexAttribute> attributeData;
+				std::vector<Mesh::CompressedVertexAttribute> compressedAttributeData;
+
+				UINT elementCount;
+				UINT elementSize;
+				const void* elementData;
+				if (meshManager->AttributesCompressed())
+				{
+					compressedAttributeData = meshManager->GetCompressedAttributeArray();
+					elementCount = (UINT)compressedAttributeData.size();
+					elementSize = static_cast<UINT>(sizeof(Mesh::CompressedVertexAttribute));
+					elementData = compressedAttributeData.data();
+				}
+				else
+				{
+					attributeData = meshManager->GetAttributeArray();
+					elementCount = (UINT)attributeData.size();
+					elementSize = static_cast<UINT>(sizeof(Mesh::VertexAttribute));
+					elementData = attributeData.data();
+				}
+				UINT bufferSize{ static_cast<UINT>(elementCount * elementSize) };
 
 				D3D12_HEAP_PROPERTIES heapProperties = { D3D12_HEAP_TYPE_DEFAULT, D3D12_CPU_PAGE_PROPERTY_UNKNOWN, D3D12_MEMORY_POOL_UNKNOWN, 1, 1 };
 				CD3DX12_RESOURCE_DESC resourceDescription = CD3DX12_RESOURCE_DESC::Buffer(bufferSize, D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS);
-				GFX_THROW_INFO(pDevice->CreateCommittedResource(&heapProperties, D3D12_HEAP_FLAG_NONE, &resourceDescription, D3D12_RESOURCE_STATE_COPY_DEST, nullptr, IID_PPV_ARGS(&vertexBuffer)));
-				vertexDescriptorHeap = CreateDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE, 1);
+				GFX_THROW_INFO(pDevice->CreateCommittedResource(&heapProperties, D3D12_HEAP_FLAG_NONE, &resourceDescription, D3D12_RESOURCE_STATE_COPY_DEST, nullptr, IID_PPV_ARGS(&attributeBuffer)));
+				attributeDescriptorHeap = CreateDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE, 1);
 
 				D3D12_UNORDERED_ACCESS_VIEW_DESC bufferDescriptor;
 				ZeroMemory(&bufferDescriptor, sizeof(bufferDescriptor));
 				bufferDescriptor.Format = DXGI_FORMAT_UNKNOWN;
 				bufferDescriptor.ViewDimension = D3D12_UAV_DIMENSION_BUFFER;
-				bufferDescriptor.Buffer = { 0, (UINT)vertexData.size(), elementSize, 0, D3D12_BUFFER_UAV_FLAG_NONE };
+				bufferDescriptor.Buffer = { 0, elementCount, elementSize, 0, D3D12_BUFFER_UAV_FLAG_NONE };
 
 				static UINT descriptorSize = pDevice->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-				pDevice->CreateUnorderedAccessView(vertexBuffer.Get(), nullptr, &bufferDescriptor, vertexDescriptorHeap->GetCPUDescriptorHandleForHeapStart());
+				pDevice->CreateUnorderedAccessView(attributeBuffer.Get(), nullptr, &bufferDescriptor, attributeDescriptorHeap->GetCPUDescriptorHandleForHeapStart());
 
 				heapProperties.Type = D3D12_HEAP_TYPE_UPLOAD;
 				resourceDescription.Flags = D3D12_RESOURCE_FLAG_NONE;
 
-				GFX_THROW_INFO(pDevice->CreateCommittedResource(&heapProperties, D3D12_HEAP_FLAG_NONE, &resourceDescription, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&vertexUploadBuffer)));
+				GFX_THROW_INFO(pDevice->CreateCommittedResource(&heapProperties, D3D12_HEAP_FLAG_NONE, &resourceDescription, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&attributeUploadBuffer)));
 
 				void* pData;
-				GFX_THROW_INFO(vertexUploadBuffer->Map(0, NULL, &pData));
-				memcpy(pData, vertexData.data(), bufferSize);
-				vertexUploadBuffer->Unmap(0, NULL);
-				pCommandList->CopyBufferRegion(vertexBuffer.Get(), 0, vertexUploadBuffer.Get(), 0, bufferSize);
-				auto barrier = CD3DX12_RESOURCE_BARRIER::Transition(vertexBuffer.Get(), D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+				GFX_THROW_INFO(attributeUploadBuffer->Map(0, NULL, &pData));
+				memcpy(pData, elementData, bufferSize);
+				attributeUploadBuffer->Unmap(0, NULL);
+				pCommandList->CopyBufferRegion(attributeBuffer.Get(), 0, attributeUploadBuffer.Get(), 0, bufferSize);
+				auto barrier = CD3DX12_RESOURCE_BARRIER::Transition(attributeBuffer.Get(), D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
 				pCommandList->ResourceBarrier(1, &barrier);
 			}
 
@@ -748,6 +1047,30 @@ namespace Graphics
 		}
 	}
 
+	void Graphics::UploadBufferRange(ID3D12Resource* buffer, ID3D12Resource* uploadBuffer, const void* data, UINT64 offset, UINT64 size)
+	{
+		HRESULT hr;
+
+		if (size == 0)
+		{
+			return;
+		}
+
+		//The upload buffer mirrors the whole buffer, so the range is written at the same offset in both
+		void* pData;
+		D3D12_RANGE readRange = { 0, 0 };
+		GFX_THROW_INFO(uploadBuffer->Map(0, &readRange, &pData));
+		memcpy((unsigned char*)pData + offset, data, size);
+		D3D12_RANGE writtenRange = { (SIZE_T)offset, (SIZE_T)(offset + size) };
+		uploadBuffer->Unmap(0, &writtenRange);
+
+		auto barrier = CD3DX12_RESOURCE_BARRIER::Transition(buffer, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE, D3D12_RESOURCE_STATE_COPY_DEST);
+		pCommandList->ResourceBarrier(1, &barrier);
+		pCommandList->CopyBufferRegion(buffer, offset, uploadBuffer, offset, size);
+		barrier = CD3DX12_RESOURCE_BARRIER::Transition(buffer, D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+		pCommandList->ResourceBarrier(1, &barrier);
+	}
+
 	void Graphics::WaitForPreviousFrame()
 	{
 		HRESULT hr;
@@ -796,61 +1119,37 @@ namespace Graphics
 				rtvHandle.Offset(1, rtvDescriptorSize);
 			}
 
-			D3D12_RESOURCE_DESC uavResourceDesc = {};
-			uavResourceDesc.DepthOrArraySize = 1;
-			uavResourceDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
-			uavResourceDesc.Format = DXGI_FORMAT_R16G16B16A16_FLOAT;
-			uavResourceDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
-			uavResourceDesc.Width = clientWidth;
-			uavResourceDesc.Height = clientHeight;
-			uavResourceDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
-			uavResourceDesc.MipLevels = 1;
-			uavResourceDesc.SampleDesc.Count = 1;
-
-			D3D12_HEAP_PROPERTIES uavHeapProps = {};
-			uavHeapProps.Type = D3D12_HEAP_TYPE_DEFAULT;
-			uavHeapProps.CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
-			uavHeapProps.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
-			uavHeapProps.CreationNodeMask = 0;
-			uavHeapProps.VisibleNodeMask = 0;
-			GFX_THROW_INFO(pDevice->CreateCommittedResource(&uavHeapProps, D3D12_HEAP_FLAG_NONE, &uavResourceDesc, D3D12_RESOURCE_STATE_UNORDERED_ACCESS, nullptr, IID_PPV_ARGS(&pUnorderedAccess)));
-
-			D3D12_DESCRIPTOR_HEAP_DESC uavDescriptorHeapDesc = {};
-			uavDescriptorHeapDesc.NumDescriptors = 1;
-			uavDescriptorHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
-			uavDescriptorHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
-
-			GFX_THROW_INFO(pDevice->CreateDescriptorHeap(&uavDescriptorHeapDesc, IID_PPV_ARGS(&pUAVHeap)));
-
-			D3D12_CPU_DESCRIPTOR_HANDLE uavHandle = pUAVHeap->GetCPUDescriptorHandleForHeapStart();
-
-			D3D12_UNORDERED_ACCESS_VIEW_DESC uavDesc = {};
-			uavDesc.ViewDimension = D3D12_UAV_DIMENSION_TEXTURE2D;
-			pDevice->CreateUnorderedAccessView(pUnorderedAccess.Get(), nullptr, &uavDesc, uavHandle);
+			//Every render texture is client sized, and the history in them is lost
+			CreateRenderTextures();
+			governor.SetOutputSize((unsigned int)clientWidth, (unsigned int)clientHeight);
 		}
 	}
 
+	const MeshManagement::ResolutionGovernor::Statistics& Graphics::GetResolutionStatistics() const
+	{
+		return governor.GetStatistics();
+	}
+
 	void Graphics::SetRenderConstants()
 	{
 		RenderConstants constants;
 		ZeroMemory(&constants, sizeof(constants));
 		constants.time = float(clock()) / CLOCKS_PER_SEC;
 		constants.frame = currentFrame;
-		constants.width = clientWidth;
-		constants.height = clientHeight;
-
-		constants.originX = 3.6f * std::sin(constants.time * 1.5f) + 0.5f;
-		constants.originY = 3.0f + std::sin(constants.time * 2.0f);
-		constants.originZ = 3.6f * std::cos(constants.time * 1.0f) + 0.5f;
-
-		float mulBy = std::sqrt(constants.originX * constants.originX + constants.originZ * constants.originZ);
-		constants.originX /= mulBy * 0.2f;
-		constants.originZ /= mulBy * 0.25f;
-
-		constants.padding1 = 0;
+		constants.width = renderWidth;
+		constants.height = renderHeight;
+		constants.previousWidth = previousRenderWidth;
+		constants.previousHeight = previousRenderHeight;
+		previousRenderWidth = renderWidth;
+		previousRenderHeight = renderHeight;
+
+		Vector3<float> origin = Camera::OrbitPosition(constants.time);
+		constants.originX = origin.x;
+		constants.originY = origin.y;
+		constants.originZ = origin.z;
+
+		constants.denoiseIteration = 0;
 		constants.padding2 = 0;
-		constants.padding4 = 0;
-		constants.padding5 = 0;
 		constants.padding6 = 0;
 
 		constants.previousOriginX = (float)camera.position.x;
@@ -890,6 +1189,14 @@ namespace Graphics
 
 		GFX_THROW_INFO(pCommandAllocator->Reset());
 		GFX_THROW_INFO(pCommandList->Reset(pCommandAllocator.Get(), pRenderPipelineState.Get()));
+		if (dynamicResolution)
+		{
+			pCommandList->EndQuery(pTimestampQueryHeap.Get(), D3D12_QUERY_TYPE_TIMESTAMP, 0);
+		}
+
+		//Every pass up to Shaders/Upscale.hlsl works on the top left renderWidth by renderHeight pixels of its textures
+		renderWidth = dynamicResolution ? governor.GetRenderWidth() : (UINT)clientWidth;
+		renderHeight = dynamicResolution ? governor.GetRenderHeight() : (UINT)clientHeight;
 
 		UpdateUIBuffer();
 		UpdateTriangleBuffer();
@@ -897,14 +1204,18 @@ namespace Graphics
 		//Set root signature
 		pCommandList->SetComputeRootSignature(pRootSignature.Get());
 
-		//Bind Triangle buffer, Vertex Buffer, Node Hierarchy, Render Texture, and UI buffer
+		//Bind Triangle buffer, Vertex Position and Attribute Buffers, Node Hierarchy, Render Texture, and UI buffer
 		auto triangleBufferHeap = triangleDescriptorHeap.Get();
 		pCommandList->SetDescriptorHeaps(1, &triangleBufferHeap);
 		pCommandList->SetComputeRootDescriptorTable(3, triangleBufferHeap->GetGPUDescriptorHandleForHeapStart());
 
-		auto vertexBufferHeap = vertexDescriptorHeap.Get();
-		pCommandList->SetDescriptorHeaps(1, &vertexBufferHeap);
-		pCommandList->SetComputeRootDescriptorTable(5, vertexBufferHeap->GetGPUDescriptorHandleForHeapStart());
+		auto positionBufferHeap = positionDescriptorHeap.Get();
+		pCommandList->SetDescriptorHeaps(1, &positionBufferHeap);
+		pCommandList->SetComputeRootDescriptorTable(5, positionBufferHeap->GetGPUDescriptorHandleForHeapStart());
+
+		auto attributeBufferHeap = attributeDescriptorHeap.Get();
+		pCommandList->SetDescriptorHeaps(1, &attributeBufferHeap);
+		pCommandList->SetComputeRootDescriptorTable(10, attributeBufferHeap->GetGPUDescriptorHandleForHeapStart());
 
 		auto bvhBufferHeap = boundingVolumeHierarchyDescriptorHeap.Get();
 		pCommandList->SetDescriptorHeaps(1, &bvhBufferHeap);
@@ -926,6 +1237,15 @@ namespace Graphics
 		auto geomertyReprojectionBufferHeap = pGeomertyHistoryBufferHeap.Get();
 		pCommandList->SetDescriptorHeaps(1, &geomertyReprojectionBufferHeap);
 		pCommandList->SetComputeRootDescriptorTable(8, pGeomertyHistoryBufferHeap->GetGPUDescriptorHandleForHeapStart());
+		auto motionBufferHeap = pMotionBufferHeap.Get();
+		pCommandList->SetDescriptorHeaps(1, &motionBufferHeap);
+		pCommandList->SetComputeRootDescriptorTable(11, pMotionBufferHeap->GetGPUDescriptorHandleForHeapStart());
+		if (dynamicResolution)
+		{
+			auto upscaleBufferHeap = pUpscaleBufferHeap.Get();
+			pCommandList->SetDescriptorHeaps(1, &upscaleBufferHeap);
+			pCommandList->SetComputeRootDescriptorTable(12, pUpscaleBufferHeap->GetGPUDescriptorHandleForHeapStart());
+		}
 
 		if (uiManager.ElementCount() != 0)
 		{
@@ -937,33 +1257,83 @@ namespace Graphics
 		//Set Constants
 		SetRenderConstants();
 
-		//Execute compute shader
+		//Execute compute shader, one thread per pixel traced this frame
 		double threadGroupSize = 32;
-		pCommandList->Dispatch((UINT)std::ceil((double)clientWidth / threadGroupSize), (UINT)std::ceil((double)clientHeight / threadGroupSize), 1);
+		UINT tracedColumns = Checkerboard::CheckerboardColumns(checkerboard, renderWidth);
+		UINT tracedRows = Checkerboard::CheckerboardRows(checkerboard, renderHeight);
+		pCommandList->Dispatch((UINT)std::ceil((double)tracedColumns / threadGroupSize), (UINT)std::ceil((double)tracedRows / threadGroupSize), 1);
+
+		//Fill in the pixels that weren't traced
+		if (checkerboard != Checkerboard::checkerboardFull)
+		{
+			D3D12_RESOURCE_BARRIER uavBarrier = CD3DX12_RESOURCE_BARRIER::UAV(nullptr);
+			pCommandList->ResourceBarrier(1, &uavBarrier);
+			pCommandList->SetPipelineState(pCheckerboardPipelineState.Get());
+			pCommandList->Dispatch((UINT)std::ceil((double)renderWidth / threadGroupSize), (UINT)std::ceil((double)renderHeight / threadGroupSize), 1);
+		}
+
+		//Blend the frame into the history once main has written all of it
+		{
+			D3D12_RESOURCE_BARRIER uavBarrier = CD3DX12_RESOURCE_BARRIER::UAV(nullptr);
+			pCommandList->ResourceBarrier(1, &uavBarrier);
+			pCommandList->SetPipelineState(pTemporalPipelineState.Get());
+			pCommandList->Dispatch((UINT)std::ceil((double)renderWidth / threadGroupSize), (UINT)std::ceil((double)renderHeight / threadGroupSize), 1);
+		}
+
+		//Denoise, every iteration reads what the dispatch before it wrote
+		if (denoise)
+		{
+			pCommandList->SetPipelineState(pDenoisePipelineState.Get());
+			for (UINT iteration = 0; iteration < std::max(denoiseIterations, 1u); iteration++)
+			{
+				D3D12_RESOURCE_BARRIER uavBarrier = CD3DX12_RESOURCE_BARRIER::UAV(nullptr);
+				pCommandList->ResourceBarrier(1, &uavBarrier);
+				pCommandList->SetComputeRoot32BitConstant(2, iteration, offsetof(RenderConstants, denoiseIteration) / 4);
+				pCommandList->Dispatch((UINT)std::ceil((double)renderWidth / threadGroupSize), (UINT)std::ceil((double)renderHeight / threadGroupSize), 1);
+			}
+		}
+
+		//Stretch the frame to the client size
+		if (dynamicResolution)
+		{
+			D3D12_RESOURCE_BARRIER uavBarrier = CD3DX12_RESOURCE_BARRIER::UAV(nullptr);
+			pCommandList->ResourceBarrier(1, &uavBarrier);
+			pCommandList->SetPipelineState(pUpscalePipelineState.Get());
+			pCommandList->Dispatch((UINT)std::ceil((double)clientWidth / threadGroupSize), (UINT)std::ceil((double)clientHeight / threadGroupSize), 1);
+		}
 
-		//Copy history buffer to temp buffer and render uav to backbuffer
-		D3D12_RESOURCE_BARRIER transitionToCopyBarrier[6] = { CD3DX12_RESOURCE_BARRIER::Transition(pBackBuffers[currentBackBufferIndex].Get(), D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_COPY_DEST),
+		//Copy history buffer to temp buffer and the accumulated, denoised or upscaled frame to backbuffer
+		D3D12_RESOURCE_BARRIER transitionToCopyBarrier[7] = { CD3DX12_RESOURCE_BARRIER::Transition(pBackBuffers[currentBackBufferIndex].Get(), D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_COPY_DEST),
 															  CD3DX12_RESOURCE_BARRIER::Transition(pUnorderedAccess.Get(), D3D12_RESOURCE_STATE_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_COPY_SOURCE),
 															  CD3DX12_RESOURCE_BARRIER::Transition(pHistoryBuffer.Get(), D3D12_RESOURCE_STATE_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_COPY_SOURCE), 
 															  CD3DX12_RESOURCE_BARRIER::Transition(pGeomertyHistoryBuffer.Get(), D3D12_RESOURCE_STATE_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_COPY_SOURCE),
 															  CD3DX12_RESOURCE_BARRIER::Transition(pTemporaryHistoryBuffer.Get(), D3D12_RESOURCE_STATE_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_COPY_DEST), 
-															  CD3DX12_RESOURCE_BARRIER::Transition(pGeomertyTemporaryHistoryBuffer.Get(), D3D12_RESOURCE_STATE_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_COPY_DEST) };
+															  CD3DX12_RESOURCE_BARRIER::Transition(pGeomertyTemporaryHistoryBuffer.Get(), D3D12_RESOURCE_STATE_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_COPY_DEST),
+															  CD3DX12_RESOURCE_BARRIER::Transition(pUpscaleBuffer.Get(), D3D12_RESOURCE_STATE_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_COPY_SOURCE) };
 
-		pCommandList->ResourceBarrier(6, transitionToCopyBarrier);
+		UINT copyBarrierCount = dynamicResolution ? 7 : 6;
+		pCommandList->ResourceBarrier(copyBarrierCount, transitionToCopyBarrier);
 
-		pCommandList->CopyResource(pBackBuffers[currentBackBufferIndex].Get(), pUnorderedAccess.Get());
+		pCommandList->CopyResource(pBackBuffers[currentBackBufferIndex].Get(), dynamicResolution ? pUpscaleBuffer.Get() : denoise ? pUnorderedAccess.Get() : pHistoryBuffer.Get());
 		pCommandList->CopyResource(pTemporaryHistoryBuffer.Get(), pHistoryBuffer.Get());
 		pCommandList->CopyResource(pGeomertyTemporaryHistoryBuffer.Get(), pGeomertyHistoryBuffer.Get());
 
 		//Reset resource states
-		D3D12_RESOURCE_BARRIER resetStateBarrier[6] = { CD3DX12_RESOURCE_BARRIER::Transition(pBackBuffers[currentBackBufferIndex].Get(), D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_COMMON),
+		D3D12_RESOURCE_BARRIER resetStateBarrier[7] = { CD3DX12_RESOURCE_BARRIER::Transition(pBackBuffers[currentBackBufferIndex].Get(), D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_COMMON),
 														CD3DX12_RESOURCE_BARRIER::Transition(pUnorderedAccess.Get(), D3D12_RESOURCE_STATE_COPY_SOURCE, D3D12_RESOURCE_STATE_UNORDERED_ACCESS),
 														CD3DX12_RESOURCE_BARRIER::Transition(pHistoryBuffer.Get(), D3D12_RESOURCE_STATE_COPY_SOURCE, D3D12_RESOURCE_STATE_UNORDERED_ACCESS),
 														CD3DX12_RESOURCE_BARRIER::Transition(pGeomertyHistoryBuffer.Get(), D3D12_RESOURCE_STATE_COPY_SOURCE, D3D12_RESOURCE_STATE_UNORDERED_ACCESS),
 														CD3DX12_RESOURCE_BARRIER::Transition(pTemporaryHistoryBuffer.Get(), D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_UNORDERED_ACCESS), 
-														CD3DX12_RESOURCE_BARRIER::Transition(pGeomertyTemporaryHistoryBuffer.Get(), D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_UNORDERED_ACCESS) };
+														CD3DX12_RESOURCE_BARRIER::Transition(pGeomertyTemporaryHistoryBuffer.Get(), D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_UNORDERED_ACCESS),
+														CD3DX12_RESOURCE_BARRIER::Transition(pUpscaleBuffer.Get(), D3D12_RESOURCE_STATE_COPY_SOURCE, D3D12_RESOURCE_STATE_UNORDERED_ACCESS) };
 
-		pCommandList->ResourceBarrier(6, resetStateBarrier);
+		pCommandList->ResourceBarrier(copyBarrierCount, resetStateBarrier);
+
+		if (dynamicResolution)
+		{
+			pCommandList->EndQuery(pTimestampQueryHeap.Get(), D3D12_QUERY_TYPE_TIMESTAMP, 1);
+			pCommandList->ResolveQueryData(pTimestampQueryHeap.Get(), D3D12_QUERY_TYPE_TIMESTAMP, 0, 2, pTimestampReadbackBuffer.Get(), 0);
+		}
 
 		GFX_THROW_INFO(pCommandList->Close());
 	}
@@ -998,6 +1368,18 @@ namespace Graphics
 			currentFrame++;
 
 			WaitForPreviousFrame();
+
+			//The frame has finished, so its timestamps are ready
+			if (dynamicResolution)
+			{
+				UINT64* pTimestamps;
+				D3D12_RANGE readRange = { 0, 2 * sizeof(UINT64) };
+				GFX_THROW_INFO(pTimestampReadbackBuffer->Map(0, &readRange, (void**)&pTimestamps));
+				double milliseconds = (double)(pTimestamps[1] - pTimestamps[0]) * 1000.0 / (double)timestampFrequency;
+				D3D12_RANGE writtenRange = { 0, 0 };
+				pTimestampReadbackBuffer->Unmap(0, &writtenRange);
+				governor.EndFrame(milliseconds);
+			}
 		}
 	}
 }
\ No newline at end of file
@@ -6,6 +6,7 @@
 
 #include "UIManager.h"
 #include "MeshManager.h"
+#include "ResolutionGovernor.h"
 #include "Camera.h"
 
 #include <d3d12.h>
@@ -38,11 +39,14 @@ namespace Graphics
 		float previousOriginY;
 		float previousOriginZ;
 
-		float padding1, padding2;
+		unsigned int denoiseIteration; //Set per dispatch of Shaders/Denoise.hlsl
+		float padding2;
 
 		float mat[9];
 
-		float padding4, padding5, padding6;
+		unsigned int previousWidth; //Size the frame before was rendered at, which dynamic resolution may change
+		unsigned int previousHeight;
+		float padding6;
 
 		float previousMatrix[9];
 	};
@@ -63,6 +67,7 @@ namespace Graphics
 
 		void Render();
 		void Resize(UINT32 width, UINT32 height);
+		const MeshManagement::ResolutionGovernor::Statistics& GetResolutionStatistics() const; //The render size and scale in use
 	private:
 		void LoadPipeline();
 		void LoadAssets();
@@ -76,11 +81,14 @@ namespace Graphics
 		void CreatePipelineSynchronizationObjects();
 		void CreatePipelineRootSignature();
 		void CreatePipelineStateObjects();
+		void CreatePipelineTimestampQueries();
+		ComPtr<ID3D12PipelineState> CreateComputePipelineState(LPCWSTR shaderPath, const D3D_SHADER_MACRO* defines);
 	private:
 		void CreateBackbuffers();
 		void CreateRenderTextures();
 		void UpdateUIBuffer();
 		void UpdateTriangleBuffer();
+		void UploadBufferRange(ID3D12Resource* buffer, ID3D12Resource* uploadBuffer, const void* data, UINT64 offset, UINT64 size);
 	private:
 		ComPtr<ID3D12DescriptorHeap> CreateDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYPE type, D3D12_DESCRIPTOR_HEAP_FLAGS flags, UINT numDescriptors);
 		void WaitForPreviousFrame();
@@ -95,6 +103,15 @@ namespace Graphics
 		static const UINT frameCount = 2;
 		bool VSyncEnabled = false;
 		bool useWarp = false;
+		bool pathTracing = false; //Compiles RenderCompute.hlsl with PATH_TRACING instead of direct lighting
+		unsigned int maxPathDepth = 4; //Surface hits per path
+		unsigned int pathSegments = 8; //Rays traced per pixel per frame, ended paths are replaced until these are used up
+		unsigned int sampler = 1; //Sequence constant from Shaders/Sampler.hlsli for jitter and path sampling, 1 is Owen scrambled Sobol
+		bool denoise = false; //Filters every frame with Shaders/Denoise.hlsl before it is presented
+		unsigned int denoiseIterations = 5; //Filter passes, each one doubles the distance between taps
+		unsigned int checkerboard = 1; //Pattern constant from Shaders/Checkerboard.hlsli, 1 traces every pixel, 2 half and 4 a quarter of them each frame
+		bool dynamicResolution = false; //Renders at the size ResolutionGovernor picks and upscales with Shaders/Upscale.hlsl
+		double frameBudget = 1000.0 / 60.0; //Milliseconds of GPU time per frame dynamicResolution aims for
 	private:
 		bool tearingSupported = false;
 #pragma warning(push)
@@ -120,6 +137,17 @@ namespace Graphics
 		ComPtr<ID3D12DescriptorHeap> pGeomertyHistoryBufferHeap;
 		ComPtr<ID3D12DescriptorHeap> pGeomertyTemporaryHistoryBufferHeap;
 
+		ComPtr<ID3D12Resource> pMotionBuffer; //Written by Shaders/RenderCompute.hlsl for Shaders/Temporal.hlsl
+		ComPtr<ID3D12DescriptorHeap> pMotionBufferHeap;
+
+		ComPtr<ID3D12Resource> pUpscaleBuffer; //Written by Shaders/Upscale.hlsl under dynamicResolution
+		ComPtr<ID3D12DescriptorHeap> pUpscaleBufferHeap;
+
+		//Timestamps either end of the command list, for the governor
+		ComPtr<ID3D12QueryHeap> pTimestampQueryHeap;
+		ComPtr<ID3D12Resource> pTimestampReadbackBuffer;
+		UINT64 timestampFrequency = 0;
+
 		ComPtr<ID3D12Resource> uiElementBuffer;
 		ComPtr<ID3D12Resource> uiUploadBuffer;
 		ComPtr<ID3D12DescriptorHeap> uiElementDescriptorHeap;
@@ -132,15 +160,23 @@ namespace Graphics
 		ComPtr<ID3D12Resource> boundingVolumeHierarchyUploadBuffer;
 		ComPtr<ID3D12DescriptorHeap> boundingVolumeHierarchyDescriptorHeap;
 
-		ComPtr<ID3D12Resource> vertexBuffer;
-		ComPtr<ID3D12Resource> vertexUploadBuffer;
-		ComPtr<ID3D12DescriptorHeap> vertexDescriptorHeap;
+		ComPtr<ID3D12Resource> positionBuffer;
+		ComPtr<ID3D12Resource> positionUploadBuffer;
+		ComPtr<ID3D12DescriptorHeap> positionDescriptorHeap;
+
+		ComPtr<ID3D12Resource> attributeBuffer;
+		ComPtr<ID3D12Resource> attributeUploadBuffer;
+		ComPtr<ID3D12DescriptorHeap> attributeDescriptorHeap;
 
 		UINT RTVDescriptorSize;
 		UINT UAVDescriptorSize;
 		UINT currentBackBufferIndex;
 
 		ComPtr<ID3D12PipelineState> pRenderPipelineState;
+		ComPtr<ID3D12PipelineState> pCheckerboardPipelineState;
+		ComPtr<ID3D12PipelineState> pTemporalPipelineState;
+		ComPtr<ID3D12PipelineState> pDenoisePipelineState;
+		ComPtr<ID3D12PipelineState> pUpscalePipelineState;
 
 		ComPtr<ID3D12RootSignature> pRootSignature;
 
@@ -153,6 +189,12 @@ namespace Graphics
 		Camera camera = Camera();
 		unsigned int currentFrame = 0;
 
+		MeshManagement::ResolutionGovernor governor;
+		UINT renderWidth = 0;
+		UINT renderHeight = 0;
+		UINT previousRenderWidth = 0; //0 until there is a history to reproject from
+		UINT previousRenderHeight = 0;
+
 #ifndef NDEBUG
 		EngineDebug::DirectxErrorCatcher errorCatcher;
 #endif
@@ -4,7 +4,7 @@
 
 template <typename MatrixType> class Matrix2x2
 {
-	static_assert(std::is_arithmetic<VectorType>::value, "Matrix type must be numeric.");
+	static_assert(std::is_arithmetic<MatrixType>::value, "Matrix type must be numeric.");
 public:
 	Matrix2x2(MatrixType x0, MatrixType y0, MatrixType x1, MatrixType y1) : x0(x0), y0(y0), x1(x1), y1(y1) {};
 	template <typename Type> Matrix2x2(Vector2<Type> v0, Vector2<Type> v1) : x0(v0.x), y0(v0.y), x1(v1.x), y1(v1.y) {};
@@ -56,9 +56,14 @@ public:
 	template<typename Type> Matrix3x3<MatrixType> operator/(Type scalar) { static_assert(std::is_arithmetic<Type>::value, "Scalar type must be numeric."); return Matrix3x3<MatrixType>(x0 / scalar, y0 / scalar, z0 / scalar, x1 / scalar, y1 / scalar, z1 / scalar, x2 / scalar, y2 / scalar, z2 / scalar); }
 	template<typename Type> Matrix3x3<MatrixType> operator/=(Type scalar) { static_assert(std::is_arithmetic<Type>::value, "Scalar type must be numeric."); *this = Matrix3x3<MatrixType>(x0 / scalar, y0 / scalar, z0 / scalar, x1 / scalar, y1 / scalar, z1 / scalar, x2 / scalar, y2 / scalar, z2 / scalar); return *this; }
 public:
-	template<typename Type> static Matrix3x3<Type> Invert(Matrix3x3<Type> matrix)
+	//A singular matrix has no inverse, it returns the identity and clears invertible if given
+	template<typename Type> static Matrix3x3<Type> Invert(Matrix3x3<Type> matrix, bool* invertible = nullptr)
 	{
 		double determinant = matrix.Determinant();
+		if (invertible != nullptr)
+		{
+			*invertible = determinant != 0;
+		}
 		if (determinant == 0)
 		{
 			return Matrix3x3<Type>(1, 0, 0, 0, 1, 0, 0, 0, 1);
@@ -83,4 +88,37 @@ public:
 #pragma warning(disable:4172)
 	float* GetGpuMatrix() { float matrix[9] = { (float)x0, (float)y0, (float)z0, (float)x1, (float)y1, (float)z1, (float)x2, (float)y2, (float)z2 }; return matrix; }
 #pragma warning(pop)
+};
+
+//Affine transform, a 3x3 linear part in columns x, y and z followed by a translation column w. Rows are x0 y0 z0 w0 and so on.
+template <typename MatrixType> class Matrix3x4
+{
+	static_assert(std::is_arithmetic<MatrixType>::value, "Matrix type must be numeric.");
+public:
+	Matrix3x4(MatrixType x0, MatrixType y0, MatrixType z0, MatrixType w0, MatrixType x1, MatrixType y1, MatrixType z1, MatrixType w1, MatrixType x2, MatrixType y2, MatrixType z2, MatrixType w2) : x0(x0), y0(y0), z0(z0), w0(w0), x1(x1), y1(y1), z1(z1), w1(w1), x2(x2), y2(y2), z2(z2), w2(w2) {};
+	template<typename Type> Matrix3x4(Matrix3x3<Type> linear, Vector3<Type> translation) : x0(linear.x0), y0(linear.y0), z0(linear.z0), w0(translation.x), x1(linear.x1), y1(linear.y1), z1(linear.z1), w1(translation.y), x2(linear.x2), y2(linear.y2), z2(linear.z2), w2(translation.z) {};
+	template <typename Type> operator Matrix3x4<Type>() { static_assert(std::is_arithmetic<Type>::value, "Cannot convert to a matrix of this type"); return Matrix3x4<Type>((Type)x0, (Type)y0, (Type)z0, (Type)w0, (Type)x1, (Type)y1, (Type)z1, (Type)w1, (Type)x2, (Type)y2, (Type)z2, (Type)w2); }
+public:
+	//Applies matrix first, then this transform
+	template<typename Type> Matrix3x4<MatrixType> operator*(Matrix3x4<Type> matrix) { static_assert(std::is_arithmetic<Type>::value, "Matrix type must be numeric."); Matrix3x3<MatrixType> linear = GetLinear() * matrix.GetLinear(); return Matrix3x4<MatrixType>(linear, TransformPoint(Vector3<Type>(matrix.w0, matrix.w1, matrix.w2))); }
+	template<typename Type> Matrix3x4<MatrixType> operator*=(Matrix3x4<Type> matrix) { *this = *this * matrix; return *this; }
+public:
+	template<typename Type> Vector3<MatrixType> TransformPoint(Vector3<Type> point) { return Vector3<MatrixType>(x0 * (MatrixType)point.x + y0 * (MatrixType)point.y + z0 * (MatrixType)point.z + w0, x1 * (MatrixType)point.x + y1 * (MatrixType)point.y + z1 * (MatrixType)point.z + w1, x2 * (MatrixType)point.x + y2 * (MatrixType)point.y + z2 * (MatrixType)point.z + w2); }
+	template<typename Type> Vector3<MatrixType> TransformDirection(Vector3<Type> direction) { return Vector3<MatrixType>(x0 * (MatrixType)direction.x + y0 * (MatrixType)direction.y + z0 * (MatrixType)direction.z, x1 * (MatrixType)direction.x + y1 * (MatrixType)direction.y + z1 * (MatrixType)direction.z, x2 * (MatrixType)direction.x + y2 * (MatrixType)direction.y + z2 * (MatrixType)direction.z); }
+	Matrix3x3<MatrixType> GetLinear() { return Matrix3x3<MatrixType>(x0, y0, z0, x1, y1, z1, x2, y2, z2); }
+public:
+	static Matrix3x4<MatrixType> Identity() { return Matrix3x4<MatrixType>(1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0); }
+
+	//Inverse of the linear part, and the translation moved back through it. A singular linear part inverts to the identity and
+	//clears invertible, like Matrix3x3::Invert, so callers that can't use such a transform should check it.
+	template<typename Type> static Matrix3x4<Type> Invert(Matrix3x4<Type> matrix, bool* invertible = nullptr)
+	{
+		Matrix3x3<Type> inverseLinear = Matrix3x3<Type>::Invert(matrix.GetLinear(), invertible);
+		Vector3<Type> translation = Vector3<Type>(inverseLinear.x0 * matrix.w0 + inverseLinear.y0 * matrix.w1 + inverseLinear.z0 * matrix.w2, inverseLinear.x1 * matrix.w0 + inverseLinear.y1 * matrix.w1 + inverseLinear.z1 * matrix.w2, inverseLinear.x2 * matrix.w0 + inverseLinear.y2 * matrix.w1 + inverseLinear.z2 * matrix.w2);
+		return Matrix3x4<Type>(inverseLinear, -translation);
+	}
+public:
+	MatrixType x0, y0, z0, w0;
+	MatrixType x1, y1, z1, w1;
+	MatrixType x2, y2, z2, w2;
 };
\ No newline at end of file
@@ -0,0 +1,266 @@
+#ifndef BLUE_NOISE_HLSLI
+#define BLUE_NOISE_HLSLI
+
+//64x64 blue noise tile, the rank of every texel in 0 to 4095, two 16 bit ranks per entry with the lower texel in the low half.
+//Made with void and cluster (Ulichney 1993), toroidal Gaussian energy with sigma 1.9, so it tiles without seams.
+static const uint blueNoiseRanks[2048] =
+{
+	0x05f3011bu, 0x09800e94u, 0x0bb90721u, 0x0e610002u, 0x031504b0u, 0x0b3b09e6u, 0x0bf700feu, 0x0fe10d6du,
+	0x0dc40572u, 0x0c40097du, 0x013c0f95u, 0x09870d85u, 0x0b690edbu, 0x079803d2u, 0x06140e77u, 0x01b303bcu,
+	0x0a330536u, 0x08050f1bu, 0x0a06040bu, 0x0725029fu, 0x04a00c39u, 0x05a10cf9u, 0x0bfd0826u, 0x0a3202a2u,
+	0x00570de1u, 0x06dd0961u, 0x058b0efbu, 0x07d30316u, 0x01bc03efu, 0x00ae04c8u, 0x09720ec4u, 0x0e190b9au,
+	0x08010a59u, 0x0c2f04fcu, 0x061c0437u, 0x0a730cffu, 0x08870699u, 0x0e0a0544u, 0x02c20430u, 0x08c30608u,
+	0x01af0360u, 0x009d0e92u, 0x0759041eu, 0x01ff089au, 0x047a06d6u, 0x0aaf0f46u, 0x09df00a8u, 0x0cce07ecu,
+	0x0e03043cu, 0x0bff05b8u, 0x0d6b0096u, 0x0f450b41u, 0x06720050u, 0x019b0e30u, 0x06a50f79u, 0x01b80ee2u,
+	0x04260783u, 0x02360accu, 0x0c9904c9u, 0x0ff8010du, 0x0e9305dbu, 0x0a250c45u, 0x07c60ce3u, 0x02f90469u,
+	0x0cc10f18u, 0x02610084u, 0x0ff408a1u, 0x0205037du, 0x00d70d7au, 0x09230fa2u, 0x0a940786u, 0x072200b9u,
+	0x0a3c0c89u, 0x0b610850u, 0x0ac80538u, 0x0e490383u, 0x01190bf6u, 0x0d3008eeu, 0x0209055cu, 0x0eac0b81u,
+	0x0730002cu, 0x08c00330u, 0x01860eb8u, 0x07e50567u, 0x08ae0a86u, 0x09cf031cu, 0x038c0b07u, 0x0cb004bau,
+	0x0f3b058fu, 0x087f0c4eu, 0x09440e17u, 0x0beb0716u, 0x084209b9u, 0x070602d7u, 0x0f9703afu, 0x08df0024u,
+	0x03c006eau, 0x0d8e0ae9u, 0x014909fbu, 0x0b45057au, 0x03e0076au, 0x01600c13u, 0x0f3c0cfeu, 0x0e5c0990u,
+	0x0468022du, 0x02fa06cdu, 0x06390f00u, 0x00720cecu, 0x06000a17u, 0x071d0295u, 0x0f8b035cu, 0x06670890u,
+	0x0aa9097au, 0x021e0c72u, 0x099a0634u, 0x0e720387u, 0x0bc4023du, 0x0d420448u, 0x0032072au, 0x08d90b8eu,
+	0x010509c3u, 0x0617033fu, 0x03b30175u, 0x026f0ab7u, 0x0d970061u, 0x0b42053bu, 0x064401edu, 0x05630c10u,
+	0x0192099fu, 0x07a20f81u, 0x0e3506a8u, 0x083a0c68u, 0x0a080efeu, 0x029405ebu, 0x04ee06aau, 0x0afd03c3u,
+	0x0f5f0555u, 0x018f0d68u, 0x09560bd6u, 0x07e20277u, 0x0ffb050fu, 0x098b0cb3u, 0x04bb0de9u, 0x02be0c31u,
+	0x0d8f012du, 0x0fe404abu, 0x06f50b6eu, 0x04cc0cb7u, 0x0fb700f4u, 0x0146061bu, 0x0dd90942u, 0x027907dau,
+	0x06e90e59u, 0x0f8d0b4eu, 0x0d3c07b0u, 0x04970e70u, 0x0f57069fu, 0x092a0142u, 0x0aa60e43u, 0x02730da3u,
+	0x0b820d19u, 0x031305c1u, 0x009b04beu, 0x02db095cu, 0x006204a5u, 0x0e4a0b10u, 0x01a00820u, 0x00800bb8u,
+	0x0c1a07b9u, 0x001a08feu, 0x04770795u, 0x0eb30daau, 0x04030b1cu, 0x003e0838u, 0x01660ad2u, 0x05b1078fu,
+	0x03a90f05u, 0x00bf07c2u, 0x02cc0863u, 0x0a1e0df1u, 0x0c6b0751u, 0x0ed8083bu, 0x05c402d5u, 0x00c90faeu,
+	0x0d0403f6u, 0x0a3504f5u, 0x0581002eu, 0x0b8008a4u, 0x0a5a0359u, 0x042f0d20u, 0x01010765u, 0x082f04b1u,
+	0x0440005au, 0x0e880900u, 0x0bc50aa7u, 0x0dd201d3u, 0x0d4006ffu, 0x036708e9u, 0x0ef60c7du, 0x0def08b0u,
+	0x034d0656u, 0x05d209f0u, 0x0a770fa0u, 0x06be00f9u, 0x0c26031bu, 0x069b01ebu, 0x04200f27u, 0x0cea09f8u,
+	0x090f0b23u, 0x0a400557u, 0x04230d15u, 0x08ec0000u, 0x0b210588u, 0x0aa203b7u, 0x0a0e0509u, 0x06830c02u,
+	0x08340abau, 0x0c2501f4u, 0x09b202dau, 0x01cd0edcu, 0x0c4f0788u, 0x088205cbu, 0x03210fc6u, 0x0ef70a03u,
+	0x06780e1bu, 0x02130c96u, 0x0f5607feu, 0x05fb03fbu, 0x0fcb0a64u, 0x04570203u, 0x05a309d5u, 0x0a4702e7u,
+	0x0cc501fbu, 0x0e0d0425u, 0x0c71024bu, 0x09170576u, 0x09e90173u, 0x05c50e66u, 0x08b40bc0u, 0x006e0dbeu,
+	0x06ae0242u, 0x017a0e2eu, 0x05fe0ee6u, 0x0f610bb1u, 0x0281019fu, 0x009a0dbdu, 0x01da0ce5u, 0x0d750463u,
+	0x0ec20314u, 0x0dd10926u, 0x0400065au, 0x00e30c95u, 0x098e0501u, 0x00920264u, 0x0c6c0b52u, 0x0728057du,
+	0x02c70af2u, 0x0a0d00f1u, 0x07420540u, 0x089d0ce2u, 0x051b011fu, 0x07ad0bcdu, 0x070c0026u, 0x04ae0d59u,
+	0x00e60feau, 0x0b390889u, 0x0370071eu, 0x0d43084cu, 0x076b0f75u, 0x0cc604dcu, 0x0345025fu, 0x05120709u,
+	0x0be60f8eu, 0x0adb0310u, 0x0228076du, 0x06960983u, 0x04830e64u, 0x066a07afu, 0x0e8108b3u, 0x0985071bu,
+	0x05af013du, 0x00a30484u, 0x07130fd9u, 0x082d0ad1u, 0x0df80f34u, 0x0eb103e6u, 0x020b063fu, 0x0399091fu,
+	0x086c0c27u, 0x0d930fe0u, 0x00530385u, 0x0b640ee3u, 0x06910338u, 0x0d0b0e82u, 0x0f420af8u, 0x0b8c0150u,
+	0x06af07d8u, 0x05180ebcu, 0x0f0e01a6u, 0x04510bb6u, 0x0ae600b3u, 0x09540393u, 0x0a8e010au, 0x081c0e79u,
+	0x09aa0136u, 0x08930460u, 0x050d0c63u, 0x032b0d49u, 0x0ca7084du, 0x0fef09a8u, 0x0b7b0351u, 0x080a001bu,
+	0x0bd30f68u, 0x0b1e0776u, 0x024d08afu, 0x05e30d89u, 0x0bbb030fu, 0x0a7f06e3u, 0x0db807ebu, 0x014e0f48u,
+	0x05ce0785u, 0x0b34048cu, 0x0918069au, 0x09e4027fu, 0x083f0c90u, 0x029100e5u, 0x0912060cu, 0x05620389u,
+	0x0a8f0970u, 0x0d6e02c0u, 0x00440940u, 0x06450a28u, 0x0e160292u, 0x0d7c086au, 0x06310fd6u, 0x03d90b51u,
+	0x05bb0c9fu, 0x00600da6u, 0x03cc0fbdu, 0x0a7500c2u, 0x015d0b5bu, 0x0c110546u, 0x05d30246u, 0x03e30ac5u,
+	0x01df0ca8u, 0x03780a3fu, 0x01240cd9u, 0x0a0f0494u, 0x08c40016u, 0x0d4c0189u, 0x00690466u, 0x0a4404f1u,
+	0x0eca0240u, 0x017c0976u, 0x0e450c00u, 0x01be05b4u, 0x0f6704b5u, 0x0a870974u, 0x0e290419u, 0x02190c28u,
+	0x00770e7eu, 0x03cd0c52u, 0x059f0aedu, 0x0e8e07bcu, 0x05490c34u, 0x000f06b1u, 0x049e07b6u, 0x08ed01e4u,
+	0x074c0f35u, 0x06540283u, 0x07f009fau, 0x06e70e24u, 0x03f90f39u, 0x0a410064u, 0x0f140775u, 0x052b0da9u,
+	0x0df302a6u, 0x0f240629u, 0x0e3c0542u, 0x06870b91u, 0x0cd00f89u, 0x09620568u, 0x0bcc02a4u, 0x0cee06bfu,
+	0x003f03e7u, 0x031f0d5du, 0x042e0819u, 0x0ac10d2au, 0x0377079du, 0x053f0d9du, 0x00b80745u, 0x0674085fu,
+	0x045b0d34u, 0x08330606u, 0x02230fb5u, 0x034b0ccbu, 0x01cc0997u, 0x0a3d0b89u, 0x0d3d02ddu, 0x00cd0c04u,
+	0x03520a5cu, 0x0ea20b3au, 0x01320beeu, 0x02ab0597u, 0x062408e7u, 0x0d000eafu, 0x00dd0471u, 0x09e008d8u,
+	0x088c06c1u, 0x098f0056u, 0x07e802d3u, 0x03d80928u, 0x07a10229u, 0x0b0d0379u, 0x08470fd5u, 0x0e5709b1u,
+	0x08ba0b1fu, 0x0a83071fu, 0x00ff0fa5u, 0x0ec606e8u, 0x0642003cu, 0x015f0b75u, 0x0ce70fd0u, 0x032a0b24u,
+	0x0a090f7cu, 0x01350753u, 0x048f0dd5u, 0x00fb06dau, 0x0f8808b1u, 0x0eba0411u, 0x096f05cfu, 0x06c30e23u,
+	0x0cf404f6u, 0x01c008c1u, 0x09430485u, 0x0c570afcu, 0x01d10db2u, 0x094c07f7u, 0x03230694u, 0x01810c54u,
+	0x0b8d0fbeu, 0x073d0427u, 0x01a30c2au, 0x0ab80ed6u, 0x0e080c56u, 0x0ea600ccu, 0x011a05efu, 0x05860331u,
+	0x04af0f71u, 0x061f0c43u, 0x02a50531u, 0x09300b97u, 0x02490df0u, 0x08d00c58u, 0x09e102d4u, 0x07bb04deu,
+	0x0b94017eu, 0x08e80285u, 0x09c50bd7u, 0x0b470ed4u, 0x04f20d91u, 0x0c550735u, 0x03a20145u, 0x024f083eu,
+	0x00370ec8u, 0x056c07c3u, 0x02480dddu, 0x07660f83u, 0x035304dbu, 0x0d7d0bbau, 0x0b490217u, 0x07d70e4bu,
+	0x010404c7u, 0x0d8c0e97u, 0x05fd0a71u, 0x07050094u, 0x08810519u, 0x04490a16u, 0x0d9b0750u, 0x01cf0c76u,
+	0x00ef07f9u, 0x01f70e38u, 0x0a120ce9u, 0x03c20860u, 0x0a430570u, 0x047607f1u, 0x05fa0e55u, 0x09350006u,
+	0x05690df5u, 0x0d110ee5u, 0x02ed0058u, 0x03bf05cau, 0x00bb0810u, 0x08da0282u, 0x0fb00ae5u, 0x0bae055fu,
+	0x03eb09beu, 0x0a790ff5u, 0x06880d1bu, 0x001d041bu, 0x0ac709c7u, 0x0fa100eeu, 0x0a5f0523u, 0x03a50604u,
+	0x0a1a0d23u, 0x023905a5u, 0x0ff3036eu, 0x0d65047cu, 0x019102f5u, 0x0bfc0663u, 0x0914026eu, 0x066e0aa1u,
+	0x09bc0bc2u, 0x08f002f7u, 0x006d0ef8u, 0x0f8704a2u, 0x00df0cb2u, 0x06f30f38u, 0x0bf001e3u, 0x03fa0f1eu,
+	0x06fe0addu, 0x04d90366u, 0x0ac2068eu, 0x01b90791u, 0x0a980cbcu, 0x067b0e5bu, 0x00910d09u, 0x0d96077au,
+	0x017d0648u, 0x07000c3au, 0x0116036cu, 0x0cac08abu, 0x05c60e2bu, 0x040606ebu, 0x0047086eu, 0x070e0ee4u,
+	0x08f902b7u, 0x08140b2cu, 0x08c90cf0u, 0x09ae0bbcu, 0x0b2b0e78u, 0x0d260f9bu, 0x04d8009fu, 0x039a0f22u,
+	0x0d6c0738u, 0x0b0f043bu, 0x07a906adu, 0x01b50bf5u, 0x0304066bu, 0x03a30b1bu, 0x0a2a0d29u, 0x026506a1u,
+	0x00ce0ca0u, 0x085a0a53u, 0x0ff00e2au, 0x09360c1bu, 0x054f0f53u, 0x035509d0u, 0x01f30492u, 0x02f00a30u,
+	0x0b280462u, 0x02af0875u, 0x0e7b09a1u, 0x07cd0b9cu, 0x0eec02cbu, 0x0c3608f4u, 0x0dc90280u, 0x01b2098cu,
+	0x0f620bd9u, 0x04ed0008u, 0x06920185u, 0x07600262u, 0x059e0063u, 0x03d508d7u, 0x09ee07a7u, 0x000d0df2u,
+	0x0ff705d1u, 0x055a014au, 0x035f0dbau, 0x09470e69u, 0x0d720769u, 0x084b099bu, 0x01080527u, 0x0dad08b5u,
+	0x0f6c07dfu, 0x098101e6u, 0x011e03f4u, 0x046a026du, 0x00400650u, 0x07de0d71u, 0x0e8b0b4du, 0x091c0c8bu,
+	0x0e1e0f43u, 0x05e900e4u, 0x0aa80f58u, 0x055e0458u, 0x0a3401e8u, 0x0d22012fu, 0x05960b25u, 0x0ca90803u,
+	0x0659044fu, 0x0e6a0781u, 0x0f1709f4u, 0x0caa03c7u, 0x034e081eu, 0x0aad020au, 0x05740ed5u, 0x08aa02d0u,
+	0x0a80022cu, 0x08440c32u, 0x0a4800abu, 0x0b530268u, 0x003305abu, 0x018c0e2du, 0x0b5c0ec3u, 0x059c0328u,
+	0x0c2c046eu, 0x0ba40620u, 0x05820cefu, 0x083d0d9eu, 0x02f80b73u, 0x0f16018au, 0x087d05b5u, 0x006706b9u,
+	0x0762054eu, 0x04d70cb5u, 0x074f0207u, 0x0d600074u, 0x03c90fddu, 0x078e0652u, 0x03440495u, 0x00b60fb3u,
+	0x0da40a89u, 0x0c2e0392u, 0x0b5600d3u, 0x0a7c0528u, 0x0dce0f6au, 0x06b00bdbu, 0x01110c88u, 0x0cdf0b77u,
+	0x095a04b8u, 0x062a03b4u, 0x0c8e0f64u, 0x03fd051cu, 0x0a700fbcu, 0x06120488u, 0x0c840777u, 0x005c0fd8u,
+	0x0e3d0957u, 0x076402d2u, 0x0a660021u, 0x09b306eeu, 0x0c350eb2u, 0x0950074au, 0x012a0402u, 0x03960bf2u,
+	0x09b6024cu, 0x0dc60ae4u, 0x0c5c08c8u, 0x09660643u, 0x0bec0818u, 0x007d0df9u, 0x09ff0eabu, 0x024106d4u,
+	0x0939053cu, 0x087402c3u, 0x0de305f1u, 0x0131092fu, 0x04980627u, 0x01a20960u, 0x082c043fu, 0x0ea3064fu,
+	0x07b40187u, 0x02c50d37u, 0x0720090bu, 0x0891010fu, 0x01fe0cfcu, 0x08fc0c21u, 0x0410027cu, 0x06ec0a68u,
+	0x01650b27u, 0x08e3050bu, 0x034a0f3du, 0x01e20e36u, 0x04fb03dbu, 0x0cdb0ab3u, 0x0f8f0296u, 0x0d510a4bu,
+	0x08120ea1u, 0x009c03e8u, 0x0f090324u, 0x01570b36u, 0x05060302u, 0x093f0ab5u, 0x0c7401c1u, 0x0e40089fu,
+	0x0efd0ba2u, 0x0d1e019du, 0x022a045au, 0x02ef0733u, 0x00250d50u, 0x0e510754u, 0x09b80fa6u, 0x0aef036au,
+	0x00710f50u, 0x0b900e15u, 0x0eb501cau, 0x0de009eau, 0x036d07c4u, 0x0f2f06d7u, 0x00eb09bbu, 0x08640d79u,
+	0x0ebd0398u, 0x0d470a00u, 0x0b59044bu, 0x00880615u, 0x0fb108d5u, 0x068600cfu, 0x04c10ddfu, 0x058c071au,
+	0x01520b3fu, 0x06db0fd1u, 0x05980a39u, 0x0e960412u, 0x06fd0cf6u, 0x0f280253u, 0x03fc05f8u, 0x00fa0adau,
+	0x073e0613u, 0x0b000a11u, 0x08110fcdu, 0x0c3f0e9cu, 0x08760b0au, 0x02900a2bu, 0x00b2053du, 0x07120db6u,
+	0x04f80a23u, 0x03ee0697u, 0x04a90abdu, 0x02ad05e7u, 0x00830ba0u, 0x0d280ae2u, 0x0e990514u, 0x020405f6u,
+	0x066f0c6eu, 0x012907f2u, 0x0c6a0244u, 0x0af9079bu, 0x05930d54u, 0x0202080cu, 0x0b8f09c4u, 0x03060003u,
+	0x063d0901u, 0x0ba104a3u, 0x025d0d66u, 0x09c6087cu, 0x0b9e0014u, 0x035e0858u, 0x076c0d3fu, 0x02e104dfu,
+	0x03ac0cd6u, 0x050e0035u, 0x00ac068bu, 0x040d09bdu, 0x0f08056bu, 0x0b6b037bu, 0x08f80d13u, 0x02a10c20u,
+	0x0c9e0885u, 0x0f0b0975u, 0x0020081bu, 0x06a20c30u, 0x04730e74u, 0x0176087bu, 0x07e10318u, 0x04a40b63u,
+	0x02b00f5eu, 0x05a70a92u, 0x088f0fd2u, 0x0ed904bfu, 0x0a1f02b6u, 0x03650ca2u, 0x08b20e80u, 0x0f3707a3u,
+	0x02260c42u, 0x09580cf1u, 0x019507bdu, 0x06930decu, 0x0fa80480u, 0x0a2d0565u, 0x0bf80162u, 0x09890fe8u,
+	0x07e40e18u, 0x08ff0f30u, 0x03490bb3u, 0x015c0cebu, 0x01ee06e1u, 0x06100da0u, 0x01c807d4u, 0x05b60432u,
+	0x01250e75u, 0x05a2023au, 0x0d12032cu, 0x01560fe3u, 0x0575096eu, 0x065d0f84u, 0x0c290a2fu, 0x098d0013u,
+	0x00cb0dc0u, 0x0e110bdfu, 0x00ed06deu, 0x03aa0995u, 0x070b016fu, 0x045f0bd1u, 0x014b05dau, 0x04130d80u,
+	0x0e1f0a22u, 0x037f007au, 0x052a0f76u, 0x0c4d0ad0u, 0x00fd0790u, 0x08f70db7u, 0x004f0e5eu, 0x0b480831u,
+	0x044701b6u, 0x02550c24u, 0x05c70e33u, 0x0f960aaau, 0x0be10946u, 0x008504b3u, 0x06c60a90u, 0x0b0c0fdeu,
+	0x0bda0388u, 0x0dab07a0u, 0x08d20b55u, 0x0a650718u, 0x0b1d0397u, 0x02600d98u, 0x06fc0e42u, 0x08ad0381u,
+	0x073f055bu, 0x093d03f7u, 0x0cd7032du, 0x06350baau, 0x0f2d0da2u, 0x008b0933u, 0x0b060fedu, 0x01b10661u,
+	0x08570511u, 0x05f7073bu, 0x00c50c09u, 0x0ef902e8u, 0x023203b8u, 0x06370b3cu, 0x06dc042au, 0x0543028du,
+	0x0a62065cu, 0x06fb0da1u, 0x086b0117u, 0x07b2046bu, 0x0e4102bfu, 0x0f2e083cu, 0x03070c7au, 0x003b0df4u,
+	0x04990704u, 0x09ef0f8cu, 0x053300c0u, 0x0212043au, 0x07920c97u, 0x09290097u, 0x0cbe0434u, 0x01dd0ffcu,
+	0x0b110d1cu, 0x04eb0ef1u, 0x0a6101c7u, 0x002b0e95u, 0x04e90859u, 0x0a760258u, 0x0cd307c5u, 0x096702bcu,
+	0x0a9d0edfu, 0x0b2e029cu, 0x08950e3eu, 0x0a240653u, 0x0d030931u, 0x02fc07f5u, 0x0a9c0c8cu, 0x0d5f0f4cu,
+	0x007c08d6u, 0x04f7030cu, 0x0eed09ceu, 0x004b0d64u, 0x09ec0655u, 0x03df0103u, 0x05130927u, 0x084809c1u,
+	0x0aa40d76u, 0x066401d2u, 0x0eb602bau, 0x08320ddeu, 0x030a0f49u, 0x05aa0bc9u, 0x0ac00100u, 0x07ce060au,
+	0x09f70300u, 0x08230070u, 0x056f0d5cu, 0x041807b7u, 0x0c730adfu, 0x0e1006b5u, 0x039f0552u, 0x06f00be7u,
+	0x01270d21u, 0x03f20f4du, 0x049609adu, 0x01590d74u, 0x0e8a05acu, 0x019904fau, 0x09520eccu, 0x038400d0u,
+	0x07b50b96u, 0x0c980fa3u, 0x03910aebu, 0x0b620218u, 0x057c0cafu, 0x07310ae1u, 0x0d2f0198u, 0x05e20254u,
+	0x0c750141u, 0x040108a0u, 0x0acb0cbfu, 0x006c0941u, 0x04ef0681u, 0x08550d53u, 0x09a00f19u, 0x0bbd0161u,
+	0x067f0ea7u, 0x0f850256u, 0x06ca0b68u, 0x0fc002aau, 0x08f601d9u, 0x00e9033bu, 0x0eb009d2u, 0x080b0051u,
+	0x05cd047fu, 0x00220c51u, 0x020c07e0u, 0x070f0ffdu, 0x003a0abbu, 0x09cc0bedu, 0x05df0756u, 0x0c59049bu,
+	0x05900e4du, 0x01a8094bu, 0x0779060bu, 0x04e40905u, 0x03290dccu, 0x0bf10f78u, 0x067c0e8fu, 0x0ee80b6au,
+	0x09690335u, 0x0f360556u, 0x01370724u, 0x0b9805d8u, 0x019c0a19u, 0x06d50e84u, 0x04aa02b8u, 0x03d00de6u,
+	0x08ca0525u, 0x04380c69u, 0x00b40925u, 0x0dca0a1bu, 0x0b9b0601u, 0x0f6f0d58u, 0x08a3044du, 0x01f80acau,
+	0x02fb0dc3u, 0x06b408f2u, 0x0b7a0d31u, 0x0c600354u, 0x08a70441u, 0x03c80f99u, 0x02370dbcu, 0x014f087eu,
+	0x026a0708u, 0x0e0c041fu, 0x0be900a4u, 0x06d80ffau, 0x0862012bu, 0x048201f0u, 0x005e07f3u, 0x04460a3eu,
+	0x0bbe0782u, 0x0e020007u, 0x0c190800u, 0x0479032fu, 0x08e20cedu, 0x0a7d03b5u, 0x07800b6cu, 0x00310c8au,
+	0x0d830a4eu, 0x05f90113u, 0x03630e44u, 0x04b90cadu, 0x01230807u, 0x0592075au, 0x0c4a0230u, 0x0fc5063au,
+	0x09eb0b5du, 0x04d60e6du, 0x05940a6bu, 0x07ae00e8u, 0x02b50e3au, 0x00f306a4u, 0x0d160b4au, 0x0ac60f07u,
+	0x0f5c09b7u, 0x08060b67u, 0x02de0d0du, 0x03e909f5u, 0x0a7a0eb4u, 0x05d60982u, 0x02cd0cd2u, 0x0fca08beu,
+	0x06a60d9cu, 0x03b0027bu, 0x01e909cau, 0x0e3f0fceu, 0x02780799u, 0x00af0f8au, 0x020f0560u, 0x0faf0903u,
+	0x07e706f2u, 0x0bb402d9u, 0x072d0a8cu, 0x09710172u, 0x03c10e7au, 0x09930b2du, 0x07960d0cu, 0x05040138u,
+	0x07340386u, 0x0f7b0190u, 0x08bc0289u, 0x09c20f06u, 0x0ba301e1u, 0x081f0558u, 0x033a0a2cu, 0x05070673u,
+	0x035d0027u, 0x0a380646u, 0x0e7104b2u, 0x001105a4u, 0x076f0c44u, 0x03a40d55u, 0x0e310b0eu, 0x01100503u,
+	0x0a7205bfu, 0x0b300edau, 0x05200d08u, 0x0aab06e5u, 0x05bc0048u, 0x09770c07u, 0x0e6e0d46u, 0x034f062eu,
+	0x01ac0b17u, 0x04a10ebeu, 0x0f1a0865u, 0x0c0e058eu, 0x0f470263u, 0x069c0019u, 0x0a930308u, 0x09630e34u,
+	0x086f0c8du, 0x0bf90090u, 0x0de503e5u, 0x04a60626u, 0x092b0d7fu, 0x0ed30c87u, 0x01a50456u, 0x0bd507d0u,
+	0x08dc0cc2u, 0x00f60d8bu, 0x0220072cu, 0x0b400888u, 0x028b064eu, 0x0f9e017bu, 0x071c00a7u, 0x0ca509e2u,
+	0x0193084au, 0x08d10491u, 0x01180622u, 0x03d7098au, 0x0db30872u, 0x0455069du, 0x00f50827u, 0x042d0be0u,
+	0x05790e0fu, 0x0ccc099du, 0x004e0227u, 0x067d0da7u, 0x0a4a089eu, 0x0d88051du, 0x04160ef3u, 0x05e1006fu,
+	0x0d86029du, 0x0aec0670u, 0x0cb907ffu, 0x06ed004du, 0x038f0a96u, 0x061a00a5u, 0x096c0dffu, 0x02740fe5u,
+	0x04750e68u, 0x0f0201ceu, 0x09480afau, 0x0f5b0cdcu, 0x0dd80478u, 0x089b053au, 0x0c1e0668u, 0x03d6020du,
+	0x0e4e0b93u, 0x00930797u, 0x0de40f3fu, 0x0c9102c8u, 0x0b260f01u, 0x03370184u, 0x0ab00ee9u, 0x09f20287u,
+	0x008e088du, 0x0fe9068fu, 0x07b303e1u, 0x03170adeu, 0x0bc10454u, 0x01c907cfu, 0x0b6d08deu, 0x0f4a0821u,
+	0x04440a37u, 0x05220ee1u, 0x0a0a0214u, 0x0b72030du, 0x0f900158u, 0x029a077du, 0x00650ae3u, 0x0740056au,
+	0x08560a63u, 0x0c3805deu, 0x052f03abu, 0x033c013eu, 0x095f07a4u, 0x0abf0bcfu, 0x03390e9fu, 0x0f55094eu,
+	0x02a80548u, 0x03690cc9u, 0x08250a45u, 0x057b0b88u, 0x04d30222u, 0x0cfd0a20u, 0x051506e6u, 0x0f44078bu,
+	0x0c230d33u, 0x0b50031eu, 0x0532090du, 0x0f860c67u, 0x0e060099u, 0x0c770607u, 0x04e0028eu, 0x0cf706c7u,
+	0x0ba601a7u, 0x00d8093eu, 0x0fdb0752u, 0x0e6c08d3u, 0x0867054bu, 0x04c40ce0u, 0x08980be8u, 0x03dc0d7eu,
+	0x0b8a00e0u, 0x06d002f2u, 0x07fc0fc8u, 0x0a420db4u, 0x0f150073u, 0x010603f8u, 0x04b607efu, 0x006a0d8au,
+	0x09060ae0u, 0x0c010666u, 0x044301fcu, 0x00bd073cu, 0x07c00945u, 0x001e0fdcu, 0x0c6508d4u, 0x05e60151u,
+	0x04c30201u, 0x0133074bu, 0x09f60d67u, 0x070a01bbu, 0x01640998u, 0x0fba03adu, 0x0e8509f9u, 0x035b011du,
+	0x05990772u, 0x03950e07u, 0x05cc0d01u, 0x0c370452u, 0x0dbf023fu, 0x09da0695u, 0x03190f32u, 0x06400c7bu,
+	0x09990eebu, 0x00420dfdu, 0x025909e8u, 0x06770bacu, 0x02000c83u, 0x09fe05d4u, 0x0c860298u, 0x075e062cu,
+	0x0f7a0407u, 0x05000dafu, 0x0fac0965u, 0x0ea00d44u, 0x0c220679u, 0x041a02e0u, 0x0b090e39u, 0x097c038eu,
+	0x08390debu, 0x0e910a78u, 0x029b05fcu, 0x04c00e48u, 0x08b60d10u, 0x07580ac3u, 0x0bfa00b5u, 0x0b080910u,
+	0x026b0f9fu, 0x0a7e0852u, 0x01670ec7u, 0x07c80afeu, 0x0a6003cfu, 0x01db00c3u, 0x06fa041du, 0x0aa0014du,
+	0x04e1021au, 0x0d3b0767u, 0x0ea405a8u, 0x04cf03e4u, 0x0e6008b7u, 0x06e00d2eu, 0x0b4c0febu, 0x0a210180u,
+	0x010b0250u, 0x00280701u, 0x05e50ac4u, 0x037a0143u, 0x0dd00a7bu, 0x09d605c9u, 0x06580216u, 0x007b0f9cu,
+	0x03ed0b84u, 0x00050f25u, 0x038b08acu, 0x08090babu, 0x0ef205adu, 0x045e02cfu, 0x05510651u, 0x04080dd6u,
+	0x000c09deu, 0x06c40c5au, 0x097902e3u, 0x0036066cu, 0x08f30f6du, 0x0ea505ddu, 0x095e0b33u, 0x0f980808u,
+	0x08ce0ce8u, 0x01ab042cu, 0x090a0abeu, 0x073600a9u, 0x02ea0b35u, 0x05100830u, 0x0dc7001fu, 0x0ed1088au,
+	0x0b860d0au, 0x0e870851u, 0x07e302f3u, 0x08c20cc3u, 0x0089049cu, 0x084e0b7fu, 0x04e80d41u, 0x0cbd07ccu,
+	0x024e06b8u, 0x0c0d0573u, 0x0ab406f6u, 0x00c10f6eu, 0x0b660225u, 0x0e5f0ca3u, 0x0d3e085eu, 0x07dd01d8u,
+	0x04d40630u, 0x01220d69u, 0x04f90bdcu, 0x0cba0e50u, 0x0b9902bdu, 0x07a50d48u, 0x0e120508u, 0x0595000au,
+	0x0e8302d8u, 0x07e90bfeu, 0x0c610334u, 0x0d920f92u, 0x0a8a0163u, 0x0bfb0390u, 0x046f0949u, 0x05bd0348u,
+	0x04ad09afu, 0x09f10380u, 0x01e00c48u, 0x06f80b44u, 0x0f66028cu, 0x0723018eu, 0x00f00e90u, 0x03110a6fu,
+	0x0a100909u, 0x04640d18u, 0x0da50178u, 0x040c064bu, 0x06cf0a13u, 0x09680140u, 0x0a970049u, 0x0f2a02b3u,
+	0x0eae0b70u, 0x042208efu, 0x08130fb8u, 0x09d301d6u, 0x04900729u, 0x0336016bu, 0x02510c5eu, 0x03cb0bc6u,
+	0x0b1306e4u, 0x0f4b007eu, 0x051a068cu, 0x09b001f6u, 0x0f200621u, 0x0e7f00d9u, 0x01d40746u, 0x07b10aeeu,
+	0x064a0168u, 0x0d4e0fd3u, 0x04210566u, 0x0e210f11u, 0x0c5f052du, 0x035a0904u, 0x0c0b0442u, 0x05b90efcu,
+	0x00ba0e1du, 0x07f40fd7u, 0x02ec096du, 0x08f50c47u, 0x05390e04u, 0x07740350u, 0x03c60ff6u, 0x07070c3cu,
+	0x03250183u, 0x075b0a4du, 0x0b5405c3u, 0x0dd4038au, 0x0f0c0584u, 0x08a90acfu, 0x06380fdfu, 0x08690a49u,
+	0x016e0991u, 0x0a1c05f2u, 0x08710d06u, 0x044e0b74u, 0x057707b8u, 0x09ed0cdeu, 0x0f910641u, 0x0e470cb6u,
+	0x0be5091du, 0x00d20288u, 0x093206c8u, 0x09d1004cu, 0x0d7307d5u, 0x0b16062du, 0x02660996u, 0x019e0886u,
+	0x075f04acu, 0x0b3e0368u, 0x05050e67u, 0x003d077eu, 0x0f130cf2u, 0x0bd00aceu, 0x04cd05eau, 0x08bf09c8u,
+	0x0ca60583u, 0x0e05006bu, 0x09220247u, 0x0c1700c7u, 0x0078085du, 0x09c006c0u, 0x046d00f7u, 0x0f2c0dd3u,
+	0x04f00cabu, 0x028f0e28u, 0x00d403d1u, 0x02ce0deau, 0x08fb0c50u, 0x04170267u, 0x02c90b76u, 0x00590550u,
+	0x0eea072bu, 0x07c90a8du, 0x0b040e01u, 0x03a6060fu, 0x0a6a01c2u, 0x0ff100c6u, 0x0d070553u, 0x0bb006f1u,
+	0x0c9c0ab1u, 0x021b063cu, 0x0a8200f8u, 0x02690fa7u, 0x047e081du, 0x08a20197u, 0x02310e1au, 0x00de0d1fu,
+	0x08240e4cu, 0x0af303d4u, 0x06c90d25u, 0x0a690f7fu, 0x02860439u, 0x03ae0e8du, 0x07630d36u, 0x00b001fau,
+	0x07d10341u, 0x09240ba7u, 0x0eb70744u, 0x06a70a95u, 0x013b0fb9u, 0x080d0e14u, 0x08bb00aau, 0x03bb0a56u,
+	0x052101e5u, 0x08a8042bu, 0x0c2d0154u, 0x0f4102a3u, 0x04860bb2u, 0x078d0301u, 0x001c0df7u, 0x0f8203ceu,
+	0x099202b2u, 0x08b90ec9u, 0x05d50d63u, 0x0b8303a7u, 0x09b40633u, 0x0c9302d1u, 0x069e0079u, 0x0f4e0b22u,
+	0x065f045cu, 0x0ede09d7u, 0x04b40107u, 0x06250312u, 0x0cc40da8u, 0x05d70b29u, 0x094d0c08u, 0x0b580554u,
+	0x0d6a0671u, 0x0ff20445u, 0x05ba01aeu, 0x0015097eu, 0x0af6039bu, 0x0d3504e3u, 0x0f4006d2u, 0x0d9a0c3eu,
+	0x0e260b1au, 0x03200c9du, 0x04da0f9au, 0x08430daeu, 0x0e9d06d1u, 0x08b80cb1u, 0x0a460188u, 0x07fd05ecu,
+	0x00750d99u, 0x04090545u, 0x07100bc8u, 0x0e5a0a01u, 0x0d90012eu, 0x0f800726u, 0x07d90a5bu, 0x0934033du,
+	0x0ba801b7u, 0x055d02a0u, 0x0c6f07acu, 0x075709a6u, 0x08e601deu, 0x013a07d6u, 0x0f4f02e6u, 0x0a850849u,
+	0x02430ecfu, 0x0adc0102u, 0x04c50c80u, 0x08530d84u, 0x074e0befu, 0x0ece0a29u, 0x04740208u, 0x084005d0u,
+	0x09780685u, 0x05f00009u, 0x075c0a0bu, 0x00a1094au, 0x09ac0571u, 0x066d0233u, 0x0f1c0b2fu, 0x0489093bu,
+	0x06b7016cu, 0x08220c4bu, 0x0f2101bdu, 0x04e600a0u, 0x0c1d0911u, 0x054c0374u, 0x0e6f0429u, 0x0d9f05b0u,
+	0x0c5d0748u, 0x08840fdau, 0x0e560194u, 0x0f120b79u, 0x04ff0045u, 0x0a310fbbu, 0x0dc5048eu, 0x037c002au,
+	0x09dd0717u, 0x062808c5u, 0x032607f8u, 0x0f26021du, 0x019a0561u, 0x03470611u, 0x09ba0bcau, 0x02ee00e7u,
+	0x07a6018bu, 0x0b5f0f1fu, 0x03ea0215u, 0x01770cf8u, 0x0d5a0ae8u, 0x0c1403bdu, 0x034004fdu, 0x0e370c7eu,
+	0x0a260b5eu, 0x03220f51u, 0x0cd8096au, 0x07be02c4u, 0x0ea90affu, 0x087301dcu, 0x01280b65u, 0x0a02027au,
+	0x004304d5u, 0x0a9a0372u, 0x0415093cu, 0x05a9027du, 0x03ca0ad3u, 0x06ac0c5bu, 0x0b8b021cu, 0x0cca0603u,
+	0x0c1f04ceu, 0x005b0e2fu, 0x0b600d3au, 0x043309fdu, 0x0cc80e5du, 0x00660953u, 0x0ddb0773u, 0x0fff0cd4u,
+	0x0c150394u, 0x0d61048au, 0x0e7606b3u, 0x03330beau, 0x07710fc2u, 0x0ed7004au, 0x020607dcu, 0x07430098u,
+	0x025203b2u, 0x049d0d57u, 0x05ae0aa5u, 0x04350e1cu, 0x001006abu, 0x0d4505ffu, 0x0c7c095bu, 0x08410f9du,
+	0x0d020af5u, 0x0de706d9u, 0x00e2061du, 0x082b0ce6u, 0x09550ddcu, 0x0d5200c4u, 0x0e7d076eu, 0x01710908u,
+	0x02b90fa9u, 0x03f00580u, 0x06b60f59u, 0x00a20778u, 0x02a70897u, 0x0b140fa4u, 0x08e503ecu, 0x0a9f0502u,
+	0x058d086du, 0x08bd0272u, 0x0a4f0086u, 0x06470524u, 0x0470087au, 0x05910a8bu, 0x08960db5u, 0x0fcc09fcu,
+	0x08e4060eu, 0x0038077fu, 0x015e068du, 0x08cb0b9fu, 0x09f30fe6u, 0x0ee002acu, 0x00ad06ceu, 0x063b03beu,
+	0x0ec5015au, 0x05290210u, 0x0f310c05u, 0x0a150714u, 0x0ec10346u, 0x0877057eu, 0x09d80305u, 0x0b19041cu,
+	0x08830789u, 0x0a9b01c4u, 0x01200920u, 0x0c3b0dedu, 0x06690a6cu, 0x080204a8u, 0x023c0ebbu, 0x0e6506c2u,
+	0x09cb0130u, 0x0afb0ecbu, 0x01a907d2u, 0x0ef00919u, 0x0dfb023eu, 0x01210951u, 0x06900b7cu, 0x04d10d05u,
+	0x0b0200fcu, 0x0bf30e09u, 0x07fb0f7eu, 0x022e0d78u, 0x0cc003bau, 0x0a9e050au, 0x0787047bu, 0x0e530bf4u,
+	0x044c0921u, 0x09ab07eau, 0x0aea02f4u, 0x017904b7u, 0x02340682u, 0x0af10be2u, 0x052e0148u, 0x00b70f0fu,
+	0x06890d0fu, 0x0bcb0ebfu, 0x04f302feu, 0x023805c8u, 0x0bbf038du, 0x01740d1du, 0x0b9505b2u, 0x0c810046u,
+	0x0dcb044au, 0x0364061eu, 0x043e0f7du, 0x0b0b0ca4u, 0x06ef00d6u, 0x030e0ce4u, 0x04140f74u, 0x0c1c0270u,
+	0x056d0eaau, 0x095901c5u, 0x05170371u, 0x00d50a3bu, 0x0bdd0719u, 0x01960829u, 0x030b0df6u, 0x05470a14u,
+	0x0b920297u, 0x00b10fadu, 0x08a60db0u, 0x0ff90001u, 0x07ba0d2cu, 0x0f700467u, 0x06600dfau, 0x03610c2bu,
+	0x045d0a51u, 0x0d8709a9u, 0x0cd107c7u, 0x09840fcfu, 0x07370e32u, 0x09e5008du, 0x03570d8du, 0x07680a57u,
+	0x0cf302e2u, 0x0ba900bcu, 0x0d7b0703u, 0x05b302e9u, 0x03b60c03u, 0x06230a18u, 0x0ad601aau, 0x098607c1u,
+	0x08700303u, 0x0c9b0431u, 0x0e7c0299u, 0x060d0b4bu, 0x094f0f0du, 0x0f94008au, 0x08cf0b37u, 0x00290d38u,
+	0x07020c94u, 0x05a60a5eu, 0x078a03f3u, 0x0b710c66u, 0x03a0091bu, 0x00540a3au, 0x08f10727u, 0x081701f9u,
+	0x02710e20u, 0x06020012u, 0x03da0182u, 0x08280ad5u, 0x0ee701b4u, 0x0879053eu, 0x06570f69u, 0x0eff0915u,
+	0x080f0ad7u, 0x0221095du, 0x09b5054du, 0x078c002du, 0x08350e62u, 0x05160f0au, 0x0e5208e1u, 0x0d95000eu,
+	0x0f3306f7u, 0x06490a74u, 0x0114075du, 0x04720892u, 0x0db902f1u, 0x03fe0585u, 0x0224067au, 0x0f6005edu,
+	0x037e085bu, 0x0ce101adu, 0x023b0e9bu, 0x05340636u, 0x0e8c01bau, 0x0c7f0609u, 0x0d6f02d6u, 0x05dc0ab6u,
+	0x05260fe7u, 0x0b380747u, 0x08db0eefu, 0x048d00d1u, 0x0309062fu, 0x04040b46u, 0x0c120275u, 0x01c304d0u,
+	0x06bc0fc9u, 0x0c4904bdu, 0x08780e98u, 0x0a5d0fe2u, 0x01550481u, 0x0c790284u, 0x0bd2073au, 0x05c004a7u,
+	0x0b85016au, 0x0d5e0087u, 0x09e30fc4u, 0x0d170c16u, 0x01fd07aau, 0x0c780a58u, 0x0e9e07eeu, 0x049a0134u,
+	0x0e270ad9u, 0x08ea0665u, 0x09cd0b2au, 0x0d820343u, 0x080e0a84u, 0x09a20115u, 0x0b7804e7u, 0x009503f5u,
+	0x093a0ca1u, 0x0de20c06u, 0x06bb02cau, 0x0bad0c92u, 0x0a2e0d77u, 0x0cb40938u, 0x00db07cbu, 0x059d0dbbu,
+	0x039d0017u, 0x0a810e13u, 0x03de010cu, 0x068001f2u, 0x09370ba5u, 0x008c0d70u, 0x033e0a91u, 0x0a070ffeu,
+	0x03c40cfau, 0x04c60815u, 0x059b01efu, 0x0030039cu, 0x0ed20ad4u, 0x035806f4u, 0x09db0d81u, 0x077b0bb5u,
+	0x02dc097fu, 0x04e500cau, 0x01120f2bu, 0x0f77070du, 0x028a0487u, 0x0fab0dcfu, 0x01a10894u, 0x07840efau,
+	0x013f0a0cu, 0x084f039eu, 0x09e704cau, 0x02570f54u, 0x00340794u, 0x01690fc1u, 0x06f90e86u, 0x0b7e09dcu,
+	0x09020cc7u, 0x07ab02a9u, 0x0b3d05eeu, 0x0dee0cd5u, 0x05890356u, 0x064c0f52u, 0x088003ffu, 0x0698020eu,
+	0x026c0916u, 0x0b310eeeu, 0x0e2c092du, 0x0f6b06bau, 0x04c2097bu, 0x0907018du, 0x051f0052u, 0x03d3025cu,
+	0x0c0c0f10u, 0x07db0d62u, 0x0bd8040eu, 0x00760868u, 0x0b120cbbu, 0x058a0749u, 0x06a9034cu, 0x048b0e4fu,
+	0x067e02b4u, 0x01d70f73u, 0x007f0ab2u, 0x040a059au, 0x06d30e22u, 0x05e404ecu, 0x03320a99u, 0x08540424u,
+	0x0ed0062bu, 0x0d32016du, 0x07110f5au, 0x08c704e2u, 0x0ad800dau, 0x09a7077cu, 0x0e9a0ccfu, 0x0dda00ecu,
+	0x054a0c46u, 0x02ff0755u, 0x012c0c62u, 0x02ae0836u, 0x06320b87u, 0x0c3d0e46u, 0x0fee0aacu, 0x0cdd063eu,
+	0x05590082u, 0x0a1d06ccu, 0x0de8029eu, 0x0973057fu, 0x03b90676u, 0x00230c0au, 0x0a6d0d14u, 0x08fa0bceu,
+	0x0b150dacu, 0x05f50cdau, 0x0d4d0e89u, 0x091e07e6u, 0x03730acdu, 0x02450c33u, 0x0d2408ccu, 0x01ec0f5du,
+	0x0b050c18u, 0x099c047du, 0x0055031du, 0x025b0a04u, 0x0e540c53u, 0x02c101bfu, 0x0b0304f4u, 0x045307cau,
+	0x0e630a6eu, 0x06180041u, 0x04360aa3u, 0x05350db1u, 0x00dc0ccdu, 0x085c040fu, 0x072f02e4u, 0x08160e00u,
+	0x0b20090eu, 0x0fc701f1u, 0x01530c70u, 0x0edd0ab9u, 0x08cd01f5u, 0x09d90f23u, 0x024a0804u, 0x054100e1u,
+	0x003907edu, 0x072e0428u, 0x032e096bu, 0x0be3010eu, 0x0ef501d0u, 0x0dcd0837u, 0x00680b4fu, 0x0739052cu,
+	0x008f0a36u, 0x088e0587u, 0x0e3b0be4u, 0x0f2907fau, 0x046106c5u, 0x0fb20861u, 0x0c0f002fu, 0x032705f4u,
+	0x08460147u, 0x0d2709a3u, 0x07150f1du, 0x021f09d4u, 0x077008ddu, 0x05a00f3eu, 0x011c0b7du, 0x0a540459u,
+	0x0ead017fu, 0x089903b1u, 0x07610619u, 0x031a0450u, 0x05370d4au, 0x046c0144u, 0x06050dfcu, 0x036f0fbfu,
+	0x0ecd0c64u, 0x027e0a50u, 0x050c0c41u, 0x06160fb4u, 0x09bf0cfbu, 0x043d00f2u, 0x099e065eu, 0x02c60e58u,
+	0x0dc803ddu, 0x06840fc3u, 0x040501cbu, 0x05e00d5bu, 0x0b9d0376u, 0x05780a52u, 0x090c0d2bu, 0x06e20f04u,
+	0x0f720bc3u, 0x01d504eau, 0x00be0375u, 0x0fd40bdeu, 0x036b0ae7u, 0x01ea0d39u, 0x0ef40994u, 0x03420c8fu,
+	0x0dc205d9u, 0x09a404cbu, 0x0b6f0018u, 0x082a0e6bu, 0x0baf0a55u, 0x02e506bdu, 0x0b010c85u, 0x09a50732u,
+	0x05be01e7u, 0x014c08c6u, 0x0af40e0bu, 0x0465088bu, 0x02eb0741u, 0x0faa0564u, 0x013907a8u, 0x082e0c6du,
+	0x022b092cu, 0x0cae079cu, 0x05300a4cu, 0x01700b18u, 0x009e0964u, 0x074d0dc1u, 0x01a403a1u, 0x025e09c9u,
+	0x03e20cf5u, 0x08eb0b43u, 0x07f60e25u, 0x06620493u, 0x0e0e0004u, 0x06a00a27u, 0x089c04ddu, 0x06df005du,
+	0x079a0bd4u, 0x02f60d0eu, 0x0cb80f65u, 0x05e801c6u, 0x0fec00c8u, 0x0ea8079eu, 0x03f1091au, 0x0e730126u,
+	0x049f0b5au, 0x07bf0f93u, 0x068a03c5u, 0x0eb90211u, 0x0a88000bu, 0x0d4b0bc7u, 0x0ac90382u, 0x04d20f3au,
+	0x0b320d2du, 0x00ea0362u, 0x02bb0f03u, 0x079308e0u, 0x0c820f63u, 0x065b0235u, 0x081a0ec0u, 0x0abc04bcu,
+	0x079f005fu, 0x02930675u, 0x0a6705b7u, 0x02df0c9au, 0x0845056eu, 0x0c4c015bu, 0x0d9402b1u, 0x0fb60af7u,
+	0x025a092eu, 0x0af00109u, 0x04fe06b2u, 0x0dd708fdu, 0x098803a8u, 0x0aae022fu, 0x051e0081u, 0x08660d4fu,
+	0x02fd064du, 0x0bb70d1au, 0x0a0500a6u, 0x0b570d56u, 0x0dfe0913u, 0x08a506a3u, 0x05c20276u, 0x06cb01b0u
+};
+
+#endif
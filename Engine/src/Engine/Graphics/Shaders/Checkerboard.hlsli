@@ -0,0 +1,76 @@
+#ifndef CHECKERBOARD_HLSLI
+#define CHECKERBOARD_HLSLI
+
+//Which pixels are traced on which frame when only part of the image is traced each frame. The shaders include this file, and
+//the CPU renderers compile the same code as C++ through MeshManagement::Checkerboard, so both trace the same pixels.
+//main runs one thread per traced pixel over a compact grid, CheckerboardColumns by CheckerboardRows, and CheckerboardPixelX/Y
+//give the pixel of each thread. The pixel may be one past the right or bottom edge when the image size is odd.
+
+#ifdef __cplusplus
+typedef unsigned int uint;
+#elif !defined(CHECKERBOARD)
+#define CHECKERBOARD 1 //Pattern the shaders run with, set by Graphics::CreatePipelineStateObjects
+#endif
+
+static const uint checkerboardFull = 1; //Every pixel every frame
+static const uint checkerboardHalf = 2; //A checkerboard, the other colour on the next frame
+static const uint checkerboardQuarter = 4; //One pixel of every 2x2 block, a different one each frame
+
+//Position in the 2x2 block, x + 2 * y, traced on each frame of checkerboardQuarter. Diagonal steps first so every pair of frames
+//covers both rows and both columns.
+static const uint checkerboardQuarterOrder[4] = { 0, 3, 1, 2 };
+
+inline bool CheckerboardTraced(uint pattern, uint x, uint y, uint frame)
+{
+	if (pattern == checkerboardHalf)
+	{
+		return ((x + y + frame) & 1) == 0;
+	}
+	if (pattern == checkerboardQuarter)
+	{
+		return (x & 1) + 2 * (y & 1) == checkerboardQuarterOrder[frame & 3];
+	}
+	return true;
+}
+
+//Frame index a pixel's samples should use. Each pixel is traced on every pattern-th frame, and skipping through a sample sequence
+//in steps of 2 or 4 would fix the low bits of the Sobol index and leave the samples in one part of the domain, so traced pixels
+//walk their sequence one index per trace instead.
+inline uint CheckerboardSampleFrame(uint pattern, uint frame)
+{
+	return frame / pattern;
+}
+
+inline uint CheckerboardColumns(uint pattern, uint width)
+{
+	return pattern == checkerboardFull ? width : (width + 1) / 2;
+}
+
+inline uint CheckerboardRows(uint pattern, uint height)
+{
+	return pattern == checkerboardQuarter ? (height + 1) / 2 : height;
+}
+
+inline uint CheckerboardPixelX(uint pattern, uint column, uint row, uint frame)
+{
+	if (pattern == checkerboardHalf)
+	{
+		return column * 2 + ((row + frame) & 1);
+	}
+	if (pattern == checkerboardQuarter)
+	{
+		return column * 2 + (checkerboardQuarterOrder[frame & 3] & 1);
+	}
+	return column;
+}
+
+inline uint CheckerboardPixelY(uint pattern, uint row, uint frame)
+{
+	if (pattern == checkerboardQuarter)
+	{
+		return row * 2 + (checkerboardQuarterOrder[frame & 3] >> 1);
+	}
+	return row;
+}
+
+#endif
@@ -0,0 +1,69 @@
+#pragma warning( disable : 4000 )
+
+//Fills in the pixels main didn't trace this frame, the GPU version of CheckerboardResolver in EngineMeshManager. Each one takes
+//the motion and geometry of the traced pixel around it nearest the camera, so edges stay with the foreground, and the mean
+//colour of the traced pixels around it on that surface. Shaders/Temporal.hlsl then replaces that colour with the reprojected
+//history wherever there is one, so the spatial fill only shows where something was just disoccluded.
+//Only untraced pixels are written and only traced ones read, so no thread sees another's output.
+
+#include "Checkerboard.hlsli"
+
+RWTexture2D<float4> result : register(u0); //Raw colour
+RWTexture2D<float4> GeomertyHistoryBuffer : register(u5); //Primary hit normal, mesh id
+RWTexture2D<float4> motionBuffer : register(u8); //Offset to the previous frame's position in pixels, primary hit distance
+
+cbuffer constants : register(b0, space0)
+{
+	float time;
+	unsigned int frame;
+	unsigned int width;
+	unsigned int height;
+}
+
+[numthreads(32, 32, 1)]
+void main(uint2 id : SV_DispatchThreadID)
+{
+	if (id.x >= width || id.y >= height || CheckerboardTraced(CHECKERBOARD, id.x, id.y, frame))
+	{
+		return;
+	}
+
+	//Every pattern traces at least one pixel of each 3x3 block inside the image, but one pixel wide or tall images can have none
+	//traced around a pixel, which then keeps what the previous frame left in it
+	int2 nearest = (int2)id;
+	float nearestDistance = 1.#INF;
+	for (int neighbourY = max((int)id.y - 1, 0); neighbourY <= min((int)id.y + 1, (int)height - 1); neighbourY++)
+	{
+		for (int neighbourX = max((int)id.x - 1, 0); neighbourX <= min((int)id.x + 1, (int)width - 1); neighbourX++)
+		{
+			if (CheckerboardTraced(CHECKERBOARD, neighbourX, neighbourY, frame) && (all(nearest == (int2)id) || motionBuffer[int2(neighbourX, neighbourY)].z < nearestDistance))
+			{
+				nearest = int2(neighbourX, neighbourY);
+				nearestDistance = motionBuffer[nearest].z;
+			}
+		}
+	}
+	if (all(nearest == (int2)id))
+	{
+		return;
+	}
+	float4 geometry = GeomertyHistoryBuffer[nearest];
+
+	float3 sum = 0;
+	float count = 0;
+	for (int sameY = max((int)id.y - 1, 0); sameY <= min((int)id.y + 1, (int)height - 1); sameY++)
+	{
+		for (int sameX = max((int)id.x - 1, 0); sameX <= min((int)id.x + 1, (int)width - 1); sameX++)
+		{
+			if (CheckerboardTraced(CHECKERBOARD, sameX, sameY, frame) && (uint)GeomertyHistoryBuffer[int2(sameX, sameY)].w == (uint)geometry.w)
+			{
+				sum += result[int2(sameX, sameY)].xyz;
+				count++;
+			}
+		}
+	}
+
+	motionBuffer[id] = motionBuffer[nearest];
+	GeomertyHistoryBuffer[id] = geometry;
+	result[id] = float4(sum / count, 1);
+}
@@ -0,0 +1,150 @@
+#pragma warning( disable : 4000 )
+
+//Edge avoiding à-trous filter over the frame main rendered, the GPU version of Denoiser in EngineMeshManager. Graphics dispatches
+//this once per iteration. The first iteration reads reprojectionBuffer, the others read the previous iteration's output, and
+//outputs alternate between tempResult and result so the last one lands in result. tempResult is free to use here because the
+//history is copied back into it at the end of the frame. reprojectionBuffer itself is never filtered, so the noise the filter
+//removes doesn't get accumulated as detail.
+
+#ifndef DENOISE_ITERATIONS
+#define DENOISE_ITERATIONS 5
+#endif
+
+RWTexture2D<float4> result : register(u0);
+RWTexture2D<float4> tempResult : register(u3);
+RWTexture2D<float4> reprojectionBuffer : register(u4); //Accumulated colour from Shaders/Temporal.hlsl, history length
+RWTexture2D<float4> GeomertyHistoryBuffer : register(u5); //Primary hit normal, mesh id
+RWTexture2D<float4> motionBuffer : register(u8); //Offset to the previous frame's position in pixels, primary hit distance
+
+cbuffer constants : register(b0, space0)
+{
+	float time;
+	unsigned int frame;
+	unsigned int width;
+	unsigned int height;
+
+	float originX;
+	float originY;
+	float originZ;
+
+	float previousOriginX;
+	float previousOriginY;
+	float previousOriginZ;
+
+	unsigned int denoiseIteration;
+	float padding;
+
+	float4 mat0;
+	float4 mat1;
+	float4 mat2;
+}
+
+static const float kernelWeights[5] = { 1.0 / 16.0, 1.0 / 4.0, 3.0 / 8.0, 1.0 / 4.0, 1.0 / 16.0 }; //B3 spline
+static const float colorSigma = 2.0; //Colour distance where a tap's weight falls to 1/e, halved every iteration
+static const float depthSigma = 0.02; //Distance difference per pixel of tap offset, relative to the centre's distance
+
+//Same as RenderCompute.hlsl
+float filteredChecker(float2 p)
+{
+	float2 s = sign(frac(p*.5) - .5);
+	return .5 - .5*s.x*s.y;
+}
+
+//Colour of the surface main hit through the centre of pixel id, rebuilt from its distance and mesh id
+float3 Albedo(uint2 id, float distance, uint meshID)
+{
+	if (meshID == 1)
+	{
+		return float3(0.2, 0.8, 1);
+	}
+	if (meshID == 2)
+	{
+		float2 uv = (-int2(width, height) + 2.0 * (id + 0.5)) / (float)height;
+		float3 direction = normalize(mul(float3(uv.x, -uv.y, -1.5), float3x3(mat0.x, mat0.y, mat0.z, mat0.w, mat1.x, mat1.y, mat1.z, mat1.w, mat2.x)));
+		float3 position = float3(originX, originY, originZ) + direction * distance;
+		return saturate(filteredChecker(position.xz * 2) + 0.5);
+	}
+	return 1;
+}
+
+bool WritesResult(uint iteration)
+{
+	return (DENOISE_ITERATIONS - 1 - iteration) % 2 == 0;
+}
+
+//Colour at id divided by its albedo, so textures aren't blurred along with the noise
+float3 Input(uint2 id, float distance, uint meshID)
+{
+	if (denoiseIteration == 0)
+	{
+		return reprojectionBuffer[id].xyz / Albedo(id, distance, meshID);
+	}
+	return WritesResult(denoiseIteration - 1) ? result[id].xyz : tempResult[id].xyz;
+}
+
+[numthreads(32, 32, 1)]
+void main(uint2 id : SV_DispatchThreadID)
+{
+	if (id.x >= width || id.y >= height)
+	{
+		return;
+	}
+
+	float4 centerGeometry = GeomertyHistoryBuffer[id];
+	float centerDistance = motionBuffer[id].z;
+	uint centerID = (uint)centerGeometry.w;
+	float3 center = Input(id, centerDistance, centerID);
+
+	//The sky has no normal to compare and nothing to filter
+	float3 filtered = center;
+	if (centerID != 0)
+	{
+		int step = 1 << denoiseIteration;
+		float colorScale = (float)(step * step) / (colorSigma * colorSigma);
+
+		float3 sum = 0;
+		float weightSum = 0;
+		for (int tapY = 0; tapY < 5; tapY++)
+		{
+			for (int tapX = 0; tapX < 5; tapX++)
+			{
+				int2 offset = int2(tapX - 2, tapY - 2) * step;
+				int2 tap = (int2)id + offset;
+				if (any(tap < 0) || tap.x >= (int)width || tap.y >= (int)height)
+				{
+					continue;
+				}
+				float4 tapGeometry = GeomertyHistoryBuffer[tap];
+				if ((uint)tapGeometry.w != centerID)
+				{
+					continue;
+				}
+
+				float tapDistance = motionBuffer[tap].z;
+				float3 color = Input(tap, tapDistance, centerID);
+				float3 difference = color - center;
+				float colorTerm = dot(difference, difference) * colorScale;
+				float pixels = length((float2)offset);
+				float depthTerm = pixels == 0 ? 0 : abs(tapDistance - centerDistance) / (centerDistance * depthSigma * pixels);
+				float weight = exp(-(colorTerm + depthTerm)) * pow(saturate(dot(tapGeometry.xyz, centerGeometry.xyz)), 128) * kernelWeights[tapX] * kernelWeights[tapY];
+
+				sum += color * weight;
+				weightSum += weight;
+			}
+		}
+		filtered = sum / weightSum;
+	}
+
+	if (denoiseIteration == DENOISE_ITERATIONS - 1)
+	{
+		filtered *= Albedo(id, centerDistance, centerID);
+	}
+	if (WritesResult(denoiseIteration))
+	{
+		result[id] = float4(filtered, 1);
+	}
+	else
+	{
+		tempResult[id] = float4(filtered, 1);
+	}
+}
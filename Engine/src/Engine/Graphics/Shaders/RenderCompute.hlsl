@@ -1,16 +1,34 @@
 #pragma warning( disable : 4000 )
 
+#include "Sampler.hlsli"
+#include "Checkerboard.hlsli"
+
+#ifndef SAMPLER
+#define SAMPLER samplerSobol
+#endif
+
 struct Triangle
 {
 	uint indices1;
 	uint indices2;
 };
-struct Vertex
+struct VertexPosition
 {
 	float position[3];
+};
+#ifdef COMPRESSED_ATTRIBUTES
+struct VertexAttribute
+{
+	uint normal; //Octahedral encoded, 16 bit snorm per axis
+	uint UV; //Two halfs
+};
+#else
+struct VertexAttribute
+{
 	float normal[3];
 	float UV[2];
 };
+#endif
 
 struct BVHNode
 {
@@ -38,11 +56,10 @@ struct RayHit
 
 RWTexture2D<float4> result : register(u0);
 RWStructuredBuffer<BVHNode> nodeHierarchy : register(u1);
-RWStructuredBuffer<Vertex> vertexBuffer : register(u2);
-RWTexture2D<float4> tempResult : register(u3);
-RWTexture2D<float4> reprojectionBuffer : register(u4);
+RWStructuredBuffer<VertexPosition> positionBuffer : register(u2);
 RWTexture2D<float4> GeomertyHistoryBuffer : register(u5);
-RWTexture2D<float4> TemporaryGeomertyHistoryBuffer : register(u6);
+RWStructuredBuffer<VertexAttribute> attributeBuffer : register(u7);
+RWTexture2D<float4> motionBuffer : register(u8); //Offset to the previous frame's position in pixels, primary hit distance
 
 struct UIElement
 {
@@ -80,7 +97,10 @@ cbuffer constants : register(b0, space0)
 
 	float4 mat0;
 	float4 mat1;
-	float4 mat2;
+	float mat2;
+	unsigned int previousWidth; //Size of the frame before, which dynamic resolution may have rendered smaller or larger
+	unsigned int previousHeight;
+	float padding3;
 
 	float4 previousMat0;
 	float4 previousMat1;
@@ -118,6 +138,30 @@ float4 triIntersect(float3 origin, float3 rayDirection, float3 v0, float3 v1, fl
 	return float4(t, u, v, 1 - u - v);
 }
 
+float3 AttributeNormal(VertexAttribute attribute)
+{
+#ifdef COMPRESSED_ATTRIBUTES
+	float2 p = max(float2((float)(int)(attribute.normal << 16) / 2147418112.0, (float)(int)(attribute.normal & 0xffff0000) / 2147418112.0), -1);
+	float3 n = float3(p, 1 - abs(p.x) - abs(p.y));
+	if (n.z < 0)
+	{
+		n.xy = (1 - abs(n.yx)) * (n.xy >= 0 ? 1.0 : -1.0);
+	}
+	return normalize(n);
+#else
+	return (float3)attribute.normal;
+#endif
+}
+
+float2 AttributeUV(VertexAttribute attribute)
+{
+#ifdef COMPRESSED_ATTRIBUTES
+	return f16tof32(uint2(attribute.UV, attribute.UV >> 16));
+#else
+	return (float2)attribute.UV;
+#endif
+}
+
 float4 SampleUI(float2 position)
 {
 	uint count = 0;
@@ -169,11 +213,9 @@ float hash(uint state)
 	return (float)state * 0.0000000002328306437;
 }
 
-bool ShadowSampleScene(float3 position, uint2 id)
+//Returns true if nothing blocks the ray from position along direction
+bool ShadowSampleScene(float3 position, float3 direction)
 {
-	float random = hash(id.x * width + id.y + (frac(time + 1) * 65536));
-	float3 direction = float3(0.57735 + random * 0.05, 0.57735 + hash(random * 65536 + 1) * 0.05, 0.57735 + hash(random * 65536) * 0.05);
-
 	unsigned int currentIndex = ROOT_NODE_INDEX;
 
 	float3 fractionalRayDirection = 1 / direction;
@@ -188,7 +230,7 @@ bool ShadowSampleScene(float3 position, uint2 id)
 				uint index2 = ((triangleBuffer[node.triangleIndex].indices1 & 0xfff00000) >> 20) | ((triangleBuffer[node.triangleIndex].indices2 & 0x00000ff) << 12);
 				uint index3 = ((triangleBuffer[node.triangleIndex].indices2 & 0x0fffff00) >> 8);
 
-				if (triIntersect(position, direction, (float3)vertexBuffer[index1].position, (float3)vertexBuffer[index2].position, (float3)vertexBuffer[index3].position).x != 1.#INF)
+				if (triIntersect(position, direction, (float3)positionBuffer[index1].position, (float3)positionBuffer[index2].position, (float3)positionBuffer[index3].position).x != 1.#INF)
 				{
 					return false;
 				}
@@ -221,6 +263,9 @@ RayHit SampleScene(float3 rayOrigin, float3 rayDirection)
 
 	unsigned int currentIndex = ROOT_NODE_INDEX;
 
+	//The traversal only keeps the closest triangle's vertices and barycentrics, its attributes are read once it is known
+	uint3 hitIndices = uint3(0, 0, 0);
+	float3 hitBarycentrics = float3(0, 0, 0);
 	float3 fractionalRayDirection = 1 / rayDirection;
 	while (currentIndex != 4294967294u)
 	{
@@ -233,18 +278,12 @@ RayHit SampleScene(float3 rayOrigin, float3 rayDirection)
 				uint index2 = ((triangleBuffer[node.triangleIndex].indices1 & 0xfff00000) >> 20) | ((triangleBuffer[node.triangleIndex].indices2 & 0x00000ff) << 12);
 				uint index3 = ((triangleBuffer[node.triangleIndex].indices2 & 0x0fffff00) >> 8);
 
-				float4 intersect = triIntersect(rayOrigin, rayDirection, (float3)vertexBuffer[index1].position, (float3)vertexBuffer[index2].position, (float3)vertexBuffer[index3].position);
+				float4 intersect = triIntersect(rayOrigin, rayDirection, (float3)positionBuffer[index1].position, (float3)positionBuffer[index2].position, (float3)positionBuffer[index3].position);
 				if (intersect.x < hit.distance)
 				{
 					hit.distance = intersect.x;
-					hit.position = (hit.distance * rayDirection + rayOrigin);
-					hit.normal = normalize(((float3)vertexBuffer[index2].normal * intersect.y) + ((float3)vertexBuffer[index3].normal * intersect.z) + ((float3)vertexBuffer[index1].normal * intersect.w));
-
-					float2 uv = (float2)vertexBuffer[index2].UV * intersect.y + (float2)vertexBuffer[index3].UV * intersect.z + (float2)vertexBuffer[index1].UV * intersect.w;
-
-					hit.color = float3(0.2, 0.8, 1);
-
-					hit.meshID = 1;
+					hitIndices = uint3(index1, index2, index3);
+					hitBarycentrics = intersect.yzw;
 				}
 			}
 			currentIndex = node.hitLink;
@@ -255,6 +294,21 @@ RayHit SampleScene(float3 rayOrigin, float3 rayDirection)
 		}
 	}
 
+	if (hit.distance != 1.#INF)
+	{
+		VertexAttribute attribute1 = attributeBuffer[hitIndices.x];
+		VertexAttribute attribute2 = attributeBuffer[hitIndices.y];
+		VertexAttribute attribute3 = attributeBuffer[hitIndices.z];
+		hit.position = (hit.distance * rayDirection + rayOrigin);
+		hit.normal = normalize((AttributeNormal(attribute2) * hitBarycentrics.x) + (AttributeNormal(attribute3) * hitBarycentrics.y) + (AttributeNormal(attribute1) * hitBarycentrics.z));
+
+		float2 uv = AttributeUV(attribute2) * hitBarycentrics.x + AttributeUV(attribute3) * hitBarycentrics.y + AttributeUV(attribute1) * hitBarycentrics.z;
+
+		hit.color = float3(0.2, 0.8, 1);
+
+		hit.meshID = 1;
+	}
+
 	float t = -rayOrigin.y / rayDirection.y;
 	if (t > 0 && t < hit.distance && length(rayOrigin + rayDirection * t) < 6)
 	{
@@ -268,47 +322,143 @@ RayHit SampleScene(float3 rayOrigin, float3 rayDirection)
 	return hit;
 }
 
-float4 sampleTempBuffer(float2 pos, float3 normal, float4 color, float distance, uint id)
+float3 CameraRayDirection(uint2 id, float2 offset)
 {
-	float2 fpos = pos - floor(pos);
-	float4 col = 0;
+	float2 uv = (-int2(width, height) + 2.0 * (id + offset)) / (float)height;
+	return normalize(mul(float3(uv.x, -uv.y, -1.5), float3x3(mat0.x, mat0.y, mat0.z, mat0.w, mat1.x, mat1.y, mat1.z, mat1.w, mat2)));
+}
 
-	const float alpha = 0.01;
+#ifdef PATH_TRACING
+//MAX_DEPTH and PATH_SEGMENTS come from Graphics::CreatePipelineStateObjects. The CPU version is PathTracer in EngineMeshManager.
+static const float3 sunDirection = float3(0.57735, 0.57735, 0.57735);
+static const float3 skyRadiance = float3(0.5, 0.5, 0.5);
+static const uint rouletteDepth = 2;
+static const uint rouletteDimensions = 64; //Roulette draws start here, so each bounce direction keeps a whole dimension pair
 
-	uint2 currentPos = uint2(pos.x, pos.y);
-	col += ((uint)TemporaryGeomertyHistoryBuffer[currentPos].w != id || distance > 1000 || currentPos.x <= 0 || currentPos.y <= 0 || frame < 10 || any(abs(TemporaryGeomertyHistoryBuffer[currentPos].xyz - normal) > 0.05)) ? color * (1 - fpos.x) * (1 - fpos.y) : (color * alpha + tempResult[currentPos] * (1 - alpha)) * (1 - fpos.x) * (1 - fpos.y);
+//Cosine weighted direction around normal, using the tangent frame of Duff et al. 2017
+float3 CosineSampleHemisphere(float3 normal, float u1, float u2)
+{
+	float s = normal.z >= 0 ? 1.0 : -1.0;
+	float a = -1.0 / (s + normal.z);
+	float b = normal.x * normal.y * a;
+	float3 tangent = float3(1 + s * normal.x * normal.x * a, s * b, -s * normal.x);
+	float3 bitangent = float3(b, s + normal.y * normal.y * a, -normal.y);
+
+	float radius = sqrt(u1);
+	float phi = 6.28318531 * u2;
+	return tangent * (radius * cos(phi)) + bitangent * (radius * sin(phi)) + normal * sqrt(max(1 - u1, 0));
+}
 
-	currentPos = uint2(pos.x, pos.y + 1);
-	col += ((uint)TemporaryGeomertyHistoryBuffer[currentPos].w != id || distance > 1000 || currentPos.x <= 0 || currentPos.y <= 0 || frame < 10 || any(abs(TemporaryGeomertyHistoryBuffer[currentPos].xyz - normal) > 0.05)) ? color * (1 - fpos.x) * fpos.y : (color * alpha + tempResult[currentPos] * (1 - alpha)) * (1 - fpos.x) * fpos.y;
+//Averages diffuse paths through the pixel until PATH_SEGMENTS rays have been traced. A path that ends is replaced by a new camera
+//path straight away, so a thread whose paths end early keeps working instead of waiting on the longest path in its group. The
+//last path always runs to its end. The first path continues from the primary hit main already found.
+float3 TracePaths(uint2 id, float3 cameraOrigin, RayHit primaryHit, float3 primaryDirection)
+{
+	uint sampleIndex = CheckerboardSampleFrame(CHECKERBOARD, frame) * PATH_SEGMENTS;
+
+	float3 sum = 0;
+	uint completedPaths = 0;
+
+	float3 rayDirection = primaryDirection;
+	RayHit hit = primaryHit;
+	float3 throughput = 1;
+	float3 radiance = 0;
+	uint depth = 0;
+	[loop]
+	for (uint segment = 1; ; segment++)
+	{
+		bool pathEnded = true;
+		if (hit.distance == 1.#INF)
+		{
+			radiance += throughput * skyRadiance;
+		}
+		else
+		{
+			hit.normal = dot(hit.normal, rayDirection) > 0 ? -hit.normal : hit.normal;
+			float3 origin = hit.position + hit.normal * 0.01;
 
-	currentPos = uint2(pos.x + 1, pos.y);
-	col += ((uint)TemporaryGeomertyHistoryBuffer[currentPos].w != id || distance > 1000 || currentPos.x <= 0 || currentPos.y <= 0 || frame < 10 || any(abs(TemporaryGeomertyHistoryBuffer[currentPos].xyz - normal) > 0.05)) ? color * fpos.x * (1 - fpos.y) : (color * alpha + tempResult[currentPos] * (1 - alpha)) * fpos.x * (1 - fpos.y);
+			//The sun's irradiance is pi, so a lit surface reflects albedo * cos
+			float cosine = dot(hit.normal, sunDirection);
+			if (cosine > 0 && ShadowSampleScene(origin, sunDirection))
+			{
+				radiance += throughput * hit.color * cosine;
+			}
 
-	currentPos = uint2(pos.x + 1, pos.y + 1);
-	col += ((uint)TemporaryGeomertyHistoryBuffer[currentPos].w != id || distance > 1000 || currentPos.x <= 0 || currentPos.y <= 0 || frame < 10 || any(abs(TemporaryGeomertyHistoryBuffer[currentPos].xyz - normal) > 0.05)) ? color * fpos.x * fpos.y : (color * alpha + tempResult[currentPos] * (1 - alpha)) * fpos.x * fpos.y;
+			depth++;
+			if (depth < MAX_DEPTH)
+			{
+				throughput *= hit.color;
+				float survival = min(max(throughput.x, max(throughput.y, throughput.z)), 0.95);
+				if (depth < rouletteDepth || SampleSequence(SAMPLER, id.x, id.y, sampleIndex, rouletteDimensions + depth) < survival)
+				{
+					throughput /= depth < rouletteDepth ? 1.0 : survival;
+					rayDirection = normalize(CosineSampleHemisphere(hit.normal, SampleSequence(SAMPLER, id.x, id.y, sampleIndex, 2 * depth), SampleSequence(SAMPLER, id.x, id.y, sampleIndex, 2 * depth + 1)));
+					hit = SampleScene(origin, rayDirection);
+					pathEnded = false;
+				}
+			}
+		}
 
-	return col;
+		if (pathEnded)
+		{
+			sum += radiance;
+			completedPaths++;
+			if (segment >= PATH_SEGMENTS)
+			{
+				break;
+			}
+
+			//Regenerate the path from the camera through a new point in the pixel
+			sampleIndex++;
+			rayDirection = CameraRayDirection(id, float2(SampleSequence(SAMPLER, id.x, id.y, sampleIndex, 0), SampleSequence(SAMPLER, id.x, id.y, sampleIndex, 1)));
+			hit = SampleScene(cameraOrigin, rayDirection);
+			throughput = 1;
+			radiance = 0;
+			depth = 0;
+		}
+	}
+	return sum / completedPaths;
 }
+#endif
 
+//One thread per pixel traced this frame, Shaders/CheckerboardResolve.hlsl fills in the others
 [numthreads(32, 32, 1)]
-void main(uint2 id : SV_DispatchThreadID)
+void main(uint2 thread : SV_DispatchThreadID)
 {
-	float2 offset = float2(hash(frac(time) * 100), hash(frac(time) * 100 + 1));
-	offset = float2(0.5, 0.5);
+	uint2 id = uint2(CheckerboardPixelX(CHECKERBOARD, thread.x, thread.y, frame), CheckerboardPixelY(CHECKERBOARD, thread.y, frame));
+	if (id.x >= width || id.y >= height)
+	{
+		return;
+	}
 
-	float2 uv = (-int2(width, height) + 2.0 * (id + offset)) / (float)height;
+#ifdef PATH_TRACING
+	//TracePaths continues the first path of the pixel from this ray, so it takes that path's sub pixel position from sampler
+	//dimensions 0 and 1 like every later path and like PathTracer::Regenerate
+	uint firstSample = CheckerboardSampleFrame(CHECKERBOARD, frame) * PATH_SEGMENTS;
+	float2 offset = float2(SampleSequence(SAMPLER, id.x, id.y, firstSample, 0), SampleSequence(SAMPLER, id.x, id.y, firstSample, 1));
+#else
+	float2 offset = float2(0.5, 0.5);
+#endif
 
 	float3 rayOrigin = float3(originX, originY, originZ);
 
-	float3 rayDirection = normalize(mul(float3(uv.x, -uv.y, -1.5), float3x3(mat0.x, mat0.y, mat0.z, mat0.w, mat1.x, mat1.y, mat1.z, mat1.w, mat2.x)));
+	float3 rayDirection = CameraRayDirection(id, offset);
 
 	float4 color = float4(0, 0, 0, 0);
 	RayHit hit = SampleScene(rayOrigin, rayDirection);
+#ifdef PATH_TRACING
+	color = float4(TracePaths(id, rayOrigin, hit, rayDirection), 1);
+	if (hit.distance == 1.#INF)
+	{
+		hit.distance = 10000;
+	}
+#else
 	if (hit.distance != 1.#INF)
 	{
-		float random = hash(id.x * width + id.y + (frac(time + 1) * 65536));
-		float3 lightDir = float3(0.57735 + random * 0.05, 0.57735 + hash(random * 65536 + 1) * 0.05, 0.57735 + hash(random * 65536) * 0.05);
-		bool inShadow = ShadowSampleScene(hit.position + (hit.normal * 0.01), id);
+		uint sampleFrame = CheckerboardSampleFrame(CHECKERBOARD, frame);
+		float3 jitter = float3(SampleSequence(SAMPLER, id.x, id.y, sampleFrame, 0), SampleSequence(SAMPLER, id.x, id.y, sampleFrame, 1), SampleSequence(SAMPLER, id.x, id.y, sampleFrame, 2));
+		float3 lightDir = 0.57735 + jitter * 0.05;
+		bool inShadow = ShadowSampleScene(hit.position + (hit.normal * 0.01), lightDir);
 		float lighting = (saturate(dot(hit.normal, float3(0.57735, 0.57735, 0.57735))) * inShadow) + 0.05;
 
 		color = float4(hit.color * lighting, 1);
@@ -318,18 +468,22 @@ void main(uint2 id : SV_DispatchThreadID)
 		hit.distance = 10000;
 		color = float4(hit.color, 1);
 	}
+#endif
 
 	//Reproject
 	float3 cameraSpace = mul(float3x3(previousMat0.x, previousMat0.y, previousMat0.z, previousMat0.w, previousMat1.x, previousMat1.y, previousMat1.z, previousMat1.w, previousMat2.x), (hit.distance * rayDirection) + rayOrigin - float3(previousOriginX, previousOriginY, previousOriginZ));
 	float2 ndc = -1.5 * cameraSpace.xy / cameraSpace.z;
 
-	float2 rasterSpace = ((float2(ndc.x, -ndc.y) * (float)height + float2(width, height)) / 2.0) - offset;
+	float2 rasterSpace = ((float2(ndc.x, -ndc.y) * (float)previousHeight + float2(previousWidth, previousHeight)) / 2.0) - offset;
 
-	reprojectionBuffer[id] = float4(sampleTempBuffer(rasterSpace, hit.normal, color, hit.distance, hit.meshID).xyz, hit.distance);
+	//Behind the previous camera there is nothing to reproject from
+	rasterSpace = cameraSpace.z < 0 ? rasterSpace : -10000;
+	motionBuffer[id] = float4(rasterSpace - id, hit.distance, 0);
 
 	GeomertyHistoryBuffer[id] = float4(hit.normal, hit.meshID);
 
 	float4 uiColor = SampleUI(id);
 
-	result[id] = reprojectionBuffer[id];
+	//Shaders/Temporal.hlsl blends this into the history
+	result[id] = color;
 }
\ No newline at end of file
@@ -0,0 +1,143 @@
+#ifndef SAMPLER_HLSLI
+#define SAMPLER_HLSLI
+
+//Sample sequences indexed by pixel, sample and dimension, in [0, 1). RenderCompute.hlsl includes this file, and the CPU tracers
+//compile the same code as C++ through MeshManagement::Sampler, so both draw exactly the same numbers. Only integer arithmetic
+//decides the values, keep it that way so the two stay bit identical.
+//The sample index is frame * samplesPerFrame + sample. Dimensions 0 and 1 are the position in the pixel, and each bounce should
+//take the next pair, since pairs share a 4D Sobol set or an R2 sequence and are stratified together.
+
+#ifdef __cplusplus
+typedef unsigned int uint;
+
+inline uint reversebits(uint x)
+{
+	x = ((x >> 1) & 0x55555555u) | ((x & 0x55555555u) << 1);
+	x = ((x >> 2) & 0x33333333u) | ((x & 0x33333333u) << 2);
+	x = ((x >> 4) & 0x0f0f0f0fu) | ((x & 0x0f0f0f0fu) << 4);
+	x = ((x >> 8) & 0x00ff00ffu) | ((x & 0x00ff00ffu) << 8);
+	return (x >> 16) | (x << 16);
+}
+#endif
+
+#include "BlueNoise.hlsli"
+
+static const uint samplerRandom = 0; //Hashed white noise
+static const uint samplerSobol = 1; //Owen scrambled Sobol, padded with independent 4D sets past dimension 3
+static const uint samplerR2 = 2; //Roberts' R2 sequence over each pair of dimensions, randomly shifted per pixel and dimension
+static const uint samplerBlueNoise = 3; //Sobol shared by all pixels, shifted per pixel by a blue noise tile so errors are blue
+
+//Direction vectors of the first four Sobol dimensions, Joe and Kuo 2008
+static const uint sobolDirections[128] =
+{
+	0x80000000u, 0x40000000u, 0x20000000u, 0x10000000u, 0x08000000u, 0x04000000u, 0x02000000u, 0x01000000u, 0x00800000u, 0x00400000u, 0x00200000u, 0x00100000u, 0x00080000u, 0x00040000u, 0x00020000u, 0x00010000u,
+	0x00008000u, 0x00004000u, 0x00002000u, 0x00001000u, 0x00000800u, 0x00000400u, 0x00000200u, 0x00000100u, 0x00000080u, 0x00000040u, 0x00000020u, 0x00000010u, 0x00000008u, 0x00000004u, 0x00000002u, 0x00000001u,
+	0x80000000u, 0xc0000000u, 0xa0000000u, 0xf0000000u, 0x88000000u, 0xcc000000u, 0xaa000000u, 0xff000000u, 0x80800000u, 0xc0c00000u, 0xa0a00000u, 0xf0f00000u, 0x88880000u, 0xcccc0000u, 0xaaaa0000u, 0xffff0000u,
+	0x80008000u, 0xc000c000u, 0xa000a000u, 0xf000f000u, 0x88008800u, 0xcc00cc00u, 0xaa00aa00u, 0xff00ff00u, 0x80808080u, 0xc0c0c0c0u, 0xa0a0a0a0u, 0xf0f0f0f0u, 0x88888888u, 0xccccccccu, 0xaaaaaaaau, 0xffffffffu,
+	0x80000000u, 0xc0000000u, 0x60000000u, 0x90000000u, 0xe8000000u, 0x5c000000u, 0x8e000000u, 0xc5000000u, 0x68800000u, 0x9cc00000u, 0xee600000u, 0x55900000u, 0x80680000u, 0xc09c0000u, 0x60ee0000u, 0x90550000u,
+	0xe8808000u, 0x5cc0c000u, 0x8e606000u, 0xc5909000u, 0x6868e800u, 0x9c9c5c00u, 0xeeee8e00u, 0x5555c500u, 0x8000e880u, 0xc0005cc0u, 0x60008e60u, 0x9000c590u, 0xe8006868u, 0x5c009c9cu, 0x8e00eeeeu, 0xc5005555u,
+	0x80000000u, 0xc0000000u, 0x20000000u, 0x50000000u, 0xf8000000u, 0x74000000u, 0xa2000000u, 0x93000000u, 0xd8800000u, 0x25400000u, 0x59e00000u, 0xe6d00000u, 0x78080000u, 0xb40c0000u, 0x82020000u, 0xc3050000u,
+	0x208f8000u, 0x51474000u, 0xfbea2000u, 0x75d93000u, 0xa0858800u, 0x914e5400u, 0xdbe79e00u, 0x25db6d00u, 0x58800080u, 0xe54000c0u, 0x79e00020u, 0xb6d00050u, 0x800800f8u, 0xc00c0074u, 0x200200a2u, 0x50050093u
+};
+
+inline uint SamplerHash(uint x)
+{
+	x ^= x >> 16;
+	x *= 0x7feb352du;
+	x ^= x >> 15;
+	x *= 0x846ca68bu;
+	x ^= x >> 16;
+	return x;
+}
+
+inline float SamplerToUnit(uint x)
+{
+	return (float)(x >> 8) * (1.0f / 16777216.0f);
+}
+
+inline uint SamplerPixelSeed(uint pixelX, uint pixelY)
+{
+	return SamplerHash(pixelX ^ SamplerHash(pixelY));
+}
+
+inline float SampleRandom(uint pixelX, uint pixelY, uint sampleIndex, uint dimension)
+{
+	return SamplerToUnit(SamplerHash(SamplerPixelSeed(pixelX, pixelY) ^ SamplerHash(sampleIndex ^ SamplerHash(dimension))));
+}
+
+//Hash based Owen scrambling, Burley 2020 "Practical Hash-based Owen Scrambling"
+inline uint LaineKarrasPermutation(uint x, uint seed)
+{
+	x += seed;
+	x ^= x * 0x6c50b47cu;
+	x ^= x * 0xb82f1e52u;
+	x ^= x * 0xc7afe638u;
+	x ^= x * 0x8d22f6e6u;
+	return x;
+}
+
+inline uint NestedUniformScramble(uint x, uint seed)
+{
+	return reversebits(LaineKarrasPermutation(reversebits(x), seed));
+}
+
+inline uint SobolSample(uint index, uint dimension)
+{
+	uint result = 0;
+	for (uint bit = 0; index != 0; bit++, index >>= 1)
+	{
+		result ^= (index & 1u) * sobolDirections[dimension * 32 + bit];
+	}
+	return result;
+}
+
+inline float SampleSobol(uint pixelX, uint pixelY, uint sampleIndex, uint dimension)
+{
+	//The index shuffle is shared by the four dimensions of a set, so they stay one stratified 4D point set
+	uint seed = SamplerHash(SamplerPixelSeed(pixelX, pixelY) ^ SamplerHash(dimension >> 2));
+	uint index = NestedUniformScramble(sampleIndex, seed);
+	uint setDimension = dimension & 3u;
+	return SamplerToUnit(NestedUniformScramble(SobolSample(index, setDimension), SamplerHash(seed + setDimension)));
+}
+
+inline float SampleR2(uint pixelX, uint pixelY, uint sampleIndex, uint dimension)
+{
+	//Steps of 1 / g and 1 / g^2 for the plastic number g, in 32 bit fixed point so they wrap around exactly. Pairs after the first
+	//walk the sequence with an odd stride, otherwise every pair would repeat the same points.
+	uint pair = dimension >> 1;
+	uint stride = pair == 0 ? 1u : SamplerHash(pair) | 1u;
+	uint step = (dimension & 1u) != 0 ? 2447445414u : 3242174889u;
+	uint shift = SamplerHash(SamplerPixelSeed(pixelX, pixelY) ^ SamplerHash(dimension + 0x51ed270bu));
+	return SamplerToUnit(shift + sampleIndex * stride * step);
+}
+
+inline float SampleBlueNoise(uint pixelX, uint pixelY, uint sampleIndex, uint dimension)
+{
+	//Toroidal shift by the tile (Georgiev and Fajardo 2016), moved to a different place in the tile for each dimension
+	uint offset = SamplerHash(dimension + 0x2c1b3c6du);
+	uint texel = ((pixelY + (offset >> 6)) & 63u) * 64u + ((pixelX + offset) & 63u);
+	uint rank = (blueNoiseRanks[texel >> 1] >> ((texel & 1u) * 16u)) & 0xffffu;
+	uint seed = SamplerHash(dimension >> 2);
+	uint setDimension = dimension & 3u;
+	uint sobol = NestedUniformScramble(SobolSample(NestedUniformScramble(sampleIndex, seed), setDimension), SamplerHash(seed + setDimension));
+	return SamplerToUnit((rank << 20) + (1u << 19) + sobol);
+}
+
+inline float SampleSequence(uint sampler, uint pixelX, uint pixelY, uint sampleIndex, uint dimension)
+{
+	if (sampler == samplerSobol)
+	{
+		return SampleSobol(pixelX, pixelY, sampleIndex, dimension);
+	}
+	if (sampler == samplerR2)
+	{
+		return SampleR2(pixelX, pixelY, sampleIndex, dimension);
+	}
+	if (sampler == samplerBlueNoise)
+	{
+		return SampleBlueNoise(pixelX, pixelY, sampleIndex, dimension);
+	}
+	return SampleRandom(pixelX, pixelY, sampleIndex, dimension);
+}
+
+#endif
@@ -0,0 +1,135 @@
+#pragma warning( disable : 4000 )
+
+//Blends the frame main rendered into the history, the GPU version of TemporalAccumulator in EngineMeshManager. main leaves the
+//raw colour in result and the offset to where each pixel's hit was last frame in motionBuffer. The history there is fetched
+//bilinearly from the taps whose geometry matches, clamped to the colour box of result's 3x3 neighbourhood so stale colour
+//can't linger as ghosting, and blended in with a weight of one over the pixel's history length. reprojectionBuffer gets the
+//blended colour and the history length, and Graphics copies it to tempResult at the end of the frame for the next one.
+//Pixels main didn't trace this frame hold Shaders/CheckerboardResolve.hlsl's spatial fill instead of a new sample, so they carry
+//their history over unchanged and only take the fill where the history was lost. The box is then built from the traced pixels
+//of a 5x5 neighbourhood, since a 3x3 one may hold only the centre.
+//Under dynamic resolution every pass works on the top left width by height pixels of its textures, and the history left there
+//by the frame before may be a different size. main projects into that size, so the history carries over when the scale changes.
+
+#include "Checkerboard.hlsli"
+
+RWTexture2D<float4> result : register(u0); //Raw colour
+RWTexture2D<float4> tempResult : register(u3); //Last frame's reprojectionBuffer
+RWTexture2D<float4> reprojectionBuffer : register(u4); //Accumulated colour, history length
+RWTexture2D<float4> GeomertyHistoryBuffer : register(u5); //Primary hit normal, mesh id
+RWTexture2D<float4> TemporaryGeomertyHistoryBuffer : register(u6); //Last frame's GeomertyHistoryBuffer
+RWTexture2D<float4> motionBuffer : register(u8); //Offset to the previous frame's position in pixels, primary hit distance
+
+cbuffer constants : register(b0, space0)
+{
+	float time;
+	unsigned int frame;
+	unsigned int width;
+	unsigned int height;
+
+	float originX;
+	float originY;
+	float originZ;
+
+	float previousOriginX;
+	float previousOriginY;
+	float previousOriginZ;
+
+	float2 padding;
+
+	float4 mat0;
+	float4 mat1;
+	float mat2;
+	unsigned int previousWidth; //Size of the frame tempResult holds
+	unsigned int previousHeight;
+}
+
+static const float maxHistoryLength = 64; //The blend weight never drops below one over this
+static const float colorBoxScale = 1.25; //Standard deviations either side of the neighbourhood mean the history is clamped to
+static const float normalThreshold = 0.9; //Cosine between normals above which a history tap counts as the same surface
+static const float minimumHistoryWeight = 0.01; //Bilinear weight of the valid taps below which the history counts as disoccluded
+
+[numthreads(32, 32, 1)]
+void main(uint2 id : SV_DispatchThreadID)
+{
+	if (id.x >= width || id.y >= height)
+	{
+		return;
+	}
+
+	//Colour box of the neighbourhood's samples
+	int boxRadius = CHECKERBOARD == checkerboardFull ? 1 : 2;
+	float3 mean = 0;
+	float3 meanSquare = 0;
+	float count = 0;
+	for (int neighbourY = max((int)id.y - boxRadius, 0); neighbourY <= min((int)id.y + boxRadius, (int)height - 1); neighbourY++)
+	{
+		for (int neighbourX = max((int)id.x - boxRadius, 0); neighbourX <= min((int)id.x + boxRadius, (int)width - 1); neighbourX++)
+		{
+			if (!CheckerboardTraced(CHECKERBOARD, neighbourX, neighbourY, frame))
+			{
+				continue;
+			}
+			float3 color = result[int2(neighbourX, neighbourY)].xyz;
+			mean += color;
+			meanSquare += color * color;
+			count++;
+		}
+	}
+	mean /= count;
+	float3 deviation = sqrt(max(meanSquare / count - mean * mean, 0)) * colorBoxScale;
+
+	//Bilinear history from the taps that saw the same surface
+	float4 geometry = GeomertyHistoryBuffer[id];
+	uint meshID = (uint)geometry.w;
+	float2 previousPosition = (float2)id + motionBuffer[id].xy;
+	float2 basePosition = floor(previousPosition);
+	float2 fraction = previousPosition - basePosition;
+
+	float3 previous = 0;
+	float previousLength = 0;
+	float weightSum = 0;
+	for (int tap = 0; tap < 4; tap++)
+	{
+		int2 tapPosition = (int2)basePosition + int2(tap & 1, tap >> 1);
+		if (any(tapPosition < 0) || tapPosition.x >= (int)previousWidth || tapPosition.y >= (int)previousHeight)
+		{
+			continue;
+		}
+		float4 tapGeometry = TemporaryGeomertyHistoryBuffer[tapPosition];
+		if ((uint)tapGeometry.w != meshID || (meshID != 0 && dot(tapGeometry.xyz, geometry.xyz) < normalThreshold))
+		{
+			continue;
+		}
+
+		float weight = ((tap & 1) ? fraction.x : 1 - fraction.x) * ((tap >> 1) ? fraction.y : 1 - fraction.y);
+		float4 history = tempResult[tapPosition];
+		previous += history.xyz * weight;
+		previousLength += history.w * weight;
+		weightSum += weight;
+	}
+
+	//The history length shrinks in proportion to how far the history had to be clamped. Untraced pixels aren't checked until
+	//their next sample arrives.
+	bool traced = CheckerboardTraced(CHECKERBOARD, id.x, id.y, frame);
+	float historyLength = 0;
+	if (weightSum > minimumHistoryWeight)
+	{
+		float3 unclamped = previous / weightSum;
+		previous = traced ? clamp(unclamped, mean - deviation, mean + deviation) : unclamped;
+		float boxSquare = max(dot(deviation, deviation) * 4, 1e-8);
+		historyLength = previousLength / weightSum * (1 - min(sqrt(dot(previous - unclamped, previous - unclamped) / boxSquare), 1));
+	}
+
+	float3 color = result[id].xyz;
+	if (traced)
+	{
+		historyLength = min(historyLength + 1, maxHistoryLength);
+		color = lerp(previous, color, 1 / historyLength);
+	}
+	else if (weightSum > minimumHistoryWeight)
+	{
+		color = previous;
+	}
+	reprojectionBuffer[id] = float4(color, historyLength);
+}
@@ -0,0 +1,47 @@
+#pragma warning( disable : 4000 )
+
+//Stretches the frame rendered at the size ResolutionGovernor picked to the whole of upscaleBuffer, which Graphics copies to the
+//backbuffer. The frame is the top left width by height pixels of result when it was denoised, of reprojectionBuffer otherwise.
+//Bilinear with pixel centres lined up, the same as ResolutionGovernor::Upscale in EngineMeshManager.
+
+RWTexture2D<float4> result : register(u0); //Denoised colour
+RWTexture2D<float4> reprojectionBuffer : register(u4); //Accumulated colour, history length
+RWTexture2D<float4> upscaleBuffer : register(u9); //Output size
+
+cbuffer constants : register(b0, space0)
+{
+	float time;
+	unsigned int frame;
+	unsigned int width;
+	unsigned int height;
+}
+
+float3 Load(int2 position)
+{
+#ifdef DENOISE
+	return result[position].xyz;
+#else
+	return reprojectionBuffer[position].xyz;
+#endif
+}
+
+[numthreads(32, 32, 1)]
+void main(uint2 id : SV_DispatchThreadID)
+{
+	uint outputWidth;
+	uint outputHeight;
+	upscaleBuffer.GetDimensions(outputWidth, outputHeight);
+	if (id.x >= outputWidth || id.y >= outputHeight)
+	{
+		return;
+	}
+
+	float2 source = clamp(((float2)id + 0.5) * float2(width, height) / float2(outputWidth, outputHeight) - 0.5, 0, float2(width - 1, height - 1));
+	int2 base = (int2)source;
+	int2 next = min(base + 1, int2(width - 1, height - 1));
+	float2 fraction = source - (float2)base;
+
+	float3 top = lerp(Load(base), Load(int2(next.x, base.y)), fraction.x);
+	float3 bottom = lerp(Load(int2(base.x, next.y)), Load(next), fraction.x);
+	upscaleBuffer[id] = float4(lerp(top, bottom, fraction.y), 1);
+}
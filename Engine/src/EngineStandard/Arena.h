@@ -0,0 +1,191 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+namespace ESL
+{
+	//Monotonic allocator for short lived scratch memory. Allocations are never freed individually, memory is returned by
+	//rewinding to a marker or resetting the whole arena. Blocks are kept after a rewind so a steady state reuses them.
+	class Arena
+	{
+	public:
+		struct Marker
+		{
+			size_t block;
+			size_t offset;
+		};
+		struct Statistics
+		{
+			size_t allocations = 0; //Calls to Allocate
+			size_t blockAllocations = 0; //Calls to malloc made by the arena
+			size_t bytesReserved = 0;
+			size_t peakBytesUsed = 0;
+		};
+	public:
+		Arena(size_t initialCapacity = 65536)
+		{
+			Reserve(initialCapacity);
+		}
+		~Arena()
+		{
+			for (size_t i = 0; i < blocks.size(); i++)
+			{
+				free(blocks[i].data);
+			}
+		}
+		Arena(const Arena&) = delete;
+		Arena& operator=(const Arena&) = delete;
+
+		//Makes sure at least bytes can be allocated without the arena going back to the heap
+		void Reserve(size_t bytes)
+		{
+			size_t available = 0;
+			for (size_t i = currentBlock; i < blocks.size(); i++)
+			{
+				available += blocks[i].size - (i == currentBlock ? currentOffset : 0);
+			}
+			if (available < bytes)
+			{
+				AddBlock(bytes - available);
+			}
+		}
+
+		void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t))
+		{
+			statistics.allocations++;
+
+			while (currentBlock < blocks.size())
+			{
+				size_t offset = (currentOffset + alignment - 1) & ~(alignment - 1);
+				if (offset + size <= blocks[currentBlock].size)
+				{
+					usedBytes += offset + size - currentOffset;
+					currentOffset = offset + size;
+					if (usedBytes > statistics.peakBytesUsed)
+					{
+						statistics.peakBytesUsed = usedBytes;
+					}
+					return blocks[currentBlock].data + offset;
+				}
+
+				//Move on to the next block, the tail of this one stays unused until a rewind and is not counted as used
+				blocks[currentBlock].used = currentOffset;
+				currentBlock++;
+				currentOffset = 0;
+			}
+
+			size_t lastSize = blocks.size() > 0 ? blocks.back().size : 0;
+			AddBlock(size + alignment > lastSize * 2 ? size + alignment : lastSize * 2);
+			return Allocate(size, alignment);
+		}
+
+		template <class T> T* Allocate(size_t count)
+		{
+			return static_cast<T*>(Allocate(count * sizeof(T), alignof(T)));
+		}
+
+		Marker GetMarker() const
+		{
+			return { currentBlock, currentOffset };
+		}
+
+		void Rewind(Marker marker)
+		{
+			currentBlock = marker.block;
+			currentOffset = marker.offset;
+
+			usedBytes = marker.offset;
+			for (size_t i = 0; i < marker.block; i++)
+			{
+				usedBytes += blocks[i].used;
+			}
+		}
+
+		void Reset()
+		{
+			Rewind({ 0, 0 });
+		}
+
+		const Statistics& GetStatistics() const
+		{
+			return statistics;
+		}
+	private:
+		void AddBlock(size_t size)
+		{
+			Block block;
+			block.data = static_cast<char*>(malloc(size));
+			if (block.data == nullptr)
+			{
+				throw std::bad_alloc();
+			}
+			block.size = size;
+			block.used = 0;
+			blocks.push_back(block);
+
+			statistics.blockAllocations++;
+			statistics.bytesReserved += size;
+		}
+	private:
+		struct Block
+		{
+			char* data;
+			size_t size;
+			size_t used; //Offset the block was left at, only meaningful for blocks before currentBlock
+		};
+		std::vector<Block> blocks;
+		size_t currentBlock = 0;
+		size_t currentOffset = 0;
+		size_t usedBytes = 0;
+		Statistics statistics;
+	};
+
+	//Rewinds the arena to where it was on construction when going out of scope
+	class ArenaScope
+	{
+	public:
+		ArenaScope(Arena& arena) : arena(arena), marker(arena.GetMarker()) {}
+		~ArenaScope()
+		{
+			arena.Rewind(marker);
+		}
+		ArenaScope(const ArenaScope&) = delete;
+		ArenaScope& operator=(const ArenaScope&) = delete;
+	private:
+		Arena& arena;
+		Arena::Marker marker;
+	};
+
+	//Standard library allocator backed by an Arena, deallocate is a no-op
+	template <class T> class ArenaAllocator
+	{
+	public:
+		typedef T value_type;
+	public:
+		ArenaAllocator(Arena& arena) : arena(&arena) {}
+		template <class U> ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena) {}
+
+		T* allocate(size_t count)
+		{
+			return arena->Allocate<T>(count);
+		}
+		void deallocate(T*, size_t) {}
+
+		template <class U> bool operator==(const ArenaAllocator<U>& other) const
+		{
+			return arena == other.arena;
+		}
+		template <class U> bool operator!=(const ArenaAllocator<U>& other) const
+		{
+			return arena != other.arena;
+		}
+	private:
+		template <class U> friend class ArenaAllocator;
+		Arena* arena;
+	};
+
+	template <class T> using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+}
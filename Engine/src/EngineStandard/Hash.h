@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace ESL
+{
+	namespace HashDetail
+	{
+		constexpr uint64_t prime1 = 0x9E3779B185EBCA87ull;
+		constexpr uint64_t prime2 = 0xC2B2AE3D27D4EB4Full;
+		constexpr uint64_t prime3 = 0x165667B19E3779F9ull;
+		constexpr uint64_t prime4 = 0x85EBCA77C2B2AE63ull;
+		constexpr uint64_t prime5 = 0x27D4EB2F165667C5ull;
+
+		inline uint64_t RotateLeft(uint64_t value, int bits)
+		{
+			return (value << bits) | (value >> (64 - bits));
+		}
+
+		inline uint64_t Read64(const unsigned char* data)
+		{
+			uint64_t value;
+			memcpy(&value, data, sizeof(value));
+			return value;
+		}
+
+		inline uint32_t Read32(const unsigned char* data)
+		{
+			uint32_t value;
+			memcpy(&value, data, sizeof(value));
+			return value;
+		}
+
+		inline uint64_t Round(uint64_t accumulator, uint64_t input)
+		{
+			accumulator += input * prime2;
+			accumulator = RotateLeft(accumulator, 31);
+			return accumulator * prime1;
+		}
+
+		inline uint64_t MergeRound(uint64_t accumulator, uint64_t value)
+		{
+			accumulator ^= Round(0, value);
+			return accumulator * prime1 + prime4;
+		}
+	}
+
+	//64 bit non cryptographic hash (the XXH64 algorithm), reads 32 bytes per iteration. Chain calls by passing the previous result as seed.
+	inline uint64_t Hash64(const void* input, size_t size, uint64_t seed = 0)
+	{
+		using namespace HashDetail;
+
+		const unsigned char* data = (const unsigned char*)input;
+		const unsigned char* end = data + size;
+		uint64_t hash;
+
+		if (size >= 32)
+		{
+			uint64_t v1 = seed + prime1 + prime2;
+			uint64_t v2 = seed + prime2;
+			uint64_t v3 = seed;
+			uint64_t v4 = seed - prime1;
+
+			const unsigned char* limit = end - 32;
+			do
+			{
+				v1 = Round(v1, Read64(data));
+				v2 = Round(v2, Read64(data + 8));
+				v3 = Round(v3, Read64(data + 16));
+				v4 = Round(v4, Read64(data + 24));
+				data += 32;
+			} while (data <= limit);
+
+			hash = RotateLeft(v1, 1) + RotateLeft(v2, 7) + RotateLeft(v3, 12) + RotateLeft(v4, 18);
+			hash = MergeRound(hash, v1);
+			hash = MergeRound(hash, v2);
+			hash = MergeRound(hash, v3);
+			hash = MergeRound(hash, v4);
+		}
+		else
+		{
+			hash = seed + prime5;
+		}
+
+		hash += (uint64_t)size;
+
+		while (data + 8 <= end)
+		{
+			hash ^= Round(0, Read64(data));
+			hash = RotateLeft(hash, 27) * prime1 + prime4;
+			data += 8;
+		}
+		if (data + 4 <= end)
+		{
+			hash ^= (uint64_t)Read32(data) * prime1;
+			hash = RotateLeft(hash, 23) * prime2 + prime3;
+			data += 4;
+		}
+		while (data < end)
+		{
+			hash ^= (*data) * prime5;
+			hash = RotateLeft(hash, 11) * prime1;
+			data++;
+		}
+
+		hash ^= hash >> 33;
+		hash *= prime2;
+		hash ^= hash >> 29;
+		hash *= prime3;
+		hash ^= hash >> 32;
+		return hash;
+	}
+}
@@ -0,0 +1,314 @@
+#pragma once
+
+#include <cstdlib>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ESL
+{
+	//Parsed JSON document. Small and strict enough for asset headers, not meant for large or untrusted streaming input.
+	struct JsonValue
+	{
+		enum class Type
+		{
+			Null, Bool, Number, String, Array, Object
+		};
+
+		Type type = Type::Null;
+		bool boolean = false;
+		double number = 0;
+		std::string string;
+		std::vector<JsonValue> array;
+		std::vector<std::pair<std::string, JsonValue>> object; //Members in document order
+
+		//Returns the member called key, or nullptr if this isn't an object or has no such member
+		const JsonValue* Find(const char* key) const
+		{
+			for (size_t i = 0; i < object.size(); i++)
+			{
+				if (object[i].first == key)
+				{
+					return &object[i].second;
+				}
+			}
+			return nullptr;
+		}
+
+		double NumberOr(const char* key, double fallback) const
+		{
+			const JsonValue* value = Find(key);
+			return (value != nullptr && value->type == Type::Number) ? value->number : fallback;
+		}
+
+		size_t Size() const
+		{
+			return type == Type::Array ? array.size() : object.size();
+		}
+	};
+
+	namespace JsonDetail
+	{
+		inline void SkipWhitespace(const char*& cursor, const char* end)
+		{
+			while (cursor < end && (*cursor == ' ' || *cursor == '\t' || *cursor == '\n' || *cursor == '\r'))
+			{
+				cursor++;
+			}
+		}
+
+		inline void AppendUtf8(std::string& output, unsigned int codePoint)
+		{
+			if (codePoint < 0x80)
+			{
+				output += (char)codePoint;
+			}
+			else if (codePoint < 0x800)
+			{
+				output += (char)(0xC0 | (codePoint >> 6));
+				output += (char)(0x80 | (codePoint & 0x3F));
+			}
+			else if (codePoint < 0x10000)
+			{
+				output += (char)(0xE0 | (codePoint >> 12));
+				output += (char)(0x80 | ((codePoint >> 6) & 0x3F));
+				output += (char)(0x80 | (codePoint & 0x3F));
+			}
+			else
+			{
+				output += (char)(0xF0 | (codePoint >> 18));
+				output += (char)(0x80 | ((codePoint >> 12) & 0x3F));
+				output += (char)(0x80 | ((codePoint >> 6) & 0x3F));
+				output += (char)(0x80 | (codePoint & 0x3F));
+			}
+		}
+
+		inline bool ParseHex4(const char*& cursor, const char* end, unsigned int& value)
+		{
+			if (end - cursor < 4)
+			{
+				return false;
+			}
+			value = 0;
+			for (int i = 0; i < 4; i++, cursor++)
+			{
+				char c = *cursor;
+				value <<= 4;
+				if (c >= '0' && c <= '9') value |= (unsigned int)(c - '0');
+				else if (c >= 'a' && c <= 'f') value |= (unsigned int)(c - 'a' + 10);
+				else if (c >= 'A' && c <= 'F') value |= (unsigned int)(c - 'A' + 10);
+				else return false;
+			}
+			return true;
+		}
+
+		inline bool ParseString(const char*& cursor, const char* end, std::string& output)
+		{
+			cursor++; //Opening quote
+			while (cursor < end && *cursor != '"')
+			{
+				if (*cursor != '\\')
+				{
+					output += *cursor++;
+					continue;
+				}
+
+				cursor++;
+				if (cursor >= end)
+				{
+					return false;
+				}
+				char escape = *cursor++;
+				switch (escape)
+				{
+				case '"': output += '"'; break;
+				case '\\': output += '\\'; break;
+				case '/': output += '/'; break;
+				case 'b': output += '\b'; break;
+				case 'f': output += '\f'; break;
+				case 'n': output += '\n'; break;
+				case 'r': output += '\r'; break;
+				case 't': output += '\t'; break;
+				case 'u':
+				{
+					unsigned int codePoint;
+					if (!ParseHex4(cursor, end, codePoint))
+					{
+						return false;
+					}
+					if (codePoint >= 0xD800 && codePoint < 0xDC00 && end - cursor >= 6 && cursor[0] == '\\' && cursor[1] == 'u') //Surrogate pair
+					{
+						cursor += 2;
+						unsigned int low;
+						if (!ParseHex4(cursor, end, low))
+						{
+							return false;
+						}
+						codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+					}
+					AppendUtf8(output, codePoint);
+					break;
+				}
+				default:
+					return false;
+				}
+			}
+			if (cursor >= end)
+			{
+				return false;
+			}
+			cursor++; //Closing quote
+			return true;
+		}
+
+		inline bool ParseValue(const char*& cursor, const char* end, JsonValue& value, int depth)
+		{
+			if (depth > 256)
+			{
+				return false;
+			}
+
+			SkipWhitespace(cursor, end);
+			if (cursor >= end)
+			{
+				return false;
+			}
+
+			char c = *cursor;
+			if (c == '{')
+			{
+				value.type = JsonValue::Type::Object;
+				cursor++;
+				SkipWhitespace(cursor, end);
+				if (cursor < end && *cursor == '}')
+				{
+					cursor++;
+					return true;
+				}
+				while (true)
+				{
+					SkipWhitespace(cursor, end);
+					if (cursor >= end || *cursor != '"')
+					{
+						return false;
+					}
+					value.object.push_back(std::pair<std::string, JsonValue>());
+					if (!ParseString(cursor, end, value.object.back().first))
+					{
+						return false;
+					}
+					SkipWhitespace(cursor, end);
+					if (cursor >= end || *cursor != ':')
+					{
+						return false;
+					}
+					cursor++;
+					if (!ParseValue(cursor, end, value.object.back().second, depth + 1))
+					{
+						return false;
+					}
+					SkipWhitespace(cursor, end);
+					if (cursor < end && *cursor == ',')
+					{
+						cursor++;
+						continue;
+					}
+					if (cursor < end && *cursor == '}')
+					{
+						cursor++;
+						return true;
+					}
+					return false;
+				}
+			}
+			if (c == '[')
+			{
+				value.type = JsonValue::Type::Array;
+				cursor++;
+				SkipWhitespace(cursor, end);
+				if (cursor < end && *cursor == ']')
+				{
+					cursor++;
+					return true;
+				}
+				while (true)
+				{
+					value.array.push_back(JsonValue());
+					if (!ParseValue(cursor, end, value.array.back(), depth + 1))
+					{
+						return false;
+					}
+					SkipWhitespace(cursor, end);
+					if (cursor < end && *cursor == ',')
+					{
+						cursor++;
+						continue;
+					}
+					if (cursor < end && *cursor == ']')
+					{
+						cursor++;
+						return true;
+					}
+					return false;
+				}
+			}
+			if (c == '"')
+			{
+				value.type = JsonValue::Type::String;
+				return ParseString(cursor, end, value.string);
+			}
+			if (end - cursor >= 4 && std::string(cursor, 4) == "true")
+			{
+				value.type = JsonValue::Type::Bool;
+				value.boolean = true;
+				cursor += 4;
+				return true;
+			}
+			if (end - cursor >= 5 && std::string(cursor, 5) == "false")
+			{
+				value.type = JsonValue::Type::Bool;
+				cursor += 5;
+				return true;
+			}
+			if (end - cursor >= 4 && std::string(cursor, 4) == "null")
+			{
+				cursor += 4;
+				return true;
+			}
+
+			//Numbers are copied out first since the input isn't null terminated
+			const char* numberEnd = cursor;
+			while (numberEnd < end && ((*numberEnd >= '0' && *numberEnd <= '9') || *numberEnd == '-' || *numberEnd == '+' || *numberEnd == '.' || *numberEnd == 'e' || *numberEnd == 'E'))
+			{
+				numberEnd++;
+			}
+			if (numberEnd == cursor)
+			{
+				return false;
+			}
+			std::string number(cursor, numberEnd);
+			char* parsedEnd = nullptr;
+			value.type = JsonValue::Type::Number;
+			value.number = strtod(number.c_str(), &parsedEnd);
+			cursor = numberEnd;
+			return parsedEnd == number.c_str() + number.size();
+		}
+	}
+
+	//Parses the JSON document in [begin, end), returns false on a syntax error
+	inline bool ParseJson(const char* begin, const char* end, JsonValue& value)
+	{
+		value = JsonValue();
+		const char* cursor = begin;
+		if (!JsonDetail::ParseValue(cursor, end, value, 0))
+		{
+			return false;
+		}
+		JsonDetail::SkipWhitespace(cursor, end);
+		while (cursor < end && *cursor == '\0') //GLB pads its JSON chunk with spaces, tolerate zero padding too
+		{
+			cursor++;
+		}
+		return cursor == end;
+	}
+}
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <cstddef>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ESL
+{
+	//Read only view of a whole file mapped into memory. Pages are loaded by the OS as they are touched.
+	class MappedFile
+	{
+	public:
+		MappedFile() {}
+		MappedFile(const char* path)
+		{
+			Open(path);
+		}
+		~MappedFile()
+		{
+			Close();
+		}
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		bool Open(const char* path)
+		{
+			Close();
+#ifdef _WIN32
+			fileHandle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+			if (fileHandle == INVALID_HANDLE_VALUE)
+			{
+				fileHandle = nullptr;
+				return false;
+			}
+
+			LARGE_INTEGER fileSize;
+			if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0)
+			{
+				Close();
+				return false;
+			}
+			size = (size_t)fileSize.QuadPart;
+
+			mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (mappingHandle == nullptr)
+			{
+				Close();
+				return false;
+			}
+			data = (const unsigned char*)MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+#else
+			descriptor = open(path, O_RDONLY | O_CLOEXEC);
+			if (descriptor < 0)
+			{
+				return false;
+			}
+
+			struct stat status;
+			if (fstat(descriptor, &status) != 0 || status.st_size == 0)
+			{
+				Close();
+				return false;
+			}
+			size = (size_t)status.st_size;
+
+			void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+			data = mapping == MAP_FAILED ? nullptr : (const unsigned char*)mapping;
+			if (data != nullptr)
+			{
+				madvise(mapping, size, MADV_SEQUENTIAL);
+			}
+#endif
+			if (data == nullptr)
+			{
+				Close();
+				return false;
+			}
+			return true;
+		}
+
+		void Close()
+		{
+#ifdef _WIN32
+			if (data != nullptr)
+			{
+				UnmapViewOfFile(data);
+			}
+			if (mappingHandle != nullptr)
+			{
+				CloseHandle(mappingHandle);
+			}
+			if (fileHandle != nullptr)
+			{
+				CloseHandle(fileHandle);
+			}
+			mappingHandle = nullptr;
+			fileHandle = nullptr;
+#else
+			if (data != nullptr)
+			{
+				munmap((void*)data, size);
+			}
+			if (descriptor >= 0)
+			{
+				close(descriptor);
+			}
+			descriptor = -1;
+#endif
+			data = nullptr;
+			size = 0;
+		}
+
+		bool IsOpen() const
+		{
+			return data != nullptr;
+		}
+		const unsigned char* Data() const
+		{
+			return data;
+		}
+		size_t Size() const
+		{
+			return size;
+		}
+	private:
+		const unsigned char* data = nullptr;
+		size_t size = 0;
+#ifdef _WIN32
+		HANDLE fileHandle = nullptr;
+		HANDLE mappingHandle = nullptr;
+#else
+		int descriptor = -1;
+#endif
+	};
+}
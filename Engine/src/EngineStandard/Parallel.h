@@ -0,0 +1,97 @@
+#pragma once
+
+#include <algorithm>
+#include <iterator>
+#include <thread>
+#include <vector>
+
+namespace ESL
+{
+	inline unsigned int ThreadCount()
+	{
+		unsigned int count = std::thread::hardware_concurrency();
+		return count == 0 ? 1 : count;
+	}
+
+	//Splits [0, count) into one contiguous range per thread and calls function(begin, end, threadIndex) for each range
+	template <class Function> void ParallelFor(size_t count, const Function& function, unsigned int threadCount = ThreadCount())
+	{
+		if (count == 0)
+		{
+			return;
+		}
+		if (threadCount > count)
+		{
+			threadCount = (unsigned int)count;
+		}
+		if (threadCount <= 1)
+		{
+			function((size_t)0, count, 0u);
+			return;
+		}
+
+		std::vector<std::thread> threads;
+		threads.reserve(threadCount - 1);
+
+		size_t rangeSize = (count + threadCount - 1) / threadCount;
+		for (unsigned int thread = 1; thread < threadCount; thread++)
+		{
+			size_t begin = thread * rangeSize;
+			size_t end = begin + rangeSize < count ? begin + rangeSize : count;
+			if (begin >= end)
+			{
+				break;
+			}
+			threads.push_back(std::thread([&function, begin, end, thread]() { function(begin, end, thread); }));
+		}
+
+		function((size_t)0, rangeSize < count ? rangeSize : count, 0u);
+
+		for (size_t i = 0; i < threads.size(); i++)
+		{
+			threads[i].join();
+		}
+	}
+
+	//Sorts contiguous chunks on separate threads, then merges neighbouring chunks in parallel rounds
+	template <class Iterator, class Compare> void ParallelSort(Iterator begin, Iterator end, const Compare& compare, unsigned int threadCount = ThreadCount())
+	{
+		size_t count = (size_t)std::distance(begin, end);
+		size_t minimumChunk = 4096;
+		if (threadCount > (count + minimumChunk - 1) / minimumChunk)
+		{
+			threadCount = (unsigned int)((count + minimumChunk - 1) / minimumChunk);
+		}
+		if (threadCount <= 1)
+		{
+			std::sort(begin, end, compare);
+			return;
+		}
+
+		size_t chunkSize = (count + threadCount - 1) / threadCount;
+		ParallelFor(threadCount, [&](size_t first, size_t last, unsigned int)
+		{
+			for (size_t chunk = first; chunk < last; chunk++)
+			{
+				size_t chunkBegin = std::min(chunk * chunkSize, count);
+				size_t chunkEnd = std::min(chunkBegin + chunkSize, count);
+				std::sort(begin + chunkBegin, begin + chunkEnd, compare);
+			}
+		}, threadCount);
+
+		for (size_t width = chunkSize; width < count; width *= 2)
+		{
+			size_t pairs = (count + width * 2 - 1) / (width * 2);
+			ParallelFor(pairs, [&](size_t first, size_t last, unsigned int)
+			{
+				for (size_t pair = first; pair < last; pair++)
+				{
+					size_t pairBegin = pair * width * 2;
+					size_t middle = std::min(pairBegin + width, count);
+					size_t pairEnd = std::min(pairBegin + width * 2, count);
+					std::inplace_merge(begin + pairBegin, begin + middle, begin + pairEnd, compare);
+				}
+			}, threadCount);
+		}
+	}
+}
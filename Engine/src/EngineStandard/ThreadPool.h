@@ -0,0 +1,98 @@
+#pragma once
+
+#include "Parallel.h"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ESL
+{
+	//Fixed set of worker threads running submitted tasks in submission order
+	class ThreadPool
+	{
+	public:
+		ThreadPool(unsigned int threadCount = ThreadCount())
+		{
+			threads.reserve(threadCount);
+			for (unsigned int i = 0; i < threadCount; i++)
+			{
+				threads.push_back(std::thread([this]() { WorkerLoop(); }));
+			}
+		}
+		~ThreadPool()
+		{
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				stopping = true;
+			}
+			taskAvailable.notify_all();
+			for (size_t i = 0; i < threads.size(); i++)
+			{
+				threads[i].join();
+			}
+		}
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		void Submit(std::function<void()> task)
+		{
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				tasks.push_back(std::move(task));
+				pendingTasks++;
+			}
+			taskAvailable.notify_one();
+		}
+
+		//Blocks until every submitted task has finished
+		void Wait()
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			tasksFinished.wait(lock, [this]() { return pendingTasks == 0; });
+		}
+
+		unsigned int GetThreadCount() const
+		{
+			return (unsigned int)threads.size();
+		}
+	private:
+		void WorkerLoop()
+		{
+			while (true)
+			{
+				std::function<void()> task;
+				{
+					std::unique_lock<std::mutex> lock(mutex);
+					taskAvailable.wait(lock, [this]() { return stopping || tasks.size() > 0; });
+					if (tasks.size() == 0)
+					{
+						return;
+					}
+					task = std::move(tasks.front());
+					tasks.pop_front();
+				}
+
+				task();
+
+				std::lock_guard<std::mutex> lock(mutex);
+				pendingTasks--;
+				if (pendingTasks == 0)
+				{
+					tasksFinished.notify_all();
+				}
+			}
+		}
+	private:
+		std::vector<std::thread> threads;
+		std::deque<std::function<void()>> tasks;
+		size_t pendingTasks = 0;
+		bool stopping = false;
+		std::mutex mutex;
+		std::condition_variable taskAvailable;
+		std::condition_variable tasksFinished;
+	};
+}
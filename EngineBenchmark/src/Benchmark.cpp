@@ -0,0 +1,963 @@
+//Headless CPU benchmark of the orbit camera workload. It doesn't touch Direct3D, so besides the Visual Studio project it builds
+//on a Linux box with no GPU, from the repository root:
+//g++ -O2 -std=c++17 -D'__declspec(x)=' -IEngineMeshManager/src -IEngine/src -IEngineDebugger/src EngineBenchmark/src/Benchmark.cpp EngineMeshManager/src/*.cpp EngineDebugger/src/EngineLogger.cpp -lpthread -o EngineBenchmark
+
+#include "MeshManager.h"
+#include "MeshDecoder.h"
+#include "InstanceTracer.h"
+#include "PagedMesh.h"
+#include "RenderScene.h"
+#include "WavefrontRenderer.h"
+#include "PathTracer.h"
+#include "AdaptiveSampler.h"
+#include "Denoiser.h"
+#include "TemporalAccumulator.h"
+#include "CheckerboardResolver.h"
+#include "ResolutionGovernor.h"
+#include "VertexCompression.h"
+#include "Engine/Graphics/Camera.h"
+#include "EngineStandard/Hash.h"
+#include "EngineStandard/Memory.h"
+#include "EngineStandard/Parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <math.h>
+#include <stdlib.h>
+
+using namespace MeshManagement;
+
+namespace
+{
+	struct BenchmarkSettings
+	{
+		std::string meshPath;
+		std::string outputPath; //Empty writes the report to stdout
+		unsigned int frames = 120;
+		unsigned int warmupFrames = 2; //Rendered before timing starts, not part of the report
+		unsigned int width = 640;
+		unsigned int height = 360;
+		unsigned int threads = 0; //0 uses every hardware thread
+		float timeStep = 1.0f / 60.0f; //Seconds of orbit between frames
+		bool meshlets = false;
+		bool wavefront = false; //Render in separate stages over ray queues instead of tracing each pixel start to finish
+		size_t wavefrontSize = 65536; //Rays or paths in flight at once with --wavefront or --path-tracing
+		bool pathTracing = false; //Multi bounce path tracing instead of direct lighting, always runs as a wavefront
+		PathTracer::Settings path;
+		unsigned int convergenceSamples = 0; //Above 0, reports RMSE against a reference at 1, 2, 4... up to this many samples per pixel
+		unsigned int referenceSamples = 1024;
+		bool timeToQuality = false; //Compares uniform and adaptive progressive rendering until they reach targetRmse
+		float targetRmse = 0.02f;
+		AdaptiveSampler::Settings adaptive;
+		bool denoise = false; //Filters path traced frames, and convergence images next to the unfiltered ones
+		Denoiser::Settings denoiser;
+		bool temporal = false; //Accumulates path traced frames over time, before --denoise
+		TemporalAccumulator::Settings temporalAccumulator;
+		unsigned int checkerboard = Checkerboard::checkerboardFull; //Share of the path traced pixels traced each frame, the rest are resolved from their neighbours
+		double frameBudget = 0; //Above 0, renders each frame at the size a ResolutionGovernor picks to meet it and upscales it
+		ResolutionGovernor::Settings resolution;
+		double pagedMegabytes = 0; //Above 0, streams the mesh into a PagedMesh file and traces it through a cache of this size
+		unsigned int subdivisions = 0; //Times each triangle is split in four on its way into the paged file
+		unsigned int chunkTriangles = 16384;
+		bool compressionError = false; //Reports the CompressedVertexAttribute round trip error of every mesh instead of rendering
+	};
+
+	const char* const samplerNames[] = { "random", "sobol", "r2", "bluenoise" }; //Indexed by the Sampler constants
+
+	void PrintUsage()
+	{
+		std::cerr << "Usage: EngineBenchmark <mesh file> [--frames N] [--warmup N] [--width W] [--height H] [--threads N] [--timestep seconds] [--meshlets] [--wavefront] [--wavefront-size N] [--path-tracing] [--spp N] [--max-depth N] [--roulette-depth N] [--no-regeneration] [--sampler random|sobol|r2|bluenoise] [--convergence N] [--reference-spp N] [--time-to-quality] [--target-rmse X] [--error-threshold X] [--tile-size N] [--max-spp N] [--denoise] [--denoise-iterations N] [--color-sigma X] [--depth-sigma X] [--temporal] [--max-history N] [--checkerboard 1|2|4] [--frame-budget ms] [--min-scale X] [--max-scale X] [--paged MB] [--subdivide N] [--chunk-triangles N] [--compression-error] [--output path]" << std::endl;
+	}
+
+	bool ParseArguments(int argc, char** argv, BenchmarkSettings& settings)
+	{
+		for (int i = 1; i < argc; i++)
+		{
+			std::string argument = argv[i];
+			bool hasValue = i + 1 < argc;
+			if (argument == "--meshlets")
+			{
+				settings.meshlets = true;
+			}
+			else if (argument == "--wavefront")
+			{
+				settings.wavefront = true;
+			}
+			else if (argument == "--path-tracing")
+			{
+				settings.pathTracing = true;
+			}
+			else if (argument == "--no-regeneration")
+			{
+				settings.path.regeneratePaths = false;
+			}
+			else if (argument == "--wavefront-size" && hasValue)
+			{
+				settings.wavefrontSize = (size_t)strtoull(argv[++i], nullptr, 10);
+			}
+			else if (argument == "--sampler" && hasValue)
+			{
+				std::string name = argv[++i];
+				unsigned int sampler = 0;
+				while (sampler < 4 && name != samplerNames[sampler])
+				{
+					sampler++;
+				}
+				if (sampler == 4)
+				{
+					std::cerr << "Unknown sampler: " << name << std::endl;
+					return false;
+				}
+				settings.path.sampler = sampler;
+			}
+			else if (argument == "--convergence" && hasValue)
+			{
+				settings.convergenceSamples = (unsigned int)strtoul(argv[++i], nullptr, 10);
+			}
+			else if (argument == "--reference-spp" && hasValue)
+			{
+				settings.referenceSamples = (unsigned int)strtoul(argv[++i], nullptr, 10);
+			}
+			else if (argument == "--time-to-quality")
+			{
+				settings.timeToQuality = true;
+			}
+			else if (argument == "--target-rmse" && hasValue)
+			{
+				settings.targetRmse = strtof(argv[++i], nullptr);
+			}
+			else if (argument == "--error-threshold" && hasValue)
+			{
+				settings.adaptive.errorThreshold = strtof(argv[++i], nullptr);
+			}
+			else if (argument == "--tile-size" && hasValue)
+			{
+				settings.adaptive.tileSize = (unsigned int)strtoul(argv[++i], nullptr, 10);
+			}
+			else if (argument == "--max-spp" && hasValue)
+			{
+				settings.adaptive.maximumSamples = (unsigned int)strtoul(argv[++i], nullptr, 10);
+			}
+			else if (argument == "--denoise")
+			{
+				settings.denoise = true;
+			}
+			else if (argument == "--denoise-iterations" && hasValue)
+			{
+				settings.denoiser.iterations = (unsigned int)strtoul(argv[++i], nullptr, 10);
+			}
+			else if (argument == "--color-sigma" && hasValue)
+			{
+				settings.denoiser.colorSigma = strtof(argv[++i], nullptr);
+			}
+			else if (argument == "--depth-sigma" && hasValue)
+			{
+				settings.denoiser.depthSigma = strtof(argv[++i], nullptr);
+			}
+			else if (argument == "--temporal")
+			{
+				settings.temporal = true;
+			}
+			else if (argument == "--max-history" && hasValue)
+			{
+				settings.temporalAccumulator.maxHistoryLength = std::max((unsigned int)strtoul(argv[++i], nullptr, 10), 1u);
+			}
+			else if (argument == "--checkerboard" && hasValue)
+			{
+				settings.checkerboard = (unsigned int)strtoul(argv[++i], nullptr, 10);
+				if (settings.checkerboard != Checkerboard::checkerboardFull && settings.checkerboard != Checkerboard::checkerboardHalf && settings.checkerboard != Checkerboard::checkerboardQuarter)
+				{
+					std::cerr << "Checkerboard pattern must be 1, 2 or 4" << std::endl;
+					return false;
+				}
+			}
+			else if (argument == "--frame-budget" && hasValue)
+			{
+				settings.frameBudget = strtod(argv[++i], nullptr);
+			}
+			else if (argument == "--min-scale" && hasValue)
+			{
+				settings.resolution.minimumScale = strtof(argv[++i], nullptr);
+			}
+			else if (argument == "--max-scale" && hasValue)
+			{
+				settings.resolution.maximumScale = strtof(argv[++i], nullptr);
+			}
+			else if (argument == "--compression-error")
+			{
+				settings.compressionError = true;
+			}
+			else if (argument == "--paged" && hasValue)
+			{
+				settings.pagedMegabytes = strtod(argv[++i], nullptr);
+			}
+			else if (argument == "--subdivide" && hasValue)
+			{
+				settings.subdivisions = (unsigned int)strtoul(argv[++i], nullptr, 10);
+			}
+			else if (argument == "--chunk-triangles" && hasValue)
+			{
+				settings.chunkTriangles = (unsigned int)strtoul(argv[++i], nullptr, 10);
+			}
+			else if (argument == "--spp" && hasValue)
+			{
+				settings.path.samplesPerPixel = (unsigned int)strtoul(argv[++i], nullptr, 10);
+			}
+			else if (argument == "--max-depth" && hasValue)
+			{
+				settings.path.maxDepth = (unsigned int)strtoul(argv[++i], nullptr, 10);
+			}
+			else if (argument == "--roulette-depth" && hasValue)
+			{
+				settings.path.rouletteDepth = (unsigned int)strtoul(argv[++i], nullptr, 10);
+			}
+			else if (argument == "--frames" && hasValue)
+			{
+				settings.frames = (unsigned int)strtoul(argv[++i], nullptr, 10);
+			}
+			else if (argument == "--warmup" && hasValue)
+			{
+				settings.warmupFrames = (unsigned int)strtoul(argv[++i], nullptr, 10);
+			}
+			else if (argument == "--width" && hasValue)
+			{
+				settings.width = (unsigned int)strtoul(argv[++i], nullptr, 10);
+			}
+			else if (argument == "--height" && hasValue)
+			{
+				settings.height = (unsigned int)strtoul(argv[++i], nullptr, 10);
+			}
+			else if (argument == "--threads" && hasValue)
+			{
+				settings.threads = (unsigned int)strtoul(argv[++i], nullptr, 10);
+			}
+			else if (argument == "--timestep" && hasValue)
+			{
+				settings.timeStep = strtof(argv[++i], nullptr);
+			}
+			else if (argument == "--output" && hasValue)
+			{
+				settings.outputPath = argv[++i];
+			}
+			else if (argument.size() > 0 && argument[0] != '-' && settings.meshPath.empty())
+			{
+				settings.meshPath = argument;
+			}
+			else
+			{
+				std::cerr << "Unknown argument: " << argument << std::endl;
+				return false;
+			}
+		}
+		if (settings.resolution.minimumScale <= 0 || settings.resolution.minimumScale > settings.resolution.maximumScale || settings.resolution.maximumScale > 1)
+		{
+			std::cerr << "Scales must satisfy 0 < min-scale <= max-scale <= 1" << std::endl;
+			return false;
+		}
+		if (settings.pagedMegabytes > 0 && (settings.pathTracing || settings.wavefront || settings.meshlets || settings.frameBudget > 0))
+		{
+			std::cerr << "--paged traces direct lighting one pixel at a time, it can't be combined with --path-tracing, --wavefront, --meshlets or --frame-budget" << std::endl;
+			return false;
+		}
+		if (!settings.pathTracing && (settings.denoise || settings.temporal || settings.checkerboard != Checkerboard::checkerboardFull))
+		{
+			std::cerr << "--denoise, --temporal and --checkerboard work on path traced frames, they need --path-tracing" << std::endl;
+			return false;
+		}
+		if (settings.pagedMegabytes <= 0 && (settings.subdivisions > 0 || settings.chunkTriangles != BenchmarkSettings().chunkTriangles))
+		{
+			std::cerr << "--subdivide and --chunk-triangles need --paged" << std::endl;
+			return false;
+		}
+		return !settings.meshPath.empty() && settings.frames > 0 && settings.width > 0 && settings.height > 0 && settings.wavefrontSize > 0 && settings.referenceSamples > 0 && settings.path.samplesPerPixel > 0 && settings.path.maxDepth > 0;
+	}
+
+	std::string JsonString(const std::string& value)
+	{
+		std::string escaped = "\"";
+		for (size_t i = 0; i < value.size(); i++)
+		{
+			char c = value[i];
+			if (c == '"' || c == '\\')
+			{
+				escaped += '\\';
+				escaped += c;
+			}
+			else if ((unsigned char)c < 0x20)
+			{
+				std::ostringstream oss;
+				oss << "\\u" << std::hex << std::setw(4) << std::setfill('0') << (int)c;
+				escaped += oss.str();
+			}
+			else
+			{
+				escaped += c;
+			}
+		}
+		return escaped + "\"";
+	}
+
+	//Nearest rank percentile of an ascending list
+	double Percentile(const std::vector<double>& sorted, double percent)
+	{
+		size_t rank = (size_t)ceil(percent / 100.0 * (double)sorted.size());
+		return sorted[rank == 0 ? 0 : rank - 1];
+	}
+
+	//Camera of the shader's orbit at time seconds
+	WavefrontRenderer::View OrbitView(const BenchmarkSettings& settings, float time)
+	{
+		Graphics::Camera camera;
+		camera.position = (Vector3<double>)Graphics::Camera::OrbitPosition(time);
+		camera.targetPosition = Vector3<double>(0, 0, 0);
+		camera.UpdateCameraToWorldMatrix();
+		const Matrix3x3<double>& m = camera.cameraToWorldMatrix;
+
+		WavefrontRenderer::View view;
+		view.origin[0] = (float)camera.position.x;
+		view.origin[1] = (float)camera.position.y;
+		view.origin[2] = (float)camera.position.z;
+		const double rows[9] = { m.x0, m.y0, m.z0, m.x1, m.y1, m.z1, m.x2, m.y2, m.z2 };
+		for (int i = 0; i < 9; i++)
+		{
+			view.cameraToWorld[i] = (float)rows[i];
+		}
+		view.width = settings.width;
+		view.height = settings.height;
+		return view;
+	}
+
+	//Path traced image of view to measure error against. It uses white noise at sample indices past the ones being measured, so
+	//it isn't correlated with any of the sequences.
+	std::vector<float> RenderReference(PathTracer& pathTracer, const BenchmarkSettings& settings, const WavefrontRenderer::View& view)
+	{
+		std::vector<float> reference((size_t)view.width * view.height * 3);
+		PathTracer::Settings referenceSettings = settings.path;
+		referenceSettings.sampler = Sampler::samplerRandom;
+		referenceSettings.samplesPerPixel = settings.referenceSamples;
+		referenceSettings.frame = 1;
+		pathTracer.Render(view, referenceSettings, reference.data());
+		return reference;
+	}
+
+	double Rmse(const std::vector<float>& image, const std::vector<float>& reference)
+	{
+		double squaredError = 0;
+		for (size_t i = 0; i < image.size(); i++)
+		{
+			double difference = (double)image[i] - (double)reference[i];
+			squaredError += difference * difference;
+		}
+		return sqrt(squaredError / (double)image.size());
+	}
+
+	//Path traces the first frame with every sampler at doubling sample counts and compares each image against a reference. With
+	//--denoise each image is also compared after filtering.
+	std::string ConvergenceReport(PathTracer& pathTracer, const InstanceTracer& tracer, const BenchmarkSettings& settings, unsigned int threadCount)
+	{
+		WavefrontRenderer::View view = OrbitView(settings, 0);
+		std::vector<float> reference = RenderReference(pathTracer, settings, view);
+		std::vector<float> image(reference.size());
+		std::vector<float> denoised(reference.size());
+		Denoiser denoiser(threadCount);
+		Denoiser::Guides guides;
+		if (settings.denoise)
+		{
+			denoiser.TraceGuides(tracer, view, guides);
+		}
+
+		std::ostringstream json;
+		json << std::setprecision(6);
+		json << "{\n";
+		json << "  \"mesh\": " << JsonString(settings.meshPath) << ",\n";
+		json << "  \"width\": " << settings.width << ",\n";
+		json << "  \"height\": " << settings.height << ",\n";
+		json << "  \"threads\": " << threadCount << ",\n";
+		json << "  \"maxDepth\": " << settings.path.maxDepth << ",\n";
+		json << "  \"referenceSamples\": " << settings.referenceSamples << ",\n";
+		if (settings.denoise)
+		{
+			json << "  \"denoiser\": { \"iterations\": " << settings.denoiser.iterations << ", \"colorSigma\": " << settings.denoiser.colorSigma << ", \"depthSigma\": " << settings.denoiser.depthSigma << " },\n";
+		}
+		json << "  \"samplers\": [\n";
+		for (unsigned int sampler = 0; sampler < 4; sampler++)
+		{
+			json << "    { \"name\": \"" << samplerNames[sampler] << "\", \"rmse\": [";
+			for (unsigned int samples = 1; samples <= settings.convergenceSamples; samples *= 2)
+			{
+				PathTracer::Settings pathSettings = settings.path;
+				pathSettings.sampler = sampler;
+				pathSettings.samplesPerPixel = samples;
+				pathSettings.frame = 0;
+
+				std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+				pathTracer.Render(view, pathSettings, image.data());
+				double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+				json << (samples == 1 ? " " : ", ") << "{ \"samples\": " << samples << ", \"rmse\": " << Rmse(image, reference) << ", \"milliseconds\": " << milliseconds;
+				if (settings.denoise)
+				{
+					start = std::chrono::steady_clock::now();
+					denoiser.Filter(image.data(), guides, settings.denoiser, denoised.data());
+					double denoiseMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+					json << ", \"denoisedRmse\": " << Rmse(denoised, reference) << ", \"denoiseMilliseconds\": " << denoiseMilliseconds;
+				}
+				json << " }";
+			}
+			json << " ]" << (sampler < 3 ? " },\n" : " }\n");
+		}
+		json << "  ]\n";
+		json << "}\n";
+		return json.str();
+	}
+
+	//Renders the first frame progressively until its RMSE against a reference reaches the target, once sampling every pixel
+	//uniformly and once adaptively. Only the passes are timed, not the error measurements between them.
+	std::string TimeToQualityReport(PathTracer& pathTracer, const BenchmarkSettings& settings, unsigned int threadCount)
+	{
+		WavefrontRenderer::View view = OrbitView(settings, 0);
+		std::vector<float> reference = RenderReference(pathTracer, settings, view);
+
+		std::ostringstream json;
+		json << std::setprecision(6);
+		json << "{\n";
+		json << "  \"mesh\": " << JsonString(settings.meshPath) << ",\n";
+		json << "  \"width\": " << settings.width << ",\n";
+		json << "  \"height\": " << settings.height << ",\n";
+		json << "  \"threads\": " << threadCount << ",\n";
+		json << "  \"sampler\": \"" << samplerNames[settings.path.sampler] << "\",\n";
+		json << "  \"maxDepth\": " << settings.path.maxDepth << ",\n";
+		json << "  \"referenceSamples\": " << settings.referenceSamples << ",\n";
+		json << "  \"targetRmse\": " << settings.targetRmse << ",\n";
+		json << "  \"tileSize\": " << settings.adaptive.tileSize << ",\n";
+		json << "  \"errorThreshold\": " << settings.adaptive.errorThreshold << ",\n";
+		const char* const modes[] = { "uniform", "adaptive" };
+		for (int mode = 0; mode < 2; mode++)
+		{
+			AdaptiveSampler::Settings adaptiveSettings = settings.adaptive;
+			adaptiveSettings.path = settings.path;
+			if (mode == 0)
+			{
+				adaptiveSettings.errorThreshold = 0;
+			}
+			AdaptiveSampler sampler(pathTracer, view, adaptiveSettings);
+
+			double seconds = 0;
+			double rmse = Rmse(sampler.GetImage(), reference);
+			unsigned int passes = 0;
+			bool running = true;
+			while (rmse > settings.targetRmse && running)
+			{
+				std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+				running = sampler.Step();
+				seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+				rmse = Rmse(sampler.GetImage(), reference);
+				passes++;
+			}
+			json << "  \"" << modes[mode] << "\": { \"reachedTarget\": " << (rmse <= settings.targetRmse ? "true" : "false") << ", \"seconds\": " << seconds << ", \"passes\": " << passes
+				<< ", \"samples\": " << sampler.GetSampleCount() << ", \"rmse\": " << rmse << ", \"activeTiles\": " << sampler.GetActiveTileCount() << " }" << (mode == 0 ? ",\n" : "\n");
+		}
+		json << "}\n";
+		return json.str();
+	}
+
+	//Splits a triangle into four at its edge midpoints, levels times. Shared edges split at the same points, so the result is
+	//as connected as the source, just larger than the cache.
+	void AddSubdivided(PagedMesh::Writer& writer, const Mesh::Vertex vertices[3], unsigned int levels)
+	{
+		if (levels == 0)
+		{
+			writer.AddTriangle(vertices);
+			return;
+		}
+
+		Mesh::Vertex midpoints[3]; //Of the edge from each vertex to the next
+		for (int edge = 0; edge < 3; edge++)
+		{
+			const Mesh::Vertex& a = vertices[edge];
+			const Mesh::Vertex& b = vertices[(edge + 1) % 3];
+			for (int i = 0; i < 3; i++)
+			{
+				midpoints[edge].position[i] = (a.position[i] + b.position[i]) * 0.5f;
+				midpoints[edge].normal[i] = (a.normal[i] + b.normal[i]) * 0.5f;
+			}
+			midpoints[edge].UV[0] = (a.UV[0] + b.UV[0]) * 0.5f;
+			midpoints[edge].UV[1] = (a.UV[1] + b.UV[1]) * 0.5f;
+		}
+
+		const Mesh::Vertex children[4][3] = {
+			{ vertices[0], midpoints[0], midpoints[2] },
+			{ midpoints[0], vertices[1], midpoints[1] },
+			{ midpoints[2], midpoints[1], vertices[2] },
+			{ midpoints[0], midpoints[1], midpoints[2] }
+		};
+		for (int child = 0; child < 4; child++)
+		{
+			AddSubdivided(writer, children[child], levels - 1);
+		}
+	}
+
+	//Streams the ASCII STL mesh into a paged file without ever holding it in memory, then renders the orbit with direct lighting
+	//traced through a chunk cache of --paged megabytes. Returns an empty report if the file couldn't be written or opened.
+	std::string PagedReport(const BenchmarkSettings& settings, unsigned int threadCount)
+	{
+		std::string pagedPath = settings.meshPath + ".paged";
+		std::chrono::steady_clock::time_point writeStart = std::chrono::steady_clock::now();
+		unsigned long long sourceTriangles = 0;
+		{
+			PagedMesh::Writer writer(pagedPath.c_str(), false, settings.chunkTriangles);
+			bool read = MeshDecoder::StreamAsciiStl(settings.meshPath.c_str(), [&](Mesh::Vertex vertices[3])
+			{
+				sourceTriangles++;
+				AddSubdivided(writer, vertices, settings.subdivisions);
+			});
+			if (!read || !writer.Finish())
+			{
+				std::cerr << "Could not write " << pagedPath << std::endl;
+				return "";
+			}
+		}
+		double writeSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - writeStart).count();
+		size_t writePeakBytes = ESL::PeakResidentBytes();
+		std::ifstream pagedFile(pagedPath, std::ios::binary | std::ios::ate);
+		unsigned long long fileBytes = (unsigned long long)pagedFile.tellg();
+		pagedFile.close();
+
+		std::ostringstream json;
+		{
+			PagedMesh mesh(pagedPath.c_str(), (size_t)(settings.pagedMegabytes * 1048576.0));
+			if (!mesh.IsOpen())
+			{
+				std::cerr << "Could not open " << pagedPath << std::endl;
+				return "";
+			}
+
+			std::vector<float> image((size_t)settings.width * settings.height);
+			std::vector<double> frameMilliseconds;
+			std::vector<MeshTracer::Statistics> threadStatistics(threadCount);
+			std::vector<unsigned long long> threadShadowRays(threadCount, 0);
+			unsigned long long imageHash = 0;
+			for (unsigned int frame = 0; frame < settings.warmupFrames + settings.frames; frame++)
+			{
+				bool timed = frame >= settings.warmupFrames;
+				unsigned int timedFrame = timed ? frame - settings.warmupFrames : frame;
+				WavefrontRenderer::View view = OrbitView(settings, (float)timedFrame * settings.timeStep);
+
+				//Rows are handed out one at a time like WavefrontRenderer::RenderPerPixel, shaded without the ground
+				std::chrono::steady_clock::time_point frameStart = std::chrono::steady_clock::now();
+				std::atomic<unsigned int> nextRow(0);
+				ESL::ParallelFor(threadCount, [&](size_t, size_t, unsigned int thread)
+				{
+					MeshTracer::Statistics* statistics = timed ? &threadStatistics[thread] : nullptr;
+					for (unsigned int y = nextRow++; y < view.height; y = nextRow++)
+					{
+						for (unsigned int x = 0; x < view.width; x++)
+						{
+							MeshTracer::Ray ray = WavefrontRenderer::CameraRay(view, x, y);
+							MeshTracer::Hit hit = mesh.Trace(ray, statistics);
+							float brightness = 0;
+							if (hit.distance != INFINITY)
+							{
+								float diffuse = std::max(hit.normal[0] * RenderScene::lightDirection[0] + hit.normal[1] * RenderScene::lightDirection[1] + hit.normal[2] * RenderScene::lightDirection[2], 0.0f);
+								if (diffuse > 0)
+								{
+									MeshTracer::Ray shadowRay;
+									for (int i = 0; i < 3; i++)
+									{
+										shadowRay.origin[i] = hit.position[i] + hit.normal[i] * RenderScene::shadowBias;
+										shadowRay.direction[i] = RenderScene::lightDirection[i];
+									}
+									threadShadowRays[thread] += timed ? 1 : 0;
+									diffuse = mesh.Occluded(shadowRay, statistics) ? 0.0f : diffuse;
+								}
+								brightness = diffuse + RenderScene::ambient;
+							}
+							image[(size_t)y * view.width + x] = brightness;
+						}
+					}
+				}, threadCount);
+
+				if (timed)
+				{
+					frameMilliseconds.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - frameStart).count());
+					imageHash = ESL::Hash64(image.data(), image.size() * sizeof(float), imageHash);
+				}
+			}
+
+			double totalMilliseconds = 0;
+			for (size_t i = 0; i < frameMilliseconds.size(); i++)
+			{
+				totalMilliseconds += frameMilliseconds[i];
+			}
+			MeshTracer::Statistics traversal;
+			unsigned long long shadowRays = 0;
+			for (unsigned int i = 0; i < threadCount; i++)
+			{
+				traversal.rays += threadStatistics[i].rays;
+				traversal.nodesVisited += threadStatistics[i].nodesVisited;
+				shadowRays += threadShadowRays[i];
+			}
+			std::vector<double> sorted = frameMilliseconds;
+			std::sort(sorted.begin(), sorted.end());
+			PagedMesh::PageStatistics pages = mesh.GetPageStatistics();
+
+			json << std::setprecision(6);
+			json << "{\n";
+			json << "  \"mesh\": " << JsonString(settings.meshPath) << ",\n";
+			json << "  \"frames\": " << settings.frames << ",\n";
+			json << "  \"width\": " << settings.width << ",\n";
+			json << "  \"height\": " << settings.height << ",\n";
+			json << "  \"threads\": " << threadCount << ",\n";
+			json << "  \"sourceTriangles\": " << sourceTriangles << ",\n";
+			json << "  \"subdivisions\": " << settings.subdivisions << ",\n";
+			json << "  \"triangles\": " << mesh.GetTriangleCount() << ",\n";
+			json << "  \"chunkTriangles\": " << settings.chunkTriangles << ",\n";
+			json << "  \"fileBytes\": " << fileBytes << ",\n";
+			json << "  \"cacheBudgetBytes\": " << (size_t)(settings.pagedMegabytes * 1048576.0) << ",\n";
+			json << "  \"residentHierarchyBytes\": " << mesh.GetResidentHierarchyBytes() << ",\n";
+			json << "  \"writeSeconds\": " << writeSeconds << ",\n";
+			json << "  \"writePeakMemoryBytes\": " << writePeakBytes << ",\n";
+			json << "  \"primaryRays\": " << (unsigned long long)settings.width * settings.height * settings.frames << ",\n";
+			json << "  \"shadowRays\": " << shadowRays << ",\n";
+			json << "  \"mraysPerSecond\": " << (totalMilliseconds > 0 ? (double)traversal.rays / (totalMilliseconds * 1000.0) : 0.0) << ",\n";
+			json << "  \"msPerFrame\": { \"mean\": " << totalMilliseconds / sorted.size() << ", \"min\": " << sorted.front() << ", \"p50\": " << Percentile(sorted, 50)
+				<< ", \"p90\": " << Percentile(sorted, 90) << ", \"p99\": " << Percentile(sorted, 99) << ", \"max\": " << sorted.back() << " },\n";
+			json << "  \"pages\": { \"hits\": " << pages.hits << ", \"misses\": " << pages.misses << ", \"prefetches\": " << pages.prefetches << ", \"evictions\": " << pages.evictions
+				<< ", \"bytesRead\": " << pages.bytesRead << ", \"peakResidentBytes\": " << pages.peakResidentBytes << " },\n"; //Counted over warmup frames too
+			json << "  \"nodesPerRay\": " << (traversal.rays > 0 ? (double)traversal.nodesVisited / (double)traversal.rays : 0.0) << ",\n";
+			json << "  \"peakMemoryBytes\": " << ESL::PeakResidentBytes() << ",\n";
+			json << "  \"imageHash\": \"" << std::hex << std::setw(16) << std::setfill('0') << imageHash << "\"\n";
+			json << "}\n";
+		}
+		remove(pagedPath.c_str());
+		return json.str();
+	}
+
+	//Encodes every mesh's vertex attributes like MeshDecoder::CompressAttributes, then decodes them to find the worst round trip
+	//error against VertexCompression's bounds. Only the encoding is timed.
+	std::string CompressionReport(const MeshManager& meshManager, const BenchmarkSettings& settings)
+	{
+		size_t vertices = 0;
+		double encodeMilliseconds = 0;
+		double maxNormalError = 0;
+		double maxUVError = 0;
+		std::vector<Mesh::CompressedVertexAttribute> compressed;
+		for (uint16_t mesh = 0; mesh < meshManager.GetMeshCount(); mesh++)
+		{
+			const std::vector<Mesh::VertexAttribute>& attributes = meshManager.GetLod(mesh, 0).attributes; //Empty if already compressed
+			compressed.resize(attributes.size());
+
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			for (size_t i = 0; i < attributes.size(); i++)
+			{
+				compressed[i] = VertexCompression::Compress(attributes[i]);
+			}
+			encodeMilliseconds += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+			for (size_t i = 0; i < attributes.size(); i++)
+			{
+				const Mesh::VertexAttribute& original = attributes[i];
+				Mesh::VertexAttribute decoded = VertexCompression::Decompress(compressed[i]);
+
+				double cross[3] = { (double)original.normal[1] * decoded.normal[2] - (double)original.normal[2] * decoded.normal[1], (double)original.normal[2] * decoded.normal[0] - (double)original.normal[0] * decoded.normal[2], (double)original.normal[0] * decoded.normal[1] - (double)original.normal[1] * decoded.normal[0] };
+				double dot = (double)original.normal[0] * decoded.normal[0] + (double)original.normal[1] * decoded.normal[1] + (double)original.normal[2] * decoded.normal[2];
+				maxNormalError = std::max(maxNormalError, atan2(sqrt(cross[0] * cross[0] + cross[1] * cross[1] + cross[2] * cross[2]), dot) * 57.29577951308232);
+
+				for (int uv = 0; uv < 2; uv++)
+				{
+					double magnitude = fabs((double)original.UV[uv]);
+					maxUVError = std::max(maxUVError, fabs((double)decoded.UV[uv] - (double)original.UV[uv]) / std::max(magnitude, VertexCompression::maxUVAbsoluteError / VertexCompression::maxUVRelativeError));
+				}
+			}
+			vertices += attributes.size();
+		}
+
+		std::ostringstream json;
+		json << std::setprecision(6);
+		json << "{\n";
+		json << "  \"mesh\": " << JsonString(settings.meshPath) << ",\n";
+		json << "  \"vertices\": " << vertices << ",\n";
+		json << "  \"bytes\": { \"uncompressed\": " << vertices * sizeof(Mesh::VertexAttribute) << ", \"compressed\": " << vertices * sizeof(Mesh::CompressedVertexAttribute) << " },\n";
+		json << "  \"encodeMilliseconds\": " << encodeMilliseconds << ",\n";
+		json << "  \"maxNormalErrorDegrees\": " << maxNormalError << ",\n";
+		json << "  \"maxUVRelativeError\": " << maxUVError << ",\n";
+		json << "  \"withinBounds\": " << (maxNormalError <= VertexCompression::maxNormalErrorDegrees && maxUVError <= VertexCompression::maxUVRelativeError ? "true" : "false") << "\n";
+		json << "}\n";
+		return json.str();
+	}
+
+	int WriteReport(const BenchmarkSettings& settings, const std::string& report)
+	{
+		if (settings.outputPath.empty())
+		{
+			std::cout << report;
+			return 0;
+		}
+
+		std::ofstream output(settings.outputPath, std::ios::out | std::ios::trunc);
+		output << report;
+		if (!output)
+		{
+			std::cerr << "Could not write " << settings.outputPath << std::endl;
+			return 1;
+		}
+		return 0;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	BenchmarkSettings settings;
+	if (!ParseArguments(argc, argv, settings))
+	{
+		PrintUsage();
+		return 1;
+	}
+	unsigned int threadCount = settings.threads == 0 ? ESL::ThreadCount() : settings.threads;
+	if (settings.pagedMegabytes > 0) //Never loads the mesh into a MeshManager
+	{
+		std::string report = PagedReport(settings, threadCount);
+		return report.empty() ? 1 : WriteReport(settings, report);
+	}
+
+	std::chrono::steady_clock::time_point loadStart = std::chrono::steady_clock::now();
+	MeshManager meshManager;
+	std::vector<MeshHandle> handles = meshManager.ReadMeshFile(settings.meshPath.c_str());
+	if (handles.size() == 0)
+	{
+		std::cerr << "Could not read any meshes from " << settings.meshPath << std::endl;
+		return 1;
+	}
+
+	//Files without a scene place each mesh once at the origin, like the renderer does
+	if (meshManager.GetInstanceCount() == 0)
+	{
+		const float identity[12] = { 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0 };
+		for (size_t i = 0; i < handles.size(); i++)
+		{
+			meshManager.AddInstance(handles[i], identity);
+		}
+	}
+	size_t triangleCount = 0;
+	for (uint16_t i = 0; i < meshManager.GetMeshCount(); i++)
+	{
+		triangleCount += meshManager.GetMeshRange(i).triangleCount;
+	}
+
+	InstanceTracer tracer(meshManager, settings.meshlets);
+	WavefrontRenderer renderer(tracer, threadCount, settings.wavefrontSize);
+	PathTracer pathTracer(tracer, threadCount, settings.wavefrontSize);
+	double loadSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - loadStart).count();
+
+	if (settings.convergenceSamples > 0)
+	{
+		return WriteReport(settings, ConvergenceReport(pathTracer, tracer, settings, threadCount));
+	}
+	if (settings.timeToQuality)
+	{
+		return WriteReport(settings, TimeToQualityReport(pathTracer, settings, threadCount));
+	}
+	if (settings.compressionError)
+	{
+		return WriteReport(settings, CompressionReport(meshManager, settings));
+	}
+
+	//Frame i always renders the camera at i * timeStep seconds, so every run traces the same rays. The render size depends on
+	//timing under --frame-budget, so then the rays and the hash vary between runs.
+	unsigned int channels = 3; //Every renderer writes RGB
+	std::vector<float> image((size_t)settings.width * settings.height * channels);
+	bool dynamicResolution = settings.frameBudget > 0;
+	ResolutionGovernor::Settings resolutionSettings = settings.resolution;
+	resolutionSettings.targetMilliseconds = settings.frameBudget;
+	ResolutionGovernor governor(settings.width, settings.height, resolutionSettings);
+	std::vector<float> upscaled(dynamicResolution ? image.size() : 0);
+	double scaleSum = 0;
+	std::vector<double> frameMilliseconds;
+	WavefrontRenderer::Statistics total;
+	PathTracer::Statistics pathTotal;
+	Denoiser denoiser(threadCount);
+	Denoiser::Guides guides;
+	double denoiseMilliseconds = 0;
+	TemporalAccumulator temporalAccumulator(threadCount);
+	double temporalMilliseconds = 0;
+	double historyLengthSum = 0;
+	double historyPixels = 0;
+	CheckerboardResolver checkerboardResolver(threadCount);
+	std::vector<unsigned int> tracedPixels;
+	std::vector<float> tracedValues;
+	unsigned long long imageHash = 0;
+	for (unsigned int frame = 0; frame < settings.warmupFrames + settings.frames; frame++)
+	{
+		bool timed = frame >= settings.warmupFrames;
+		unsigned int timedFrame = timed ? frame - settings.warmupFrames : frame;
+
+		std::chrono::steady_clock::time_point frameStart = std::chrono::steady_clock::now();
+		WavefrontRenderer::View view = OrbitView(settings, (float)timedFrame * settings.timeStep);
+		if (dynamicResolution)
+		{
+			view.width = governor.GetRenderWidth();
+			view.height = governor.GetRenderHeight();
+			image.resize((size_t)view.width * view.height * channels);
+		}
+		WavefrontRenderer::Statistics* statistics = timed ? &total : nullptr;
+		if (settings.pathTracing)
+		{
+			PathTracer::Settings pathSettings = settings.path;
+			pathSettings.frame = timedFrame;
+			if (settings.checkerboard != Checkerboard::checkerboardFull)
+			{
+				CheckerboardResolver::TracedPixels(settings.checkerboard, view.width, view.height, timedFrame, tracedPixels);
+				tracedValues.resize(tracedPixels.size() * 3);
+				pathSettings.frame = Checkerboard::CheckerboardSampleFrame(settings.checkerboard, timedFrame);
+				pathTracer.RenderPixels(view, pathSettings, tracedPixels.data(), tracedPixels.size(), tracedValues.data(), timed ? &pathTotal : nullptr);
+				for (size_t i = 0; i < tracedPixels.size(); i++)
+				{
+					std::copy(&tracedValues[i * 3], &tracedValues[i * 3] + 3, &image[(size_t)tracedPixels[i] * 3]);
+				}
+				denoiser.TraceGuides(tracer, view, tracedPixels.data(), tracedPixels.size(), guides);
+				checkerboardResolver.Resolve(settings.checkerboard, timedFrame, guides, image.data());
+			}
+			else
+			{
+				pathTracer.Render(view, pathSettings, image.data(), timed ? &pathTotal : nullptr);
+				if (settings.denoise || settings.temporal)
+				{
+					denoiser.TraceGuides(tracer, view, guides);
+				}
+			}
+			if (settings.temporal)
+			{
+				std::chrono::steady_clock::time_point temporalStart = std::chrono::steady_clock::now();
+				TemporalAccumulator::Settings temporalSettings = settings.temporalAccumulator;
+				temporalSettings.checkerboard = settings.checkerboard;
+				temporalSettings.frame = timedFrame;
+				temporalAccumulator.Accumulate(view, guides, image.data(), temporalSettings, image.data());
+				temporalMilliseconds += timed ? std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - temporalStart).count() : 0.0;
+				if (timed)
+				{
+					const std::vector<float>& historyLengths = temporalAccumulator.GetHistoryLengths();
+					for (size_t i = 0; i < historyLengths.size(); i++)
+					{
+						historyLengthSum += historyLengths[i];
+					}
+					historyPixels += (double)historyLengths.size();
+				}
+			}
+			if (settings.denoise)
+			{
+				std::chrono::steady_clock::time_point denoiseStart = std::chrono::steady_clock::now();
+				denoiser.Filter(image.data(), guides, settings.denoiser, image.data());
+				denoiseMilliseconds += timed ? std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - denoiseStart).count() : 0.0;
+			}
+		}
+		else if (settings.wavefront)
+		{
+			renderer.Render(view, image.data(), statistics);
+		}
+		else
+		{
+			renderer.RenderPerPixel(view, image.data(), statistics);
+		}
+		if (dynamicResolution)
+		{
+			ResolutionGovernor::Upscale(image.data(), view.width, view.height, channels, upscaled.data(), settings.width, settings.height, threadCount);
+		}
+		double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - frameStart).count();
+
+		if (timed)
+		{
+			frameMilliseconds.push_back(milliseconds);
+			const std::vector<float>& output = dynamicResolution ? upscaled : image;
+			imageHash = ESL::Hash64(output.data(), output.size() * sizeof(float), imageHash);
+			scaleSum += governor.GetStatistics().scale;
+		}
+		if (dynamicResolution)
+		{
+			governor.EndFrame(milliseconds);
+		}
+	}
+
+	double totalMilliseconds = 0;
+	for (size_t i = 0; i < frameMilliseconds.size(); i++)
+	{
+		totalMilliseconds += frameMilliseconds[i];
+	}
+	if (settings.pathTracing)
+	{
+		//Camera rays count as primary rays, the bounces after them are reported separately
+		total.primaryRays = pathTotal.paths;
+		total.shadowRays = pathTotal.shadowRays;
+		total.traversal = pathTotal.traversal;
+	}
+	unsigned long long bounceRays = pathTotal.extensionRays - pathTotal.paths;
+	std::vector<double> sorted = frameMilliseconds;
+	std::sort(sorted.begin(), sorted.end());
+
+	std::ostringstream json;
+	json << std::setprecision(6);
+	json << "{\n";
+	json << "  \"mesh\": " << JsonString(settings.meshPath) << ",\n";
+	json << "  \"frames\": " << settings.frames << ",\n";
+	json << "  \"warmupFrames\": " << settings.warmupFrames << ",\n";
+	json << "  \"width\": " << settings.width << ",\n";
+	json << "  \"height\": " << settings.height << ",\n";
+	json << "  \"timeStep\": " << settings.timeStep << ",\n";
+	json << "  \"threads\": " << threadCount << ",\n";
+	json << "  \"meshlets\": " << (settings.meshlets ? "true" : "false") << ",\n";
+	json << "  \"wavefront\": " << (settings.wavefront ? "true" : "false") << ",\n";
+	json << "  \"wavefrontSize\": " << settings.wavefrontSize << ",\n";
+	json << "  \"meshes\": " << meshManager.GetMeshCount() << ",\n";
+	json << "  \"instances\": " << meshManager.GetInstanceCount() << ",\n";
+	json << "  \"triangles\": " << triangleCount << ",\n";
+	json << "  \"loadSeconds\": " << loadSeconds << ",\n";
+	json << "  \"primaryRays\": " << total.primaryRays << ",\n";
+	json << "  \"shadowRays\": " << total.shadowRays << ",\n";
+	json << "  \"mraysPerSecond\": " << (totalMilliseconds > 0 ? (double)(total.primaryRays + bounceRays + total.shadowRays) / (totalMilliseconds * 1000.0) : 0.0) << ",\n";
+	json << "  \"msPerFrame\": { \"mean\": " << totalMilliseconds / sorted.size() << ", \"min\": " << sorted.front() << ", \"p50\": " << Percentile(sorted, 50)
+		<< ", \"p90\": " << Percentile(sorted, 90) << ", \"p95\": " << Percentile(sorted, 95) << ", \"p99\": " << Percentile(sorted, 99) << ", \"max\": " << sorted.back() << " },\n";
+	if (settings.pathTracing)
+	{
+		json << "  \"pathTracing\": { \"samplesPerPixel\": " << settings.path.samplesPerPixel << ", \"maxDepth\": " << settings.path.maxDepth << ", \"rouletteDepth\": " << settings.path.rouletteDepth
+			<< ", \"sampler\": \"" << samplerNames[settings.path.sampler] << "\", \"regeneratePaths\": " << (settings.path.regeneratePaths ? "true" : "false") << ", \"bounceRays\": " << bounceRays << ", \"iterations\": " << pathTotal.iterations
+			<< ", \"queueOccupancy\": " << (pathTotal.iterations > 0 ? (double)pathTotal.activePaths / ((double)pathTotal.iterations * (double)pathTracer.GetWavefrontSize()) : 0.0);
+		if (settings.denoise)
+		{
+			json << ", \"denoiseIterations\": " << settings.denoiser.iterations << ", \"denoiseMsPerFrame\": " << denoiseMilliseconds / sorted.size(); //Included in msPerFrame
+		}
+		if (settings.checkerboard != Checkerboard::checkerboardFull)
+		{
+			json << ", \"checkerboard\": " << settings.checkerboard;
+		}
+		if (settings.temporal)
+		{
+			json << ", \"maxHistoryLength\": " << settings.temporalAccumulator.maxHistoryLength << ", \"temporalMsPerFrame\": " << temporalMilliseconds / sorted.size()
+				<< ", \"meanHistoryLength\": " << historyLengthSum / historyPixels;
+		}
+		json << " },\n";
+	}
+	else if (settings.wavefront)
+	{
+		json << "  \"stageSeconds\": { \"generate\": " << total.generateSeconds << ", \"extend\": " << total.extendSeconds << ", \"shade\": " << total.shadeSeconds
+			<< ", \"shadow\": " << total.shadowSeconds << " },\n";
+	}
+	if (dynamicResolution)
+	{
+		const ResolutionGovernor::Statistics& resolution = governor.GetStatistics();
+		json << "  \"dynamicResolution\": { \"frameBudget\": " << settings.frameBudget << ", \"minimumScale\": " << settings.resolution.minimumScale << ", \"maximumScale\": " << settings.resolution.maximumScale
+			<< ", \"meanScale\": " << scaleSum / sorted.size() << ", \"finalScale\": " << resolution.scale << ", \"finalWidth\": " << resolution.renderWidth << ", \"finalHeight\": " << resolution.renderHeight
+			<< ", \"scaleChanges\": " << resolution.scaleChanges << " },\n";
+	}
+	json << "  \"nodesPerRay\": " << (total.traversal.rays > 0 ? (double)total.traversal.nodesVisited / (double)total.traversal.rays : 0.0) << ",\n";
+	json << "  \"peakMemoryBytes\": " << ESL::PeakResidentBytes() << ",\n";
+	json << "  \"imageHash\": \"" << std::hex << std::setw(16) << std::setfill('0') << imageHash << "\"\n"; //Equal across runs, thread counts and --wavefront for the same settings
+	json << "}\n";
+
+	return WriteReport(settings, json.str());
+}
@@ -19,7 +19,11 @@ namespace EngineDebug
 
 		time_t now = time(0);
 		tm localTime;
+#ifdef _WIN32
 		localtime_s(&localTime, &now);
+#else
+		localtime_r(&now, &localTime);
+#endif
 
 		const size_t lastSlashIndex = file.find_last_of("\\");
 		if (std::string::npos != lastSlashIndex)
@@ -35,7 +39,11 @@ namespace EngineDebug
 
 		time_t now = time(0);
 		tm localTime;
+#ifdef _WIN32
 		localtime_s(&localTime, &now);
+#else
+		localtime_r(&now, &localTime);
+#endif
 
 		const size_t lastSlashIndex = file.find_last_of("\\");
 		if (std::string::npos != lastSlashIndex)
@@ -51,7 +59,11 @@ namespace EngineDebug
 
 		time_t now = time(0);
 		tm localTime;
+#ifdef _WIN32
 		localtime_s(&localTime, &now);
+#else
+		localtime_r(&now, &localTime);
+#endif
 
 		const size_t lastSlashIndex = file.find_last_of("\\");
 		if (std::string::npos != lastSlashIndex)
@@ -67,7 +79,11 @@ namespace EngineDebug
 
 		time_t now = time(0);
 		tm localTime;
+#ifdef _WIN32
 		localtime_s(&localTime, &now);
+#else
+		localtime_r(&now, &localTime);
+#endif
 
 		const size_t lastSlashIndex = file.find_last_of("\\");
 		if (std::string::npos != lastSlashIndex)
@@ -0,0 +1,158 @@
+#include "AdaptiveSampler.h"
+
+#include <algorithm>
+#include <math.h>
+
+namespace MeshManagement
+{
+	namespace
+	{
+		float Luminance(const float* rgb)
+		{
+			return 0.2126f * rgb[0] + 0.7152f * rgb[1] + 0.0722f * rgb[2];
+		}
+	}
+
+	AdaptiveSampler::AdaptiveSampler(PathTracer& pathTracer, const WavefrontRenderer::View& view, const Settings& settings) : pathTracer(&pathTracer), view(view), settings(settings)
+	{
+		this->settings.tileSize = std::max(settings.tileSize, 1u);
+		this->settings.minimumSamples = std::max(settings.minimumSamples, 2u);
+		tilesX = (view.width + this->settings.tileSize - 1) / this->settings.tileSize;
+		unsigned int tilesY = (view.height + this->settings.tileSize - 1) / this->settings.tileSize;
+
+		size_t pixelCount = (size_t)view.width * view.height;
+		image.resize(pixelCount * 3, 0.0f);
+		luminanceMean.resize(pixelCount, 0.0f);
+		luminanceM2.resize(pixelCount, 0.0f);
+		tileSamples.resize((size_t)tilesX * tilesY, 0);
+		tileDeviations.resize(tileSamples.size(), 0.0f);
+		for (unsigned int tile = 0; tile < tileSamples.size(); tile++)
+		{
+			unsigned int tileX = (tile % tilesX) * this->settings.tileSize;
+			unsigned int tileY = (tile / tilesX) * this->settings.tileSize;
+			tilePixels.push_back((std::min(tileX + this->settings.tileSize, view.width) - tileX) * (std::min(tileY + this->settings.tileSize, view.height) - tileY));
+			activeTiles.push_back(tile);
+		}
+		UpdateActivePixels();
+	}
+
+	bool AdaptiveSampler::Step(PathTracer::Statistics* statistics)
+	{
+		if (activeTiles.size() == 0)
+		{
+			return false;
+		}
+
+		//Every active pixel has had the same number of passes, so that count is also the index of its next sample
+		PathTracer::Settings pathSettings = settings.path;
+		pathSettings.samplesPerPixel = 1;
+		pathSettings.frame = tileSamples[activeTiles[0]];
+		passValues.resize(activePixels.size() * 3);
+		pathTracer->RenderPixels(view, pathSettings, activePixels.data(), activePixels.size(), passValues.data(), statistics);
+		sampleCount += activePixels.size();
+
+		float count = (float)(pathSettings.frame + 1);
+		for (size_t i = 0; i < activePixels.size(); i++)
+		{
+			size_t pixel = activePixels[i];
+			const float* value = &passValues[i * 3];
+			for (int channel = 0; channel < 3; channel++)
+			{
+				image[pixel * 3 + channel] += (value[channel] - image[pixel * 3 + channel]) / count;
+			}
+
+			float luminance = Luminance(value);
+			float delta = luminance - luminanceMean[pixel];
+			luminanceMean[pixel] += delta / count;
+			luminanceM2[pixel] += delta * (luminance - luminanceMean[pixel]);
+		}
+
+		for (size_t i = 0; i < activeTiles.size(); i++)
+		{
+			tileSamples[activeTiles[i]]++;
+			tileDeviations[activeTiles[i]] = GetTileDeviation(activeTiles[i]);
+		}
+		double deviationSum = 0;
+		for (size_t tile = 0; tile < tileDeviations.size(); tile++)
+		{
+			deviationSum += (double)tileDeviations[tile] * tilePixels[tile];
+		}
+		float meanDeviation = (float)(deviationSum / (double)luminanceMean.size());
+
+		//Samples proportional to deviation, with the constant that makes the image RMSE come out at errorThreshold
+		float stopRatio = settings.errorThreshold * settings.errorThreshold / std::max(meanDeviation, 1e-12f);
+		size_t remaining = 0;
+		for (size_t i = 0; i < activeTiles.size(); i++)
+		{
+			unsigned int tile = activeTiles[i];
+			unsigned int samples = tileSamples[tile];
+			bool converged = samples >= settings.minimumSamples && settings.errorThreshold > 0 && tileDeviations[tile] <= stopRatio * (float)samples;
+			if (!converged && samples < settings.maximumSamples)
+			{
+				activeTiles[remaining++] = tile;
+			}
+		}
+		if (remaining != activeTiles.size())
+		{
+			activeTiles.resize(remaining);
+			UpdateActivePixels();
+		}
+		return activeTiles.size() > 0;
+	}
+
+	void AdaptiveSampler::Run(PathTracer::Statistics* statistics)
+	{
+		while (Step(statistics))
+		{
+		}
+	}
+
+	float AdaptiveSampler::GetTileError(size_t tile) const
+	{
+		unsigned int samples = tileSamples[tile];
+		return samples < 2 ? INFINITY : GetTileDeviation(tile) / sqrtf((float)samples);
+	}
+
+	float AdaptiveSampler::GetTileDeviation(size_t tile) const
+	{
+		unsigned int samples = tileSamples[tile];
+		if (samples < 2)
+		{
+			return INFINITY;
+		}
+
+		unsigned int tileX = (unsigned int)(tile % tilesX) * settings.tileSize;
+		unsigned int tileY = (unsigned int)(tile / tilesX) * settings.tileSize;
+		unsigned int endX = std::min(tileX + settings.tileSize, view.width);
+		unsigned int endY = std::min(tileY + settings.tileSize, view.height);
+
+		float varianceSum = 0;
+		for (unsigned int y = tileY; y < endY; y++)
+		{
+			for (unsigned int x = tileX; x < endX; x++)
+			{
+				varianceSum += luminanceM2[(size_t)y * view.width + x] / (float)(samples - 1);
+			}
+		}
+		return sqrtf(varianceSum / (float)tilePixels[tile]);
+	}
+
+	void AdaptiveSampler::UpdateActivePixels()
+	{
+		activePixels.clear();
+		for (size_t i = 0; i < activeTiles.size(); i++)
+		{
+			unsigned int tileX = (activeTiles[i] % tilesX) * settings.tileSize;
+			unsigned int tileY = (activeTiles[i] / tilesX) * settings.tileSize;
+			unsigned int endX = std::min(tileX + settings.tileSize, view.width);
+			unsigned int endY = std::min(tileY + settings.tileSize, view.height);
+			for (unsigned int y = tileY; y < endY; y++)
+			{
+				for (unsigned int x = tileX; x < endX; x++)
+				{
+					activePixels.push_back(y * view.width + x);
+				}
+			}
+		}
+	}
+}
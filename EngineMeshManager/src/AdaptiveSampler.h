@@ -0,0 +1,78 @@
+#pragma once
+
+#include "PathTracer.h"
+
+#include <vector>
+
+namespace MeshManagement
+{
+	//Progressive path tracing that only keeps sampling where the image is still noisy. Every pass adds one sample to each pixel of
+	//the active tiles and tracks the running mean colour and luminance variance of every pixel.
+	//Stopping every tile once its own error reaches the target spends as many samples as sampling uniformly, since the noisy tiles
+	//then need the samples the quiet ones save. The image RMSE for a sample count is lowest when each tile's samples are
+	//proportional to its luminance standard deviation instead, so once a tile has minimumSamples it stops when its deviation over
+	//its samples falls under errorThreshold squared over the mean deviation of all tiles, or when it reaches maximumSamples. The
+	//image then reaches a luminance RMSE of about errorThreshold.
+	class __declspec(dllexport) AdaptiveSampler
+	{
+	public:
+		struct Settings
+		{
+			unsigned int tileSize = 16;
+			unsigned int minimumSamples = 16; //Variance estimates from fewer samples are too unreliable to stop on
+			unsigned int maximumSamples = 4096;
+			float errorThreshold = 0.02f; //Luminance RMSE the image should reach, 0 never stops early
+			PathTracer::Settings path; //samplesPerPixel and frame are set per pass
+		};
+	public:
+		AdaptiveSampler(PathTracer& pathTracer, const WavefrontRenderer::View& view, const Settings& settings);
+	public:
+		//Traces one pass over the active tiles, returns false once every tile has stopped
+		bool Step(PathTracer::Statistics* statistics = nullptr);
+		//Steps until every tile has stopped, the stopping criterion for offline renders
+		void Run(PathTracer::Statistics* statistics = nullptr);
+
+		const std::vector<float>& GetImage() const //Mean RGB of every pixel, row major
+		{
+			return image;
+		}
+		float GetTileError(size_t tile) const; //RMS over the tile's pixels of the standard error of their mean luminance
+		unsigned int GetTileSamples(size_t tile) const
+		{
+			return tileSamples[tile];
+		}
+		size_t GetTileCount() const
+		{
+			return tileSamples.size();
+		}
+		size_t GetActiveTileCount() const
+		{
+			return activeTiles.size();
+		}
+		unsigned long long GetSampleCount() const //Samples traced over all pixels so far
+		{
+			return sampleCount;
+		}
+	private:
+		float GetTileDeviation(size_t tile) const; //RMS over the tile's pixels of their luminance standard deviation
+		void UpdateActivePixels();
+	private:
+		PathTracer* pathTracer;
+		WavefrontRenderer::View view;
+		Settings settings;
+		unsigned int tilesX;
+		unsigned long long sampleCount = 0;
+#pragma warning(push)
+#pragma warning(disable:4251)
+		std::vector<float> image;
+		std::vector<float> luminanceMean;
+		std::vector<float> luminanceM2; //Sum of squared deviations from the mean, Welford's running variance
+		std::vector<unsigned int> tileSamples;
+		std::vector<unsigned int> tilePixels;
+		std::vector<float> tileDeviations; //Last GetTileDeviation of every tile, frozen once it stops
+		std::vector<unsigned int> activeTiles;
+		std::vector<unsigned int> activePixels; //Pixels of the active tiles, tile by tile
+		std::vector<float> passValues;
+#pragma warning(pop)
+	};
+}
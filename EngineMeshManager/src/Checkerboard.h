@@ -0,0 +1,11 @@
+#pragma once
+
+namespace MeshManagement
+{
+	//CPU build of the traced pixel patterns in Engine/Graphics/Shaders/Checkerboard.hlsli, use CheckerboardTraced with one of the
+	//checkerboard constants
+	namespace Checkerboard
+	{
+#include "Engine/Graphics/Shaders/Checkerboard.hlsli"
+	}
+}
@@ -0,0 +1,111 @@
+#include "CheckerboardResolver.h"
+#include "EngineStandard/Parallel.h"
+
+#include <algorithm>
+#include <math.h>
+
+namespace MeshManagement
+{
+	CheckerboardResolver::CheckerboardResolver(unsigned int threadCount) : threadCount(threadCount == 0 ? ESL::ThreadCount() : threadCount)
+	{
+	}
+
+	void CheckerboardResolver::TracedPixels(unsigned int pattern, unsigned int width, unsigned int height, unsigned int frame, std::vector<unsigned int>& pixels)
+	{
+		pixels.clear();
+		unsigned int columns = Checkerboard::CheckerboardColumns(pattern, width);
+		unsigned int rows = Checkerboard::CheckerboardRows(pattern, height);
+		pixels.reserve((size_t)columns * rows);
+		for (unsigned int row = 0; row < rows; row++)
+		{
+			for (unsigned int column = 0; column < columns; column++)
+			{
+				unsigned int x = Checkerboard::CheckerboardPixelX(pattern, column, row, frame);
+				unsigned int y = Checkerboard::CheckerboardPixelY(pattern, row, frame);
+				if (x < width && y < height)
+				{
+					pixels.push_back(y * width + x);
+				}
+			}
+		}
+	}
+
+	void CheckerboardResolver::Resolve(unsigned int pattern, unsigned int frame, Denoiser::Guides& guides, float* image) const
+	{
+		if (pattern == Checkerboard::checkerboardFull)
+		{
+			return;
+		}
+
+		ESL::ParallelFor(guides.height, [&](size_t begin, size_t end, unsigned int)
+		{
+			for (int y = (int)begin; y < (int)end; y++)
+			{
+				for (int x = 0; x < (int)guides.width; x++)
+				{
+					if (Checkerboard::CheckerboardTraced(pattern, (unsigned int)x, (unsigned int)y, frame))
+					{
+						continue;
+					}
+					size_t pixel = (size_t)y * guides.width + x;
+					int firstX = std::max(x - 1, 0);
+					int lastX = std::min(x + 1, (int)guides.width - 1);
+					int firstY = std::max(y - 1, 0);
+					int lastY = std::min(y + 1, (int)guides.height - 1);
+
+					//Every pattern traces at least one pixel of each 3x3 block inside the image, but one pixel wide or tall images
+					//can have none traced around a pixel, which then keeps what the previous frame left in it
+					size_t nearest = pixel;
+					float nearestDistance = INFINITY;
+					for (int neighbourY = firstY; neighbourY <= lastY; neighbourY++)
+					{
+						for (int neighbourX = firstX; neighbourX <= lastX; neighbourX++)
+						{
+							size_t neighbour = (size_t)neighbourY * guides.width + neighbourX;
+							if (Checkerboard::CheckerboardTraced(pattern, (unsigned int)neighbourX, (unsigned int)neighbourY, frame) && (nearest == pixel || guides.distances[neighbour] < nearestDistance))
+							{
+								nearest = neighbour;
+								nearestDistance = guides.distances[neighbour];
+							}
+						}
+					}
+					if (nearest == pixel)
+					{
+						continue;
+					}
+
+					float sum[3] = { 0, 0, 0 };
+					float count = 0;
+					for (int neighbourY = firstY; neighbourY <= lastY; neighbourY++)
+					{
+						for (int neighbourX = firstX; neighbourX <= lastX; neighbourX++)
+						{
+							size_t neighbour = (size_t)neighbourY * guides.width + neighbourX;
+							if (Checkerboard::CheckerboardTraced(pattern, (unsigned int)neighbourX, (unsigned int)neighbourY, frame) && guides.meshIDs[neighbour] == guides.meshIDs[nearest])
+							{
+								for (int channel = 0; channel < 3; channel++)
+								{
+									sum[channel] += image[neighbour * 3 + channel];
+								}
+								count++;
+							}
+						}
+					}
+
+					guides.normalX[pixel] = guides.normalX[nearest];
+					guides.normalY[pixel] = guides.normalY[nearest];
+					guides.normalZ[pixel] = guides.normalZ[nearest];
+					guides.distances[pixel] = guides.distances[nearest];
+					guides.meshIDs[pixel] = guides.meshIDs[nearest];
+					guides.albedoR[pixel] = guides.albedoR[nearest];
+					guides.albedoG[pixel] = guides.albedoG[nearest];
+					guides.albedoB[pixel] = guides.albedoB[nearest];
+					for (int channel = 0; channel < 3; channel++)
+					{
+						image[pixel * 3 + channel] = sum[channel] / count;
+					}
+				}
+			}
+		}, threadCount);
+	}
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "Denoiser.h"
+#include "Checkerboard.h"
+
+#include <vector>
+
+namespace MeshManagement
+{
+	//Fills in the pixels a frame didn't trace under one of the Checkerboard patterns, the CPU version of
+	//Shaders/CheckerboardResolve.hlsl. Each untraced pixel takes the guides of the traced pixel around it nearest the camera, so
+	//edges stay with the foreground, and the mean colour of the traced pixels around it on that surface. TemporalAccumulator then
+	//replaces that colour with the reprojected history wherever there is one. The shader copies the neighbour's motion vector
+	//too, here TemporalAccumulator projects the borrowed distance along the pixel's own ray instead.
+	class __declspec(dllexport) CheckerboardResolver
+	{
+	public:
+		CheckerboardResolver(unsigned int threadCount = 0);
+	public:
+		//Lists the pixels pattern traces on frame as row major indices, in the order main's threads would trace them
+		static void TracedPixels(unsigned int pattern, unsigned int width, unsigned int height, unsigned int frame, std::vector<unsigned int>& pixels);
+		//Fills the untraced pixels of guides and image, guides.width * guides.height RGB values row major. Only traced pixels are
+		//read, so guides only needs to hold those, as from Denoiser::TraceGuides over TracedPixels.
+		void Resolve(unsigned int pattern, unsigned int frame, Denoiser::Guides& guides, float* image) const;
+	private:
+		unsigned int threadCount;
+	};
+}
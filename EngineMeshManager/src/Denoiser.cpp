@@ -0,0 +1,351 @@
+#include "Denoiser.h"
+#include "RenderScene.h"
+#include "EngineStandard/Parallel.h"
+
+#include <algorithm>
+#include <math.h>
+#include <string.h>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace MeshManagement
+{
+	namespace
+	{
+		const float kernel[5] = { 1.0f / 16.0f, 1.0f / 4.0f, 3.0f / 8.0f, 1.0f / 4.0f, 1.0f / 16.0f }; //B3 spline
+
+		//Per tap factors of one iteration, tap t is at offset ((t % 5 - 2) * step, (t / 5 - 2) * step)
+		struct IterationConstants
+		{
+			int step;
+			float colorScale; //One over the iteration's colour sigma squared
+			float depthScales[25];
+			float weights[25];
+		};
+
+		//exp(x) for x <= 0 to within about 1e-4, using the same operations as ExpNegative4 so both filter paths agree
+		float ExpNegative(float x)
+		{
+			float t = std::max(x, -87.0f) * 1.44269504f;
+			float whole = floorf(t);
+			float f = t - whole;
+			float power = 1.0f + f * (0.69314718f + f * (0.24022651f + f * (0.05550411f + f * (0.00961813f + f * 0.00133336f))));
+			int bits;
+			memcpy(&bits, &power, 4);
+			bits += (int)whole * 8388608; //Adds whole to the exponent
+			memcpy(&power, &bits, 4);
+			return power;
+		}
+
+		//max(cosine, 0)^128, sharp enough that only nearly parallel normals count as the same surface
+		float NormalWeight(float cosine)
+		{
+			cosine = std::max(cosine, 0.0f);
+			for (int i = 0; i < 7; i++)
+			{
+				cosine *= cosine;
+			}
+			return cosine;
+		}
+
+		void FilterPixel(const Denoiser::Guides& guides, const IterationConstants& constants, const std::vector<float>* source, std::vector<float>* destination, int x, int y)
+		{
+			size_t center = (size_t)y * guides.width + x;
+			float centerID = guides.meshIDs[center];
+			if (centerID == (float)RenderScene::skyID)
+			{
+				for (int channel = 0; channel < 3; channel++)
+				{
+					destination[channel][center] = source[channel][center];
+				}
+				return;
+			}
+
+			float inverseDistance = 1.0f / guides.distances[center];
+			float sum[3] = { 0, 0, 0 };
+			float weightSum = 0;
+			for (int tapY = 0; tapY < 5; tapY++)
+			{
+				int sampleY = y + (tapY - 2) * constants.step;
+				if (sampleY < 0 || sampleY >= (int)guides.height)
+				{
+					continue;
+				}
+				for (int tapX = 0; tapX < 5; tapX++)
+				{
+					int sampleX = x + (tapX - 2) * constants.step;
+					size_t tap = (size_t)sampleY * guides.width + sampleX;
+					if (sampleX < 0 || sampleX >= (int)guides.width || guides.meshIDs[tap] != centerID)
+					{
+						continue;
+					}
+
+					float r = source[0][tap] - source[0][center];
+					float g = source[1][tap] - source[1][center];
+					float b = source[2][tap] - source[2][center];
+					float colorTerm = (r * r + g * g + b * b) * constants.colorScale;
+					float depthTerm = fabsf(guides.distances[tap] - guides.distances[center]) * inverseDistance * constants.depthScales[tapY * 5 + tapX];
+					float cosine = guides.normalX[tap] * guides.normalX[center] + guides.normalY[tap] * guides.normalY[center] + guides.normalZ[tap] * guides.normalZ[center];
+					float weight = ExpNegative(-(colorTerm + depthTerm)) * NormalWeight(cosine) * constants.weights[tapY * 5 + tapX];
+
+					sum[0] += source[0][tap] * weight;
+					sum[1] += source[1][tap] * weight;
+					sum[2] += source[2][tap] * weight;
+					weightSum += weight;
+				}
+			}
+			for (int channel = 0; channel < 3; channel++)
+			{
+				destination[channel][center] = sum[channel] / weightSum;
+			}
+		}
+
+#if defined(_M_X64) || defined(__SSE2__)
+		__m128 ExpNegative4(__m128 x)
+		{
+			__m128 t = _mm_mul_ps(_mm_max_ps(x, _mm_set1_ps(-87.0f)), _mm_set1_ps(1.44269504f));
+			__m128i whole = _mm_cvttps_epi32(t);
+			__m128 truncated = _mm_cvtepi32_ps(whole);
+			__m128 roundedUp = _mm_cmpgt_ps(truncated, t); //Truncation rounds negative values up, step those down to the floor
+			truncated = _mm_sub_ps(truncated, _mm_and_ps(roundedUp, _mm_set1_ps(1.0f)));
+			whole = _mm_add_epi32(whole, _mm_castps_si128(roundedUp));
+
+			__m128 f = _mm_sub_ps(t, truncated);
+			__m128 power = _mm_add_ps(_mm_set1_ps(0.00961813f), _mm_mul_ps(f, _mm_set1_ps(0.00133336f)));
+			power = _mm_add_ps(_mm_set1_ps(0.05550411f), _mm_mul_ps(f, power));
+			power = _mm_add_ps(_mm_set1_ps(0.24022651f), _mm_mul_ps(f, power));
+			power = _mm_add_ps(_mm_set1_ps(0.69314718f), _mm_mul_ps(f, power));
+			power = _mm_add_ps(_mm_set1_ps(1.0f), _mm_mul_ps(f, power));
+			return _mm_castsi128_ps(_mm_add_epi32(_mm_castps_si128(power), _mm_slli_epi32(whole, 23)));
+		}
+
+		//FilterPixel for pixels x to x + 3, whose taps must all lie inside the image horizontally
+		void FilterBlock(const Denoiser::Guides& guides, const IterationConstants& constants, const std::vector<float>* source, std::vector<float>* destination, int x, int y)
+		{
+			size_t center = (size_t)y * guides.width + x;
+			__m128 centerR = _mm_loadu_ps(&source[0][center]);
+			__m128 centerG = _mm_loadu_ps(&source[1][center]);
+			__m128 centerB = _mm_loadu_ps(&source[2][center]);
+			__m128 centerNormalX = _mm_loadu_ps(&guides.normalX[center]);
+			__m128 centerNormalY = _mm_loadu_ps(&guides.normalY[center]);
+			__m128 centerNormalZ = _mm_loadu_ps(&guides.normalZ[center]);
+			__m128 centerDistance = _mm_loadu_ps(&guides.distances[center]);
+			__m128 centerID = _mm_loadu_ps(&guides.meshIDs[center]);
+			//Sky pixels have no normal to compare and nothing to filter, they keep their colour
+			__m128 sky = _mm_cmpeq_ps(centerID, _mm_set1_ps((float)RenderScene::skyID));
+			if (_mm_movemask_ps(sky) == 15)
+			{
+				_mm_storeu_ps(&destination[0][center], centerR);
+				_mm_storeu_ps(&destination[1][center], centerG);
+				_mm_storeu_ps(&destination[2][center], centerB);
+				return;
+			}
+
+			__m128 inverseDistance = _mm_div_ps(_mm_set1_ps(1.0f), centerDistance);
+			__m128 absoluteMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+			__m128 colorScale = _mm_set1_ps(constants.colorScale);
+
+			__m128 sumR = _mm_setzero_ps();
+			__m128 sumG = _mm_setzero_ps();
+			__m128 sumB = _mm_setzero_ps();
+			__m128 weightSum = _mm_setzero_ps();
+			for (int tapY = 0; tapY < 5; tapY++)
+			{
+				int sampleY = y + (tapY - 2) * constants.step;
+				if (sampleY < 0 || sampleY >= (int)guides.height)
+				{
+					continue;
+				}
+				for (int tapX = 0; tapX < 5; tapX++)
+				{
+					size_t tap = (size_t)sampleY * guides.width + (x + (tapX - 2) * constants.step);
+					__m128 tapR = _mm_loadu_ps(&source[0][tap]);
+					__m128 tapG = _mm_loadu_ps(&source[1][tap]);
+					__m128 tapB = _mm_loadu_ps(&source[2][tap]);
+
+					__m128 r = _mm_sub_ps(tapR, centerR);
+					__m128 g = _mm_sub_ps(tapG, centerG);
+					__m128 b = _mm_sub_ps(tapB, centerB);
+					__m128 colorTerm = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(r, r), _mm_mul_ps(g, g)), _mm_mul_ps(b, b)), colorScale);
+					__m128 depthDifference = _mm_and_ps(_mm_sub_ps(_mm_loadu_ps(&guides.distances[tap]), centerDistance), absoluteMask);
+					__m128 depthTerm = _mm_mul_ps(_mm_mul_ps(depthDifference, inverseDistance), _mm_set1_ps(constants.depthScales[tapY * 5 + tapX]));
+					__m128 weight = ExpNegative4(_mm_sub_ps(_mm_setzero_ps(), _mm_add_ps(colorTerm, depthTerm)));
+
+					__m128 cosine = _mm_mul_ps(_mm_loadu_ps(&guides.normalX[tap]), centerNormalX);
+					cosine = _mm_add_ps(cosine, _mm_mul_ps(_mm_loadu_ps(&guides.normalY[tap]), centerNormalY));
+					cosine = _mm_add_ps(cosine, _mm_mul_ps(_mm_loadu_ps(&guides.normalZ[tap]), centerNormalZ));
+					cosine = _mm_max_ps(cosine, _mm_setzero_ps());
+					for (int i = 0; i < 7; i++)
+					{
+						cosine = _mm_mul_ps(cosine, cosine);
+					}
+					weight = _mm_mul_ps(_mm_mul_ps(weight, cosine), _mm_set1_ps(constants.weights[tapY * 5 + tapX]));
+					weight = _mm_and_ps(weight, _mm_cmpeq_ps(_mm_loadu_ps(&guides.meshIDs[tap]), centerID));
+
+					sumR = _mm_add_ps(sumR, _mm_mul_ps(tapR, weight));
+					sumG = _mm_add_ps(sumG, _mm_mul_ps(tapG, weight));
+					sumB = _mm_add_ps(sumB, _mm_mul_ps(tapB, weight));
+					weightSum = _mm_add_ps(weightSum, weight);
+				}
+			}
+
+			__m128 filtered[3] = { _mm_div_ps(sumR, weightSum), _mm_div_ps(sumG, weightSum), _mm_div_ps(sumB, weightSum) };
+			__m128 original[3] = { centerR, centerG, centerB };
+			for (int channel = 0; channel < 3; channel++)
+			{
+				_mm_storeu_ps(&destination[channel][center], _mm_or_ps(_mm_and_ps(sky, original[channel]), _mm_andnot_ps(sky, filtered[channel])));
+			}
+		}
+#endif
+	}
+
+	Denoiser::Denoiser(unsigned int threadCount) : threadCount(threadCount == 0 ? ESL::ThreadCount() : threadCount)
+	{
+	}
+
+	void Denoiser::TraceGuides(const InstanceTracer& tracer, const WavefrontRenderer::View& view, Guides& guides) const
+	{
+		ResizeGuides(view, guides);
+		ESL::ParallelFor(view.height, [&](size_t begin, size_t end, unsigned int)
+		{
+			for (size_t y = begin; y < end; y++)
+			{
+				for (unsigned int x = 0; x < view.width; x++)
+				{
+					TraceGuide(tracer, view, x, (unsigned int)y, guides);
+				}
+			}
+		}, threadCount);
+	}
+
+	void Denoiser::TraceGuides(const InstanceTracer& tracer, const WavefrontRenderer::View& view, const unsigned int* pixels, size_t pixelCount, Guides& guides) const
+	{
+		ResizeGuides(view, guides);
+		ESL::ParallelFor(pixelCount, [&](size_t begin, size_t end, unsigned int)
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				TraceGuide(tracer, view, pixels[i] % view.width, pixels[i] / view.width, guides);
+			}
+		}, threadCount);
+	}
+
+	void Denoiser::ResizeGuides(const WavefrontRenderer::View& view, Guides& guides)
+	{
+		size_t pixelCount = (size_t)view.width * view.height;
+		guides.width = view.width;
+		guides.height = view.height;
+		guides.normalX.resize(pixelCount);
+		guides.normalY.resize(pixelCount);
+		guides.normalZ.resize(pixelCount);
+		guides.distances.resize(pixelCount);
+		guides.meshIDs.resize(pixelCount);
+		guides.albedoR.resize(pixelCount);
+		guides.albedoG.resize(pixelCount);
+		guides.albedoB.resize(pixelCount);
+	}
+
+	void Denoiser::TraceGuide(const InstanceTracer& tracer, const WavefrontRenderer::View& view, unsigned int x, unsigned int y, Guides& guides)
+	{
+		size_t pixel = (size_t)y * view.width + x;
+		MeshTracer::Ray ray = WavefrontRenderer::CameraRay(view, x, y);
+		InstanceTracer::Hit hit = tracer.Trace(ray);
+		bool ground = RenderScene::IntersectGround(ray, hit);
+		if (hit.distance == INFINITY)
+		{
+			guides.normalX[pixel] = 0;
+			guides.normalY[pixel] = 0;
+			guides.normalZ[pixel] = 0;
+			guides.distances[pixel] = RenderScene::skyDistance;
+			guides.meshIDs[pixel] = (float)RenderScene::skyID;
+			guides.albedoR[pixel] = 1;
+			guides.albedoG[pixel] = 1;
+			guides.albedoB[pixel] = 1;
+			return;
+		}
+
+		float side = hit.normal[0] * ray.direction[0] + hit.normal[1] * ray.direction[1] + hit.normal[2] * ray.direction[2] > 0 ? -1.0f : 1.0f;
+		guides.normalX[pixel] = hit.normal[0] * side;
+		guides.normalY[pixel] = hit.normal[1] * side;
+		guides.normalZ[pixel] = hit.normal[2] * side;
+		guides.distances[pixel] = hit.distance;
+		guides.meshIDs[pixel] = (float)(ground ? RenderScene::groundID : RenderScene::meshID);
+		float groundAlbedo = ground ? RenderScene::GroundAlbedo(hit.position[0], hit.position[2]) : 0.0f;
+		guides.albedoR[pixel] = ground ? groundAlbedo : RenderScene::meshAlbedo[0];
+		guides.albedoG[pixel] = ground ? groundAlbedo : RenderScene::meshAlbedo[1];
+		guides.albedoB[pixel] = ground ? groundAlbedo : RenderScene::meshAlbedo[2];
+	}
+
+	void Denoiser::Filter(const float* image, const Guides& guides, const Settings& settings, float* output)
+	{
+		size_t pixelCount = (size_t)guides.width * guides.height;
+		for (int set = 0; set < 2; set++)
+		{
+			for (int channel = 0; channel < 3; channel++)
+			{
+				planes[set][channel].resize(pixelCount);
+			}
+		}
+		for (size_t i = 0; i < pixelCount; i++)
+		{
+			planes[0][0][i] = image[i * 3] / guides.albedoR[i];
+			planes[0][1][i] = image[i * 3 + 1] / guides.albedoG[i];
+			planes[0][2][i] = image[i * 3 + 2] / guides.albedoB[i];
+		}
+
+		for (unsigned int iteration = 0; iteration < settings.iterations; iteration++)
+		{
+			FilterIteration(guides, settings, iteration, planes[iteration % 2], planes[(iteration + 1) % 2]);
+		}
+
+		const std::vector<float>* result = planes[settings.iterations % 2];
+		for (size_t i = 0; i < pixelCount; i++)
+		{
+			output[i * 3] = result[0][i] * guides.albedoR[i];
+			output[i * 3 + 1] = result[1][i] * guides.albedoG[i];
+			output[i * 3 + 2] = result[2][i] * guides.albedoB[i];
+		}
+	}
+
+	void Denoiser::FilterIteration(const Guides& guides, const Settings& settings, unsigned int iteration, const std::vector<float>* source, std::vector<float>* destination) const
+	{
+		IterationConstants constants;
+		constants.step = 1 << iteration;
+		float colorSigma = settings.colorSigma / (float)constants.step;
+		constants.colorScale = 1.0f / (colorSigma * colorSigma);
+		for (int tapY = 0; tapY < 5; tapY++)
+		{
+			for (int tapX = 0; tapX < 5; tapX++)
+			{
+				float offset = (float)constants.step * sqrtf((float)((tapX - 2) * (tapX - 2) + (tapY - 2) * (tapY - 2)));
+				constants.depthScales[tapY * 5 + tapX] = offset == 0 ? 0.0f : 1.0f / (settings.depthSigma * offset);
+				constants.weights[tapY * 5 + tapX] = kernel[tapX] * kernel[tapY];
+			}
+		}
+
+		ESL::ParallelFor(guides.height, [&](size_t begin, size_t end, unsigned int)
+		{
+			for (int y = (int)begin; y < (int)end; y++)
+			{
+				int x = 0;
+#if defined(_M_X64) || defined(__SSE2__)
+				int border = 2 * constants.step; //Pixels closer to the sides than this have taps outside the image
+				for (; x < (int)guides.width && x < border; x++)
+				{
+					FilterPixel(guides, constants, source, destination, x, y);
+				}
+				for (; x + 4 + border <= (int)guides.width; x += 4)
+				{
+					FilterBlock(guides, constants, source, destination, x, y);
+				}
+#endif
+				for (; x < (int)guides.width; x++)
+				{
+					FilterPixel(guides, constants, source, destination, x, y);
+				}
+			}
+		}, threadCount);
+	}
+}
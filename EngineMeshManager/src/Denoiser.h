@@ -0,0 +1,53 @@
+#pragma once
+
+#include "WavefrontRenderer.h"
+
+#include <vector>
+
+namespace MeshManagement
+{
+	//Edge avoiding à-trous wavelet filter (Dammertz et al. 2010) for path traced images, the CPU version of Shaders/Denoise.hlsl.
+	//Every iteration blurs with a 5x5 B3 spline kernel whose taps are 2^iteration pixels apart, weighting each tap by how closely
+	//its colour, normal, distance and mesh id match the centre pixel. Noise is averaged within a surface but not across its edges,
+	//and five iterations cover a 125 pixel wide footprint for 25 taps each. The image is divided by the albedo of the primary hit
+	//before filtering and multiplied back after, so textures stay sharp. Four pixels are filtered at a time with SSE2.
+	class __declspec(dllexport) Denoiser
+	{
+	public:
+		Denoiser(unsigned int threadCount = 0);
+	public:
+		struct Settings
+		{
+			unsigned int iterations = 5;
+			float colorSigma = 2.0f; //Colour distance where a tap's weight falls to 1/e, halved every iteration as the noise drops
+			float depthSigma = 0.02f; //Distance difference per pixel of tap offset, relative to the centre's distance, where the weight falls to 1/e
+		};
+		//Primary hit of every pixel, planar and row major. On the GPU these are GeomertyHistoryBuffer and motionBuffer.z.
+		struct Guides
+		{
+			unsigned int width = 0;
+			unsigned int height = 0;
+			std::vector<float> normalX, normalY, normalZ; //Facing the camera, zero for the sky
+			std::vector<float> distances;
+			std::vector<float> meshIDs; //RenderScene ids, stored as floats to compare alongside the other guides
+			std::vector<float> albedoR, albedoG, albedoB; //One for the sky
+		};
+	public:
+		//Fills guides from rays through view's pixel centres
+		void TraceGuides(const InstanceTracer& tracer, const WavefrontRenderer::View& view, Guides& guides) const;
+		//Fills only the listed pixels, row major indices, leaving the rest of guides as it was
+		void TraceGuides(const InstanceTracer& tracer, const WavefrontRenderer::View& view, const unsigned int* pixels, size_t pixelCount, Guides& guides) const;
+		//Filters guides.width * guides.height RGB values, row major. image and output may be the same.
+		void Filter(const float* image, const Guides& guides, const Settings& settings, float* output);
+	private:
+		static void ResizeGuides(const WavefrontRenderer::View& view, Guides& guides);
+		static void TraceGuide(const InstanceTracer& tracer, const WavefrontRenderer::View& view, unsigned int x, unsigned int y, Guides& guides);
+		void FilterIteration(const Guides& guides, const Settings& settings, unsigned int iteration, const std::vector<float>* source, std::vector<float>* destination) const;
+	private:
+		unsigned int threadCount;
+#pragma warning(push)
+#pragma warning(disable:4251)
+		std::vector<float> planes[2][3]; //Ping pong RGB planes, iterations read one set and write the other
+#pragma warning(pop)
+	};
+}
@@ -0,0 +1,318 @@
+#include "FileWatcher.h"
+#include "EngineLogger.h"
+
+#include <chrono>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <Windows.h>
+#else
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+namespace MeshManagement
+{
+	namespace
+	{
+		const int watchPollMilliseconds = 100; //How long the watcher blocks before checking whether it should stop
+		const size_t notificationBufferSize = 16384;
+	}
+
+	FileWatcher::FileWatcher(std::function<void(const std::string& path)> onChanged) : onChanged(onChanged)
+	{
+#ifndef _WIN32
+		inotifyDescriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		if (inotifyDescriptor < 0)
+		{
+			DEBUGERROR("FileWatcher Failed: Could not initialize inotify")
+			return;
+		}
+#endif
+		watchThread = std::thread(&FileWatcher::WatchLoop, this);
+	}
+
+	FileWatcher::~FileWatcher()
+	{
+		{
+			std::lock_guard<std::mutex> lock(watchMutex);
+			stopWatching = true;
+		}
+		if (watchThread.joinable())
+		{
+			watchThread.join();
+		}
+
+		for (size_t i = 0; i < directories.size(); i++)
+		{
+			StopWatching(directories[i]);
+		}
+#ifndef _WIN32
+		if (inotifyDescriptor >= 0)
+		{
+			close(inotifyDescriptor);
+		}
+#endif
+	}
+
+	void FileWatcher::Watch(const std::string& path)
+	{
+		size_t separator = path.find_last_of("/\\");
+		std::string directory = separator == std::string::npos ? std::string(".") : path.substr(0, separator);
+		std::string fileName = separator == std::string::npos ? path : path.substr(separator + 1);
+
+		std::lock_guard<std::mutex> lock(watchMutex);
+		for (size_t i = 0; i < directories.size(); i++)
+		{
+			if (directories[i].directory == directory)
+			{
+				for (size_t j = 0; j < directories[i].files.size(); j++)
+				{
+					if (directories[i].files[j].first == fileName)
+					{
+						return;
+					}
+				}
+				directories[i].files.push_back({ fileName, path });
+				return;
+			}
+		}
+
+		//Started by the watcher's thread, on Windows pending reads are cancelled when the thread that issued them exits
+		WatchedDirectory watched;
+		watched.directory = directory;
+		watched.files.push_back({ fileName, path });
+		directories.push_back(std::move(watched));
+	}
+
+	void FileWatcher::FileChanged(const WatchedDirectory& directory, const std::string& fileName, std::vector<std::string>& changedPaths) const
+	{
+		for (size_t i = 0; i < directory.files.size(); i++)
+		{
+#ifdef _WIN32
+			bool matches = _stricmp(directory.files[i].first.c_str(), fileName.c_str()) == 0;
+#else
+			bool matches = directory.files[i].first == fileName;
+#endif
+			if (matches)
+			{
+				changedPaths.push_back(directory.files[i].second);
+			}
+		}
+	}
+
+#ifdef _WIN32
+	void FileWatcher::StartWatching(WatchedDirectory& directory)
+	{
+		if (directory.handle == nullptr)
+		{
+			HANDLE handle = CreateFileA(directory.directory.c_str(), FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+			if (handle == INVALID_HANDLE_VALUE)
+			{
+				DEBUGERROR("FileWatcher Failed: Could not open directory " + directory.directory)
+				directory.handle = INVALID_HANDLE_VALUE;
+				return;
+			}
+
+			OVERLAPPED* overlapped = new OVERLAPPED();
+			overlapped->hEvent = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+			directory.handle = handle;
+			directory.overlapped = overlapped;
+			directory.buffer.resize(notificationBufferSize);
+		}
+		if (directory.handle == INVALID_HANDLE_VALUE)
+		{
+			return;
+		}
+
+		OVERLAPPED* overlapped = (OVERLAPPED*)directory.overlapped;
+		ResetEvent(overlapped->hEvent);
+		if (!ReadDirectoryChangesW(directory.handle, directory.buffer.data(), (DWORD)directory.buffer.size(), FALSE, FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME, nullptr, overlapped, nullptr))
+		{
+			DEBUGERROR("FileWatcher Failed: ReadDirectoryChangesW failed for " + directory.directory)
+		}
+	}
+
+	void FileWatcher::StopWatching(WatchedDirectory& directory)
+	{
+		if (directory.handle != nullptr && directory.handle != INVALID_HANDLE_VALUE)
+		{
+			OVERLAPPED* overlapped = (OVERLAPPED*)directory.overlapped;
+			CancelIo(directory.handle);
+			DWORD bytes;
+			GetOverlappedResult(directory.handle, overlapped, &bytes, TRUE);
+			CloseHandle(overlapped->hEvent);
+			CloseHandle(directory.handle);
+			delete overlapped;
+		}
+		directory.handle = nullptr;
+		directory.overlapped = nullptr;
+	}
+
+	void FileWatcher::WatchLoop()
+	{
+		std::vector<HANDLE> events;
+		std::vector<size_t> eventDirectories;
+		std::vector<std::string> changedPaths;
+		while (true)
+		{
+			events.clear();
+			eventDirectories.clear();
+			{
+				std::lock_guard<std::mutex> lock(watchMutex);
+				if (stopWatching)
+				{
+					return;
+				}
+
+				for (size_t i = 0; i < directories.size() && events.size() < MAXIMUM_WAIT_OBJECTS; i++)
+				{
+					if (directories[i].handle == nullptr)
+					{
+						StartWatching(directories[i]);
+					}
+					if (directories[i].handle != INVALID_HANDLE_VALUE)
+					{
+						events.push_back(((OVERLAPPED*)directories[i].overlapped)->hEvent);
+						eventDirectories.push_back(i);
+					}
+				}
+			}
+
+			if (events.size() == 0)
+			{
+				std::this_thread::sleep_for(std::chrono::milliseconds(watchPollMilliseconds));
+				continue;
+			}
+
+			DWORD result = WaitForMultipleObjects((DWORD)events.size(), events.data(), FALSE, watchPollMilliseconds);
+			if (result < WAIT_OBJECT_0 || result >= WAIT_OBJECT_0 + events.size())
+			{
+				continue;
+			}
+
+			changedPaths.clear();
+			{
+				std::lock_guard<std::mutex> lock(watchMutex);
+				WatchedDirectory& directory = directories[eventDirectories[result - WAIT_OBJECT_0]];
+
+				DWORD bytes = 0;
+				if (GetOverlappedResult(directory.handle, (OVERLAPPED*)directory.overlapped, &bytes, FALSE) && bytes > 0)
+				{
+					const unsigned char* notification = directory.buffer.data();
+					while (true)
+					{
+						const FILE_NOTIFY_INFORMATION* information = (const FILE_NOTIFY_INFORMATION*)notification;
+						if (information->Action == FILE_ACTION_MODIFIED || information->Action == FILE_ACTION_ADDED || information->Action == FILE_ACTION_RENAMED_NEW_NAME)
+						{
+							int wideLength = (int)(information->FileNameLength / sizeof(WCHAR));
+							int length = WideCharToMultiByte(CP_UTF8, 0, information->FileName, wideLength, nullptr, 0, nullptr, nullptr);
+							std::string fileName(length, '\0');
+							WideCharToMultiByte(CP_UTF8, 0, information->FileName, wideLength, &fileName[0], length, nullptr, nullptr);
+							FileChanged(directory, fileName, changedPaths);
+						}
+
+						if (information->NextEntryOffset == 0)
+						{
+							break;
+						}
+						notification += information->NextEntryOffset;
+					}
+				}
+
+				StartWatching(directory);
+			}
+
+			//The lock is released first, onChanged may take locks that are held around Watch
+			for (size_t i = 0; i < changedPaths.size(); i++)
+			{
+				onChanged(changedPaths[i]);
+			}
+		}
+	}
+#else
+	void FileWatcher::StartWatching(WatchedDirectory& directory)
+	{
+		directory.descriptor = inotify_add_watch(inotifyDescriptor, directory.directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+		if (directory.descriptor < 0)
+		{
+			DEBUGERROR("FileWatcher Failed: Could not watch directory " + directory.directory)
+			directory.descriptor = -2;
+		}
+	}
+
+	void FileWatcher::StopWatching(WatchedDirectory& directory)
+	{
+		if (directory.descriptor >= 0)
+		{
+			inotify_rm_watch(inotifyDescriptor, directory.descriptor);
+		}
+		directory.descriptor = -1;
+	}
+
+	void FileWatcher::WatchLoop()
+	{
+		std::vector<unsigned char> buffer(notificationBufferSize);
+		std::vector<std::string> changedPaths;
+		while (true)
+		{
+			{
+				std::lock_guard<std::mutex> lock(watchMutex);
+				if (stopWatching)
+				{
+					return;
+				}
+
+				for (size_t i = 0; i < directories.size(); i++)
+				{
+					if (directories[i].descriptor == -1)
+					{
+						StartWatching(directories[i]);
+					}
+				}
+			}
+
+			pollfd descriptor = { inotifyDescriptor, POLLIN, 0 };
+			if (poll(&descriptor, 1, watchPollMilliseconds) <= 0)
+			{
+				continue;
+			}
+
+			ssize_t length = read(inotifyDescriptor, buffer.data(), buffer.size());
+			if (length <= 0)
+			{
+				continue;
+			}
+
+			changedPaths.clear();
+			{
+				std::lock_guard<std::mutex> lock(watchMutex);
+				for (ssize_t offset = 0; offset < length;)
+				{
+					const inotify_event* event = (const inotify_event*)&buffer[offset];
+					if (event->len > 0)
+					{
+						for (size_t i = 0; i < directories.size(); i++)
+						{
+							if (directories[i].descriptor == event->wd)
+							{
+								FileChanged(directories[i], std::string(event->name), changedPaths);
+							}
+						}
+					}
+					offset += sizeof(inotify_event) + event->len;
+				}
+			}
+
+			//The lock is released first, onChanged may take locks that are held around Watch
+			for (size_t i = 0; i < changedPaths.size(); i++)
+			{
+				onChanged(changedPaths[i]);
+			}
+		}
+	}
+#endif
+}
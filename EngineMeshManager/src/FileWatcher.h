@@ -0,0 +1,50 @@
+#pragma once
+
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace MeshManagement
+{
+	//Reports files that have been written to, using ReadDirectoryChangesW on Windows and inotify on Linux. Each watched file's
+	//directory is watched, since editors often replace a file by renaming a temporary one over it.
+	class __declspec(dllexport) FileWatcher
+	{
+	public:
+		//onChanged is called from the watcher's thread with the path as it was passed to Watch, without the watcher's lock held so
+		//it may call Watch or take locks of its own that are held around Watch
+		FileWatcher(std::function<void(const std::string& path)> onChanged);
+		~FileWatcher();
+		FileWatcher(const FileWatcher&) = delete;
+		FileWatcher& operator=(const FileWatcher&) = delete;
+	public:
+		void Watch(const std::string& path);
+	private:
+		struct WatchedDirectory
+		{
+			std::string directory;
+			std::vector<std::pair<std::string, std::string>> files; //File name and the path it was watched with
+			void* handle = nullptr; //Directory handle on Windows
+			void* overlapped = nullptr;
+			std::vector<unsigned char> buffer;
+			int descriptor = -1; //inotify watch descriptor on Linux
+		};
+	private:
+		void WatchLoop();
+		void StartWatching(WatchedDirectory& directory);
+		void StopWatching(WatchedDirectory& directory);
+		void FileChanged(const WatchedDirectory& directory, const std::string& fileName, std::vector<std::string>& changedPaths) const;
+	private:
+		bool stopWatching = false;
+		int inotifyDescriptor = -1;
+#pragma warning(push)
+#pragma warning(disable:4251)
+		std::function<void(const std::string& path)> onChanged;
+		std::mutex watchMutex;
+		std::vector<WatchedDirectory> directories;
+		std::thread watchThread;
+#pragma warning(pop)
+	};
+}
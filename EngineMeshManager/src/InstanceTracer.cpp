@@ -0,0 +1,243 @@
+#include "InstanceTracer.h"
+#include "RayBatch.h"
+#include "Engine/Graphics/Matrix.h"
+
+#include <math.h>
+
+namespace MeshManagement
+{
+	namespace
+	{
+		const unsigned int boundsBatchSize = 64; //Instances whose bounds are tested together before any of them is traversed
+	}
+
+	InstanceTracer::InstanceTracer(const MeshManager& meshManager, bool useMeshlets) : transforms(meshManager.GetInstanceTransforms())
+	{
+		unsigned int instanceCount = meshManager.GetInstanceCount();
+		std::vector<unsigned int> meshTracers(meshManager.GetMeshCount(), 4294967295);
+		instanceTracers.resize(instanceCount);
+		for (int axis = 0; axis < 3; axis++)
+		{
+			boundsMin[axis].resize(instanceCount);
+			boundsMax[axis].resize(instanceCount);
+		}
+
+		for (unsigned int i = 0; i < instanceCount; i++)
+		{
+			MeshHandle handle = meshManager.GetInstance(i).mesh;
+			uint16_t meshIndex = meshManager.GetMeshIndex(handle);
+			const Mesh& mesh = meshManager.GetMesh(handle);
+			if (meshTracers[meshIndex] == 4294967295)
+			{
+				meshTracers[meshIndex] = (unsigned int)tracers.size();
+				tracers.push_back(MeshTracer(mesh, useMeshlets));
+			}
+			instanceTracers[i] = meshTracers[meshIndex];
+
+			//World bounds around the transformed corners of the mesh's root box, empty for meshes without a hierarchy and for
+			//singular transforms, so rays never reach them
+			float worldMin[3] = { INFINITY, INFINITY, INFINITY };
+			float worldMax[3] = { -INFINITY, -INFINITY, -INFINITY };
+			if (mesh.rootIndex != 4294967295 && transforms.singular[i] == 0)
+			{
+				const Mesh::AABB& aabb = mesh.nodeHierarchy[mesh.rootIndex].aabb;
+				Matrix3x4<float> objectToWorld = Matrix3x4<float>(transforms.objectToWorld[0][i], transforms.objectToWorld[1][i], transforms.objectToWorld[2][i], transforms.objectToWorld[3][i],
+					transforms.objectToWorld[4][i], transforms.objectToWorld[5][i], transforms.objectToWorld[6][i], transforms.objectToWorld[7][i],
+					transforms.objectToWorld[8][i], transforms.objectToWorld[9][i], transforms.objectToWorld[10][i], transforms.objectToWorld[11][i]);
+				for (int corner = 0; corner < 8; corner++)
+				{
+					Vector3<float> point = objectToWorld.TransformPoint(Vector3<float>((corner & 1) ? aabb.bx : aabb.ax, (corner & 2) ? aabb.by : aabb.ay, (corner & 4) ? aabb.bz : aabb.az));
+					const float coordinates[3] = { point.x, point.y, point.z };
+					for (int axis = 0; axis < 3; axis++)
+					{
+						worldMin[axis] = fminf(worldMin[axis], coordinates[axis]);
+						worldMax[axis] = fmaxf(worldMax[axis], coordinates[axis]);
+					}
+				}
+			}
+			for (int axis = 0; axis < 3; axis++)
+			{
+				boundsMin[axis][i] = worldMin[axis];
+				boundsMax[axis][i] = worldMax[axis];
+			}
+		}
+	}
+
+	void InstanceTracer::IntersectBounds(const MeshTracer::Ray& ray, const float inverseDirection[3], unsigned int firstInstance, unsigned int count, float entries[]) const
+	{
+		//Straight loops over the bounds arrays so the compiler can test several instances per instruction
+		const float* minX = &boundsMin[0][firstInstance];
+		const float* minY = &boundsMin[1][firstInstance];
+		const float* minZ = &boundsMin[2][firstInstance];
+		const float* maxX = &boundsMax[0][firstInstance];
+		const float* maxY = &boundsMax[1][firstInstance];
+		const float* maxZ = &boundsMax[2][firstInstance];
+		for (unsigned int i = 0; i < count; i++)
+		{
+			float tx1 = (minX[i] - ray.origin[0]) * inverseDirection[0];
+			float tx2 = (maxX[i] - ray.origin[0]) * inverseDirection[0];
+			float ty1 = (minY[i] - ray.origin[1]) * inverseDirection[1];
+			float ty2 = (maxY[i] - ray.origin[1]) * inverseDirection[1];
+			float tz1 = (minZ[i] - ray.origin[2]) * inverseDirection[2];
+			float tz2 = (maxZ[i] - ray.origin[2]) * inverseDirection[2];
+
+			float minT = fmaxf(fmaxf(fminf(tx1, tx2), fminf(ty1, ty2)), fminf(tz1, tz2));
+			float maxT = fminf(fminf(fmaxf(tx1, tx2), fmaxf(ty1, ty2)), fmaxf(tz1, tz2));
+			entries[i] = (maxT >= minT && maxT >= 0) ? fmaxf(minT, 0.0f) : INFINITY;
+		}
+	}
+
+	MeshTracer::Ray InstanceTracer::ToObjectSpace(const MeshTracer::Ray& ray, unsigned int instance) const
+	{
+		//The direction isn't renormalized, so distances along the object space ray equal world space distances
+		const std::vector<float>* m = transforms.worldToObject;
+		MeshTracer::Ray objectRay;
+		for (int row = 0; row < 3; row++)
+		{
+			objectRay.origin[row] = m[row * 4][instance] * ray.origin[0] + m[row * 4 + 1][instance] * ray.origin[1] + m[row * 4 + 2][instance] * ray.origin[2] + m[row * 4 + 3][instance];
+			objectRay.direction[row] = m[row * 4][instance] * ray.direction[0] + m[row * 4 + 1][instance] * ray.direction[1] + m[row * 4 + 2][instance] * ray.direction[2];
+		}
+		return objectRay;
+	}
+
+	InstanceTracer::Intersection InstanceTracer::Intersect(const MeshTracer::Ray& ray, MeshTracer::Statistics* statistics, float maxDistance) const
+	{
+		Intersection intersection;
+		intersection.mesh.distance = maxDistance;
+		intersection.mesh.barycentrics[0] = 0;
+		intersection.mesh.barycentrics[1] = 0;
+		intersection.mesh.triangleIndex = 4294967295;
+		intersection.instanceIndex = 4294967295;
+
+		float inverseDirection[3] = { 1.0f / ray.direction[0], 1.0f / ray.direction[1], 1.0f / ray.direction[2] };
+		float entries[boundsBatchSize];
+		MeshTracer::Statistics meshStatistics;
+
+		unsigned int instanceCount = (unsigned int)instanceTracers.size();
+		for (unsigned int first = 0; first < instanceCount; first += boundsBatchSize)
+		{
+			unsigned int count = instanceCount - first < boundsBatchSize ? instanceCount - first : boundsBatchSize;
+			IntersectBounds(ray, inverseDirection, first, count, entries);
+			for (unsigned int i = 0; i < count; i++)
+			{
+				if (entries[i] >= intersection.mesh.distance)
+				{
+					continue;
+				}
+
+				MeshTracer::Intersection candidate = tracers[instanceTracers[first + i]].Intersect(ToObjectSpace(ray, first + i), &meshStatistics, intersection.mesh.distance);
+				if (candidate.triangleIndex != 4294967295)
+				{
+					intersection.mesh = candidate;
+					intersection.instanceIndex = first + i;
+				}
+			}
+		}
+
+		if (statistics != nullptr)
+		{
+			statistics->rays++;
+			statistics->nodesVisited += meshStatistics.nodesVisited;
+			statistics->positionFetches += meshStatistics.positionFetches;
+		}
+
+		return intersection;
+	}
+
+	InstanceTracer::Hit InstanceTracer::GetHit(const MeshTracer::Ray& ray, const Intersection& intersection, MeshTracer::Statistics* statistics) const
+	{
+		Hit hit;
+		hit.distance = intersection.mesh.distance;
+		hit.position[0] = 0;
+		hit.position[1] = 0;
+		hit.position[2] = 0;
+		hit.normal[0] = 0;
+		hit.normal[1] = 0;
+		hit.normal[2] = 0;
+		hit.UV[0] = 0;
+		hit.UV[1] = 0;
+		hit.triangleIndex = intersection.mesh.triangleIndex;
+		hit.instanceIndex = intersection.instanceIndex;
+
+		if (hit.instanceIndex != 4294967295)
+		{
+			//Attributes are only read for the closest instance. Normals go back to world space through the transpose of the inverse transform.
+			unsigned int instance = hit.instanceIndex;
+			MeshTracer::Hit objectHit = tracers[instanceTracers[instance]].GetHit(ToObjectSpace(ray, instance), intersection.mesh, statistics);
+			const std::vector<float>* m = transforms.worldToObject;
+			for (int i = 0; i < 3; i++)
+			{
+				hit.position[i] = ray.origin[i] + ray.direction[i] * hit.distance;
+				hit.normal[i] = m[i][instance] * objectHit.normal[0] + m[4 + i][instance] * objectHit.normal[1] + m[8 + i][instance] * objectHit.normal[2];
+			}
+			float magnitude = sqrtf(hit.normal[0] * hit.normal[0] + hit.normal[1] * hit.normal[1] + hit.normal[2] * hit.normal[2]);
+			if (magnitude > 0)
+			{
+				hit.normal[0] /= magnitude;
+				hit.normal[1] /= magnitude;
+				hit.normal[2] /= magnitude;
+			}
+			hit.UV[0] = objectHit.UV[0];
+			hit.UV[1] = objectHit.UV[1];
+		}
+
+		return hit;
+	}
+
+	InstanceTracer::Hit InstanceTracer::Trace(const MeshTracer::Ray& ray, MeshTracer::Statistics* statistics, float maxDistance) const
+	{
+		return GetHit(ray, Intersect(ray, statistics, maxDistance), statistics);
+	}
+
+	bool InstanceTracer::Occluded(const MeshTracer::Ray& ray, MeshTracer::Statistics* statistics, float maxDistance) const
+	{
+		float inverseDirection[3] = { 1.0f / ray.direction[0], 1.0f / ray.direction[1], 1.0f / ray.direction[2] };
+		float entries[boundsBatchSize];
+		MeshTracer::Statistics meshStatistics;
+		bool occluded = false;
+
+		unsigned int instanceCount = (unsigned int)instanceTracers.size();
+		for (unsigned int first = 0; first < instanceCount && !occluded; first += boundsBatchSize)
+		{
+			unsigned int count = instanceCount - first < boundsBatchSize ? instanceCount - first : boundsBatchSize;
+			IntersectBounds(ray, inverseDirection, first, count, entries);
+			for (unsigned int i = 0; i < count && !occluded; i++)
+			{
+				if (entries[i] < maxDistance)
+				{
+					occluded = tracers[instanceTracers[first + i]].Occluded(ToObjectSpace(ray, first + i), &meshStatistics, maxDistance);
+				}
+			}
+		}
+
+		if (statistics != nullptr)
+		{
+			statistics->rays++;
+			statistics->nodesVisited += meshStatistics.nodesVisited;
+			statistics->positionFetches += meshStatistics.positionFetches;
+		}
+
+		return occluded;
+	}
+
+	void InstanceTracer::IntersectBatch(const MeshTracer::Ray* rays, size_t rayCount, BatchHit* hits, float maxDistance, unsigned int threadCount) const
+	{
+		RayBatch::Run(rays, rayCount, threadCount, [&](unsigned int i)
+		{
+			Intersection intersection = Intersect(rays[i], nullptr, maxDistance);
+			hits[i].distance = intersection.mesh.distance;
+			hits[i].barycentrics[0] = intersection.mesh.barycentrics[0];
+			hits[i].barycentrics[1] = intersection.mesh.barycentrics[1];
+			hits[i].triangleIndex = intersection.mesh.triangleIndex;
+			hits[i].instanceIndex = intersection.instanceIndex;
+		});
+	}
+
+	void InstanceTracer::OccludedBatch(const MeshTracer::Ray* rays, size_t rayCount, unsigned char* mask, float maxDistance, unsigned int threadCount) const
+	{
+		RayBatch::Run(rays, rayCount, threadCount, [&](unsigned int i)
+		{
+			mask[i] = Occluded(rays[i], nullptr, maxDistance) ? 1 : 0;
+		});
+	}
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "MeshManager.h"
+#include "MeshTracer.h"
+
+#include <vector>
+
+namespace MeshManagement
+{
+	//Traces every instance in a MeshManager. Rays are moved into each instance's object space, so instances of one mesh share
+	//its hierarchy. Holds pointers to the manager's meshes and copies its instance transforms, rebuild it after either changes.
+	class __declspec(dllexport) InstanceTracer
+	{
+	public:
+		InstanceTracer(const MeshManager& meshManager, bool useMeshlets = false);
+	public:
+		struct Hit
+		{
+			float distance;
+			float position[3]; //World space
+			float normal[3]; //World space
+			float UV[2];
+			unsigned int triangleIndex;
+			unsigned int instanceIndex;
+		};
+		struct Intersection
+		{
+			MeshTracer::Intersection mesh; //Barycentrics and indices within the instanced mesh, distance in world units
+			unsigned int instanceIndex; //4294967295 on a miss
+		};
+	public:
+		Hit Trace(const MeshTracer::Ray& ray, MeshTracer::Statistics* statistics = nullptr, float maxDistance = INFINITY) const;
+		Intersection Intersect(const MeshTracer::Ray& ray, MeshTracer::Statistics* statistics = nullptr, float maxDistance = INFINITY) const;
+		Hit GetHit(const MeshTracer::Ray& ray, const Intersection& intersection, MeshTracer::Statistics* statistics = nullptr) const; //Interpolates the attributes at an intersection of ray
+		bool Occluded(const MeshTracer::Ray& ray, MeshTracer::Statistics* statistics = nullptr, float maxDistance = INFINITY) const;
+	public:
+		//Same as MeshTracer::IntersectBatch and OccludedBatch, over every instance
+		void IntersectBatch(const MeshTracer::Ray* rays, size_t rayCount, BatchHit* hits, float maxDistance = INFINITY, unsigned int threadCount = 0) const;
+		void OccludedBatch(const MeshTracer::Ray* rays, size_t rayCount, unsigned char* mask, float maxDistance = INFINITY, unsigned int threadCount = 0) const;
+	private:
+		//Entry distance of the ray into each world bounds in [firstInstance, firstInstance + count), or INFINITY if it misses
+		void IntersectBounds(const MeshTracer::Ray& ray, const float inverseDirection[3], unsigned int firstInstance, unsigned int count, float entries[]) const;
+		MeshTracer::Ray ToObjectSpace(const MeshTracer::Ray& ray, unsigned int instance) const;
+	private:
+#pragma warning(push)
+#pragma warning(disable:4251)
+		std::vector<MeshTracer> tracers; //One per mesh that has an instance
+		std::vector<unsigned int> instanceTracers;
+		MeshManager::InstanceTransforms transforms;
+		std::vector<float> boundsMin[3]; //World space bounds of each instance
+		std::vector<float> boundsMax[3];
+#pragma warning(pop)
+	};
+}
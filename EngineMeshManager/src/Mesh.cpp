@@ -1,80 +1,96 @@
 #include "Mesh.h"
+#include "EngineStandard/Arena.h"
+#include "EngineStandard/Hash.h"
 
 #include <stack>
+#include <algorithm>
+#include <math.h>
 
 Mesh::Mesh(std::string name) : meshName(name) {}
 
-void Mesh::AddTriangle(Mesh::Vertex triangleVertices[3])
+void Mesh::Reserve(size_t triangleCount)
 {
-	Triangle triangle;
+	//A closed mesh has about half as many vertices as triangles, and the hierarchy has one node less than twice the leaves
+	triangles.reserve(triangleCount);
+	nodeHierarchy.reserve(triangleCount * 2);
+	positions.reserve(triangleCount / 2 + 3);
+	attributes.reserve(triangleCount / 2 + 3);
+}
+
+void Mesh::AddTriangle(Mesh::Vertex triangleVertices[3], ESL::Arena& scratch)
+{
+	AppendTriangle(triangleVertices);
+	InsertIntoHierarchy((unsigned int)triangles.size() - 1, scratch);
+}
 
-	unsigned int indices1 = 0x00000000; //The first 32 bit number containing the first and second vertices
-	unsigned int indices2 = 0x00000000; //The second 32 bit number containing the second and third vertices
+void Mesh::AppendTriangle(Mesh::Vertex triangleVertices[3])
+{
+	unsigned int triangleIndices[3];
 
 	for (unsigned int vert = 0; vert < 3; vert++) //Loop through triangle's vertices
 	{
 		unsigned int vertexIndex = 0;
 		bool foundDuplicate = false;
-		if (vertices.size() > 0)
+		if (positions.size() > 0)
 		{
-			for (long long int index = (long long int)(vertices.size() - 1); index >= 0; index--) //Loop through all current vertices starting at top
+			for (long long int index = (long long int)(positions.size() - 1); index >= 0; index--) //Loop through all current vertices starting at top
 			{
-				bool isDuplicate = (abs(vertices[index].position[0] - triangleVertices[vert].position[0]) < 0.001 &&
-					abs(vertices[index].position[1] - triangleVertices[vert].position[1]) < 0.001 &&
-					abs(vertices[index].position[2] - triangleVertices[vert].position[2]) < 0.001);
+				bool isDuplicate = (abs(positions[index].position[0] - triangleVertices[vert].position[0]) < 0.001 &&
+					abs(positions[index].position[1] - triangleVertices[vert].position[1]) < 0.001 &&
+					abs(positions[index].position[2] - triangleVertices[vert].position[2]) < 0.001);
 
 				if (isDuplicate) //Test if this vertex already exists in a different triangle
 				{
 					vertexIndex = (unsigned int)index;
-					vertexUsedCount[index] += 1;
 					foundDuplicate = true;
-
-					vertices[index].normal[0] += triangleVertices[vert].normal[0];
-					vertices[index].normal[1] += triangleVertices[vert].normal[1];
-					vertices[index].normal[2] += triangleVertices[vert].normal[2];
-
 					break;
 				}
 			}
 		}
-		if (!foundDuplicate) //Add vertex to array if it doesn't already exist
-		{
-			vertexIndex = (unsigned int)vertices.size();
-			vertices.push_back(triangleVertices[vert]);
-			vertexUsedCount.push_back(1);
-		}
-		if (vert == 0)
-		{
-			indices1 = indices1 | (vertexIndex & 0x000fffff); //Mask first index
-		}
-		else if (vert == 1)
+		if (!foundDuplicate) //Add vertex to position and attribute streams if it doesn't already exist
 		{
-			indices1 = indices1 | ((vertexIndex << 20) & 0xfff00000); //Mask and shift second index
-			indices2 = indices2 | ((vertexIndex >> 12) & 0x000000ff);
-		}
-		else
-		{
-			indices2 = indices2 | ((vertexIndex << 8) & 0x0fffff00); //Mask and shift third index
+			vertexIndex = (unsigned int)positions.size();
+			positions.push_back({ { triangleVertices[vert].position[0], triangleVertices[vert].position[1], triangleVertices[vert].position[2] } });
+			attributes.push_back({ { triangleVertices[vert].normal[0], triangleVertices[vert].normal[1], triangleVertices[vert].normal[2] }, { triangleVertices[vert].UV[0], triangleVertices[vert].UV[1] } });
 		}
+		triangleIndices[vert] = vertexIndex;
 	}
 
-	triangle.indices1 = indices1;
-	triangle.indices2 = indices2;
+	triangles.push_back(PackIndices(triangleIndices));
+}
+
+void Mesh::BuildHierarchy(ESL::Arena& scratch)
+{
+	nodeHierarchy.clear();
+	nodeHierarchy.reserve(triangles.size() * 2);
+	rootIndex = 4294967295;
 
-	triangles.push_back(triangle);
+	for (unsigned int i = 0; i < triangles.size(); i++)
+	{
+		InsertIntoHierarchy(i, scratch);
+	}
+}
+
+void Mesh::InsertIntoHierarchy(unsigned int triangleIndex, ESL::Arena& scratch)
+{
+	unsigned int indices[3];
+	UnpackIndices(triangles[triangleIndex], indices);
+	const float* p0 = positions[indices[0]].position;
+	const float* p1 = positions[indices[1]].position;
+	const float* p2 = positions[indices[2]].position;
 
 	//Add to bounding volume hierarchy
 	{
 		AABB aabb; //Get bounding volume of triangle
-		aabb.ax = fminf(triangleVertices[0].position[0], fminf(triangleVertices[1].position[0], triangleVertices[2].position[0]));
-		aabb.ay = fminf(triangleVertices[0].position[1], fminf(triangleVertices[1].position[1], triangleVertices[2].position[1]));
-		aabb.az = fminf(triangleVertices[0].position[2], fminf(triangleVertices[1].position[2], triangleVertices[2].position[2]));
-		aabb.bx = fmaxf(triangleVertices[0].position[0], fmaxf(triangleVertices[1].position[0], triangleVertices[2].position[0]));
-		aabb.by = fmaxf(triangleVertices[0].position[1], fmaxf(triangleVertices[1].position[1], triangleVertices[2].position[1]));
-		aabb.bz = fmaxf(triangleVertices[0].position[2], fmaxf(triangleVertices[1].position[2], triangleVertices[2].position[2]));
+		aabb.ax = fminf(p0[0], fminf(p1[0], p2[0]));
+		aabb.ay = fminf(p0[1], fminf(p1[1], p2[1]));
+		aabb.az = fminf(p0[2], fminf(p1[2], p2[2]));
+		aabb.bx = fmaxf(p0[0], fmaxf(p1[0], p2[0]));
+		aabb.by = fmaxf(p0[1], fmaxf(p1[1], p2[1]));
+		aabb.bz = fmaxf(p0[2], fmaxf(p1[2], p2[2]));
 
 		Node node; //Create new leaf node
-		node.triangleIndex = (unsigned int)triangles.size() - 1;
+		node.triangleIndex = triangleIndex;
 		node.aabb = aabb;
 		node.isLeaf = 1;
 		node.parentIndex = 0;
@@ -91,9 +107,10 @@ void Mesh::AddTriangle(Mesh::Vertex triangleVertices[3])
 			return;
 		}
 
-		//Find best pair
+		//Find best pair, the queue lives in scratch memory which is handed back when this insert finishes
+		ESL::ArenaScope scratchScope(scratch);
 		unsigned int sibling = rootIndex;
-		std::stack<unsigned int> priorityQueue;
+		std::stack<unsigned int, ESL::ArenaVector<unsigned int>> priorityQueue((ESL::ArenaVector<unsigned int>(ESL::ArenaAllocator<unsigned int>(scratch))));
 		double bestCost = INFINITY;
 		priorityQueue.push(rootIndex);
 		while (priorityQueue.size() > 0)
@@ -322,9 +339,392 @@ void Mesh::AddTriangle(Mesh::Vertex triangleVertices[3])
 	}
 }
 
-std::vector<Mesh::LinkedNode> Mesh::GetLinkedNodeHierarchy()
+void Mesh::ReorderForLocality()
+{
+	if (rootIndex == 4294967295)
+	{
+		return;
+	}
+
+	//All remap tables fit in a single scratch block
+	ESL::Arena scratch(triangles.size() * sizeof(unsigned int) + positions.size() * sizeof(unsigned int) * 2 + 4096);
+	ESL::ArenaAllocator<unsigned int> allocator(scratch);
+
+	//Renumber triangles in the order a depth first traversal reaches their leaves
+	ESL::ArenaVector<unsigned int> triangleOrder(allocator); //Old triangle index for each new triangle index
+	triangleOrder.reserve(triangles.size());
+	{
+		std::stack<unsigned int, ESL::ArenaVector<unsigned int>> stack(allocator);
+		stack.push(rootIndex);
+		while (stack.size() > 0)
+		{
+			unsigned int currentIndex = stack.top();
+			stack.pop();
+
+			if (nodeHierarchy[currentIndex].isLeaf == 1)
+			{
+				triangleOrder.push_back(nodeHierarchy[currentIndex].triangleIndex);
+				nodeHierarchy[currentIndex].triangleIndex = (unsigned int)triangleOrder.size() - 1;
+			}
+			else
+			{
+				stack.push(nodeHierarchy[currentIndex].childBIndex);
+				stack.push(nodeHierarchy[currentIndex].childAIndex);
+			}
+		}
+	}
+
+	//Renumber vertices in the order the reordered triangles first use them
+	ESL::ArenaVector<unsigned int> vertexRemap(positions.size(), 4294967295, allocator); //New vertex index for each old vertex index
+	ESL::ArenaVector<unsigned int> vertexOrder(allocator); //Old vertex index for each new vertex index
+	vertexOrder.reserve(positions.size());
+
+	std::vector<Triangle> reorderedTriangles(triangleOrder.size());
+	for (unsigned int i = 0; i < triangleOrder.size(); i++)
+	{
+		unsigned int indices[3];
+		UnpackIndices(triangles[triangleOrder[i]], indices);
+
+		for (unsigned int vert = 0; vert < 3; vert++)
+		{
+			if (vertexRemap[indices[vert]] == 4294967295)
+			{
+				vertexRemap[indices[vert]] = (unsigned int)vertexOrder.size();
+				vertexOrder.push_back(indices[vert]);
+			}
+			indices[vert] = vertexRemap[indices[vert]];
+		}
+
+		reorderedTriangles[i] = PackIndices(indices);
+	}
+	triangles.swap(reorderedTriangles);
+
+	//Unreferenced vertices keep their relative order at the end
+	for (unsigned int vert = 0; vert < positions.size(); vert++)
+	{
+		if (vertexRemap[vert] == 4294967295)
+		{
+			vertexRemap[vert] = (unsigned int)vertexOrder.size();
+			vertexOrder.push_back(vert);
+		}
+	}
+
+	std::vector<VertexPosition> reorderedPositions(positions.size());
+	for (unsigned int vert = 0; vert < vertexOrder.size(); vert++)
+	{
+		reorderedPositions[vert] = positions[vertexOrder[vert]];
+	}
+	positions.swap(reorderedPositions);
+
+	if (attributes.size() == vertexOrder.size())
+	{
+		std::vector<VertexAttribute> reorderedAttributes(attributes.size());
+		for (unsigned int vert = 0; vert < vertexOrder.size(); vert++)
+		{
+			reorderedAttributes[vert] = attributes[vertexOrder[vert]];
+		}
+		attributes.swap(reorderedAttributes);
+	}
+
+	if (compressedAttributes.size() == vertexOrder.size())
+	{
+		std::vector<CompressedVertexAttribute> reorderedCompressedAttributes(compressedAttributes.size());
+		for (unsigned int vert = 0; vert < vertexOrder.size(); vert++)
+		{
+			reorderedCompressedAttributes[vert] = compressedAttributes[vertexOrder[vert]];
+		}
+		compressedAttributes.swap(reorderedCompressedAttributes);
+	}
+
+	if (meshlets.size() > 0) //Meshlets copied the old numbering
+	{
+		BuildMeshlets();
+	}
+}
+
+void Mesh::BuildMeshlets()
+{
+	meshlets.clear();
+	meshletVertices.clear();
+	meshletIndices.clear();
+	meshletHierarchy.clear();
+	meshletRootIndex = 4294967295;
+
+	if (triangles.size() == 0)
+	{
+		return;
+	}
+
+	//Grow each cluster from a seed triangle by repeatedly adding the neighbouring triangle that brings in the fewest new vertices
+	std::vector<unsigned int> unpacked(triangles.size() * 3);
+	for (unsigned int i = 0; i < triangles.size(); i++)
+	{
+		UnpackIndices(triangles[i], &unpacked[i * 3]);
+	}
+
+	std::vector<unsigned int> adjacencyOffsets(positions.size() + 1, 0); //Triangles using each vertex, in compressed rows
+	for (unsigned int i = 0; i < unpacked.size(); i++)
+	{
+		adjacencyOffsets[unpacked[i] + 1]++;
+	}
+	for (unsigned int vert = 0; vert < positions.size(); vert++)
+	{
+		adjacencyOffsets[vert + 1] += adjacencyOffsets[vert];
+	}
+	std::vector<unsigned int> adjacency(unpacked.size());
+	{
+		std::vector<unsigned int> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+		for (unsigned int i = 0; i < unpacked.size(); i++)
+		{
+			adjacency[fill[unpacked[i]]++] = i / 3;
+		}
+	}
+
+	std::vector<unsigned char> localIndex(positions.size(), 255); //Vertex's index in the open meshlet
+	std::vector<bool> assigned(triangles.size(), false);
+	std::vector<unsigned int> triangleOrder; //Old triangle index for each new triangle index
+	triangleOrder.reserve(triangles.size());
+	std::vector<AABB> meshletBounds;
+	meshletIndices.reserve(triangles.size() * 3);
+
+	auto newVertexCount = [&](unsigned int triangle)
+	{
+		const unsigned int* t = &unpacked[triangle * 3];
+		return (unsigned int)(localIndex[t[0]] == 255) + (unsigned int)(localIndex[t[1]] == 255 && t[1] != t[0]) + (unsigned int)(localIndex[t[2]] == 255 && t[2] != t[0] && t[2] != t[1]);
+	};
+
+	unsigned int nextSeed = 0;
+	while (triangleOrder.size() < triangles.size())
+	{
+		Meshlet meshlet;
+		meshlet.vertexOffset = (unsigned int)meshletVertices.size();
+		meshlet.triangleOffset = (unsigned int)triangleOrder.size();
+		meshlet.vertexCount = 0;
+		meshlet.triangleCount = 0;
+		AABB bounds = { INFINITY, INFINITY, INFINITY, -INFINITY, -INFINITY, -INFINITY };
+
+		while (meshlet.triangleCount < maxMeshletTriangles)
+		{
+			//Best neighbour of the vertices already in the meshlet
+			unsigned int best = 4294967295;
+			unsigned int bestNew = 4;
+			for (unsigned int local = 0; local < meshlet.vertexCount && bestNew > 0; local++)
+			{
+				unsigned int vert = meshletVertices[meshlet.vertexOffset + local];
+				for (unsigned int j = adjacencyOffsets[vert]; j < adjacencyOffsets[vert + 1]; j++)
+				{
+					unsigned int candidate = adjacency[j];
+					if (!assigned[candidate] && newVertexCount(candidate) < bestNew)
+					{
+						best = candidate;
+						bestNew = newVertexCount(candidate);
+					}
+				}
+			}
+
+			//Otherwise continue with the next unassigned triangle, which is nearby after ReorderForLocality
+			if (best == 4294967295)
+			{
+				while (nextSeed < triangles.size() && assigned[nextSeed])
+				{
+					nextSeed++;
+				}
+				if (nextSeed == triangles.size())
+				{
+					break;
+				}
+				best = nextSeed;
+				bestNew = newVertexCount(best);
+			}
+
+			if (meshlet.vertexCount + bestNew > maxMeshletVertices)
+			{
+				break;
+			}
+
+			assigned[best] = true;
+			triangleOrder.push_back(best);
+			for (unsigned int vert = 0; vert < 3; vert++)
+			{
+				unsigned int index = unpacked[best * 3 + vert];
+				if (localIndex[index] == 255)
+				{
+					localIndex[index] = meshlet.vertexCount;
+					meshletVertices.push_back(index);
+					meshlet.vertexCount++;
+				}
+				meshletIndices.push_back(localIndex[index]);
+
+				const float* position = positions[index].position;
+				bounds.ax = fminf(bounds.ax, position[0]);
+				bounds.ay = fminf(bounds.ay, position[1]);
+				bounds.az = fminf(bounds.az, position[2]);
+				bounds.bx = fmaxf(bounds.bx, position[0]);
+				bounds.by = fmaxf(bounds.by, position[1]);
+				bounds.bz = fmaxf(bounds.bz, position[2]);
+			}
+			meshlet.triangleCount++;
+		}
+
+		for (unsigned int local = 0; local < meshlet.vertexCount; local++)
+		{
+			localIndex[meshletVertices[meshlet.vertexOffset + local]] = 255;
+		}
+		meshlets.push_back(meshlet);
+		meshletBounds.push_back(bounds);
+	}
+
+	//Store triangles in meshlet order so meshlet triangle indices and mesh triangle indices agree
+	std::vector<unsigned int> triangleRemap(triangles.size());
+	std::vector<Triangle> reorderedTriangles(triangles.size());
+	for (unsigned int i = 0; i < triangleOrder.size(); i++)
+	{
+		triangleRemap[triangleOrder[i]] = i;
+		reorderedTriangles[i] = triangles[triangleOrder[i]];
+	}
+	triangles.swap(reorderedTriangles);
+	for (unsigned int i = 0; i < nodeHierarchy.size(); i++)
+	{
+		if (nodeHierarchy[i].isLeaf == 1)
+		{
+			nodeHierarchy[i].triangleIndex = triangleRemap[nodeHierarchy[i].triangleIndex];
+		}
+	}
+
+	//Top down median split hierarchy over the cluster bounds, one meshlet per leaf
+	struct BuildRange
+	{
+		unsigned int begin;
+		unsigned int end;
+		unsigned int parentIndex;
+		bool isChildB;
+	};
+	std::vector<unsigned int> order(meshlets.size());
+	for (unsigned int i = 0; i < order.size(); i++)
+	{
+		order[i] = i;
+	}
+	meshletHierarchy.reserve(meshlets.size() * 2);
+
+	std::stack<BuildRange> stack;
+	stack.push({ 0, (unsigned int)meshlets.size(), 4294967295, false });
+	while (stack.size() > 0)
+	{
+		BuildRange range = stack.top();
+		stack.pop();
+
+		Node node;
+		node.parentIndex = range.parentIndex;
+		node.childAIndex = 4294967295;
+		node.childBIndex = 4294967295;
+		node.aabb = meshletBounds[order[range.begin]];
+		for (unsigned int i = range.begin + 1; i < range.end; i++)
+		{
+			const AABB& bounds = meshletBounds[order[i]];
+			node.aabb.ax = fminf(node.aabb.ax, bounds.ax);
+			node.aabb.ay = fminf(node.aabb.ay, bounds.ay);
+			node.aabb.az = fminf(node.aabb.az, bounds.az);
+			node.aabb.bx = fmaxf(node.aabb.bx, bounds.bx);
+			node.aabb.by = fmaxf(node.aabb.by, bounds.by);
+			node.aabb.bz = fmaxf(node.aabb.bz, bounds.bz);
+		}
+
+		unsigned int nodeIndex = (unsigned int)meshletHierarchy.size();
+		if (range.parentIndex == 4294967295)
+		{
+			meshletRootIndex = nodeIndex;
+		}
+		else if (range.isChildB)
+		{
+			meshletHierarchy[range.parentIndex].childBIndex = nodeIndex;
+		}
+		else
+		{
+			meshletHierarchy[range.parentIndex].childAIndex = nodeIndex;
+		}
+
+		if (range.end - range.begin == 1)
+		{
+			node.triangleIndex = order[range.begin];
+			node.isLeaf = 1;
+			meshletHierarchy.push_back(node);
+			continue;
+		}
+
+		node.triangleIndex = 0;
+		node.isLeaf = 0;
+		meshletHierarchy.push_back(node);
+
+		//Split at the median centroid along the longest axis
+		float extent[3] = { node.aabb.bx - node.aabb.ax, node.aabb.by - node.aabb.ay, node.aabb.bz - node.aabb.az };
+		int axis = (extent[0] > extent[1] && extent[0] > extent[2]) ? 0 : (extent[1] > extent[2] ? 1 : 2);
+		auto centroid = [&](unsigned int meshlet)
+		{
+			const AABB& bounds = meshletBounds[meshlet];
+			return axis == 0 ? bounds.ax + bounds.bx : (axis == 1 ? bounds.ay + bounds.by : bounds.az + bounds.bz);
+		};
+
+		unsigned int middle = range.begin + (range.end - range.begin) / 2;
+		std::nth_element(order.begin() + range.begin, order.begin() + middle, order.begin() + range.end, [&](unsigned int a, unsigned int b) { return centroid(a) < centroid(b); });
+
+		stack.push({ middle, range.end, nodeIndex, true });
+		stack.push({ range.begin, middle, nodeIndex, false });
+	}
+}
+
+size_t Mesh::GetMemoryUsage() const
+{
+	return positions.size() * sizeof(VertexPosition) + attributes.size() * sizeof(VertexAttribute) + compressedAttributes.size() * sizeof(CompressedVertexAttribute) + triangles.size() * sizeof(Triangle) + nodeHierarchy.size() * sizeof(Node)
+		+ meshlets.size() * sizeof(Meshlet) + meshletVertices.size() * sizeof(unsigned int) + meshletIndices.size() + meshletHierarchy.size() * sizeof(Node);
+}
+
+unsigned long long Mesh::ComputeContentHash() const
+{
+	uint64_t hash = ESL::Hash64(positions.data(), positions.size() * sizeof(VertexPosition));
+	hash = ESL::Hash64(attributes.data(), attributes.size() * sizeof(VertexAttribute), hash);
+	hash = ESL::Hash64(compressedAttributes.data(), compressedAttributes.size() * sizeof(CompressedVertexAttribute), hash);
+	return ESL::Hash64(triangles.data(), triangles.size() * sizeof(Triangle), hash);
+}
+
+void Mesh::UnpackIndices(Mesh::Triangle triangle, unsigned int indices[3])
+{
+	indices[0] = (triangle.indices1 & 0x000fffff);
+	indices[1] = ((triangle.indices1 & 0xfff00000) >> 20) | ((triangle.indices2 & 0x000000ff) << 12);
+	indices[2] = ((triangle.indices2 & 0x0fffff00) >> 8);
+}
+
+Mesh::Triangle Mesh::PackIndices(const unsigned int indices[3])
+{
+	Triangle triangle;
+	triangle.indices1 = (indices[0] & 0x000fffff) | ((indices[1] << 20) & 0xfff00000); //Mask first index, mask and shift second index
+	triangle.indices2 = ((indices[1] >> 12) & 0x000000ff) | ((indices[2] << 8) & 0x0fffff00); //Mask and shift third index
+	return triangle;
+}
+
+std::vector<Mesh::LinkedNode> Mesh::GetLinkedNodeHierarchy() const
+{
+	return LinkHierarchy(nodeHierarchy, rootIndex);
+}
+
+std::vector<Mesh::LinkedNode> Mesh::GetLinkedMeshletHierarchy() const
+{
+	return LinkHierarchy(meshletHierarchy, meshletRootIndex);
+}
+
+std::vector<Mesh::LinkedNode> Mesh::LinkHierarchy(const std::vector<Node>& nodeHierarchy, unsigned int rootIndex)
 {
 	std::vector<LinkedNode> linkedNodeHierarchy;
+	if (rootIndex == 4294967295)
+	{
+		return linkedNodeHierarchy;
+	}
+	linkedNodeHierarchy.reserve(nodeHierarchy.size());
+
+	//One traversal stack shared by every pass, the hierarchy is never deeper than its node count
+	ESL::Arena scratch((nodeHierarchy.size() + 1) * sizeof(unsigned int) + 64);
+	ESL::ArenaVector<unsigned int> stackStorage((ESL::ArenaAllocator<unsigned int>(scratch)));
+	stackStorage.reserve(nodeHierarchy.size() + 1);
+	std::stack<unsigned int, ESL::ArenaVector<unsigned int>> stack(std::move(stackStorage));
 
 	//Allocate Nodes with base information
 	for (unsigned int i = 0; i < nodeHierarchy.size(); i++)
@@ -343,7 +743,6 @@ std::vector<Mesh::LinkedNode> Mesh::GetLinkedNodeHierarchy()
 
 	{ //Create hit links
 		unsigned int last = 4294967295;
-		std::stack<unsigned int> stack;
 		stack.push(rootIndex);
 		while (stack.size() > 0)
 		{
@@ -369,7 +768,6 @@ std::vector<Mesh::LinkedNode> Mesh::GetLinkedNodeHierarchy()
 	{ //Create miss links
 		for (unsigned int i = 0; i < nodeHierarchy.size(); i++)
 		{
-			std::stack<unsigned int> stack;
 			stack.push(i);
 
 			while (stack.size() > 0)
@@ -3,6 +3,11 @@
 #include <string>
 #include <vector>
 
+namespace ESL
+{
+	class Arena;
+}
+
 class __declspec(dllexport) Mesh
 {
 public:
@@ -14,6 +19,20 @@ public:
 		float normal[3];
 		float UV[2];
 	};
+	struct VertexPosition
+	{
+		float position[3];
+	};
+	struct VertexAttribute
+	{
+		float normal[3];
+		float UV[2];
+	};
+	struct CompressedVertexAttribute
+	{
+		unsigned int normal; //Octahedral encoded, 16 bit snorm per axis
+		unsigned short UV[2]; //Half precision
+	};
 	struct Triangle
 	{
 		unsigned int indices1;
@@ -49,20 +68,55 @@ public:
 		AABB aabb;
 		int isLeaf;
 	};
+	struct Meshlet
+	{
+		unsigned int vertexOffset; //First entry in meshletVertices
+		unsigned int triangleOffset; //First triangle, its local indices start at meshletIndices[triangleOffset * 3]
+		unsigned char vertexCount;
+		unsigned char triangleCount;
+	};
+public:
+	static constexpr unsigned int maxMeshletVertices = 64;
+	static constexpr unsigned int maxMeshletTriangles = 128;
 public:
-	void AddTriangle(Vertex vertices[3]);
+	void Reserve(size_t triangleCount);
+	void AddTriangle(Vertex vertices[3], ESL::Arena& scratch); //AppendTriangle followed by inserting it into the hierarchy
+	void AppendTriangle(Vertex vertices[3]);
+	void BuildHierarchy(ESL::Arena& scratch); //Rebuilds the hierarchy from every triangle
+	void ReorderForLocality();
+	void BuildMeshlets();
+	size_t GetMemoryUsage() const;
+	unsigned long long ComputeContentHash() const; //Hash of the vertex and triangle lists, equal for meshes with identical geometry
+	static void UnpackIndices(Triangle triangle, unsigned int indices[3]);
+	static Triangle PackIndices(const unsigned int indices[3]);
 public:
 	bool completed = false;
+	bool hasNormals = false; //Set when the file provided vertex normals or they have been generated
+	float simplificationError = 0; //Largest distance from the source surface for meshes produced by MeshSimplifier
+	bool attributesCompressed = false;
 public:
 	unsigned int rootIndex = 4294967295;
+	unsigned int meshletRootIndex = 4294967295;
 #pragma warning(push)
 #pragma warning(disable:4251)
-	std::vector<LinkedNode> GetLinkedNodeHierarchy();
+	std::vector<LinkedNode> GetLinkedNodeHierarchy() const;
+	std::vector<LinkedNode> GetLinkedMeshletHierarchy() const; //Leaf triangleIndex is a meshlet index
+	static std::vector<LinkedNode> LinkHierarchy(const std::vector<Node>& hierarchy, unsigned int root);
 
 	std::string meshName;
-	std::vector<Vertex> vertices;
-	std::vector<unsigned short int> vertexUsedCount;
+	std::vector<VertexPosition> positions; //Tightly packed positions read during traversal
+	std::vector<VertexAttribute> attributes; //Normals and UVs only read once a hit is confirmed
+	std::vector<CompressedVertexAttribute> compressedAttributes; //Replaces attributes when attributesCompressed is set
 	std::vector<Triangle> triangles;
 	std::vector<Node> nodeHierarchy;
+
+	//Clusters of consecutive triangles sharing at most maxMeshletVertices vertices, filled by BuildMeshlets. They are stored in addition to
+	//triangles, which the GPU path and the per triangle hierarchy still read.
+	std::vector<Meshlet> meshlets;
+	std::vector<unsigned int> meshletVertices; //Mesh vertex index for each meshlet local vertex
+	std::vector<unsigned char> meshletIndices; //Three local vertex indices per triangle
+	std::vector<Node> meshletHierarchy;
 #pragma warning(pop)
+private:
+	void InsertIntoHierarchy(unsigned int triangleIndex, ESL::Arena& scratch);
 };
\ No newline at end of file
@@ -1,24 +1,581 @@
 #include "MeshDecoder.h"
+#include "VertexCompression.h"
 #include "EngineLogger.h"
+#include "EngineStandard/Parallel.h"
+#include "EngineStandard/Arena.h"
+#include "EngineStandard/MappedFile.h"
+#include "EngineStandard/Json.h"
 
 #include <iostream>
 #include <fstream>
 #include <string>
 #include <sstream>
 #include <algorithm>
+#include <math.h>
+#include <string.h>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 namespace MeshManagement
 {
-	std::vector<Mesh> MeshDecoder::ReadAsciiStl(const char* path)
+	namespace
 	{
-		std::ifstream file;
-		file.open(path);
+		//Rough file bytes per triangle, used to size allocations before parsing
+		const size_t asciiStlBytesPerTriangle = 180; //Measured on the bundled ASCII STL files
+		const size_t objBytesPerTriangle = 64; //Face line plus its share of v, vt and vn lines
 
-		if (file.is_open())
+		size_t RemainingFileBytes(std::ifstream& file, size_t fileSize)
 		{
-			std::vector<Mesh> meshArray;
-			Mesh* currentMesh = nullptr;
+			std::streamoff position = file.tellg();
+			return (position >= 0 && (size_t)position < fileSize) ? fileSize - (size_t)position : 0;
+		}
+
+		void LogScratchStatistics(const ESL::Arena& scratch)
+		{
+			const ESL::Arena::Statistics& statistics = scratch.GetStatistics();
+
+			std::ostringstream oss;
+			oss << "Import scratch: " << statistics.allocations << " allocations served from " << statistics.blockAllocations << " heap blocks (" << statistics.bytesReserved << " bytes reserved, " << statistics.peakBytesUsed << " bytes peak)";
+			DEBUGLOG(oss.str())
+		}
+
+		enum class PlyType
+		{
+			Invalid, Int8, UInt8, Int16, UInt16, Int32, UInt32, Float32, Float64
+		};
+
+		struct PlyProperty
+		{
+			std::string name;
+			PlyType type = PlyType::Invalid;
+			PlyType countType = PlyType::Invalid; //Set for list properties, type is then the item type
+			size_t offset = 0; //Byte offset inside an element, only meaningful for elements without lists
+		};
+
+		struct PlyElement
+		{
+			std::string name;
+			size_t count = 0;
+			size_t stride = 0; //Size of one element, 0 when it contains a list and each element has to be walked
+			std::vector<PlyProperty> properties;
+		};
+
+		PlyType ParsePlyType(const std::string& name)
+		{
+			if (name == "char" || name == "int8") return PlyType::Int8;
+			if (name == "uchar" || name == "uint8") return PlyType::UInt8;
+			if (name == "short" || name == "int16") return PlyType::Int16;
+			if (name == "ushort" || name == "uint16") return PlyType::UInt16;
+			if (name == "int" || name == "int32") return PlyType::Int32;
+			if (name == "uint" || name == "uint32") return PlyType::UInt32;
+			if (name == "float" || name == "float32") return PlyType::Float32;
+			if (name == "double" || name == "float64") return PlyType::Float64;
+			return PlyType::Invalid;
+		}
+
+		size_t PlyTypeSize(PlyType type)
+		{
+			switch (type)
+			{
+			case PlyType::Int8: case PlyType::UInt8: return 1;
+			case PlyType::Int16: case PlyType::UInt16: return 2;
+			case PlyType::Int32: case PlyType::UInt32: case PlyType::Float32: return 4;
+			case PlyType::Float64: return 8;
+			default: return 0;
+			}
+		}
+
+		unsigned int ByteSwap32(unsigned int value)
+		{
+			return (value >> 24) | ((value >> 8) & 0x0000ff00) | ((value << 8) & 0x00ff0000) | (value << 24);
+		}
+
+		//Swaps the byte order of count 32 bit words in place, four at a time with SSE2
+		void ByteSwap32Array(unsigned int* words, size_t count)
+		{
+			size_t i = 0;
+#if defined(_M_X64) || defined(__SSE2__)
+			for (; i + 4 <= count; i += 4)
+			{
+				__m128i value = _mm_loadu_si128((const __m128i*)(words + i));
+				value = _mm_or_si128(_mm_slli_epi16(value, 8), _mm_srli_epi16(value, 8)); //Swap the bytes of each 16 bit half
+				value = _mm_shufflehi_epi16(_mm_shufflelo_epi16(value, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1)); //Swap the halves
+				_mm_storeu_si128((__m128i*)(words + i), value);
+			}
+#endif
+			for (; i < count; i++)
+			{
+				words[i] = ByteSwap32(words[i]);
+			}
+		}
+
+		//Reads one scalar of any PLY type. The engine only targets little endian machines, so big endian files set swap.
+		double ReadPlyValue(const unsigned char* data, PlyType type, bool swap)
+		{
+			unsigned char bytes[8];
+			size_t size = PlyTypeSize(type);
+			for (size_t i = 0; i < size; i++)
+			{
+				bytes[i] = data[swap ? size - 1 - i : i];
+			}
+
+			switch (type)
+			{
+			case PlyType::Int8: { signed char value; memcpy(&value, bytes, 1); return value; }
+			case PlyType::UInt8: return bytes[0];
+			case PlyType::Int16: { short value; memcpy(&value, bytes, 2); return value; }
+			case PlyType::UInt16: { unsigned short value; memcpy(&value, bytes, 2); return value; }
+			case PlyType::Int32: { int value; memcpy(&value, bytes, 4); return value; }
+			case PlyType::UInt32: { unsigned int value; memcpy(&value, bytes, 4); return value; }
+			case PlyType::Float32: { float value; memcpy(&value, bytes, 4); return value; }
+			case PlyType::Float64: { double value; memcpy(&value, bytes, 8); return value; }
+			default: return 0;
+			}
+		}
+
+		//Parses the text header, leaving body pointing at the first byte after end_header
+		bool ParsePlyHeader(const unsigned char*& body, const unsigned char* end, bool& bigEndian, std::vector<PlyElement>& elements)
+		{
+			const char terminator[] = "end_header";
+			const unsigned char* headerEnd = std::search(body, end, terminator, terminator + sizeof(terminator) - 1);
+			if (headerEnd == end || end - body < 3 || memcmp(body, "ply", 3) != 0)
+			{
+				DEBUGERROR("ReadPly Failed: Missing PLY header")
+				return false;
+			}
+
+			std::istringstream header(std::string((const char*)body, (const char*)headerEnd));
+			body = headerEnd + sizeof(terminator) - 1;
+			while (body < end && *body != '\n') //Skip to the end of the end_header line, which may end in \r\n
+			{
+				body++;
+			}
+			body++;
+
+			bool formatFound = false;
+			std::string line;
+			while (std::getline(header, line))
+			{
+				std::istringstream tokens(line);
+				std::string keyword;
+				tokens >> keyword;
+
+				if (keyword == "format")
+				{
+					std::string format;
+					tokens >> format;
+					if (format == "binary_little_endian" || format == "binary_big_endian")
+					{
+						bigEndian = format == "binary_big_endian";
+						formatFound = true;
+					}
+					else
+					{
+						DEBUGERROR("ReadPly Failed: Only binary PLY files are supported, got " + format)
+						return false;
+					}
+				}
+				else if (keyword == "element")
+				{
+					PlyElement element;
+					tokens >> element.name >> element.count;
+					elements.push_back(element);
+				}
+				else if (keyword == "property" && elements.size() > 0)
+				{
+					PlyProperty property;
+					std::string type;
+					tokens >> type;
+					if (type == "list")
+					{
+						std::string countType;
+						tokens >> countType >> type;
+						property.countType = ParsePlyType(countType);
+						if (property.countType == PlyType::Invalid)
+						{
+							DEBUGERROR("ReadPly Failed: Unknown list count type " + countType)
+							return false;
+						}
+					}
+					property.type = ParsePlyType(type);
+					tokens >> property.name;
+					if (property.type == PlyType::Invalid)
+					{
+						DEBUGERROR("ReadPly Failed: Unknown property type " + type)
+						return false;
+					}
+					elements.back().properties.push_back(property);
+				}
+			}
+
+			if (!formatFound)
+			{
+				DEBUGERROR("ReadPly Failed: Missing format line")
+				return false;
+			}
+
+			for (size_t i = 0; i < elements.size(); i++)
+			{
+				size_t stride = 0;
+				for (size_t j = 0; j < elements[i].properties.size(); j++)
+				{
+					PlyProperty& property = elements[i].properties[j];
+					if (property.countType != PlyType::Invalid)
+					{
+						stride = 0;
+						break;
+					}
+					property.offset = stride;
+					stride += PlyTypeSize(property.type);
+				}
+				elements[i].stride = stride;
+			}
+			return true;
+		}
+
+		int FindPlyProperty(const PlyElement& element, const char* const* names, size_t nameCount)
+		{
+			for (size_t i = 0; i < element.properties.size(); i++)
+			{
+				for (size_t j = 0; j < nameCount; j++)
+				{
+					if (element.properties[i].name == names[j] && element.properties[i].countType == PlyType::Invalid)
+					{
+						return (int)i;
+					}
+				}
+			}
+			return -1;
+		}
+
+		//Advances data past one element containing lists, returns false if it would run past end. Sizes are compared against the
+		//bytes left rather than added to data, so a bogus list count can't wrap the pointer around.
+		bool SkipPlyListElement(const PlyElement& element, const unsigned char*& data, const unsigned char* end, bool swap)
+		{
+			for (size_t i = 0; i < element.properties.size(); i++)
+			{
+				const PlyProperty& property = element.properties[i];
+				if (property.countType == PlyType::Invalid)
+				{
+					if (PlyTypeSize(property.type) > (size_t)(end - data))
+					{
+						return false;
+					}
+					data += PlyTypeSize(property.type);
+				}
+				else
+				{
+					if (PlyTypeSize(property.countType) > (size_t)(end - data))
+					{
+						return false;
+					}
+					double count = ReadPlyValue(data, property.countType, swap);
+					data += PlyTypeSize(property.countType);
+					if (count < 0 || count > (double)((size_t)(end - data) / PlyTypeSize(property.type)))
+					{
+						return false;
+					}
+					data += (size_t)count * PlyTypeSize(property.type);
+				}
+			}
+			return true;
+		}
+
+		//Copies one scalar property of every vertex into a float field of the destination array. With raw set float properties
+		//are copied as they are in the file and still need swapping, otherwise every value is converted to a host order float.
+		void GatherPlyProperty(const PlyElement& element, const PlyProperty& property, const unsigned char* data, bool swap, bool raw, float* destination, size_t destinationStride)
+		{
+			if (raw && property.type == PlyType::Float32)
+			{
+				for (size_t i = 0; i < element.count; i++)
+				{
+					memcpy(destination + i * destinationStride, data + i * element.stride + property.offset, sizeof(float));
+				}
+			}
+			else
+			{
+				for (size_t i = 0; i < element.count; i++)
+				{
+					destination[i * destinationStride] = (float)ReadPlyValue(data + i * element.stride + property.offset, property.type, swap);
+				}
+			}
+		}
+	}
+
+	namespace
+	{
+		const unsigned int glbMagic = 0x46546C67; //"glTF"
+		const unsigned int glbJsonChunk = 0x4E4F534A; //"JSON"
+		const unsigned int glbBinaryChunk = 0x004E4942; //"BIN\0"
+
+		const unsigned int glbByte = 5120;
+		const unsigned int glbUnsignedByte = 5121;
+		const unsigned int glbShort = 5122;
+		const unsigned int glbUnsignedShort = 5123;
+		const unsigned int glbUnsignedInt = 5125;
+		const unsigned int glbFloat = 5126;
+
+		struct GlbAccessor
+		{
+			const unsigned char* data = nullptr;
+			size_t count = 0;
+			size_t stride = 0;
+			unsigned int componentType = 0;
+			unsigned int components = 0;
+			bool normalized = false;
+		};
+
+		size_t GlbComponentSize(unsigned int componentType)
+		{
+			switch (componentType)
+			{
+			case glbByte: case glbUnsignedByte: return 1;
+			case glbShort: case glbUnsignedShort: return 2;
+			case glbUnsignedInt: case glbFloat: return 4;
+			default: return 0;
+			}
+		}
+
+		//Looks up an accessor and its buffer view, checking every element lies inside the binary chunk
+		bool ResolveGlbAccessor(const ESL::JsonValue& document, double accessorIndex, const unsigned char* binary, size_t binarySize, GlbAccessor& accessor)
+		{
+			const ESL::JsonValue* accessors = document.Find("accessors");
+			const ESL::JsonValue* bufferViews = document.Find("bufferViews");
+			if (accessors == nullptr || bufferViews == nullptr || accessorIndex < 0 || accessorIndex >= accessors->array.size())
+			{
+				return false;
+			}
+			const ESL::JsonValue& description = accessors->array[(size_t)accessorIndex];
+			if (description.Find("sparse") != nullptr)
+			{
+				DEBUGERROR("ReadGlb Failed: Sparse accessors aren't supported")
+				return false;
+			}
+
+			double viewIndex = description.NumberOr("bufferView", -1);
+			if (viewIndex < 0 || viewIndex >= bufferViews->array.size())
+			{
+				return false;
+			}
+			const ESL::JsonValue& view = bufferViews->array[(size_t)viewIndex];
+			if (view.NumberOr("buffer", 0) != 0)
+			{
+				DEBUGERROR("ReadGlb Failed: Only the embedded binary buffer is supported")
+				return false;
+			}
+
+			const ESL::JsonValue* type = description.Find("type");
+			std::string typeName = type != nullptr ? type->string : std::string();
+			accessor.components = typeName == "SCALAR" ? 1 : typeName == "VEC2" ? 2 : typeName == "VEC3" ? 3 : typeName == "VEC4" ? 4 : 0;
+			accessor.componentType = (unsigned int)description.NumberOr("componentType", 0);
+			accessor.count = (size_t)description.NumberOr("count", 0);
+			const ESL::JsonValue* normalized = description.Find("normalized");
+			accessor.normalized = normalized != nullptr && normalized->boolean;
+
+			size_t elementSize = accessor.components * GlbComponentSize(accessor.componentType);
+			if (elementSize == 0)
+			{
+				return false;
+			}
+			accessor.stride = (size_t)view.NumberOr("byteStride", (double)elementSize);
+
+			size_t viewOffset = (size_t)view.NumberOr("byteOffset", 0);
+			size_t viewLength = (size_t)view.NumberOr("byteLength", 0);
+			size_t accessorOffset = (size_t)description.NumberOr("byteOffset", 0);
+			//Written so that no sum or product can wrap around for hostile offsets and counts
+			bool outside = viewOffset > binarySize || viewLength > binarySize - viewOffset;
+			if (!outside && accessor.count > 0)
+			{
+				outside = accessor.stride == 0 || accessorOffset > viewLength || elementSize > viewLength - accessorOffset
+					|| accessor.count - 1 > (viewLength - accessorOffset - elementSize) / accessor.stride;
+			}
+			if (outside)
+			{
+				DEBUGERROR("ReadGlb Failed: Accessor lies outside the binary chunk")
+				return false;
+			}
+
+			accessor.data = binary + viewOffset + accessorOffset;
+			return true;
+		}
+
+		float ReadGlbComponent(const unsigned char* data, unsigned int componentType, bool normalized)
+		{
+			switch (componentType)
+			{
+			case glbFloat: { float value; memcpy(&value, data, 4); return value; }
+			case glbByte: { signed char value = (signed char)data[0]; return normalized ? std::max(value / 127.0f, -1.0f) : (float)value; }
+			case glbUnsignedByte: return normalized ? data[0] / 255.0f : (float)data[0];
+			case glbShort: { short value; memcpy(&value, data, 2); return normalized ? std::max(value / 32767.0f, -1.0f) : (float)value; }
+			case glbUnsignedShort: { unsigned short value; memcpy(&value, data, 2); return normalized ? value / 65535.0f : (float)value; }
+			case glbUnsignedInt: { unsigned int value; memcpy(&value, data, 4); return (float)value; }
+			default: return 0;
+			}
+		}
+
+		//Copies components floats per element into destination, whose elements are destinationStride floats apart.
+		//Tightly packed float accessors matching the destination are a single memcpy, other float layouts copy per element.
+		void CopyGlbAccessor(const GlbAccessor& accessor, unsigned int components, float* destination, size_t destinationStride)
+		{
+			components = std::min(components, accessor.components);
+			if (accessor.componentType == glbFloat)
+			{
+				if (accessor.stride == components * sizeof(float) && destinationStride == components)
+				{
+					memcpy(destination, accessor.data, accessor.count * components * sizeof(float));
+					return;
+				}
+				for (size_t i = 0; i < accessor.count; i++)
+				{
+					memcpy(destination + i * destinationStride, accessor.data + i * accessor.stride, components * sizeof(float));
+				}
+				return;
+			}
+
+			size_t componentSize = GlbComponentSize(accessor.componentType);
+			for (size_t i = 0; i < accessor.count; i++)
+			{
+				for (unsigned int component = 0; component < components; component++)
+				{
+					destination[i * destinationStride + component] = ReadGlbComponent(accessor.data + i * accessor.stride + component * componentSize, accessor.componentType, accessor.normalized);
+				}
+			}
+		}
+
+		unsigned int ReadGlbIndex(const GlbAccessor& accessor, size_t i)
+		{
+			const unsigned char* data = accessor.data + i * accessor.stride;
+			switch (accessor.componentType)
+			{
+			case glbUnsignedByte: return data[0];
+			case glbUnsignedShort: { unsigned short value; memcpy(&value, data, 2); return value; }
+			case glbUnsignedInt: { unsigned int value; memcpy(&value, data, 4); return value; }
+			default: return 4294967295;
+			}
+		}
+
+		//Column major 4x4 like glTF, result = a * b
+		void MultiplyGlbMatrices(const float a[16], const float b[16], float result[16])
+		{
+			for (int column = 0; column < 4; column++)
+			{
+				for (int row = 0; row < 4; row++)
+				{
+					result[column * 4 + row] = a[row] * b[column * 4] + a[4 + row] * b[column * 4 + 1] + a[8 + row] * b[column * 4 + 2] + a[12 + row] * b[column * 4 + 3];
+				}
+			}
+		}
+
+		void GlbNodeMatrix(const ESL::JsonValue& node, float matrix[16])
+		{
+			const ESL::JsonValue* explicitMatrix = node.Find("matrix");
+			if (explicitMatrix != nullptr && explicitMatrix->array.size() == 16)
+			{
+				for (int i = 0; i < 16; i++)
+				{
+					matrix[i] = (float)explicitMatrix->array[i].number;
+				}
+				return;
+			}
+
+			float translation[3] = { 0, 0, 0 };
+			float rotation[4] = { 0, 0, 0, 1 };
+			float scale[3] = { 1, 1, 1 };
+			const ESL::JsonValue* value = node.Find("translation");
+			for (int i = 0; value != nullptr && i < 3 && i < (int)value->array.size(); i++)
+			{
+				translation[i] = (float)value->array[i].number;
+			}
+			value = node.Find("rotation");
+			for (int i = 0; value != nullptr && i < 4 && i < (int)value->array.size(); i++)
+			{
+				rotation[i] = (float)value->array[i].number;
+			}
+			value = node.Find("scale");
+			for (int i = 0; value != nullptr && i < 3 && i < (int)value->array.size(); i++)
+			{
+				scale[i] = (float)value->array[i].number;
+			}
+
+			//Translation * Rotation * Scale, with the unit quaternion (x, y, z, w) expanded to a rotation matrix
+			float x = rotation[0], y = rotation[1], z = rotation[2], w = rotation[3];
+			float rotationMatrix[9] = {
+				1 - 2 * (y * y + z * z), 2 * (x * y + z * w), 2 * (x * z - y * w),
+				2 * (x * y - z * w), 1 - 2 * (x * x + z * z), 2 * (y * z + x * w),
+				2 * (x * z + y * w), 2 * (y * z - x * w), 1 - 2 * (x * x + y * y) };
+			for (int column = 0; column < 3; column++)
+			{
+				for (int row = 0; row < 3; row++)
+				{
+					matrix[column * 4 + row] = rotationMatrix[column * 3 + row] * scale[column];
+				}
+				matrix[column * 4 + 3] = 0;
+			}
+			matrix[12] = translation[0];
+			matrix[13] = translation[1];
+			matrix[14] = translation[2];
+			matrix[15] = 1;
+		}
+
+		//Nodes may be shared between parents, so a small file can describe exponentially many instances
+		const size_t maxGlbInstances = 1 << 20;
+		const size_t maxGlbNodeVisits = 1 << 22;
+
+		//Returns false once the instance or node visit limit stops the traversal
+		bool CollectGlbInstances(const ESL::JsonValue& nodes, size_t nodeIndex, const float parent[16], const std::vector<int>& meshRemap, std::vector<SceneInstance>& instances, size_t depth, size_t& visits)
+		{
+			if (nodeIndex >= nodes.array.size() || depth > nodes.array.size()) //Depth guards against malformed cyclic hierarchies
+			{
+				return true;
+			}
+			if (++visits > maxGlbNodeVisits)
+			{
+				return false;
+			}
+			const ESL::JsonValue& node = nodes.array[nodeIndex];
+
+			float local[16];
+			float world[16];
+			GlbNodeMatrix(node, local);
+			MultiplyGlbMatrices(parent, local, world);
+
+			double mesh = node.NumberOr("mesh", -1);
+			if (mesh >= 0 && mesh < meshRemap.size() && meshRemap[(size_t)mesh] >= 0)
+			{
+				if (instances.size() >= maxGlbInstances)
+				{
+					return false;
+				}
+
+				SceneInstance instance;
+				instance.meshIndex = (unsigned int)meshRemap[(size_t)mesh];
+				for (int row = 0; row < 3; row++)
+				{
+					for (int column = 0; column < 4; column++)
+					{
+						instance.transform[row * 4 + column] = world[column * 4 + row];
+					}
+				}
+				instances.push_back(instance);
+			}
+
+			const ESL::JsonValue* children = node.Find("children");
+			for (size_t i = 0; children != nullptr && i < children->array.size(); i++)
+			{
+				if (!CollectGlbInstances(nodes, (size_t)children->array[i].number, world, meshRemap, instances, depth + 1, visits))
+				{
+					return false;
+				}
+			}
+			return true;
+		}
 
+		//Calls onSolid with the name of each solid, onTriangle for each of its facets and onEndSolid at its end
+		template<typename SolidFunction, typename EndSolidFunction, typename TriangleFunction>
+		void ParseAsciiStl(std::ifstream& file, SolidFunction onSolid, EndSolidFunction onEndSolid, TriangleFunction onTriangle)
+		{
 			Mesh::Vertex currentVertices[3];
 			float normal[3] = { 0, 0, 0 };
 
@@ -34,30 +591,11 @@ namespace MeshManagement
 					currentLine.erase(0, spaceIndex + 1);
 					if (solidIndex == 0)
 					{
-						meshArray.push_back(Mesh(currentLine));
-						currentMesh = &meshArray.back();
+						onSolid(currentLine);
 					}
 					else
 					{
-						if (currentMesh != nullptr)
-						{
-							for (unsigned int vert = 0; vert < (unsigned int)currentMesh->vertices.size(); vert++) //Loop through all vertices and divide sum of triangle normals by count of triangle normals
-							{
-								unsigned short int numberOfUses = currentMesh->vertexUsedCount[vert];
-
-								currentMesh->vertices[vert].normal[0] /= (float)numberOfUses;
-								currentMesh->vertices[vert].normal[1] /= (float)numberOfUses;
-								currentMesh->vertices[vert].normal[2] /= (float)numberOfUses;
-
-								//Normalize
-								double magnitude = sqrt((currentMesh->vertices[vert].normal[0] * currentMesh->vertices[vert].normal[0]) + (currentMesh->vertices[vert].normal[1] * currentMesh->vertices[vert].normal[1]) + (currentMesh->vertices[vert].normal[2] * currentMesh->vertices[vert].normal[2]));
-								currentMesh->vertices[vert].normal[0] /= (float)magnitude;
-								currentMesh->vertices[vert].normal[1] /= (float)magnitude;
-								currentMesh->vertices[vert].normal[2] /= (float)magnitude;
-							}
-
-							currentMesh->completed = true;
-						}
+						onEndSolid();
 					}
 				}
 				else
@@ -112,12 +650,43 @@ namespace MeshManagement
 							}
 							else
 							{
-								currentMesh->AddTriangle(currentVertices);
+								onTriangle(currentVertices);
 							}
 						}
 					}
 				}
 			}
+		}
+	}
+
+	std::vector<Mesh> MeshDecoder::ReadAsciiStl(const char* path)
+	{
+		std::ifstream file;
+		file.open(path, std::ios::ate);
+
+		if (file.is_open())
+		{
+			size_t fileSize = (size_t)file.tellg();
+			file.seekg(0);
+
+			std::vector<Mesh> meshArray;
+			Mesh* currentMesh = nullptr;
+
+			ParseAsciiStl(file, [&](const std::string& name)
+			{
+				meshArray.push_back(Mesh(name));
+				currentMesh = &meshArray.back();
+				currentMesh->Reserve(RemainingFileBytes(file, fileSize) / asciiStlBytesPerTriangle);
+			}, [&]()
+			{
+				if (currentMesh != nullptr) //Facet normals are per face, vertex normals are generated after import
+				{
+					currentMesh->completed = true;
+				}
+			}, [&](Mesh::Vertex vertices[3])
+			{
+				currentMesh->AppendTriangle(vertices);
+			});
 
 			file.close();
 
@@ -132,14 +701,31 @@ namespace MeshManagement
 		}
 	}
 
-	Mesh MeshDecoder::ReadObj(const char* path)
+	bool MeshDecoder::StreamAsciiStl(const char* path, const std::function<void(Mesh::Vertex[3])>& onTriangle)
 	{
-		std::ifstream file;
-		file.open(path);
-
-		if (file.is_open())
+		std::ifstream file(path);
+		if (!file.is_open())
 		{
-			struct VertexPosition
+			DEBUGERROR("MeshDecoder::StreamAsciiStl Failed: Could not open file")
+			return false;
+		}
+
+		ParseAsciiStl(file, [](const std::string&) {}, []() {}, onTriangle);
+		return true;
+	}
+
+	Mesh MeshDecoder::ReadObj(const char* path)
+	{
+		std::ifstream file;
+		file.open(path, std::ios::ate);
+
+		if (file.is_open())
+		{
+			size_t fileSize = (size_t)file.tellg();
+			file.seekg(0);
+			size_t triangleEstimate = fileSize / objBytesPerTriangle;
+
+			struct VertexPosition
 			{
 				float position[3];
 			};
@@ -151,11 +737,18 @@ namespace MeshManagement
 			{
 				float normal[3];
 			};
-			std::vector<VertexPosition> vertexPositions;
-			std::vector<VertexTextureCoord> vertexTextureCoords;
-			std::vector<VertexNormal> vertexNormals;
+
+			//The raw attribute lists are only needed while parsing, so they live in scratch memory sized for the whole file
+			ESL::Arena scratch((triangleEstimate / 2 + 1) * (sizeof(VertexPosition) + sizeof(VertexTextureCoord) + sizeof(VertexNormal)) + 65536);
+			ESL::ArenaVector<VertexPosition> vertexPositions((ESL::ArenaAllocator<VertexPosition>(scratch)));
+			ESL::ArenaVector<VertexTextureCoord> vertexTextureCoords((ESL::ArenaAllocator<VertexTextureCoord>(scratch)));
+			ESL::ArenaVector<VertexNormal> vertexNormals((ESL::ArenaAllocator<VertexNormal>(scratch)));
+			vertexPositions.reserve(triangleEstimate / 2 + 1);
+			vertexTextureCoords.reserve(triangleEstimate / 2 + 1);
+			vertexNormals.reserve(triangleEstimate / 2 + 1);
 
 			Mesh mesh = Mesh("Empty mesh");
+			bool facesHaveNormals = true; //Cleared by any face vertex without a vn index
 			std::string currentLine;
 
 			while (std::getline(file, currentLine))
@@ -182,6 +775,7 @@ namespace MeshManagement
 					{
 						mesh = Mesh("New Mesh");
 					}
+					facesHaveNormals = true;
 					continue;
 				}
 
@@ -262,7 +856,7 @@ namespace MeshManagement
 					std::size_t spaceIndex = currentLine.find(" ");
 					if (spaceIndex != std::string::npos)
 					{
-						Mesh::Vertex currentVertices[3];
+						Mesh::Vertex currentVertices[3] = {};
 
 						std::stringstream ss(currentLine);
 						std::string intermediate;
@@ -304,39 +898,828 @@ namespace MeshManagement
 									attributeIndex++;
 								}
 
+								if (attributeIndex < 3)
+								{
+									facesHaveNormals = false;
+								}
 
 							}
 							tokenIndex++;
 						}
 
-						mesh.AddTriangle(currentVertices);
+						if (mesh.triangles.size() == 0) //Reserve once the object receiving the faces is known
+						{
+							mesh.Reserve(triangleEstimate);
+						}
+						mesh.AppendTriangle(currentVertices);
 					}
 					continue;
 				}
 			}
 
-			for (unsigned int vert = 0; vert < (unsigned int)mesh.vertices.size(); vert++) //Loop through all vertices and divide sum of triangle normals by count of triangle normals
+			mesh.hasNormals = facesHaveNormals && mesh.triangles.size() > 0;
+			mesh.completed = true;
+
+			file.close();
+
+			LogScratchStatistics(scratch);
+
+			return mesh;
+		}
+
+		return Mesh("Empty Mesh");
+	}
+
+	Mesh MeshDecoder::ReadPly(const char* path)
+	{
+		ESL::MappedFile file(path);
+		if (!file.IsOpen())
+		{
+			DEBUGERROR("ReadPly Failed: Could not open file")
+			return Mesh("Empty Mesh");
+		}
+
+		const unsigned char* data = file.Data();
+		const unsigned char* end = data + file.Size();
+		bool swap = false;
+		std::vector<PlyElement> elements;
+		if (!ParsePlyHeader(data, end, swap, elements))
+		{
+			return Mesh("Empty Mesh");
+		}
+
+		std::string name = std::string(path);
+		size_t separator = name.find_last_of("/\\");
+		if (separator != std::string::npos)
+		{
+			name.erase(0, separator + 1);
+		}
+		Mesh mesh = Mesh(name);
+
+		const char* const xNames[] = { "x" };
+		const char* const yNames[] = { "y" };
+		const char* const zNames[] = { "z" };
+		const char* const nxNames[] = { "nx" };
+		const char* const nyNames[] = { "ny" };
+		const char* const nzNames[] = { "nz" };
+		const char* const uNames[] = { "u", "s", "texture_u", "texture_s" };
+		const char* const vNames[] = { "v", "t", "texture_v", "texture_t" };
+
+		//Faces are checked against the vertex count from the header, so they can come before the vertices in the file
+		size_t vertexCount = 0;
+		for (size_t e = 0; e < elements.size(); e++)
+		{
+			if (elements[e].name == "vertex")
+			{
+				vertexCount = elements[e].count;
+				break;
+			}
+		}
+
+		size_t skippedFaces = 0;
+		for (size_t e = 0; e < elements.size(); e++)
+		{
+			const PlyElement& element = elements[e];
+			if (element.name == "vertex")
 			{
-				unsigned short int numberOfUses = mesh.vertexUsedCount[vert];
+				int x = FindPlyProperty(element, xNames, 1);
+				int y = FindPlyProperty(element, yNames, 1);
+				int z = FindPlyProperty(element, zNames, 1);
+				if (element.stride == 0 || x < 0 || y < 0 || z < 0)
+				{
+					DEBUGERROR("ReadPly Failed: Vertices need fixed size x, y and z properties")
+					return Mesh("Empty Mesh");
+				}
+				if (element.count > 1048576) //Triangles pack their indices into 20 bits
+				{
+					DEBUGERROR("ReadPly Failed: More than 2^20 vertices")
+					return Mesh("Empty Mesh");
+				}
+				if (element.count > (size_t)(end - data) / element.stride) //Divided, count * stride can overflow
+				{
+					DEBUGERROR("ReadPly Failed: File is truncated")
+					return Mesh("Empty Mesh");
+				}
 
-				mesh.vertices[vert].normal[0] /= (float)numberOfUses;
-				mesh.vertices[vert].normal[1] /= (float)numberOfUses;
-				mesh.vertices[vert].normal[2] /= (float)numberOfUses;
+				mesh.positions.resize(element.count);
+				mesh.attributes.assign(element.count, Mesh::VertexAttribute());
+
+				//Float properties are copied as raw words and byte swapped in bulk afterwards, other types are converted one by one
+				const PlyProperty* positionProperties[3] = { &element.properties[x], &element.properties[y], &element.properties[z] };
+				bool positionsRaw = positionProperties[0]->type == PlyType::Float32 && positionProperties[1]->type == PlyType::Float32 && positionProperties[2]->type == PlyType::Float32;
+				if (positionsRaw && element.stride == sizeof(Mesh::VertexPosition) && positionProperties[0]->offset == 0 && positionProperties[1]->offset == 4)
+				{
+					memcpy(mesh.positions.data(), data, element.count * sizeof(Mesh::VertexPosition)); //Same layout as Mesh::VertexPosition
+				}
+				else
+				{
+					for (int axis = 0; axis < 3; axis++)
+					{
+						GatherPlyProperty(element, *positionProperties[axis], data, swap, positionsRaw, &mesh.positions[0].position[axis], 3);
+					}
+				}
+				if (swap && positionsRaw)
+				{
+					ByteSwap32Array((unsigned int*)mesh.positions.data(), element.count * 3);
+				}
+
+				int attributeProperties[5] = { FindPlyProperty(element, nxNames, 1), FindPlyProperty(element, nyNames, 1), FindPlyProperty(element, nzNames, 1),
+					FindPlyProperty(element, uNames, 4), FindPlyProperty(element, vNames, 4) };
+				bool attributesRaw = true;
+				for (int i = 0; i < 5; i++)
+				{
+					attributesRaw = attributesRaw && (attributeProperties[i] < 0 || element.properties[attributeProperties[i]].type == PlyType::Float32);
+				}
+				for (int i = 0; i < 5; i++)
+				{
+					if (attributeProperties[i] >= 0)
+					{
+						float* destination = i < 3 ? &mesh.attributes[0].normal[i] : &mesh.attributes[0].UV[i - 3];
+						GatherPlyProperty(element, element.properties[attributeProperties[i]], data, swap, attributesRaw, destination, sizeof(Mesh::VertexAttribute) / sizeof(float));
+					}
+				}
+				if (swap && attributesRaw) //Missing attributes are zero, which swaps to zero
+				{
+					ByteSwap32Array((unsigned int*)mesh.attributes.data(), element.count * sizeof(Mesh::VertexAttribute) / sizeof(unsigned int));
+				}
 
-				//Normalize
-				double magnitude = sqrt((mesh.vertices[vert].normal[0] * mesh.vertices[vert].normal[0]) + (mesh.vertices[vert].normal[1] * mesh.vertices[vert].normal[1]) + (mesh.vertices[vert].normal[2] * mesh.vertices[vert].normal[2]));
-				mesh.vertices[vert].normal[0] /= (float)magnitude;
-				mesh.vertices[vert].normal[1] /= (float)magnitude;
-				mesh.vertices[vert].normal[2] /= (float)magnitude;
+				mesh.hasNormals = attributeProperties[0] >= 0 && attributeProperties[1] >= 0 && attributeProperties[2] >= 0;
+				data += element.count * element.stride;
 			}
+			else if (element.name == "face")
+			{
+				int list = -1;
+				for (size_t i = 0; i < element.properties.size(); i++)
+				{
+					if (element.properties[i].countType != PlyType::Invalid && (element.properties[i].name == "vertex_indices" || element.properties[i].name == "vertex_index"))
+					{
+						list = (int)i;
+					}
+				}
+				if (list < 0)
+				{
+					DEBUGERROR("ReadPly Failed: Faces have no vertex_indices list")
+					return Mesh("Empty Mesh");
+				}
 
-			mesh.completed = true;
+				const PlyProperty& indexList = element.properties[list];
+				size_t countSize = PlyTypeSize(indexList.countType);
+				size_t indexSize = PlyTypeSize(indexList.type);
+				if (element.count > (size_t)(end - data) / countSize) //Every face has at least its count, a bogus header can't reserve more
+				{
+					DEBUGERROR("ReadPly Failed: File is truncated")
+					return Mesh("Empty Mesh");
+				}
+				mesh.triangles.reserve(element.count);
 
-			file.close();
+				//Other face properties, usually none, are skipped around the index list
+				PlyElement before = element;
+				before.properties.resize(list);
+				PlyElement after = element;
+				after.properties.erase(after.properties.begin(), after.properties.begin() + list + 1);
 
-			return mesh;
+				//Triangle meshes nearly always store each face as a uchar 3 and three 32 bit indices with nothing around them. Those are
+				//read at a fixed stride until a face that isn't a triangle, which the general loop below continues from.
+				size_t face = 0;
+				const size_t triangleFaceSize = 1 + 3 * sizeof(unsigned int);
+				if (before.properties.size() == 0 && after.properties.size() == 0 && indexList.countType == PlyType::UInt8 && (indexList.type == PlyType::Int32 || indexList.type == PlyType::UInt32))
+				{
+					for (; face < element.count && (size_t)(end - data) >= triangleFaceSize && data[0] == 3; face++)
+					{
+						unsigned int indices[3];
+						memcpy(indices, data + 1, sizeof(indices));
+						data += triangleFaceSize;
+						if (swap)
+						{
+							indices[0] = ByteSwap32(indices[0]);
+							indices[1] = ByteSwap32(indices[1]);
+							indices[2] = ByteSwap32(indices[2]);
+						}
+
+						if (indices[0] >= vertexCount || indices[1] >= vertexCount || indices[2] >= vertexCount) //Negative int indices wrap to large values
+						{
+							skippedFaces++;
+							continue;
+						}
+						mesh.triangles.push_back(Mesh::PackIndices(indices));
+					}
+				}
+
+				std::vector<unsigned int> polygon;
+				for (; face < element.count; face++)
+				{
+					if (before.properties.size() > 0 && !SkipPlyListElement(before, data, end, swap))
+					{
+						DEBUGERROR("ReadPly Failed: File is truncated")
+						return Mesh("Empty Mesh");
+					}
+
+					if (countSize > (size_t)(end - data))
+					{
+						DEBUGERROR("ReadPly Failed: File is truncated")
+						return Mesh("Empty Mesh");
+					}
+					double listCount = ReadPlyValue(data, indexList.countType, swap);
+					data += countSize;
+					if (listCount < 0 || listCount > (double)((size_t)(end - data) / indexSize)) //Divided, count * indexSize can overflow
+					{
+						DEBUGERROR("ReadPly Failed: File is truncated")
+						return Mesh("Empty Mesh");
+					}
+					size_t count = (size_t)listCount;
+
+					polygon.resize(count);
+					bool valid = count >= 3;
+					for (size_t i = 0; i < count; i++)
+					{
+						double index = ReadPlyValue(data + i * indexSize, indexList.type, swap);
+						valid = valid && index >= 0 && index < (double)vertexCount;
+						polygon[i] = (unsigned int)index;
+					}
+					data += count * indexSize;
+
+					if (after.properties.size() > 0 && !SkipPlyListElement(after, data, end, swap))
+					{
+						DEBUGERROR("ReadPly Failed: File is truncated")
+						return Mesh("Empty Mesh");
+					}
+
+					if (!valid)
+					{
+						skippedFaces++;
+						continue;
+					}
+
+					//Polygons are split into a fan around their first vertex
+					for (size_t i = 1; i + 1 < count; i++)
+					{
+						unsigned int indices[3] = { polygon[0], polygon[i], polygon[i + 1] };
+						mesh.triangles.push_back(Mesh::PackIndices(indices));
+					}
+				}
+			}
+			else if (element.stride > 0)
+			{
+				if (element.count > (size_t)(end - data) / element.stride)
+				{
+					DEBUGERROR("ReadPly Failed: File is truncated")
+					return Mesh("Empty Mesh");
+				}
+				data += element.count * element.stride;
+			}
+			else
+			{
+				for (size_t i = 0; i < element.count; i++)
+				{
+					if (!SkipPlyListElement(element, data, end, swap))
+					{
+						DEBUGERROR("ReadPly Failed: File is truncated")
+						return Mesh("Empty Mesh");
+					}
+				}
+			}
+
+			if (data > end)
+			{
+				DEBUGERROR("ReadPly Failed: File is truncated")
+				return Mesh("Empty Mesh");
+			}
 		}
 
-		return Mesh("Empty Mesh");
+		if (skippedFaces > 0)
+		{
+			std::ostringstream oss;
+			oss << "ReadPly skipped " << skippedFaces << " faces with fewer than 3 vertices or out of range indices";
+			DEBUGWARN(oss.str())
+		}
+
+		mesh.hasNormals = mesh.hasNormals && mesh.triangles.size() > 0;
+		mesh.completed = true;
+		return mesh;
+	}
+
+	DecodedScene MeshDecoder::ReadGlb(const char* path)
+	{
+		DecodedScene scene;
+
+		ESL::MappedFile file(path);
+		if (!file.IsOpen())
+		{
+			DEBUGERROR("ReadGlb Failed: Could not open file")
+			return scene;
+		}
+
+		const unsigned char* data = file.Data();
+		size_t size = file.Size();
+		unsigned int header[3] = { 0, 0, 0 }; //Magic, version and total length
+		if (size >= 20)
+		{
+			memcpy(header, data, sizeof(header));
+		}
+		if (header[0] != glbMagic || header[1] != 2)
+		{
+			DEBUGERROR("ReadGlb Failed: Not a glTF 2.0 binary file")
+			return scene;
+		}
+		size = std::min<size_t>(size, header[2]);
+
+		//Chunks follow the 12 byte header, JSON first and then an optional binary chunk
+		const char* json = nullptr;
+		size_t jsonSize = 0;
+		const unsigned char* binary = nullptr;
+		size_t binarySize = 0;
+		for (size_t offset = 12; offset + 8 <= size;)
+		{
+			unsigned int chunk[2];
+			memcpy(chunk, data + offset, sizeof(chunk));
+			size_t chunkSize = std::min<size_t>(chunk[0], size - offset - 8);
+			if (chunk[1] == glbJsonChunk && json == nullptr)
+			{
+				json = (const char*)data + offset + 8;
+				jsonSize = chunkSize;
+			}
+			else if (chunk[1] == glbBinaryChunk && binary == nullptr)
+			{
+				binary = data + offset + 8;
+				binarySize = chunkSize;
+			}
+			offset += 8 + ((chunkSize + 3) & ~(size_t)3);
+		}
+
+		ESL::JsonValue document;
+		if (json == nullptr || !ESL::ParseJson(json, json + jsonSize, document))
+		{
+			DEBUGERROR("ReadGlb Failed: Invalid JSON chunk")
+			return scene;
+		}
+
+		const ESL::JsonValue* meshes = document.Find("meshes");
+		std::vector<int> meshRemap(meshes != nullptr ? meshes->array.size() : 0, -1); //glTF mesh to scene.meshes index
+		size_t skippedPrimitives = 0;
+		for (size_t meshIndex = 0; meshIndex < meshRemap.size(); meshIndex++)
+		{
+			const ESL::JsonValue& description = meshes->array[meshIndex];
+			const ESL::JsonValue* name = description.Find("name");
+			Mesh mesh = Mesh(name != nullptr && name->string.size() > 0 ? name->string : "Mesh " + std::to_string(meshIndex));
+
+			bool allNormals = true;
+			const ESL::JsonValue* primitives = description.Find("primitives");
+			for (size_t p = 0; primitives != nullptr && p < primitives->array.size(); p++)
+			{
+				const ESL::JsonValue& primitive = primitives->array[p];
+				const ESL::JsonValue* attributes = primitive.Find("attributes");
+				GlbAccessor positions;
+				if (primitive.NumberOr("mode", 4) != 4 || attributes == nullptr || !ResolveGlbAccessor(document, attributes->NumberOr("POSITION", -1), binary, binarySize, positions)
+					|| positions.components != 3 || mesh.positions.size() + positions.count > 1048576) //Triangles pack their indices into 20 bits
+				{
+					skippedPrimitives++;
+					continue;
+				}
+
+				GlbAccessor normals;
+				GlbAccessor uvs;
+				GlbAccessor indices;
+				bool hasNormals = ResolveGlbAccessor(document, attributes->NumberOr("NORMAL", -1), binary, binarySize, normals) && normals.count == positions.count;
+				bool hasUVs = ResolveGlbAccessor(document, attributes->NumberOr("TEXCOORD_0", -1), binary, binarySize, uvs) && uvs.count == positions.count;
+				bool hasIndices = primitive.Find("indices") != nullptr;
+				if (hasIndices && !ResolveGlbAccessor(document, primitive.NumberOr("indices", -1), binary, binarySize, indices))
+				{
+					skippedPrimitives++;
+					continue;
+				}
+
+				size_t vertexBase = mesh.positions.size();
+				mesh.positions.resize(vertexBase + positions.count);
+				mesh.attributes.resize(vertexBase + positions.count, Mesh::VertexAttribute());
+				CopyGlbAccessor(positions, 3, &mesh.positions[vertexBase].position[0], 3);
+				if (hasNormals)
+				{
+					CopyGlbAccessor(normals, 3, &mesh.attributes[vertexBase].normal[0], sizeof(Mesh::VertexAttribute) / sizeof(float));
+				}
+				if (hasUVs)
+				{
+					CopyGlbAccessor(uvs, 2, &mesh.attributes[vertexBase].UV[0], sizeof(Mesh::VertexAttribute) / sizeof(float));
+				}
+				allNormals = allNormals && hasNormals;
+
+				size_t indexCount = hasIndices ? indices.count : positions.count;
+				mesh.triangles.reserve(mesh.triangles.size() + indexCount / 3);
+				for (size_t i = 0; i + 2 < indexCount; i += 3)
+				{
+					unsigned int triangle[3];
+					bool valid = true;
+					for (int corner = 0; corner < 3; corner++)
+					{
+						triangle[corner] = hasIndices ? ReadGlbIndex(indices, i + corner) : (unsigned int)(i + corner);
+						valid = valid && triangle[corner] < positions.count;
+						triangle[corner] += (unsigned int)vertexBase;
+					}
+					if (valid)
+					{
+						mesh.triangles.push_back(Mesh::PackIndices(triangle));
+					}
+				}
+			}
+
+			if (mesh.triangles.size() > 0)
+			{
+				mesh.hasNormals = allNormals;
+				mesh.completed = true;
+				meshRemap[meshIndex] = (int)scene.meshes.size();
+				scene.meshes.push_back(std::move(mesh));
+			}
+		}
+
+		//Instances come from the default scene's node trees, or from every root node if there is no scene
+		const ESL::JsonValue* nodes = document.Find("nodes");
+		if (nodes != nullptr)
+		{
+			std::vector<size_t> roots;
+			const ESL::JsonValue* scenes = document.Find("scenes");
+			size_t sceneIndex = (size_t)document.NumberOr("scene", 0);
+			if (scenes != nullptr && sceneIndex < scenes->array.size() && scenes->array[sceneIndex].Find("nodes") != nullptr)
+			{
+				const ESL::JsonValue* sceneNodes = scenes->array[sceneIndex].Find("nodes");
+				for (size_t i = 0; i < sceneNodes->array.size(); i++)
+				{
+					roots.push_back((size_t)sceneNodes->array[i].number);
+				}
+			}
+			else
+			{
+				std::vector<char> isChild(nodes->array.size(), 0);
+				for (size_t i = 0; i < nodes->array.size(); i++)
+				{
+					const ESL::JsonValue* children = nodes->array[i].Find("children");
+					for (size_t j = 0; children != nullptr && j < children->array.size(); j++)
+					{
+						if ((size_t)children->array[j].number < isChild.size())
+						{
+							isChild[(size_t)children->array[j].number] = 1;
+						}
+					}
+				}
+				for (size_t i = 0; i < nodes->array.size(); i++)
+				{
+					if (!isChild[i])
+					{
+						roots.push_back(i);
+					}
+				}
+			}
+
+			const float identity[16] = { 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1 };
+			size_t visits = 0;
+			for (size_t i = 0; i < roots.size(); i++)
+			{
+				if (!CollectGlbInstances(*nodes, roots[i], identity, meshRemap, scene.instances, 0, visits))
+				{
+					std::ostringstream oss;
+					oss << "ReadGlb: Node hierarchy expands past " << maxGlbInstances << " instances or " << maxGlbNodeVisits << " node visits, keeping the first " << scene.instances.size() << " instances";
+					DEBUGWARN(oss.str())
+					break;
+				}
+			}
+		}
+
+		std::ostringstream oss;
+		oss << "Read " << scene.meshes.size() << " meshes and " << scene.instances.size() << " instances from GLB";
+		if (skippedPrimitives > 0)
+		{
+			oss << ", skipped " << skippedPrimitives << " primitives that aren't indexable triangle lists";
+		}
+		DEBUGLOG(oss.str())
+
+		return scene;
+	}
+
+	void MeshDecoder::ApplyImportSettings(Mesh& mesh, const MeshImportSettings& settings)
+	{
+		size_t removedTriangles = 0;
+		if (settings.removeDegenerateTriangles)
+		{
+			removedTriangles = RemoveDegenerateTriangles(mesh, settings.threadCount);
+		}
+
+		if ((mesh.rootIndex == 4294967295 || removedTriangles > 0) && mesh.triangles.size() > 0)
+		{
+			ESL::Arena scratch;
+			mesh.BuildHierarchy(scratch);
+			LogScratchStatistics(scratch);
+		}
+
+		if (!mesh.hasNormals)
+		{
+			GenerateNormals(mesh, settings.normalWeighting, settings.threadCount);
+		}
+
+		if (settings.reorderForLocality)
+		{
+			mesh.ReorderForLocality();
+		}
+
+		if (settings.compressAttributes)
+		{
+			CompressAttributes(mesh, settings.threadCount);
+		}
+
+		if (settings.buildMeshlets) //Last, since meshlets copy the final vertex numbering
+		{
+			mesh.BuildMeshlets();
+
+			//The packed triangles stay resident for the GPU path and the per triangle hierarchy, so the meshlets add to the index memory
+			size_t packedBytes = mesh.triangles.size() * sizeof(Mesh::Triangle);
+			size_t meshletBytes = mesh.meshletIndices.size() + mesh.meshletVertices.size() * sizeof(unsigned int) + mesh.meshlets.size() * sizeof(Mesh::Meshlet) + mesh.meshletHierarchy.size() * sizeof(Mesh::Node);
+			std::ostringstream oss;
+			oss << "Built " << mesh.meshlets.size() << " meshlets (" << (mesh.meshlets.size() > 0 ? (double)mesh.triangles.size() / (double)mesh.meshlets.size() : 0.0) << " triangles each). Index bytes: "
+				<< packedBytes << " packed plus " << meshletBytes << " for meshlets and their hierarchy, " << mesh.GetMemoryUsage() << " bytes resident in total. Hierarchy nodes: "
+				<< mesh.nodeHierarchy.size() << " -> " << mesh.meshletHierarchy.size();
+			DEBUGLOG(oss.str())
+		}
+	}
+
+	size_t MeshDecoder::RemoveDegenerateTriangles(Mesh& mesh, unsigned int threadCount)
+	{
+		if (threadCount == 0)
+		{
+			threadCount = ESL::ThreadCount();
+		}
+		size_t triangleCount = mesh.triangles.size();
+		std::vector<unsigned char> removed(triangleCount, 0); //0 kept, 1 degenerate, 2 duplicate, 3 opposite winding duplicate
+
+		//Key of the sorted vertex indices, identical for duplicates of either winding. Degenerate triangles get no key.
+		struct TriangleKey
+		{
+			unsigned long long key;
+			unsigned int triangle;
+		};
+		std::vector<TriangleKey> keys(triangleCount);
+		std::vector<size_t> degenerateCounts(threadCount, 0);
+		ESL::ParallelFor(triangleCount, [&](size_t begin, size_t end, unsigned int thread)
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				unsigned int indices[3];
+				Mesh::UnpackIndices(mesh.triangles[i], indices);
+				keys[i].triangle = (unsigned int)i;
+				keys[i].key = 0xffffffffffffffff;
+
+				bool degenerate = indices[0] == indices[1] || indices[1] == indices[2] || indices[2] == indices[0];
+				if (!degenerate) //Zero area when the edges are parallel
+				{
+					const float* p0 = mesh.positions[indices[0]].position;
+					const float* p1 = mesh.positions[indices[1]].position;
+					const float* p2 = mesh.positions[indices[2]].position;
+					double edgeA[3] = { (double)p1[0] - p0[0], (double)p1[1] - p0[1], (double)p1[2] - p0[2] };
+					double edgeB[3] = { (double)p2[0] - p0[0], (double)p2[1] - p0[1], (double)p2[2] - p0[2] };
+					double cross[3] = { edgeA[1] * edgeB[2] - edgeA[2] * edgeB[1], edgeA[2] * edgeB[0] - edgeA[0] * edgeB[2], edgeA[0] * edgeB[1] - edgeA[1] * edgeB[0] };
+					double crossLengthSquared = cross[0] * cross[0] + cross[1] * cross[1] + cross[2] * cross[2];
+					double edgeLengthsSquared = (edgeA[0] * edgeA[0] + edgeA[1] * edgeA[1] + edgeA[2] * edgeA[2]) * (edgeB[0] * edgeB[0] + edgeB[1] * edgeB[1] + edgeB[2] * edgeB[2]);
+					degenerate = crossLengthSquared <= edgeLengthsSquared * 1e-12;
+				}
+
+				if (degenerate)
+				{
+					removed[i] = 1;
+					degenerateCounts[thread]++;
+				}
+				else
+				{
+					std::sort(indices, indices + 3);
+					keys[i].key = ((unsigned long long)indices[0] << 40) | ((unsigned long long)indices[1] << 20) | (unsigned long long)indices[2];
+				}
+			}
+		}, threadCount);
+
+		ESL::ParallelSort(keys.begin(), keys.end(), [](const TriangleKey& a, const TriangleKey& b) { return a.key < b.key || (a.key == b.key && a.triangle < b.triangle); }, threadCount);
+
+		//Within a run of equal keys the lowest triangle index is kept, the rest are the same triangle with the same or flipped winding
+		auto rotated = [&](unsigned int triangle, unsigned int indices[3])
+		{
+			Mesh::UnpackIndices(mesh.triangles[triangle], indices);
+			while (indices[0] > indices[1] || indices[0] > indices[2])
+			{
+				unsigned int first = indices[0];
+				indices[0] = indices[1];
+				indices[1] = indices[2];
+				indices[2] = first;
+			}
+		};
+		size_t duplicateCount = 0;
+		size_t oppositeCount = 0;
+		for (size_t i = 0; i < keys.size() && keys[i].key != 0xffffffffffffffff;)
+		{
+			size_t run = 1;
+			unsigned int kept[3];
+			rotated(keys[i].triangle, kept);
+			while (i + run < keys.size() && keys[i + run].key == keys[i].key)
+			{
+				unsigned int other[3];
+				rotated(keys[i + run].triangle, other);
+				if (other[1] == kept[1])
+				{
+					removed[keys[i + run].triangle] = 2;
+					duplicateCount++;
+				}
+				else
+				{
+					removed[keys[i + run].triangle] = 3;
+					oppositeCount++;
+				}
+				run++;
+			}
+			i += run;
+		}
+
+		size_t degenerateCount = 0;
+		for (size_t thread = 0; thread < degenerateCounts.size(); thread++)
+		{
+			degenerateCount += degenerateCounts[thread];
+		}
+		size_t removedCount = degenerateCount + duplicateCount + oppositeCount;
+
+		if (removedCount > 0)
+		{
+			//Compact the triangles and drop the vertices only the removed triangles used
+			std::vector<unsigned int> vertexRemap(mesh.positions.size(), 4294967295);
+			std::vector<Mesh::Triangle> keptTriangles;
+			keptTriangles.reserve(triangleCount - removedCount);
+			for (size_t i = 0; i < triangleCount; i++)
+			{
+				if (removed[i] == 0)
+				{
+					keptTriangles.push_back(mesh.triangles[i]);
+
+					unsigned int indices[3];
+					Mesh::UnpackIndices(mesh.triangles[i], indices);
+					vertexRemap[indices[0]] = 0;
+					vertexRemap[indices[1]] = 0;
+					vertexRemap[indices[2]] = 0;
+				}
+			}
+
+			unsigned int vertexCount = 0;
+			for (size_t vert = 0; vert < vertexRemap.size(); vert++)
+			{
+				if (vertexRemap[vert] == 0)
+				{
+					vertexRemap[vert] = vertexCount;
+					mesh.positions[vertexCount] = mesh.positions[vert];
+					if (mesh.attributes.size() == vertexRemap.size())
+					{
+						mesh.attributes[vertexCount] = mesh.attributes[vert];
+					}
+					if (mesh.compressedAttributes.size() == vertexRemap.size())
+					{
+						mesh.compressedAttributes[vertexCount] = mesh.compressedAttributes[vert];
+					}
+					vertexCount++;
+				}
+			}
+			if (mesh.attributes.size() == mesh.positions.size())
+			{
+				mesh.attributes.resize(vertexCount);
+			}
+			if (mesh.compressedAttributes.size() == mesh.positions.size())
+			{
+				mesh.compressedAttributes.resize(vertexCount);
+			}
+			mesh.positions.resize(vertexCount);
+
+			for (size_t i = 0; i < keptTriangles.size(); i++)
+			{
+				unsigned int indices[3];
+				Mesh::UnpackIndices(keptTriangles[i], indices);
+				indices[0] = vertexRemap[indices[0]];
+				indices[1] = vertexRemap[indices[1]];
+				indices[2] = vertexRemap[indices[2]];
+				keptTriangles[i] = Mesh::PackIndices(indices);
+			}
+			mesh.triangles.swap(keptTriangles);
+
+			//The old hierarchy points at removed triangles
+			mesh.nodeHierarchy.clear();
+			mesh.rootIndex = 4294967295;
+		}
+
+		std::ostringstream oss;
+		oss << "Removed " << removedCount << " of " << triangleCount << " triangles from " << mesh.meshName << ": " << degenerateCount << " degenerate, " << duplicateCount << " duplicate, " << oppositeCount << " opposite winding duplicate";
+		DEBUGLOG(oss.str())
+
+		return removedCount;
+	}
+
+	void MeshDecoder::GenerateNormals(Mesh& mesh, NormalWeighting weighting, unsigned int threadCount)
+	{
+		size_t vertexCount = mesh.positions.size();
+		if (vertexCount == 0 || mesh.attributes.size() != vertexCount)
+		{
+			return;
+		}
+
+		//Group the triangle corners by vertex once, so every thread can own a range of vertices and sum their normals without per thread copies
+		std::vector<uint32_t> cornerOffsets(vertexCount + 1, 0);
+		std::vector<uint32_t> corners(mesh.triangles.size() * 3);
+		for (size_t i = 0; i < mesh.triangles.size(); i++)
+		{
+			unsigned int indices[3];
+			Mesh::UnpackIndices(mesh.triangles[i], indices);
+			cornerOffsets[indices[0] + 1]++;
+			cornerOffsets[indices[1] + 1]++;
+			cornerOffsets[indices[2] + 1]++;
+		}
+		for (size_t vert = 0; vert < vertexCount; vert++)
+		{
+			cornerOffsets[vert + 1] += cornerOffsets[vert];
+		}
+		std::vector<uint32_t> cursors(cornerOffsets.begin(), cornerOffsets.end() - 1);
+		for (size_t i = 0; i < mesh.triangles.size(); i++)
+		{
+			unsigned int indices[3];
+			Mesh::UnpackIndices(mesh.triangles[i], indices);
+			for (uint32_t corner = 0; corner < 3; corner++)
+			{
+				corners[cursors[indices[corner]]++] = (uint32_t)i * 3 + corner;
+			}
+		}
+		std::vector<uint32_t>().swap(cursors);
+
+		//Each vertex sums its corners in triangle order, so the normals don't depend on the thread count
+		ESL::ParallelFor(vertexCount, [&](size_t begin, size_t end, unsigned int)
+		{
+			for (size_t vert = begin; vert < end; vert++)
+			{
+				float normal[3] = { 0, 0, 0 };
+				for (uint32_t c = cornerOffsets[vert]; c < cornerOffsets[vert + 1]; c++)
+				{
+					uint32_t corner = corners[c] % 3;
+					unsigned int indices[3];
+					Mesh::UnpackIndices(mesh.triangles[corners[c] / 3], indices);
+
+					const float* p[3] = { mesh.positions[indices[0]].position, mesh.positions[indices[1]].position, mesh.positions[indices[2]].position };
+					float edgeA[3] = { p[1][0] - p[0][0], p[1][1] - p[0][1], p[1][2] - p[0][2] };
+					float edgeB[3] = { p[2][0] - p[0][0], p[2][1] - p[0][1], p[2][2] - p[0][2] };
+
+					//The unnormalized cross product has twice the triangle's area as its length
+					float cross[3] = { edgeA[1] * edgeB[2] - edgeA[2] * edgeB[1], edgeA[2] * edgeB[0] - edgeA[0] * edgeB[2], edgeA[0] * edgeB[1] - edgeA[1] * edgeB[0] };
+					float length = sqrtf(cross[0] * cross[0] + cross[1] * cross[1] + cross[2] * cross[2]);
+					if (length == 0)
+					{
+						continue;
+					}
+
+					float weight = 1.0f;
+					if (weighting == NormalWeighting::Angle) //Unit face normal scaled by the angle the triangle spans at this corner
+					{
+						const float* origin = p[corner];
+						const float* next = p[(corner + 1) % 3];
+						const float* previous = p[(corner + 2) % 3];
+						float a[3] = { next[0] - origin[0], next[1] - origin[1], next[2] - origin[2] };
+						float b[3] = { previous[0] - origin[0], previous[1] - origin[1], previous[2] - origin[2] };
+						float magnitudes = sqrtf((a[0] * a[0] + a[1] * a[1] + a[2] * a[2]) * (b[0] * b[0] + b[1] * b[1] + b[2] * b[2]));
+						weight = magnitudes > 0 ? acosf(std::min(std::max((a[0] * b[0] + a[1] * b[1] + a[2] * b[2]) / magnitudes, -1.0f), 1.0f)) / length : 0.0f;
+					}
+
+					normal[0] += cross[0] * weight;
+					normal[1] += cross[1] * weight;
+					normal[2] += cross[2] * weight;
+				}
+
+				float magnitude = sqrtf(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+				float scale = magnitude > 0 ? 1.0f / magnitude : 0.0f;
+				mesh.attributes[vert].normal[0] = normal[0] * scale;
+				mesh.attributes[vert].normal[1] = normal[1] * scale;
+				mesh.attributes[vert].normal[2] = normal[2] * scale;
+			}
+		}, threadCount == 0 ? ESL::ThreadCount() : threadCount);
+
+		mesh.hasNormals = true;
+	}
+
+	void MeshDecoder::CompressAttributes(Mesh& mesh, unsigned int threadCount)
+	{
+		if (mesh.attributesCompressed)
+		{
+			return;
+		}
+
+		mesh.compressedAttributes.resize(mesh.attributes.size());
+
+		//Only encodes, the round trip error against VertexCompression's bounds is measured by EngineBenchmark --compression-error
+		ESL::ParallelFor(mesh.attributes.size(), [&](size_t begin, size_t end, unsigned int)
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				mesh.compressedAttributes[i] = VertexCompression::Compress(mesh.attributes[i]);
+			}
+		}, threadCount == 0 ? ESL::ThreadCount() : threadCount);
+
+		std::ostringstream oss;
+		oss << "Compressed " << mesh.attributes.size() << " vertex attributes (" << mesh.attributes.size() * sizeof(Mesh::VertexAttribute) << " -> " << mesh.compressedAttributes.size() * sizeof(Mesh::CompressedVertexAttribute) << " bytes)";
+		DEBUGLOG(oss.str())
+
+		mesh.attributes.clear();
+		mesh.attributes.shrink_to_fit();
+		mesh.attributesCompressed = true;
 	}
 }
\ No newline at end of file
@@ -2,14 +2,57 @@
 
 #include "Mesh.h"
 
+#include <functional>
 #include <vector>
 
 namespace MeshManagement
 {
+	enum class NormalWeighting
+	{
+		Area, //Face normals weighted by triangle area
+		Angle //Face normals weighted by the angle at each corner, independent of how a surface is tessellated
+	};
+
+	struct MeshImportSettings
+	{
+		bool removeDegenerateTriangles = true; //Drop zero area and duplicated triangles before the hierarchy is built
+		NormalWeighting normalWeighting = NormalWeighting::Angle; //Used when the file doesn't provide vertex normals
+		bool reorderForLocality = true; //Renumber triangles and vertices in BVH leaf order
+		bool compressAttributes = false; //Store normals and UVs as Mesh::CompressedVertexAttribute
+		bool buildMeshlets = false; //Cluster triangles into Mesh::Meshlet with their own hierarchy
+		unsigned int threadCount = 0; //Threads each step may use, 0 for ESL::ThreadCount(). 1 when the caller already imports meshes in parallel.
+	};
+
+	//Placement of one of a scene file's meshes, transform is a row major 3x4 object to world matrix
+	struct SceneInstance
+	{
+		unsigned int meshIndex; //Into DecodedScene::meshes
+		float transform[12];
+	};
+
+	struct DecodedScene
+	{
+		std::vector<Mesh> meshes;
+		std::vector<SceneInstance> instances;
+	};
+
 	class __declspec(dllexport) MeshDecoder
 	{
 	public:
 		static std::vector<Mesh> ReadAsciiStl(const char* path);
+		//Hands every facet of every solid to onTriangle as it is parsed, without keeping them, for files too large to hold as a Mesh
+		static bool StreamAsciiStl(const char* path, const std::function<void(Mesh::Vertex[3])>& onTriangle);
 		static Mesh ReadObj(const char* path);
+		//Binary little or big endian PLY. The body is memory mapped and vertices go straight into the mesh's arrays.
+		static Mesh ReadPly(const char* path);
+		//Binary glTF 2.0. Each glTF mesh becomes one Mesh with its triangle primitives merged, and every node referencing a mesh
+		//becomes an instance of it rather than a copy. Only the embedded binary buffer is read, external URIs are rejected.
+		static DecodedScene ReadGlb(const char* path);
+	public:
+		//Decoders only fill the vertex and triangle lists, this cleans them up, builds the hierarchy and runs the optional stages
+		static void ApplyImportSettings(Mesh& mesh, const MeshImportSettings& settings);
+		static size_t RemoveDegenerateTriangles(Mesh& mesh, unsigned int threadCount = 0);
+		static void GenerateNormals(Mesh& mesh, NormalWeighting weighting, unsigned int threadCount = 0);
+		static void CompressAttributes(Mesh& mesh, unsigned int threadCount = 0);
 	};
 }
\ No newline at end of file
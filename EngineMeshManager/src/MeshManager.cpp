@@ -1,24 +1,74 @@
 #include "MeshManager.h"
+#include "VertexCompression.h"
+#include "MeshSimplifier.h"
+#include "MeshTracer.h"
 #include "EngineLogger.h"
+#include "EngineStandard/Memory.h"
+#include "EngineStandard/Hash.h"
+#include "EngineStandard/Parallel.h"
+#include "EngineStandard/ThreadPool.h"
+#include "Engine/Graphics/Matrix.h"
 
 #include <string>
 #include <sstream>
+#include <fstream>
 #include <ctime>
+#include <iterator>
+#include <chrono>
+#include <math.h>
+#include <string.h>
+#include <algorithm>
 
 namespace MeshManagement
 {
+	namespace
+	{
+		//Decoded meshes plus their hierarchy come to about twice the size of a text mesh file
+		size_t EstimateImportBytes(const char* path)
+		{
+			std::ifstream file(path, std::ios::binary | std::ios::ate);
+			if (!file.is_open())
+			{
+				return 0;
+			}
+			return (size_t)file.tellg() * 2;
+		}
+
+		template <class T> bool SameElements(const std::vector<T>& a, const std::vector<T>& b)
+		{
+			return a.size() == b.size() && (a.empty() || memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0);
+		}
+
+		//Import keys only say two meshes are probably the same, the imported geometry decides
+		bool SameContent(const Mesh& a, const Mesh& b)
+		{
+			return SameElements(a.positions, b.positions) && SameElements(a.attributes, b.attributes) && SameElements(a.compressedAttributes, b.compressedAttributes)
+				&& SameElements(a.triangles, b.triangles) && SameElements(a.meshletIndices, b.meshletIndices) && SameElements(a.meshletVertices, b.meshletVertices);
+		}
+	}
+
 	MeshManager::MeshManager()
 	{
 
 	}
 
-	void MeshManager::ReadMeshFile(const char* path)
+	MeshManager::~MeshManager()
 	{
+		fileWatcher.reset();
 		{
-			std::ostringstream oss;
-			oss << "Reading Mesh File " << path;
-			DEBUGLOG(oss.str());
+			std::lock_guard<std::mutex> lock(reloadMutex);
+			stopReloading = true;
+		}
+		reloadCondition.notify_all();
+		if (reloadThread.joinable())
+		{
+			reloadThread.join();
 		}
+	}
+
+	std::vector<Mesh> MeshManager::DecodeMeshFile(const char* path, std::vector<SceneInstance>* instances)
+	{
+		std::vector<Mesh> result;
 
 		std::string pathstr = std::string(path);
 		size_t extensionIndex = pathstr.find_last_of('.');
@@ -27,34 +77,638 @@ namespace MeshManagement
 			pathstr.erase(0, extensionIndex + 1);
 			if (pathstr == "stl")
 			{
-				double timeStart = (double)clock() / CLOCKS_PER_SEC;
-				std::vector<Mesh> readFileResult = MeshDecoder::ReadAsciiStl(path);
+				result = MeshDecoder::ReadAsciiStl(path);
+			}
+			else if (pathstr == "obj")
+			{
+				result.push_back(MeshDecoder::ReadObj(path));
+			}
+			else if (pathstr == "ply")
+			{
+				result.push_back(MeshDecoder::ReadPly(path));
+			}
+			else if (pathstr == "glb")
+			{
+				DecodedScene scene = MeshDecoder::ReadGlb(path);
+				result = std::move(scene.meshes);
+				if (instances != nullptr)
+				{
+					*instances = std::move(scene.instances);
+				}
+			}
+			else
+			{
+				DEBUGERROR("ReadMeshFile Failed: Unknown File Extension")
+			}
+		}
 
-				meshes.insert(meshes.end(), readFileResult.begin(), readFileResult.end());
-				upToDate = false;
+		return result;
+	}
 
-				std::ostringstream oss;
-				oss << "Finished Reading Mesh File. Task time: " << ((double)clock() / CLOCKS_PER_SEC) - timeStart << " seconds";
-				DEBUGLOG(oss.str())
+	std::vector<MeshHandle> MeshManager::ReadMeshFile(const char* path, MeshImportSettings settings)
+	{
+		{
+			std::ostringstream oss;
+			oss << "Reading Mesh File " << path;
+			DEBUGLOG(oss.str());
+		}
+
+		double timeStart = (double)clock() / CLOCKS_PER_SEC;
+		size_t duplicatesBefore = deduplicationStatistics.duplicates;
+		size_t bytesSavedBefore = deduplicationStatistics.bytesSaved;
+
+		std::vector<SceneInstance> fileInstances;
+		std::vector<Mesh> readFileResult = DecodeMeshFile(path, &fileInstances);
+		if (readFileResult.size() == 0)
+		{
+			return std::vector<MeshHandle>();
+		}
+
+		std::vector<MeshHandle> handles;
+		for (unsigned int i = 0; i < readFileResult.size(); i++)
+		{
+			unsigned long long key = ImportKey(readFileResult[i], settings);
+			handles.push_back(AddMesh(std::move(readFileResult[i]), settings, key, false));
+		}
+		AddInstances(fileInstances, handles);
+
+		{
+			std::lock_guard<std::mutex> lock(reloadMutex);
+			sourceFiles.push_back({ std::string(path), settings, handles });
+		}
+		if (fileWatcher)
+		{
+			fileWatcher->Watch(std::string(path));
+		}
+
+		{
+			std::ostringstream oss;
+			oss << "Finished Reading Mesh File. Task time: " << ((double)clock() / CLOCKS_PER_SEC) - timeStart << " seconds, Peak resident memory: " << ESL::PeakResidentBytes() / 1048576.0 << " MB";
+			DEBUGLOG(oss.str())
+		}
+
+		if (deduplicationStatistics.duplicates > duplicatesBefore)
+		{
+			std::ostringstream oss;
+			oss << "Shared " << deduplicationStatistics.duplicates - duplicatesBefore << " duplicate meshes, saved " << (deduplicationStatistics.bytesSaved - bytesSavedBefore) / 1048576.0
+				<< " MB. Total: " << deduplicationStatistics.uniqueMeshes << " unique meshes for " << deduplicationStatistics.handles << " handles, " << deduplicationStatistics.bytesSaved / 1048576.0 << " MB saved";
+			DEBUGLOG(oss.str())
+		}
+
+		return handles;
+	}
+
+	unsigned long long MeshManager::ImportKey(const Mesh& mesh, const MeshImportSettings& settings)
+	{
+		//The settings are part of the key since the same geometry imported with different settings produces different meshes
+		unsigned char settingsKey[5] = { (unsigned char)settings.removeDegenerateTriangles, (unsigned char)settings.normalWeighting, (unsigned char)settings.reorderForLocality,
+			(unsigned char)settings.compressAttributes, (unsigned char)settings.buildMeshlets };
+		return ESL::Hash64(settingsKey, sizeof(settingsKey), mesh.ComputeContentHash());
+	}
+
+	void MeshManager::AddInstances(const std::vector<SceneInstance>& fileInstances, const std::vector<MeshHandle>& fileHandles)
+	{
+		for (size_t i = 0; i < fileInstances.size(); i++)
+		{
+			AddInstance(fileHandles[fileInstances[i].meshIndex], fileInstances[i].transform);
+		}
+	}
+
+	unsigned int MeshManager::AddInstance(MeshHandle mesh, const float transform[12])
+	{
+		if (mesh.id >= handleMeshes.size())
+		{
+			DEBUGERROR("AddInstance Failed: Invalid mesh handle " + std::to_string(mesh.id))
+			return 4294967295;
+		}
+
+		instanceMeshes.push_back(mesh);
+		for (int i = 0; i < 12; i++)
+		{
+			instanceTransforms.objectToWorld[i].push_back(0);
+			instanceTransforms.worldToObject[i].push_back(0);
+		}
+		instanceTransforms.singular.push_back(0);
+		unsigned int instance = (unsigned int)instanceMeshes.size() - 1;
+		SetInstanceTransform(instance, transform);
+		return instance;
+	}
+
+	void MeshManager::SetInstanceTransform(unsigned int instance, const float transform[12])
+	{
+		if (instance >= instanceMeshes.size())
+		{
+			DEBUGERROR("SetInstanceTransform Failed: Invalid instance " + std::to_string(instance))
+			return;
+		}
+
+		Matrix3x4<float> objectToWorld = Matrix3x4<float>(transform[0], transform[1], transform[2], transform[3], transform[4], transform[5], transform[6], transform[7], transform[8], transform[9], transform[10], transform[11]);
+		bool invertible;
+		Matrix3x4<float> worldToObject = Matrix3x4<float>::Invert(objectToWorld, &invertible);
+		if (!invertible) //Flattened to a plane, line or point, there is no surface left to hit
+		{
+			DEBUGWARN("SetInstanceTransform: Instance " + std::to_string(instance) + " has a singular transform and is hidden")
+		}
+		instanceTransforms.singular[instance] = invertible ? 0 : 1;
+		const float inverse[12] = { worldToObject.x0, worldToObject.y0, worldToObject.z0, worldToObject.w0, worldToObject.x1, worldToObject.y1, worldToObject.z1, worldToObject.w1, worldToObject.x2, worldToObject.y2, worldToObject.z2, worldToObject.w2 };
+
+		for (int i = 0; i < 12; i++)
+		{
+			instanceTransforms.objectToWorld[i][instance] = transform[i];
+			instanceTransforms.worldToObject[i][instance] = inverse[i];
+		}
+	}
+
+	bool MeshManager::FindMesh(unsigned long long key, const Mesh& mesh, uint16_t& index) const
+	{
+		auto range = meshesByHash.equal_range(key);
+		for (auto candidate = range.first; candidate != range.second; candidate++)
+		{
+			if (SameContent(meshes[candidate->second], mesh))
+			{
+				index = candidate->second;
+				return true;
 			}
-			else if (pathstr == "obj")
+		}
+		return false;
+	}
+
+	MeshHandle MeshManager::AddMesh(Mesh&& mesh, const MeshImportSettings& settings, unsigned long long key, bool settingsApplied)
+	{
+		MeshHandle handle;
+		handle.id = (unsigned int)handleMeshes.size();
+		deduplicationStatistics.handles++;
+
+		//Stored meshes are imported, so the candidate is imported too before its content is compared
+		if (!settingsApplied)
+		{
+			MeshDecoder::ApplyImportSettings(mesh, settings);
+		}
+
+		uint16_t existing;
+		if (FindMesh(key, mesh, existing))
+		{
+			handleMeshes.push_back(existing);
+			deduplicationStatistics.duplicates++;
+			deduplicationStatistics.bytesSaved += meshes[existing].GetMemoryUsage();
+			return handle;
+		}
+		if (meshesByHash.count(key) > 0)
+		{
+			DEBUGWARN("AddMesh: Mesh " + mesh.meshName + " has the import key of a different mesh, keeping it separate")
+		}
+
+		uint16_t index = (uint16_t)meshes.size();
+		meshes.push_back(std::move(mesh));
+		meshKeys.push_back(key);
+		meshesByHash.emplace(key, index);
+		handleMeshes.push_back(index);
+		deduplicationStatistics.uniqueMeshes++;
+		upToDate = false;
+		return handle;
+	}
+
+	std::vector<std::vector<MeshHandle>> MeshManager::ReadMeshFiles(const char* const* paths, size_t pathCount, MeshImportSettings settings, size_t memoryBudgetBytes, unsigned int threadCount)
+	{
+		typedef std::chrono::steady_clock Clock;
+		auto batchStart = Clock::now();
+
+		struct DecodedFile
+		{
+			std::vector<Mesh> meshes;
+			std::vector<SceneInstance> instances;
+			std::vector<unsigned long long> keys;
+			size_t reservedBytes = 0;
+			bool ready = false;
+		};
+		std::vector<DecodedFile> files(pathCount);
+		fileImportTimings.assign(pathCount, FileImportTiming());
+
+		std::mutex batchMutex; //Guards everything below and meshesByHash while the workers run
+		std::condition_variable fileReady;
+		std::condition_variable memoryReleased;
+		size_t nextAdmittedFile = 0; //Memory is granted in path order so a later file can't starve the file being committed
+		size_t bytesInFlight = 0;
+		size_t peakBytesInFlight = 0;
+
+		std::vector<std::vector<MeshHandle>> handles(pathCount);
+		{
+			if (threadCount == 0)
 			{
-				double timeStart = (double)clock() / CLOCKS_PER_SEC;
+				threadCount = ESL::ThreadCount();
+			}
+			ESL::ThreadPool pool((unsigned int)std::max<size_t>(1, std::min<size_t>(threadCount, pathCount)));
 
-				Mesh readFileResult = MeshDecoder::ReadObj(path);
+			//The pool already runs a file per thread, so the import steps inside each file stay serial
+			MeshImportSettings buildSettings = settings;
+			buildSettings.threadCount = pool.GetThreadCount() > 1 ? 1 : settings.threadCount;
 
-				meshes.push_back(readFileResult);
-				upToDate = false;
+			for (size_t i = 0; i < pathCount; i++)
+			{
+				pool.Submit([&, i]()
+				{
+					DecodedFile& file = files[i];
+					FileImportTiming& timing = fileImportTimings[i];
+					timing.path = paths[i];
+
+					auto waitStart = Clock::now();
+					size_t estimate = EstimateImportBytes(paths[i]);
+					{
+						std::unique_lock<std::mutex> lock(batchMutex);
+						memoryReleased.wait(lock, [&]() { return nextAdmittedFile == i && (bytesInFlight == 0 || bytesInFlight + estimate <= memoryBudgetBytes); });
+						nextAdmittedFile++;
+						bytesInFlight += estimate;
+						peakBytesInFlight = std::max(peakBytesInFlight, bytesInFlight);
+					}
+					memoryReleased.notify_all();
+
+					auto decodeStart = Clock::now();
+					file.meshes = DecodeMeshFile(paths[i], &file.instances);
+					for (size_t j = 0; j < file.meshes.size(); j++)
+					{
+						file.keys.push_back(ImportKey(file.meshes[j], settings));
+					}
+
+					auto buildStart = Clock::now();
+					size_t actualBytes = 0;
+					for (size_t j = 0; j < file.meshes.size(); j++)
+					{
+						//Every mesh is imported, a duplicate is only known once its imported content matches a committed mesh
+						MeshDecoder::ApplyImportSettings(file.meshes[j], buildSettings);
+						actualBytes += file.meshes[j].GetMemoryUsage();
+						timing.triangleCount += file.meshes[j].triangles.size();
+					}
+					auto buildEnd = Clock::now();
+
+					timing.meshCount = file.meshes.size();
+					timing.memoryWaitSeconds = std::chrono::duration<double>(decodeStart - waitStart).count();
+					timing.decodeSeconds = std::chrono::duration<double>(buildStart - decodeStart).count();
+					timing.buildSeconds = std::chrono::duration<double>(buildEnd - buildStart).count();
+
+					{
+						std::lock_guard<std::mutex> lock(batchMutex);
+						bytesInFlight = bytesInFlight - estimate + actualBytes;
+						peakBytesInFlight = std::max(peakBytesInFlight, bytesInFlight);
+						file.reservedBytes = actualBytes;
+						file.ready = true;
+					}
+					fileReady.notify_all();
+					memoryReleased.notify_all();
+				});
+			}
+
+			//Commit on this thread in path order while the pool works on later files
+			for (size_t i = 0; i < pathCount; i++)
+			{
+				DecodedFile& file = files[i];
+				{
+					std::unique_lock<std::mutex> lock(batchMutex);
+					fileReady.wait(lock, [&]() { return file.ready; });
+				}
+
+				for (size_t j = 0; j < file.meshes.size(); j++)
+				{
+					std::lock_guard<std::mutex> lock(batchMutex);
+					handles[i].push_back(AddMesh(std::move(file.meshes[j]), buildSettings, file.keys[j], true));
+				}
+				file.meshes.clear();
+				file.meshes.shrink_to_fit();
+				AddInstances(file.instances, handles[i]);
+
+				if (handles[i].size() > 0)
+				{
+					{
+						std::lock_guard<std::mutex> lock(reloadMutex);
+						sourceFiles.push_back({ std::string(paths[i]), settings, handles[i] });
+					}
+					if (fileWatcher)
+					{
+						fileWatcher->Watch(std::string(paths[i]));
+					}
+				}
+
+				{
+					std::lock_guard<std::mutex> lock(batchMutex);
+					bytesInFlight -= file.reservedBytes;
+				}
+				memoryReleased.notify_all();
+			}
+		}
+
+		double decodeSeconds = 0;
+		double buildSeconds = 0;
+		size_t meshCount = 0;
+		size_t triangleCount = 0;
+		for (size_t i = 0; i < pathCount; i++)
+		{
+			const FileImportTiming& timing = fileImportTimings[i];
+			decodeSeconds += timing.decodeSeconds;
+			buildSeconds += timing.buildSeconds;
+			meshCount += timing.meshCount;
+			triangleCount += timing.triangleCount;
+
+			std::ostringstream oss;
+			oss << timing.path << ": " << timing.meshCount << " meshes, " << timing.triangleCount << " triangles. Memory wait: " << timing.memoryWaitSeconds * 1000.0
+				<< " ms, Decode: " << timing.decodeSeconds * 1000.0 << " ms, Build: " << timing.buildSeconds * 1000.0 << " ms";
+			DEBUGLOG(oss.str())
+		}
+
+		std::ostringstream oss;
+		oss << "Read " << pathCount << " mesh files (" << meshCount << " meshes, " << triangleCount << " triangles) in " << std::chrono::duration<double>(Clock::now() - batchStart).count()
+			<< " seconds. Decode total: " << decodeSeconds << " seconds, Build total: " << buildSeconds << " seconds, Peak in flight: " << peakBytesInFlight / 1048576.0
+			<< " MB of " << memoryBudgetBytes / 1048576.0 << " MB budget, Peak resident memory: " << ESL::PeakResidentBytes() / 1048576.0 << " MB";
+		DEBUGLOG(oss.str())
+
+		return handles;
+	}
+
+	const std::vector<MeshManager::FileImportTiming>& MeshManager::GetFileImportTimings() const
+	{
+		return fileImportTimings;
+	}
+
+	void MeshManager::EnableHotReload()
+	{
+		if (fileWatcher)
+		{
+			return;
+		}
+
+		reloadThread = std::thread(&MeshManager::ReloadLoop, this);
+		fileWatcher = std::make_unique<FileWatcher>([this](const std::string& path) { FileChanged(path); });
+
+		//The watcher calls FileChanged, which takes reloadMutex, so Watch and its lock are kept outside reloadMutex
+		std::vector<std::string> paths;
+		{
+			std::lock_guard<std::mutex> lock(reloadMutex);
+			for (size_t i = 0; i < sourceFiles.size(); i++)
+			{
+				paths.push_back(sourceFiles[i].path);
+			}
+		}
+		for (size_t i = 0; i < paths.size(); i++)
+		{
+			fileWatcher->Watch(paths[i]);
+		}
+	}
+
+	void MeshManager::FileChanged(const std::string& path)
+	{
+		{
+			std::lock_guard<std::mutex> lock(reloadMutex);
+			auto now = std::chrono::steady_clock::now();
+			bool queued = false;
+			for (size_t i = 0; i < changedFiles.size(); i++)
+			{
+				if (changedFiles[i].first == path)
+				{
+					changedFiles[i].second = now;
+					queued = true;
+				}
+			}
+			if (!queued)
+			{
+				changedFiles.push_back({ path, now });
+			}
+		}
+		reloadCondition.notify_one();
+	}
+
+	void MeshManager::ReloadLoop()
+	{
+		//Editors often write a file in several steps, so a file is only re-imported once it has been left alone for a moment
+		const std::chrono::milliseconds settleTime(250);
+
+		std::unique_lock<std::mutex> lock(reloadMutex);
+		while (true)
+		{
+			if (stopReloading)
+			{
+				return;
+			}
+			if (changedFiles.size() == 0)
+			{
+				reloadCondition.wait(lock);
+				continue;
+			}
+
+			auto now = std::chrono::steady_clock::now();
+			auto nextSettled = std::chrono::steady_clock::time_point::max();
+			size_t settled = changedFiles.size();
+			for (size_t i = 0; i < changedFiles.size(); i++)
+			{
+				if (now - changedFiles[i].second >= settleTime)
+				{
+					settled = i;
+					break;
+				}
+				nextSettled = std::min(nextSettled, changedFiles[i].second + settleTime);
+			}
+			if (settled == changedFiles.size())
+			{
+				reloadCondition.wait_until(lock, nextSettled);
+				continue;
+			}
 
+			std::string path = changedFiles[settled].first;
+			changedFiles.erase(changedFiles.begin() + settled);
+			std::vector<SourceFile> files;
+			for (size_t i = 0; i < sourceFiles.size(); i++)
+			{
+				if (sourceFiles[i].path == path)
+				{
+					files.push_back(sourceFiles[i]);
+				}
+			}
+
+			lock.unlock();
+
+			double timeStart = (double)clock() / CLOCKS_PER_SEC;
+			std::vector<Mesh> decoded = DecodeMeshFile(path.c_str());
+			std::vector<ReloadedMesh> reloaded;
+			for (size_t file = 0; file < files.size(); file++)
+			{
+				std::vector<Mesh> readFileResult = file + 1 < files.size() ? decoded : std::move(decoded);
+				if (readFileResult.size() != files[file].handles.size())
+				{
+					std::ostringstream oss;
+					oss << "Hot reload of " << path << " read " << readFileResult.size() << " meshes, expected " << files[file].handles.size() << ". Only matching meshes are replaced";
+					DEBUGWARN(oss.str())
+				}
+
+				for (size_t i = 0; i < readFileResult.size() && i < files[file].handles.size(); i++)
+				{
+					if (readFileResult[i].triangles.size() == 0)
+					{
+						continue;
+					}
+					unsigned long long key = ImportKey(readFileResult[i], files[file].settings);
+					MeshDecoder::ApplyImportSettings(readFileResult[i], files[file].settings);
+					reloaded.push_back({ files[file].handles[i], key, std::move(readFileResult[i]) });
+				}
+			}
+
+			{
 				std::ostringstream oss;
-				oss << "Finished Reading Mesh File. Task time: " << ((double)clock() / CLOCKS_PER_SEC) - timeStart << " seconds";
+				oss << "Re-imported " << path << " in the background. Task time: " << ((double)clock() / CLOCKS_PER_SEC) - timeStart << " seconds";
 				DEBUGLOG(oss.str())
 			}
-			else
+
+			lock.lock();
+			reloadedMeshes.insert(reloadedMeshes.end(), std::make_move_iterator(reloaded.begin()), std::make_move_iterator(reloaded.end()));
+		}
+	}
+
+	bool MeshManager::ApplyReloadedMeshes()
+	{
+		std::vector<ReloadedMesh> reloaded;
+		{
+			std::lock_guard<std::mutex> lock(reloadMutex);
+			reloaded.swap(reloadedMeshes);
+		}
+
+		for (size_t i = 0; i < reloaded.size(); i++)
+		{
+			uint16_t index = handleMeshes[reloaded[i].handle.id];
+
+			//Other handles deduplicated onto this mesh keep the old geometry, the reloaded handle moves to a mesh of its own, or
+			//to one that already holds the new content
+			bool shared = false;
+			for (size_t id = 0; id < handleMeshes.size() && !shared; id++)
 			{
-				DEBUGERROR("ReadMeshFile Failed: Unknown File Extension")
+				shared = handleMeshes[id] == index && id != reloaded[i].handle.id;
 			}
+			if (shared)
+			{
+				uint16_t existing;
+				if (FindMesh(reloaded[i].key, reloaded[i].mesh, existing))
+				{
+					handleMeshes[reloaded[i].handle.id] = existing;
+					std::ostringstream oss;
+					oss << "Reloaded mesh " << reloaded[i].mesh.meshName << " matches an existing mesh, sharing it";
+					DEBUGLOG(oss.str())
+				}
+				else
+				{
+					uint16_t copy = (uint16_t)meshes.size();
+					handleMeshes[reloaded[i].handle.id] = copy;
+					meshKeys.push_back(reloaded[i].key);
+					meshesByHash.emplace(reloaded[i].key, copy);
+					deduplicationStatistics.uniqueMeshes++;
+					meshes.push_back(std::move(reloaded[i].mesh));
+
+					std::ostringstream oss;
+					oss << "Reloaded mesh " << meshes[copy].meshName << ": " << meshes[copy].triangles.size() << " triangles, was shared with other files so it was split off, uploading every mesh";
+					DEBUGLOG(oss.str())
+				}
+				upToDate = false;
+				continue;
+			}
+
+			Mesh& current = meshes[index];
+			bool sameLayout = current.positions.size() == reloaded[i].mesh.positions.size() && current.triangles.size() == reloaded[i].mesh.triangles.size()
+				&& current.attributesCompressed == reloaded[i].mesh.attributesCompressed && current.nodeHierarchy.size() == reloaded[i].mesh.nodeHierarchy.size();
+
+			auto previousKeys = meshesByHash.equal_range(meshKeys[index]);
+			for (auto previousKey = previousKeys.first; previousKey != previousKeys.second; previousKey++)
+			{
+				if (previousKey->second == index)
+				{
+					meshesByHash.erase(previousKey);
+					break;
+				}
+			}
+			meshKeys[index] = reloaded[i].key;
+			meshesByHash.emplace(reloaded[i].key, index);
+
+			std::swap(current, reloaded[i].mesh);
+
+			if (index < lods.size() && lods[index].size() > 0)
+			{
+				lods[index].clear();
+				DEBUGWARN("LODs of a reloaded mesh were discarded, call GenerateLods to rebuild them")
+			}
+
+			if (!sameLayout)
+			{
+				upToDate = false;
+			}
+			else if (std::find(dirtyMeshes.begin(), dirtyMeshes.end(), index) == dirtyMeshes.end())
+			{
+				dirtyMeshes.push_back(index);
+			}
+
+			std::ostringstream oss;
+			oss << "Reloaded mesh " << current.meshName << ": " << current.triangles.size() << " triangles, " << (sameLayout ? "uploading its range only" : "size changed, uploading every mesh");
+			DEBUGLOG(oss.str())
+		}
+
+		//A full upload covers the dirty ranges too
+		if (!upToDate)
+		{
+			dirtyMeshes.clear();
+		}
+
+		return reloaded.size() > 0;
+	}
+
+	std::vector<uint16_t> MeshManager::TakeDirtyMeshes()
+	{
+		std::vector<uint16_t> result;
+		result.swap(dirtyMeshes);
+		return result;
+	}
+
+	uint16_t MeshManager::GetMeshCount() const
+	{
+		return (uint16_t)meshes.size();
+	}
+
+	MeshManager::MeshRange MeshManager::GetMeshRange(uint16_t index) const
+	{
+		MeshRange range = { 0, meshes[index].positions.size(), 0, meshes[index].triangles.size() };
+		for (uint16_t i = 0; i < index; i++)
+		{
+			range.firstPosition += meshes[i].positions.size();
+			range.firstTriangle += meshes[i].triangles.size();
 		}
+		return range;
+	}
+
+	uint16_t MeshManager::GetMeshIndex(MeshHandle handle) const
+	{
+		return handleMeshes[handle.id];
+	}
+
+	const Mesh& MeshManager::GetMesh(MeshHandle handle) const
+	{
+		return meshes[handleMeshes[handle.id]];
+	}
+
+	MeshManager::DeduplicationStatistics MeshManager::GetDeduplicationStatistics() const
+	{
+		return deduplicationStatistics;
+	}
+
+	unsigned int MeshManager::GetInstanceCount() const
+	{
+		return (unsigned int)instanceMeshes.size();
+	}
+
+	MeshInstance MeshManager::GetInstance(unsigned int instance) const
+	{
+		MeshInstance result;
+		result.mesh = instanceMeshes[instance];
+		for (int i = 0; i < 12; i++)
+		{
+			result.transform[i] = instanceTransforms.objectToWorld[i][instance];
+		}
+		return result;
+	}
+
+	const MeshManager::InstanceTransforms& MeshManager::GetInstanceTransforms() const
+	{
+		return instanceTransforms;
 	}
 
 	Mesh MeshManager::GetMesh(uint16_t index)
@@ -62,17 +716,197 @@ namespace MeshManagement
 		return meshes[index];
 	}
 
+	void MeshManager::GenerateLods(unsigned int levelCount, float triangleRatio)
+	{
+		double timeStart = (double)clock() / CLOCKS_PER_SEC;
+
+		//Every level is simplified straight from the imported mesh so all levels can be built at once
+		std::vector<std::pair<size_t, size_t>> tasks; //Mesh index and triangle target
+		lods.assign(meshes.size(), std::vector<Mesh>());
+		for (size_t i = 0; i < meshes.size(); i++)
+		{
+			double target = (double)meshes[i].triangles.size();
+			for (unsigned int level = 1; level <= levelCount; level++)
+			{
+				target *= triangleRatio;
+				if (target < 16)
+				{
+					break;
+				}
+				tasks.push_back({ i, (size_t)target });
+				lods[i].push_back(Mesh(meshes[i].meshName));
+			}
+		}
+
+		std::vector<Mesh*> results;
+		for (size_t i = 0; i < lods.size(); i++)
+		{
+			for (size_t level = 0; level < lods[i].size(); level++)
+			{
+				results.push_back(&lods[i][level]);
+			}
+		}
+
+		//Levels are spread over the threads, so each level's own import steps run on the thread that simplified it
+		unsigned int threadCount = (unsigned int)std::min<size_t>(ESL::ThreadCount(), tasks.size());
+		ESL::ParallelFor(tasks.size(), [&](size_t begin, size_t end, unsigned int)
+		{
+			for (size_t task = begin; task < end; task++)
+			{
+				const Mesh& source = meshes[tasks[task].first];
+
+				MeshImportSettings settings;
+				settings.compressAttributes = source.attributesCompressed;
+				settings.buildMeshlets = source.meshlets.size() > 0;
+				settings.threadCount = threadCount > 1 ? 1 : 0;
+
+				*results[task] = MeshSimplifier::Simplify(source, tasks[task].second);
+				MeshDecoder::ApplyImportSettings(*results[task], settings);
+			}
+		}, threadCount);
+
+		{
+			std::ostringstream oss;
+			oss << "Generated " << tasks.size() << " LOD meshes. Task time: " << ((double)clock() / CLOCKS_PER_SEC) - timeStart << " seconds";
+			DEBUGLOG(oss.str())
+		}
+
+		for (size_t i = 0; i < meshes.size(); i++)
+		{
+			LogLodStatistics((uint16_t)i);
+		}
+	}
+
+	unsigned int MeshManager::GetLodCount(uint16_t index) const
+	{
+		return 1 + (index < lods.size() ? (unsigned int)lods[index].size() : 0);
+	}
+
+	const Mesh& MeshManager::GetLod(uint16_t index, unsigned int level) const
+	{
+		return level == 0 ? meshes[index] : lods[index][level - 1];
+	}
+
+	unsigned int MeshManager::SelectLod(uint16_t index, float distance, float coneSpreadAngle, float coneWidth, float objectScale) const
+	{
+		float footprint = coneWidth + distance * coneSpreadAngle;
+		for (unsigned int level = GetLodCount(index) - 1; level > 0; level--)
+		{
+			if (lods[index][level - 1].simplificationError * objectScale <= footprint)
+			{
+				return level;
+			}
+		}
+		return 0;
+	}
+
+	unsigned int MeshManager::SelectInstanceLod(unsigned int instance, float distance, float coneSpreadAngle, float coneWidth) const
+	{
+		if (instance >= instanceMeshes.size())
+		{
+			DEBUGERROR("SelectInstanceLod Failed: Invalid instance " + std::to_string(instance))
+			return 0;
+		}
+
+		//The longest an object space unit gets in world space, the length of the longest column of the transform
+		float objectScale = 0;
+		for (int column = 0; column < 3; column++)
+		{
+			float x = instanceTransforms.objectToWorld[column][instance];
+			float y = instanceTransforms.objectToWorld[4 + column][instance];
+			float z = instanceTransforms.objectToWorld[8 + column][instance];
+			objectScale = std::max(objectScale, sqrtf(x * x + y * y + z * z));
+		}
+		return SelectLod(handleMeshes[instanceMeshes[instance].id], distance, coneSpreadAngle, coneWidth, objectScale);
+	}
+
+	void MeshManager::LogLodStatistics(uint16_t index) const
+	{
+		const Mesh& base = meshes[index];
+		if (base.positions.size() == 0)
+		{
+			return;
+		}
+
+		//Fixed grid of rays fired along +z through the mesh's bounds
+		float boundsMin[3] = { INFINITY, INFINITY, INFINITY };
+		float boundsMax[3] = { -INFINITY, -INFINITY, -INFINITY };
+		for (size_t vert = 0; vert < base.positions.size(); vert++)
+		{
+			for (int axis = 0; axis < 3; axis++)
+			{
+				boundsMin[axis] = fminf(boundsMin[axis], base.positions[vert].position[axis]);
+				boundsMax[axis] = fmaxf(boundsMax[axis], base.positions[vert].position[axis]);
+			}
+		}
+
+		const int gridSize = 128;
+		double baseTime = 0;
+		for (unsigned int level = 0; level < GetLodCount(index); level++)
+		{
+			const Mesh& lod = GetLod(index, level);
+			MeshTracer tracer(lod);
+			MeshTracer::Statistics statistics;
+
+			auto traceStart = std::chrono::steady_clock::now();
+			for (int y = 0; y < gridSize; y++)
+			{
+				for (int x = 0; x < gridSize; x++)
+				{
+					MeshTracer::Ray ray;
+					ray.origin[0] = boundsMin[0] + (boundsMax[0] - boundsMin[0]) * ((float)x + 0.5f) / gridSize;
+					ray.origin[1] = boundsMin[1] + (boundsMax[1] - boundsMin[1]) * ((float)y + 0.5f) / gridSize;
+					ray.origin[2] = boundsMin[2] - 1.0f;
+					ray.direction[0] = 0;
+					ray.direction[1] = 0;
+					ray.direction[2] = 1;
+					tracer.Trace(ray, &statistics);
+				}
+			}
+			double traceTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - traceStart).count();
+			if (level == 0)
+			{
+				baseTime = traceTime;
+			}
+
+			std::ostringstream oss;
+			oss << base.meshName << " LOD " << level << ": " << lod.triangles.size() << " triangles, error " << lod.simplificationError
+				<< ", " << lod.GetMemoryUsage() << " bytes (" << (double)lod.GetMemoryUsage() / (double)base.GetMemoryUsage() * 100.0 << "%)"
+				<< ", " << traceTime << " ms for " << statistics.rays << " rays (" << (baseTime > 0 ? traceTime / baseTime * 100.0 : 100.0) << "%)"
+				<< ", " << (double)statistics.nodesVisited / (double)statistics.rays << " nodes per ray";
+			DEBUGLOG(oss.str())
+		}
+	}
+
 	bool MeshManager::IsUpToDate() const
 	{
 		return upToDate;
 	}
 
+	bool MeshManager::AttributesCompressed() const
+	{
+		if (meshes.size() == 0)
+		{
+			return false;
+		}
+
+		for (size_t i = 0; i < meshes.size(); i++)
+		{
+			if (!meshes[i].attributesCompressed)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
 	std::vector<Mesh::Triangle> MeshManager::GetTriangleArray()
 	{
 		upToDate = true;
 
 		std::vector<Mesh::Triangle> triangles;
-		for (int i = 0; i < meshes.size(); i++)
+		for (size_t i = 0; i < meshes.size(); i++)
 		{
 			triangles.insert(triangles.end(), meshes[i].triangles.begin(), meshes[i].triangles.end());
 		}
@@ -80,16 +914,62 @@ namespace MeshManagement
 		return triangles;
 	}
 
-	std::vector<Mesh::Vertex> MeshManager::GetVertexArray()
+	std::vector<Mesh::VertexPosition> MeshManager::GetPositionArray()
 	{
 		upToDate = true;
 
-		std::vector<Mesh::Vertex> vertices;
-		for (int i = 0; i < meshes.size(); i++)
+		std::vector<Mesh::VertexPosition> positions;
+		for (size_t i = 0; i < meshes.size(); i++)
 		{
-			vertices.insert(vertices.end(), meshes[i].vertices.begin(), meshes[i].vertices.end());
+			positions.insert(positions.end(), meshes[i].positions.begin(), meshes[i].positions.end());
+		}
+
+		return positions;
+	}
+
+	std::vector<Mesh::VertexAttribute> MeshManager::GetAttributeArray()
+	{
+		upToDate = true;
+
+		std::vector<Mesh::VertexAttribute> attributes;
+		for (size_t i = 0; i < meshes.size(); i++)
+		{
+			if (meshes[i].attributesCompressed)
+			{
+				for (unsigned int vert = 0; vert < meshes[i].compressedAttributes.size(); vert++)
+				{
+					attributes.push_back(VertexCompression::Decompress(meshes[i].compressedAttributes[vert]));
+				}
+			}
+			else
+			{
+				attributes.insert(attributes.end(), meshes[i].attributes.begin(), meshes[i].attributes.end());
+			}
+		}
+
+		return attributes;
+	}
+
+	std::vector<Mesh::CompressedVertexAttribute> MeshManager::GetCompressedAttributeArray()
+	{
+		upToDate = true;
+
+		std::vector<Mesh::CompressedVertexAttribute> attributes;
+		for (size_t i = 0; i < meshes.size(); i++)
+		{
+			if (meshes[i].attributesCompressed)
+			{
+				attributes.insert(attributes.end(), meshes[i].compressedAttributes.begin(), meshes[i].compressedAttributes.end());
+			}
+			else
+			{
+				for (unsigned int vert = 0; vert < meshes[i].attributes.size(); vert++)
+				{
+					attributes.push_back(VertexCompression::Compress(meshes[i].attributes[vert]));
+				}
+			}
 		}
 
-		return vertices;
+		return attributes;
 	}
 }
\ No newline at end of file
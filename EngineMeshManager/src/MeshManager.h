@@ -1,27 +1,175 @@
 #pragma once
 
 #include "MeshDecoder.h"
+#include "FileWatcher.h"
 #include "Mesh.h"
 
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 namespace MeshManagement
 {
+	//Refers to a mesh read by MeshManager. Meshes with identical geometry and import settings share one entry, so several
+	//handles can resolve to the same mesh index.
+	struct MeshHandle
+	{
+		unsigned int id = 4294967295;
+	};
+
+	//Placement of a mesh in the world, transform is a row major 3x4 object to world matrix
+	struct MeshInstance
+	{
+		MeshHandle mesh;
+		float transform[12];
+	};
+
 	class __declspec(dllexport) MeshManager
 	{
 	public:
 		MeshManager();
+		~MeshManager();
+		MeshManager(const MeshManager&) = delete;
+		MeshManager& operator=(const MeshManager&) = delete;
+	public:
+		struct DeduplicationStatistics
+		{
+			size_t handles = 0;
+			size_t uniqueMeshes = 0;
+			size_t duplicates = 0; //Handles that reused an existing mesh instead of importing it again
+			size_t bytesSaved = 0; //Mesh::GetMemoryUsage of the meshes that weren't stored again
+		};
+	public:
+		//Returns a handle for every mesh in the file, in file order
+		std::vector<MeshHandle> ReadMeshFile(const char* path, MeshImportSettings settings = MeshImportSettings());
+		uint16_t GetMeshIndex(MeshHandle handle) const;
+		const Mesh& GetMesh(MeshHandle handle) const;
+		DeduplicationStatistics GetDeduplicationStatistics() const;
+	public:
+		//One array per element of the row major 3x4 transforms, so a pass over every instance reads each element contiguously
+		struct InstanceTransforms
+		{
+			std::vector<float> objectToWorld[12];
+			std::vector<float> worldToObject[12]; //Inverse of objectToWorld, moves rays into the instanced mesh's space
+			std::vector<unsigned char> singular; //Set when objectToWorld has no inverse, tracers skip such instances
+		};
 	public:
-		void ReadMeshFile(const char* path);
+		//Places the mesh again without copying its vertices or hierarchy, returns the instance index. Scene files such as GLB
+		//add an instance for every node that references a mesh.
+		unsigned int AddInstance(MeshHandle mesh, const float transform[12]);
+		void SetInstanceTransform(unsigned int instance, const float transform[12]);
+		unsigned int GetInstanceCount() const;
+		MeshInstance GetInstance(unsigned int instance) const;
+		const InstanceTransforms& GetInstanceTransforms() const;
+	public:
+		struct FileImportTiming
+		{
+			std::string path;
+			size_t meshCount = 0;
+			size_t triangleCount = 0;
+			double memoryWaitSeconds = 0; //Waiting for earlier files to free up the memory budget
+			double decodeSeconds = 0;
+			double buildSeconds = 0; //Cleanup, hierarchy and the optional import stages
+		};
+	public:
+		//Decodes and builds paths[0, pathCount) concurrently, with a file's hierarchy build overlapping the decoding of later files.
+		//Files are committed in path order, so the handles and mesh indices match calling ReadMeshFile for each path in turn.
+		//A file only starts decoding once the estimated memory of files decoded but not yet committed fits in memoryBudgetBytes.
+		//threadCount 0 uses every hardware thread.
+		std::vector<std::vector<MeshHandle>> ReadMeshFiles(const char* const* paths, size_t pathCount, MeshImportSettings settings = MeshImportSettings(), size_t memoryBudgetBytes = 1073741824, unsigned int threadCount = 0);
+		const std::vector<FileImportTiming>& GetFileImportTimings() const; //Per file breakdown of the last ReadMeshFiles call
+	public:
+		struct MeshRange
+		{
+			size_t firstPosition; //Also the first attribute
+			size_t positionCount;
+			size_t firstTriangle;
+			size_t triangleCount;
+		};
+	public:
+		//Watches every file read before and after the call. Changed files are re-imported on a background thread with the
+		//settings they were first read with, and wait in ApplyReloadedMeshes until the renderer takes them.
+		void EnableHotReload();
+		//Swaps in the meshes re-imported since the last call, call it from the thread that reads the mesh arrays.
+		//A mesh deduplicated between handles is copied on write, the reloaded handle gets a new mesh index and the others keep
+		//the old geometry. Returns true if any mesh changed.
+		bool ApplyReloadedMeshes();
+		//Meshes replaced without changing the size of any array, so uploading their ranges is enough. Meshes that changed
+		//size clear IsUpToDate instead. Clears the list.
+		std::vector<uint16_t> TakeDirtyMeshes();
+		uint16_t GetMeshCount() const;
+		MeshRange GetMeshRange(uint16_t index) const; //Where the mesh starts in the Get*Array results
 		bool IsUpToDate() const;
-		std::vector<Mesh::Vertex> GetVertexArray();
+		bool AttributesCompressed() const;
+		std::vector<Mesh::VertexPosition> GetPositionArray();
+		std::vector<Mesh::VertexAttribute> GetAttributeArray();
+		std::vector<Mesh::CompressedVertexAttribute> GetCompressedAttributeArray();
 		std::vector<Mesh::Triangle> GetTriangleArray();
 		Mesh GetMesh(uint16_t index);
+	public:
+		//Builds up to levelCount simplified copies of every mesh, each level keeping triangleRatio of the previous level's triangles
+		void GenerateLods(unsigned int levelCount = 4, float triangleRatio = 0.5f);
+		unsigned int GetLodCount(uint16_t index) const;
+		const Mesh& GetLod(uint16_t index, unsigned int level) const; //Level 0 is the imported mesh
+		//Picks the coarsest level whose simplification error fits inside the ray's footprint at the hit distance.
+		//Pass the ray cone's spread angle and width at its origin, or a fixed angle per pixel for plain distance based selection.
+		//The error is measured in object space, objectScale is how far an object space unit stretches in world space.
+		unsigned int SelectLod(uint16_t index, float distance, float coneSpreadAngle, float coneWidth = 0.0f, float objectScale = 1.0f) const;
+		//SelectLod for an instance's mesh, with the error scaled by the largest axis scale of its transform
+		unsigned int SelectInstanceLod(unsigned int instance, float distance, float coneSpreadAngle, float coneWidth = 0.0f) const;
+	private:
+		struct SourceFile
+		{
+			std::string path;
+			MeshImportSettings settings;
+			std::vector<MeshHandle> handles;
+		};
+		struct ReloadedMesh
+		{
+			MeshHandle handle;
+			unsigned long long key;
+			Mesh mesh;
+		};
+	private:
+		static std::vector<Mesh> DecodeMeshFile(const char* path, std::vector<SceneInstance>* instances = nullptr);
+		static unsigned long long ImportKey(const Mesh& mesh, const MeshImportSettings& settings);
+		//Finds a stored mesh with this key whose imported content matches the mesh
+		bool FindMesh(unsigned long long key, const Mesh& mesh, uint16_t& index) const;
+		//Imports a decoded mesh, or returns a handle to an existing mesh with the same key and content. Skips the import settings if already applied.
+		MeshHandle AddMesh(Mesh&& mesh, const MeshImportSettings& settings, unsigned long long key, bool settingsApplied);
+		void AddInstances(const std::vector<SceneInstance>& fileInstances, const std::vector<MeshHandle>& fileHandles);
+		void LogLodStatistics(uint16_t index) const;
+		void FileChanged(const std::string& path);
+		void ReloadLoop();
 	private:
 		bool upToDate = false;
+		DeduplicationStatistics deduplicationStatistics;
+		bool stopReloading = false;
 #pragma warning(push)
 #pragma warning(disable:4251)
 		std::vector<Mesh> meshes;
+		std::vector<uint16_t> handleMeshes; //Mesh index for each handle id
+		std::vector<unsigned long long> meshKeys; //ImportKey of each mesh
+		std::unordered_multimap<unsigned long long, uint16_t> meshesByHash; //Keyed on the decoded content hash combined with the import settings, colliding meshes share a key
+		std::vector<uint16_t> dirtyMeshes;
+		std::vector<FileImportTiming> fileImportTimings;
+		std::vector<MeshHandle> instanceMeshes;
+		InstanceTransforms instanceTransforms;
+
+		//Hot reload, everything below the mutex is shared with the watcher and reload threads
+		std::unique_ptr<FileWatcher> fileWatcher;
+		std::thread reloadThread;
+		std::mutex reloadMutex;
+		std::condition_variable reloadCondition;
+		std::vector<SourceFile> sourceFiles;
+		std::vector<std::pair<std::string, std::chrono::steady_clock::time_point>> changedFiles; //Path and time of the latest change
+		std::vector<ReloadedMesh> reloadedMeshes;
+		std::vector<std::vector<Mesh>> lods; //Simplified levels 1 and up for each mesh
 #pragma warning(pop)
 	};
 }
\ No newline at end of file
@@ -0,0 +1,499 @@
+#include "MeshSimplifier.h"
+#include "VertexCompression.h"
+
+#include <math.h>
+#include <algorithm>
+#include <queue>
+#include <vector>
+
+namespace MeshManagement
+{
+	namespace
+	{
+		//Symmetric 4x4 matrix summing squared distances to a set of planes, stored as its upper triangle
+		struct Quadric
+		{
+			double a2 = 0, ab = 0, ac = 0, ad = 0;
+			double b2 = 0, bc = 0, bd = 0;
+			double c2 = 0, cd = 0;
+			double d2 = 0;
+
+			void AddPlane(double a, double b, double c, double d, double weight)
+			{
+				a2 += weight * a * a; ab += weight * a * b; ac += weight * a * c; ad += weight * a * d;
+				b2 += weight * b * b; bc += weight * b * c; bd += weight * b * d;
+				c2 += weight * c * c; cd += weight * c * d;
+				d2 += weight * d * d;
+			}
+
+			void Add(const Quadric& other)
+			{
+				a2 += other.a2; ab += other.ab; ac += other.ac; ad += other.ad;
+				b2 += other.b2; bc += other.bc; bd += other.bd;
+				c2 += other.c2; cd += other.cd;
+				d2 += other.d2;
+			}
+
+			double Evaluate(const double v[3]) const
+			{
+				return a2 * v[0] * v[0] + 2 * ab * v[0] * v[1] + 2 * ac * v[0] * v[2] + 2 * ad * v[0]
+					+ b2 * v[1] * v[1] + 2 * bc * v[1] * v[2] + 2 * bd * v[1]
+					+ c2 * v[2] * v[2] + 2 * cd * v[2]
+					+ d2;
+			}
+
+			//Position minimizing the error, fails when the planes don't pin down a single point
+			bool Optimal(double v[3]) const
+			{
+				double det = a2 * (b2 * c2 - bc * bc) - ab * (ab * c2 - bc * ac) + ac * (ab * bc - b2 * ac);
+				double scale = fabs(a2) + fabs(b2) + fabs(c2);
+				if (fabs(det) <= 1e-12 * scale * scale * scale)
+				{
+					return false;
+				}
+
+				double inverseDet = 1.0 / det;
+				v[0] = -inverseDet * (ad * (b2 * c2 - bc * bc) - ab * (bd * c2 - bc * cd) + ac * (bd * bc - b2 * cd));
+				v[1] = -inverseDet * (a2 * (bd * c2 - cd * bc) - ad * (ab * c2 - bc * ac) + ac * (ab * cd - bd * ac));
+				v[2] = -inverseDet * (a2 * (b2 * cd - bc * bd) - ab * (ab * cd - bd * ac) + ad * (ab * bc - b2 * ac));
+				return true;
+			}
+		};
+
+		struct Collapse
+		{
+			double cost;
+			double position[3];
+			unsigned int vertexA; //Survives the collapse
+			unsigned int vertexB; //Merged into vertexA
+			unsigned int stampA;
+			unsigned int stampB;
+
+			bool operator<(const Collapse& other) const
+			{
+				return cost > other.cost; //Lowest cost at the top of std::priority_queue
+			}
+		};
+
+		void Cross(const double a[3], const double b[3], double result[3])
+		{
+			result[0] = a[1] * b[2] - a[2] * b[1];
+			result[1] = a[2] * b[0] - a[0] * b[2];
+			result[2] = a[0] * b[1] - a[1] * b[0];
+		}
+
+		void FaceNormal(const double p0[3], const double p1[3], const double p2[3], double normal[3])
+		{
+			double edgeA[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+			double edgeB[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+			Cross(edgeA, edgeB, normal);
+		}
+
+		//Squared distance from point to the closest point of triangle abc (Ericson, Real-Time Collision Detection 5.1.5)
+		double TriangleDistanceSquared(const double point[3], const double a[3], const double b[3], const double c[3])
+		{
+			double ab[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+			double ac[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+			double ap[3] = { point[0] - a[0], point[1] - a[1], point[2] - a[2] };
+			double bp[3] = { point[0] - b[0], point[1] - b[1], point[2] - b[2] };
+			double cp[3] = { point[0] - c[0], point[1] - c[1], point[2] - c[2] };
+			auto dot = [](const double x[3], const double y[3]) { return x[0] * y[0] + x[1] * y[1] + x[2] * y[2]; };
+
+			double closest[3];
+			auto along = [&](const double origin[3], const double edge[3], double t)
+			{
+				closest[0] = origin[0] + edge[0] * t;
+				closest[1] = origin[1] + edge[1] * t;
+				closest[2] = origin[2] + edge[2] * t;
+			};
+
+			double d1 = dot(ab, ap), d2 = dot(ac, ap);
+			double d3 = dot(ab, bp), d4 = dot(ac, bp);
+			double d5 = dot(ab, cp), d6 = dot(ac, cp);
+			double va = d3 * d6 - d5 * d4, vb = d5 * d2 - d1 * d6, vc = d1 * d4 - d3 * d2;
+			if (d1 <= 0 && d2 <= 0)
+			{
+				along(a, ab, 0);
+			}
+			else if (d3 >= 0 && d4 <= d3)
+			{
+				along(b, ab, 0);
+			}
+			else if (d6 >= 0 && d5 <= d6)
+			{
+				along(c, ab, 0);
+			}
+			else if (vc <= 0 && d1 >= 0 && d3 <= 0)
+			{
+				along(a, ab, d1 / (d1 - d3));
+			}
+			else if (vb <= 0 && d2 >= 0 && d6 <= 0)
+			{
+				along(a, ac, d2 / (d2 - d6));
+			}
+			else if (va <= 0 && d4 - d3 >= 0 && d5 - d6 >= 0)
+			{
+				double bc[3] = { c[0] - b[0], c[1] - b[1], c[2] - b[2] };
+				along(b, bc, (d4 - d3) / ((d4 - d3) + (d5 - d6)));
+			}
+			else //Inside the face
+			{
+				double denominator = 1.0 / (va + vb + vc);
+				along(a, ab, vb * denominator);
+				closest[0] += ac[0] * vc * denominator;
+				closest[1] += ac[1] * vc * denominator;
+				closest[2] += ac[2] * vc * denominator;
+			}
+
+			double offset[3] = { point[0] - closest[0], point[1] - closest[1], point[2] - closest[2] };
+			return dot(offset, offset);
+		}
+
+		const double boundaryWeight = 10.0; //Keeps open borders from shrinking inwards
+	}
+
+	Mesh MeshSimplifier::Simplify(const Mesh& source, size_t targetTriangleCount)
+	{
+		size_t vertexCount = source.positions.size();
+
+		std::vector<double> positions(vertexCount * 3);
+		for (size_t vert = 0; vert < vertexCount; vert++)
+		{
+			positions[vert * 3 + 0] = source.positions[vert].position[0];
+			positions[vert * 3 + 1] = source.positions[vert].position[1];
+			positions[vert * 3 + 2] = source.positions[vert].position[2];
+		}
+
+		std::vector<unsigned int> triangles(source.triangles.size() * 3);
+		std::vector<std::vector<unsigned int>> vertexTriangles(vertexCount);
+		for (size_t i = 0; i < source.triangles.size(); i++)
+		{
+			Mesh::UnpackIndices(source.triangles[i], &triangles[i * 3]);
+			for (int corner = 0; corner < 3; corner++)
+			{
+				vertexTriangles[triangles[i * 3 + corner]].push_back((unsigned int)i);
+			}
+		}
+		std::vector<bool> triangleRemoved(source.triangles.size(), false);
+		size_t liveTriangles = source.triangles.size();
+
+		//The source triangles around each vertex, vertexTriangles is rewritten as edges collapse
+		std::vector<unsigned int> sourceOffsets(vertexCount + 1, 0);
+		for (size_t vert = 0; vert < vertexCount; vert++)
+		{
+			sourceOffsets[vert + 1] = sourceOffsets[vert] + (unsigned int)vertexTriangles[vert].size();
+		}
+		std::vector<unsigned int> sourceTriangles(sourceOffsets[vertexCount]);
+		for (size_t vert = 0; vert < vertexCount; vert++)
+		{
+			std::copy(vertexTriangles[vert].begin(), vertexTriangles[vert].end(), sourceTriangles.begin() + sourceOffsets[vert]);
+		}
+
+		//Source vertices merged into each surviving vertex, as a linked list from the survivor
+		std::vector<unsigned int> mergedNext(vertexCount, 4294967295);
+		std::vector<unsigned int> mergedTail(vertexCount);
+		for (size_t vert = 0; vert < vertexCount; vert++)
+		{
+			mergedTail[vert] = (unsigned int)vert;
+		}
+
+		//Plane quadrics of every face, plus perpendicular planes along boundary edges
+		std::vector<Quadric> quadrics(vertexCount);
+		std::vector<unsigned long long> edges;
+		edges.reserve(triangles.size());
+		for (size_t i = 0; i < source.triangles.size(); i++)
+		{
+			const unsigned int* t = &triangles[i * 3];
+			double normal[3];
+			FaceNormal(&positions[t[0] * 3], &positions[t[1] * 3], &positions[t[2] * 3], normal);
+			double length = sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+			if (length > 0)
+			{
+				normal[0] /= length;
+				normal[1] /= length;
+				normal[2] /= length;
+				double d = -(normal[0] * positions[t[0] * 3] + normal[1] * positions[t[0] * 3 + 1] + normal[2] * positions[t[0] * 3 + 2]);
+				for (int corner = 0; corner < 3; corner++)
+				{
+					quadrics[t[corner]].AddPlane(normal[0], normal[1], normal[2], d, 1.0);
+				}
+			}
+
+			for (int corner = 0; corner < 3; corner++)
+			{
+				unsigned long long a = t[corner];
+				unsigned long long b = t[(corner + 1) % 3];
+				edges.push_back(a < b ? (a << 32) | b : (b << 32) | a);
+			}
+		}
+		std::sort(edges.begin(), edges.end());
+
+		for (size_t i = 0; i < edges.size();)
+		{
+			size_t run = 1;
+			while (i + run < edges.size() && edges[i + run] == edges[i])
+			{
+				run++;
+			}
+
+			if (run == 1) //Only one face uses this edge
+			{
+				unsigned int a = (unsigned int)(edges[i] >> 32);
+				unsigned int b = (unsigned int)(edges[i] & 0xffffffff);
+				for (size_t j = 0; j < vertexTriangles[a].size(); j++)
+				{
+					const unsigned int* t = &triangles[vertexTriangles[a][j] * 3];
+					if (t[0] != b && t[1] != b && t[2] != b)
+					{
+						continue;
+					}
+
+					double faceNormal[3];
+					FaceNormal(&positions[t[0] * 3], &positions[t[1] * 3], &positions[t[2] * 3], faceNormal);
+					double edge[3] = { positions[b * 3] - positions[a * 3], positions[b * 3 + 1] - positions[a * 3 + 1], positions[b * 3 + 2] - positions[a * 3 + 2] };
+					double normal[3];
+					Cross(edge, faceNormal, normal);
+					double length = sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+					if (length > 0)
+					{
+						normal[0] /= length;
+						normal[1] /= length;
+						normal[2] /= length;
+						double d = -(normal[0] * positions[a * 3] + normal[1] * positions[a * 3 + 1] + normal[2] * positions[a * 3 + 2]);
+						quadrics[a].AddPlane(normal[0], normal[1], normal[2], d, boundaryWeight);
+						quadrics[b].AddPlane(normal[0], normal[1], normal[2], d, boundaryWeight);
+					}
+					break;
+				}
+			}
+			i += run;
+		}
+		edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+		std::vector<unsigned int> stamps(vertexCount, 0);
+		auto computeCollapse = [&](unsigned int a, unsigned int b)
+		{
+			Collapse collapse;
+			collapse.vertexA = a;
+			collapse.vertexB = b;
+			collapse.stampA = stamps[a];
+			collapse.stampB = stamps[b];
+
+			Quadric quadric = quadrics[a];
+			quadric.Add(quadrics[b]);
+
+			if (quadric.Optimal(collapse.position))
+			{
+				collapse.cost = quadric.Evaluate(collapse.position);
+			}
+			else //Fall back to the best of the endpoints and the midpoint
+			{
+				const double* pa = &positions[a * 3];
+				const double* pb = &positions[b * 3];
+				double candidates[3][3] = { { pa[0], pa[1], pa[2] }, { pb[0], pb[1], pb[2] }, { (pa[0] + pb[0]) * 0.5, (pa[1] + pb[1]) * 0.5, (pa[2] + pb[2]) * 0.5 } };
+				collapse.cost = INFINITY;
+				for (int i = 0; i < 3; i++)
+				{
+					double cost = quadric.Evaluate(candidates[i]);
+					if (cost < collapse.cost)
+					{
+						collapse.cost = cost;
+						collapse.position[0] = candidates[i][0];
+						collapse.position[1] = candidates[i][1];
+						collapse.position[2] = candidates[i][2];
+					}
+				}
+			}
+			collapse.cost = std::max(collapse.cost, 0.0);
+			return collapse;
+		};
+
+		std::priority_queue<Collapse> queue;
+		for (size_t i = 0; i < edges.size(); i++)
+		{
+			queue.push(computeCollapse((unsigned int)(edges[i] >> 32), (unsigned int)(edges[i] & 0xffffffff)));
+		}
+
+		//Rejects collapses that would turn any surrounding face over
+		auto flipsFaces = [&](unsigned int vertex, unsigned int other, const double position[3])
+		{
+			for (size_t j = 0; j < vertexTriangles[vertex].size(); j++)
+			{
+				unsigned int triangle = vertexTriangles[vertex][j];
+				const unsigned int* t = &triangles[triangle * 3];
+				if (triangleRemoved[triangle] || t[0] == other || t[1] == other || t[2] == other)
+				{
+					continue;
+				}
+
+				const double* p[3] = { &positions[t[0] * 3], &positions[t[1] * 3], &positions[t[2] * 3] };
+				double before[3];
+				FaceNormal(p[0], p[1], p[2], before);
+				for (int corner = 0; corner < 3; corner++)
+				{
+					if (t[corner] == vertex)
+					{
+						p[corner] = position;
+					}
+				}
+				double after[3];
+				FaceNormal(p[0], p[1], p[2], after);
+
+				if (before[0] * after[0] + before[1] * after[1] + before[2] * after[2] <= 0)
+				{
+					return true;
+				}
+			}
+			return false;
+		};
+
+		std::vector<unsigned int> neighbours;
+		while (liveTriangles > targetTriangleCount && queue.size() > 0)
+		{
+			Collapse collapse = queue.top();
+			queue.pop();
+
+			unsigned int a = collapse.vertexA;
+			unsigned int b = collapse.vertexB;
+			if (collapse.stampA != stamps[a] || collapse.stampB != stamps[b]) //An endpoint changed since this entry was queued
+			{
+				continue;
+			}
+			if (flipsFaces(a, b, collapse.position) || flipsFaces(b, a, collapse.position))
+			{
+				continue;
+			}
+
+			//Merge b into a
+			positions[a * 3 + 0] = collapse.position[0];
+			positions[a * 3 + 1] = collapse.position[1];
+			positions[a * 3 + 2] = collapse.position[2];
+			quadrics[a].Add(quadrics[b]);
+			mergedNext[mergedTail[a]] = b;
+			mergedTail[a] = mergedTail[b];
+
+			for (size_t j = 0; j < vertexTriangles[b].size(); j++)
+			{
+				unsigned int triangle = vertexTriangles[b][j];
+				if (triangleRemoved[triangle])
+				{
+					continue;
+				}
+
+				unsigned int* t = &triangles[triangle * 3];
+				if (t[0] == a || t[1] == a || t[2] == a)
+				{
+					triangleRemoved[triangle] = true;
+					liveTriangles--;
+				}
+				else
+				{
+					for (int corner = 0; corner < 3; corner++)
+					{
+						if (t[corner] == b)
+						{
+							t[corner] = a;
+						}
+					}
+					vertexTriangles[a].push_back(triangle);
+				}
+			}
+			vertexTriangles[b].clear();
+			vertexTriangles[b].shrink_to_fit();
+			vertexTriangles[a].erase(std::remove_if(vertexTriangles[a].begin(), vertexTriangles[a].end(), [&](unsigned int triangle) { return triangleRemoved[triangle]; }), vertexTriangles[a].end());
+			stamps[a]++;
+			stamps[b]++;
+
+			//Requeue every edge around the merged vertex
+			neighbours.clear();
+			for (size_t j = 0; j < vertexTriangles[a].size(); j++)
+			{
+				const unsigned int* t = &triangles[vertexTriangles[a][j] * 3];
+				for (int corner = 0; corner < 3; corner++)
+				{
+					if (t[corner] != a)
+					{
+						neighbours.push_back(t[corner]);
+					}
+				}
+			}
+			std::sort(neighbours.begin(), neighbours.end());
+			neighbours.erase(std::unique(neighbours.begin(), neighbours.end()), neighbours.end());
+			for (size_t j = 0; j < neighbours.size(); j++)
+			{
+				queue.push(computeCollapse(a, neighbours[j]));
+			}
+		}
+
+		Mesh result(source.meshName);
+		result.Reserve(liveTriangles);
+		for (size_t i = 0; i < source.triangles.size(); i++)
+		{
+			if (triangleRemoved[i])
+			{
+				continue;
+			}
+
+			Mesh::Vertex vertices[3];
+			for (int corner = 0; corner < 3; corner++)
+			{
+				unsigned int vert = triangles[i * 3 + corner];
+				vertices[corner].position[0] = (float)positions[vert * 3 + 0];
+				vertices[corner].position[1] = (float)positions[vert * 3 + 1];
+				vertices[corner].position[2] = (float)positions[vert * 3 + 2];
+				vertices[corner].normal[0] = 0;
+				vertices[corner].normal[1] = 0;
+				vertices[corner].normal[2] = 0;
+
+				if (source.attributesCompressed)
+				{
+					vertices[corner].UV[0] = VertexCompression::HalfToFloat(source.compressedAttributes[vert].UV[0]);
+					vertices[corner].UV[1] = VertexCompression::HalfToFloat(source.compressedAttributes[vert].UV[1]);
+				}
+				else
+				{
+					vertices[corner].UV[0] = source.attributes[vert].UV[0];
+					vertices[corner].UV[1] = source.attributes[vert].UV[1];
+				}
+			}
+			result.AppendTriangle(vertices);
+		}
+
+		//Distance from each moved vertex to the source triangles around the vertices it replaced. Those triangles are the source
+		//surface the vertex stands in for, so this bounds its distance to the source surface, errors inside faces are not measured.
+		double maxDistanceSquared = 0;
+		for (size_t vert = 0; vert < vertexCount; vert++)
+		{
+			if (mergedTail[vert] == vert || vertexTriangles[vert].empty()) //Never moved, or collapsed into another vertex
+			{
+				continue;
+			}
+
+			double nearest = INFINITY;
+			for (unsigned int merged = (unsigned int)vert; merged != 4294967295 && nearest > 0; merged = mergedNext[merged])
+			{
+				for (unsigned int j = sourceOffsets[merged]; j < sourceOffsets[merged + 1]; j++)
+				{
+					unsigned int indices[3];
+					Mesh::UnpackIndices(source.triangles[sourceTriangles[j]], indices);
+					double corners[3][3];
+					for (int corner = 0; corner < 3; corner++)
+					{
+						corners[corner][0] = source.positions[indices[corner]].position[0];
+						corners[corner][1] = source.positions[indices[corner]].position[1];
+						corners[corner][2] = source.positions[indices[corner]].position[2];
+					}
+					nearest = std::min(nearest, TriangleDistanceSquared(&positions[vert * 3], corners[0], corners[1], corners[2]));
+				}
+			}
+			if (nearest != INFINITY)
+			{
+				maxDistanceSquared = std::max(maxDistanceSquared, nearest);
+			}
+		}
+
+		result.simplificationError = (float)sqrt(maxDistanceSquared);
+		result.completed = true;
+		return result;
+	}
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "Mesh.h"
+
+namespace MeshManagement
+{
+	//Edge collapse simplification driven by quadric error metrics (Garland and Heckbert 1997)
+	class __declspec(dllexport) MeshSimplifier
+	{
+	public:
+		//Collapses edges of source until at most targetTriangleCount triangles remain. Like a decoder's output the result
+		//has no hierarchy or normals yet, MeshDecoder::ApplyImportSettings builds them.
+		//simplificationError on the result is set to the largest distance, in object units, from a moved vertex to the source
+		//triangles around the vertices it replaced.
+		static Mesh Simplify(const Mesh& source, size_t targetTriangleCount);
+	};
+}
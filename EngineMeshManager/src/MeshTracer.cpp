@@ -0,0 +1,284 @@
+#include "MeshTracer.h"
+#include "RayBatch.h"
+#include "RayIntersection.h"
+#include "VertexCompression.h"
+#include "EngineLogger.h"
+
+#include <math.h>
+#include <sstream>
+
+namespace MeshManagement
+{
+	MeshTracer::MeshTracer(const Mesh& mesh, bool useMeshlets) : mesh(&mesh)
+	{
+		if (useMeshlets && mesh.meshletRootIndex != 4294967295)
+		{
+			linkedNodeHierarchy = mesh.GetLinkedMeshletHierarchy();
+			rootIndex = mesh.meshletRootIndex;
+			meshletTraversal = true;
+		}
+		else if (mesh.rootIndex != 4294967295)
+		{
+			linkedNodeHierarchy = mesh.GetLinkedNodeHierarchy();
+			rootIndex = mesh.rootIndex;
+		}
+	}
+
+	MeshTracer::Intersection MeshTracer::Intersect(const Ray& ray, Statistics* statistics, float maxDistance) const
+	{
+		Intersection intersection;
+		intersection.distance = maxDistance;
+		intersection.barycentrics[0] = 0;
+		intersection.barycentrics[1] = 0;
+		intersection.triangleIndex = 4294967295;
+		intersection.vertexIndices[0] = 0;
+		intersection.vertexIndices[1] = 0;
+		intersection.vertexIndices[2] = 0;
+
+		if (linkedNodeHierarchy.size() == 0)
+		{
+			return intersection;
+		}
+
+		float inverseDirection[3] = { 1.0f / ray.direction[0], 1.0f / ray.direction[1], 1.0f / ray.direction[2] };
+		unsigned long long nodesVisited = 0;
+		unsigned long long positionFetches = 0;
+
+		//Traverse using positions only, attributes are fetched by GetHit once the closest hit is known
+		unsigned int currentIndex = rootIndex;
+		while (currentIndex != 4294967294)
+		{
+			const Mesh::LinkedNode& node = linkedNodeHierarchy[currentIndex];
+			nodesVisited++;
+
+			if (BoxIntersect(ray.origin, inverseDirection, node.aabb, intersection.distance))
+			{
+				if (node.isLeaf == 1)
+				{
+					//A meshlet leaf holds a run of triangles addressed through 8 bit local indices
+					unsigned int firstTriangle = node.triangleIndex;
+					unsigned int triangleCount = 1;
+					const Mesh::Meshlet* meshlet = nullptr;
+					if (meshletTraversal)
+					{
+						meshlet = &mesh->meshlets[node.triangleIndex];
+						firstTriangle = meshlet->triangleOffset;
+						triangleCount = meshlet->triangleCount;
+					}
+
+					for (unsigned int triangle = firstTriangle; triangle < firstTriangle + triangleCount; triangle++)
+					{
+						unsigned int indices[3];
+						if (meshlet != nullptr)
+						{
+							const unsigned char* localIndices = &mesh->meshletIndices[triangle * 3];
+							indices[0] = mesh->meshletVertices[meshlet->vertexOffset + localIndices[0]];
+							indices[1] = mesh->meshletVertices[meshlet->vertexOffset + localIndices[1]];
+							indices[2] = mesh->meshletVertices[meshlet->vertexOffset + localIndices[2]];
+						}
+						else
+						{
+							Mesh::UnpackIndices(mesh->triangles[triangle], indices);
+						}
+						positionFetches += 3;
+
+						float intersect[4];
+						TriangleIntersect(ray.origin, ray.direction, mesh->positions[indices[0]].position, mesh->positions[indices[1]].position, mesh->positions[indices[2]].position, intersect);
+						if (intersect[0] < intersection.distance)
+						{
+							intersection.distance = intersect[0];
+							intersection.triangleIndex = triangle;
+							intersection.barycentrics[0] = intersect[1];
+							intersection.barycentrics[1] = intersect[2];
+							intersection.vertexIndices[0] = indices[0];
+							intersection.vertexIndices[1] = indices[1];
+							intersection.vertexIndices[2] = indices[2];
+						}
+					}
+				}
+				currentIndex = node.hitLink;
+			}
+			else
+			{
+				currentIndex = node.missLink;
+			}
+		}
+
+		if (statistics != nullptr)
+		{
+			statistics->rays++;
+			statistics->nodesVisited += nodesVisited;
+			statistics->positionFetches += positionFetches;
+		}
+
+		return intersection;
+	}
+
+	MeshTracer::Hit MeshTracer::GetHit(const Ray& ray, const Intersection& intersection, Statistics* statistics) const
+	{
+		Hit hit;
+		hit.distance = intersection.distance;
+		hit.position[0] = 0;
+		hit.position[1] = 0;
+		hit.position[2] = 0;
+		hit.normal[0] = 0;
+		hit.normal[1] = 0;
+		hit.normal[2] = 0;
+		hit.UV[0] = 0;
+		hit.UV[1] = 0;
+		hit.triangleIndex = intersection.triangleIndex;
+
+		if (intersection.triangleIndex == 4294967295)
+		{
+			return hit;
+		}
+
+		const unsigned int* hitIndices = intersection.vertexIndices;
+		float barycentrics[3] = { intersection.barycentrics[0], intersection.barycentrics[1], 1 - intersection.barycentrics[0] - intersection.barycentrics[1] };
+
+		Mesh::VertexAttribute a0, a1, a2;
+		if (mesh->attributesCompressed) //Decode only the three attributes of the hit triangle
+		{
+			a0 = VertexCompression::Decompress(mesh->compressedAttributes[hitIndices[0]]);
+			a1 = VertexCompression::Decompress(mesh->compressedAttributes[hitIndices[1]]);
+			a2 = VertexCompression::Decompress(mesh->compressedAttributes[hitIndices[2]]);
+		}
+		else
+		{
+			a0 = mesh->attributes[hitIndices[0]];
+			a1 = mesh->attributes[hitIndices[1]];
+			a2 = mesh->attributes[hitIndices[2]];
+		}
+
+		for (int i = 0; i < 3; i++)
+		{
+			hit.position[i] = ray.origin[i] + ray.direction[i] * hit.distance;
+			hit.normal[i] = a1.normal[i] * barycentrics[0] + a2.normal[i] * barycentrics[1] + a0.normal[i] * barycentrics[2];
+		}
+		hit.UV[0] = a1.UV[0] * barycentrics[0] + a2.UV[0] * barycentrics[1] + a0.UV[0] * barycentrics[2];
+		hit.UV[1] = a1.UV[1] * barycentrics[0] + a2.UV[1] * barycentrics[1] + a0.UV[1] * barycentrics[2];
+
+		float magnitude = sqrtf(hit.normal[0] * hit.normal[0] + hit.normal[1] * hit.normal[1] + hit.normal[2] * hit.normal[2]);
+		if (magnitude > 0)
+		{
+			hit.normal[0] /= magnitude;
+			hit.normal[1] /= magnitude;
+			hit.normal[2] /= magnitude;
+		}
+
+		if (statistics != nullptr)
+		{
+			statistics->attributeFetches += 3;
+		}
+
+		return hit;
+	}
+
+	MeshTracer::Hit MeshTracer::Trace(const Ray& ray, Statistics* statistics, float maxDistance) const
+	{
+		return GetHit(ray, Intersect(ray, statistics, maxDistance), statistics);
+	}
+
+	bool MeshTracer::Occluded(const Ray& ray, Statistics* statistics, float maxDistance) const
+	{
+		if (linkedNodeHierarchy.size() == 0)
+		{
+			return false;
+		}
+
+		float inverseDirection[3] = { 1.0f / ray.direction[0], 1.0f / ray.direction[1], 1.0f / ray.direction[2] };
+		unsigned long long nodesVisited = 0;
+		unsigned long long positionFetches = 0;
+		bool occluded = false;
+
+		unsigned int currentIndex = rootIndex;
+		while (currentIndex != 4294967294 && !occluded)
+		{
+			const Mesh::LinkedNode& node = linkedNodeHierarchy[currentIndex];
+			nodesVisited++;
+
+			if (BoxIntersect(ray.origin, inverseDirection, node.aabb, maxDistance))
+			{
+				if (node.isLeaf == 1)
+				{
+					unsigned int firstTriangle = node.triangleIndex;
+					unsigned int triangleCount = 1;
+					const Mesh::Meshlet* meshlet = nullptr;
+					if (meshletTraversal)
+					{
+						meshlet = &mesh->meshlets[node.triangleIndex];
+						firstTriangle = meshlet->triangleOffset;
+						triangleCount = meshlet->triangleCount;
+					}
+
+					for (unsigned int triangle = firstTriangle; triangle < firstTriangle + triangleCount && !occluded; triangle++)
+					{
+						unsigned int indices[3];
+						if (meshlet != nullptr)
+						{
+							const unsigned char* localIndices = &mesh->meshletIndices[triangle * 3];
+							indices[0] = mesh->meshletVertices[meshlet->vertexOffset + localIndices[0]];
+							indices[1] = mesh->meshletVertices[meshlet->vertexOffset + localIndices[1]];
+							indices[2] = mesh->meshletVertices[meshlet->vertexOffset + localIndices[2]];
+						}
+						else
+						{
+							Mesh::UnpackIndices(mesh->triangles[triangle], indices);
+						}
+						positionFetches += 3;
+
+						float intersect[4];
+						TriangleIntersect(ray.origin, ray.direction, mesh->positions[indices[0]].position, mesh->positions[indices[1]].position, mesh->positions[indices[2]].position, intersect);
+						occluded = intersect[0] < maxDistance;
+					}
+				}
+				currentIndex = node.hitLink;
+			}
+			else
+			{
+				currentIndex = node.missLink;
+			}
+		}
+
+		if (statistics != nullptr)
+		{
+			statistics->rays++;
+			statistics->nodesVisited += nodesVisited;
+			statistics->positionFetches += positionFetches;
+		}
+
+		return occluded;
+	}
+
+	void MeshTracer::IntersectBatch(const Ray* rays, size_t rayCount, BatchHit* hits, float maxDistance, unsigned int threadCount) const
+	{
+		RayBatch::Run(rays, rayCount, threadCount, [&](unsigned int i)
+		{
+			Intersection intersection = Intersect(rays[i], nullptr, maxDistance);
+			hits[i].distance = intersection.distance;
+			hits[i].barycentrics[0] = intersection.barycentrics[0];
+			hits[i].barycentrics[1] = intersection.barycentrics[1];
+			hits[i].triangleIndex = intersection.triangleIndex;
+			hits[i].instanceIndex = 4294967295;
+		});
+	}
+
+	void MeshTracer::OccludedBatch(const Ray* rays, size_t rayCount, unsigned char* mask, float maxDistance, unsigned int threadCount) const
+	{
+		RayBatch::Run(rays, rayCount, threadCount, [&](unsigned int i)
+		{
+			mask[i] = Occluded(rays[i], nullptr, maxDistance) ? 1 : 0;
+		});
+	}
+
+	void MeshTracer::LogBandwidthComparison(const Statistics& statistics)
+	{
+		//With interleaved vertices every position fetch pulls in the whole 32 byte vertex, and the attribute fetch at the hit is free
+		unsigned long long interleavedBytes = statistics.positionFetches * sizeof(Mesh::Vertex);
+		unsigned long long splitBytes = statistics.positionFetches * sizeof(Mesh::VertexPosition) + statistics.attributeFetches * sizeof(Mesh::VertexAttribute);
+
+		std::ostringstream oss;
+		oss << "Vertex bandwidth over " << statistics.rays << " rays. Interleaved: " << interleavedBytes << " bytes, Split: " << splitBytes << " bytes (" << (interleavedBytes > 0 ? (double)splitBytes / (double)interleavedBytes * 100.0 : 0.0) << "%)";
+		DEBUGLOG(oss.str())
+	}
+}
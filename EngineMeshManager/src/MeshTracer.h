@@ -0,0 +1,68 @@
+#pragma once
+
+#include "Mesh.h"
+
+#include <math.h>
+#include <vector>
+
+namespace MeshManagement
+{
+	struct BatchHit;
+
+	class __declspec(dllexport) MeshTracer
+	{
+	public:
+		//With useMeshlets the tracer walks the meshlet hierarchy and decodes local indices, if the mesh has meshlets
+		MeshTracer(const Mesh& mesh, bool useMeshlets = false);
+	public:
+		struct Ray
+		{
+			float origin[3];
+			float direction[3];
+		};
+		struct Hit
+		{
+			float distance;
+			float position[3];
+			float normal[3];
+			float UV[2];
+			unsigned int triangleIndex;
+		};
+		//Closest hit before any attribute is read
+		struct Intersection
+		{
+			float distance;
+			float barycentrics[2]; //Weights of the triangle's second and third vertex, the first gets 1 - u - v
+			unsigned int triangleIndex; //4294967295 on a miss
+			unsigned int vertexIndices[3];
+		};
+		struct Statistics
+		{
+			unsigned long long rays = 0;
+			unsigned long long nodesVisited = 0;
+			unsigned long long positionFetches = 0;
+			unsigned long long attributeFetches = 0;
+		};
+	public:
+		//Only hits closer than maxDistance are reported, in units of the ray's direction which doesn't need to be normalized
+		Hit Trace(const Ray& ray, Statistics* statistics = nullptr, float maxDistance = INFINITY) const;
+		Intersection Intersect(const Ray& ray, Statistics* statistics = nullptr, float maxDistance = INFINITY) const;
+		Hit GetHit(const Ray& ray, const Intersection& intersection, Statistics* statistics = nullptr) const; //Interpolates the attributes at an intersection of ray
+		bool Occluded(const Ray& ray, Statistics* statistics = nullptr, float maxDistance = INFINITY) const;
+	public:
+		//Closest hit of rays[i] into hits[i] and whether rays[i] is blocked into mask[i], for picking and physics queries. The batch
+		//is traced in a coherent order on threadCount threads, 0 uses every hardware thread.
+		void IntersectBatch(const Ray* rays, size_t rayCount, BatchHit* hits, float maxDistance = INFINITY, unsigned int threadCount = 0) const;
+		void OccludedBatch(const Ray* rays, size_t rayCount, unsigned char* mask, float maxDistance = INFINITY, unsigned int threadCount = 0) const;
+	public:
+		static void LogBandwidthComparison(const Statistics& statistics);
+	private:
+		const Mesh* mesh;
+		unsigned int rootIndex = 4294967295;
+		bool meshletTraversal = false;
+#pragma warning(push)
+#pragma warning(disable:4251)
+		std::vector<Mesh::LinkedNode> linkedNodeHierarchy;
+#pragma warning(pop)
+	};
+}
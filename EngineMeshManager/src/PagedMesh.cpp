@@ -0,0 +1,800 @@
+#include "PagedMesh.h"
+#include "MeshDecoder.h"
+#include "RayIntersection.h"
+#include "VertexCompression.h"
+#include "EngineLogger.h"
+#include "EngineStandard/Arena.h"
+
+#include <algorithm>
+#include <numeric>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <sstream>
+
+namespace MeshManagement
+{
+	namespace
+	{
+		const char pagedMeshMagic[8] = { 'R', 'T', 'P', 'A', 'G', 'E', 'D', 0 };
+		const unsigned int pagedMeshVersion = 2;
+		const unsigned int splitBins = 256; //Centroid histogram used to pick where a group is split
+		const size_t streamTriangles = 4096; //Read from a temporary file at a time
+
+		//One triangle in a temporary file, the vertices as they were added
+		struct TriangleRecord
+		{
+			Mesh::Vertex vertices[3];
+		};
+
+		size_t MeshletDataSize(unsigned int vertexCount, unsigned int triangleCount)
+		{
+			size_t size = vertexCount * (sizeof(Mesh::VertexPosition) + sizeof(Mesh::CompressedVertexAttribute)) + triangleCount * 3;
+			return (size + 3) & ~(size_t)3;
+		}
+
+		unsigned long long RoundUp(unsigned long long value, unsigned long long multiple)
+		{
+			return (value + multiple - 1) / multiple * multiple;
+		}
+
+		void ResetBounds(Mesh::AABB& bounds, float centroidMinimum[3], float centroidMaximum[3])
+		{
+			bounds = { INFINITY, INFINITY, INFINITY, -INFINITY, -INFINITY, -INFINITY };
+			for (int axis = 0; axis < 3; axis++)
+			{
+				centroidMinimum[axis] = INFINITY;
+				centroidMaximum[axis] = -INFINITY;
+			}
+		}
+
+		void GrowBounds(const TriangleRecord& triangle, Mesh::AABB& bounds, float centroidMinimum[3], float centroidMaximum[3])
+		{
+			for (int vert = 0; vert < 3; vert++)
+			{
+				const float* position = triangle.vertices[vert].position;
+				bounds.ax = fminf(bounds.ax, position[0]);
+				bounds.ay = fminf(bounds.ay, position[1]);
+				bounds.az = fminf(bounds.az, position[2]);
+				bounds.bx = fmaxf(bounds.bx, position[0]);
+				bounds.by = fmaxf(bounds.by, position[1]);
+				bounds.bz = fmaxf(bounds.bz, position[2]);
+			}
+			for (int axis = 0; axis < 3; axis++)
+			{
+				float centroid = (triangle.vertices[0].position[axis] + triangle.vertices[1].position[axis] + triangle.vertices[2].position[axis]) / 3.0f;
+				centroidMinimum[axis] = fminf(centroidMinimum[axis], centroid);
+				centroidMaximum[axis] = fmaxf(centroidMaximum[axis], centroid);
+			}
+		}
+
+		//Calls onTriangle for every triangle of a temporary file, returns false if it couldn't be read to the end
+		template<typename Function>
+		bool ForEachTriangle(const std::string& path, Function onTriangle)
+		{
+			std::ifstream file(path, std::ios::binary);
+			if (!file.is_open())
+			{
+				return false;
+			}
+
+			std::vector<TriangleRecord> block(streamTriangles);
+			while (file)
+			{
+				file.read((char*)block.data(), block.size() * sizeof(TriangleRecord));
+				size_t count = (size_t)file.gcount() / sizeof(TriangleRecord);
+				for (size_t i = 0; i < count; i++)
+				{
+					onTriangle(block[i]);
+				}
+			}
+			return file.eof() && !file.bad();
+		}
+	}
+
+	PagedMesh::Writer::Writer(const char* path, bool hasNormals, unsigned int chunkTriangles, unsigned int pageSize) : hasNormals(hasNormals), chunkTriangles(std::max(chunkTriangles, 1u)), pageSize(std::max(pageSize, 1u)), path(path)
+	{
+		root.path = TemporaryPath();
+		ResetBounds(root.bounds, root.centroidMinimum, root.centroidMaximum);
+		triangleFile.open(root.path, std::ios::binary | std::ios::trunc);
+		if (!triangleFile.is_open())
+		{
+			DEBUGERROR("PagedMesh::Writer Failed: Could not create temporary file")
+			failed = true;
+		}
+	}
+
+	PagedMesh::Writer::~Writer()
+	{
+		if (!finished)
+		{
+			triangleFile.close();
+			remove(root.path.c_str());
+		}
+	}
+
+	std::string PagedMesh::Writer::TemporaryPath()
+	{
+		return path + ".part" + std::to_string(temporaryFiles++);
+	}
+
+	void PagedMesh::Writer::AddTriangle(const Mesh::Vertex vertices[3])
+	{
+		if (failed || finished)
+		{
+			return;
+		}
+
+		TriangleRecord triangle;
+		memcpy(triangle.vertices, vertices, sizeof(triangle.vertices));
+		triangleFile.write((const char*)&triangle, sizeof(triangle));
+		GrowBounds(triangle, root.bounds, root.centroidMinimum, root.centroidMaximum);
+		root.triangleCount++;
+	}
+
+	bool PagedMesh::Writer::Finish()
+	{
+		if (finished)
+		{
+			return false;
+		}
+		finished = true;
+		triangleFile.close();
+		if (failed || triangleFile.fail() || root.triangleCount == 0)
+		{
+			DEBUGERROR("PagedMesh::Writer Failed: No triangles were written")
+			remove(root.path.c_str());
+			return false;
+		}
+
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		if (!file.is_open())
+		{
+			DEBUGERROR("PagedMesh::Writer Failed: Could not open file")
+			remove(root.path.c_str());
+			return false;
+		}
+
+		//The header is written last, a file left behind by a failure doesn't open
+		FileHeader header;
+		memset(&header, 0, sizeof(header));
+		file.write((const char*)&header, sizeof(header));
+		unsigned long long offset = RoundUp(sizeof(FileHeader), pageSize);
+
+		//Split groups until they fit in a chunk, depth first with the first child on top so chunks are written in the order
+		//the linked hierarchy visits them, and a chunk's neighbour in the file is its neighbour in space
+		nodes.clear();
+		nodes.push_back({ 0, 4294967295, 4294967295, 4294967295, root.bounds, 1 });
+		std::vector<Group> stack(1, root);
+		bool succeeded = true;
+		while (stack.size() > 0 && succeeded)
+		{
+			Group group = stack.back();
+			stack.pop_back();
+
+			if (group.triangleCount > chunkTriangles)
+			{
+				Group children[2];
+				succeeded = Split(group, children);
+				remove(group.path.c_str());
+				if (succeeded)
+				{
+					for (int child = 0; child < 2; child++)
+					{
+						children[child].node = (unsigned int)nodes.size();
+						nodes.push_back({ 0, group.node, 4294967295, 4294967295, children[child].bounds, 1 });
+					}
+					nodes[group.node].childAIndex = children[0].node;
+					nodes[group.node].childBIndex = children[1].node;
+					nodes[group.node].isLeaf = 0;
+					stack.push_back(children[1]);
+					stack.push_back(children[0]);
+				}
+				continue;
+			}
+
+			nodes[group.node].triangleIndex = (unsigned int)chunks.size();
+			succeeded = WriteChunk(group, file, offset);
+			remove(group.path.c_str());
+		}
+		for (size_t i = 0; i < stack.size(); i++)
+		{
+			remove(stack[i].path.c_str());
+		}
+		if (!succeeded)
+		{
+			DEBUGERROR("PagedMesh::Writer Failed: Error partitioning triangles")
+			return false;
+		}
+
+		std::vector<Mesh::LinkedNode> linkedNodes = Mesh::LinkHierarchy(nodes, 0);
+		memcpy(header.magic, pagedMeshMagic, sizeof(header.magic));
+		header.version = pagedMeshVersion;
+		header.pageSize = pageSize;
+		header.nodeCount = (unsigned int)linkedNodes.size();
+		header.rootIndex = 0;
+		header.chunkCount = (unsigned int)chunks.size();
+		header.triangleCount = writtenTriangles;
+		header.meshletCount = writtenMeshlets;
+		header.tableOffset = offset;
+
+		file.seekp((std::streamoff)offset);
+		file.write((const char*)linkedNodes.data(), linkedNodes.size() * sizeof(Mesh::LinkedNode));
+		file.write((const char*)chunks.data(), chunks.size() * sizeof(FileChunk));
+		file.seekp(0);
+		file.write((const char*)&header, sizeof(header));
+		if (!file.good())
+		{
+			DEBUGERROR("PagedMesh::Writer Failed: Error writing file")
+			return false;
+		}
+
+		std::ostringstream oss;
+		oss << "Wrote paged mesh with " << writtenTriangles << " triangles and " << writtenMeshlets << " meshlets in " << chunks.size() << " chunks, " << offset << " bytes. Resident hierarchy: "
+			<< linkedNodes.size() * sizeof(Mesh::LinkedNode) + chunks.size() * sizeof(FileChunk) << " bytes";
+		DEBUGLOG(oss.str())
+		return true;
+	}
+
+	bool PagedMesh::Writer::Split(const Group& group, Group children[2])
+	{
+		int axis = 0;
+		for (int i = 1; i < 3; i++)
+		{
+			if (group.centroidMaximum[i] - group.centroidMinimum[i] > group.centroidMaximum[axis] - group.centroidMinimum[axis])
+			{
+				axis = i;
+			}
+		}
+		float minimum = group.centroidMinimum[axis];
+		float extent = group.centroidMaximum[axis] - minimum;
+		auto bin = [&](const TriangleRecord& triangle)
+		{
+			float centroid = (triangle.vertices[0].position[axis] + triangle.vertices[1].position[axis] + triangle.vertices[2].position[axis]) / 3.0f;
+			return std::min((unsigned int)((centroid - minimum) / extent * (float)splitBins), splitBins - 1);
+		};
+
+		//Split at the histogram bin boundary closest to the median, or in half by order if every centroid lands in one bin
+		unsigned int splitBin = 0;
+		if (extent > 0)
+		{
+			std::vector<unsigned long long> counts(splitBins, 0);
+			if (!ForEachTriangle(group.path, [&](const TriangleRecord& triangle) { counts[bin(triangle)]++; }))
+			{
+				return false;
+			}
+
+			unsigned long long left = 0;
+			unsigned long long bestDifference = group.triangleCount;
+			for (unsigned int i = 1; i < splitBins; i++)
+			{
+				left += counts[i - 1];
+				unsigned long long difference = left * 2 > group.triangleCount ? left * 2 - group.triangleCount : group.triangleCount - left * 2;
+				if (left > 0 && left < group.triangleCount && difference < bestDifference)
+				{
+					bestDifference = difference;
+					splitBin = i;
+				}
+			}
+		}
+
+		std::ofstream outputs[2];
+		for (int child = 0; child < 2; child++)
+		{
+			children[child].path = TemporaryPath();
+			children[child].triangleCount = 0;
+			ResetBounds(children[child].bounds, children[child].centroidMinimum, children[child].centroidMaximum);
+			outputs[child].open(children[child].path, std::ios::binary | std::ios::trunc);
+		}
+
+		unsigned long long index = 0;
+		bool read = outputs[0].is_open() && outputs[1].is_open() && ForEachTriangle(group.path, [&](const TriangleRecord& triangle)
+		{
+			int child = splitBin > 0 ? (bin(triangle) >= splitBin ? 1 : 0) : (index++ >= group.triangleCount / 2 ? 1 : 0);
+			outputs[child].write((const char*)&triangle, sizeof(triangle));
+			GrowBounds(triangle, children[child].bounds, children[child].centroidMinimum, children[child].centroidMaximum);
+			children[child].triangleCount++;
+		});
+
+		bool succeeded = read;
+		for (int child = 0; child < 2; child++)
+		{
+			outputs[child].close();
+			succeeded = succeeded && !outputs[child].fail();
+		}
+		if (!succeeded)
+		{
+			remove(children[0].path.c_str());
+			remove(children[1].path.c_str());
+		}
+		return succeeded;
+	}
+
+	bool PagedMesh::Writer::WriteChunk(const Group& group, std::ofstream& file, unsigned long long& offset)
+	{
+		std::vector<TriangleRecord> triangles;
+		triangles.reserve((size_t)group.triangleCount);
+		if (!ForEachTriangle(group.path, [&](const TriangleRecord& triangle) { triangles.push_back(triangle); }))
+		{
+			return false;
+		}
+
+		//Corners with the same position share a vertex, or the same whole vertex when normals were given and may differ across
+		//an edge. Sorting the corners finds them without comparing every pair.
+		const Mesh::Vertex* corners = triangles[0].vertices;
+		size_t cornerCount = triangles.size() * 3;
+		size_t keySize = hasNormals ? sizeof(Mesh::Vertex) : sizeof(corners[0].position);
+		std::vector<unsigned int> order(cornerCount);
+		std::iota(order.begin(), order.end(), 0);
+		std::sort(order.begin(), order.end(), [&](unsigned int a, unsigned int b) { return memcmp(&corners[a], &corners[b], keySize) < 0; });
+
+		Mesh mesh("");
+		std::vector<unsigned int> vertexIndices(cornerCount);
+		for (size_t i = 0; i < cornerCount; i++)
+		{
+			const Mesh::Vertex& corner = corners[order[i]];
+			if (i == 0 || memcmp(&corners[order[i - 1]], &corner, keySize) != 0)
+			{
+				mesh.positions.push_back({ { corner.position[0], corner.position[1], corner.position[2] } });
+				mesh.attributes.push_back({ { corner.normal[0], corner.normal[1], corner.normal[2] }, { corner.UV[0], corner.UV[1] } });
+			}
+			vertexIndices[order[i]] = (unsigned int)mesh.positions.size() - 1;
+		}
+		mesh.triangles.resize(triangles.size());
+		for (size_t i = 0; i < triangles.size(); i++)
+		{
+			mesh.triangles[i] = Mesh::PackIndices(&vertexIndices[i * 3]);
+		}
+		mesh.hasNormals = hasNormals;
+
+		ESL::Arena scratch;
+		mesh.BuildHierarchy(scratch);
+		if (!hasNormals)
+		{
+			MeshDecoder::GenerateNormals(mesh, NormalWeighting::Angle);
+		}
+		mesh.ReorderForLocality();
+		mesh.BuildMeshlets();
+		std::vector<Mesh::LinkedNode> meshletNodes = mesh.GetLinkedMeshletHierarchy();
+
+		FileChunk chunk;
+		chunk.offset = offset;
+		chunk.firstTriangle = writtenTriangles;
+		chunk.nodeCount = (unsigned int)meshletNodes.size();
+		chunk.rootIndex = mesh.meshletRootIndex == 4294967295 ? 4294967294 : mesh.meshletRootIndex;
+		chunk.meshletCount = (unsigned int)mesh.meshlets.size();
+
+		std::vector<FileMeshlet> fileMeshlets(mesh.meshlets.size());
+		size_t size = meshletNodes.size() * sizeof(Mesh::LinkedNode) + fileMeshlets.size() * sizeof(FileMeshlet);
+		for (size_t i = 0; i < mesh.meshlets.size(); i++)
+		{
+			fileMeshlets[i].offset = (unsigned int)size;
+			fileMeshlets[i].firstTriangle = mesh.meshlets[i].triangleOffset;
+			fileMeshlets[i].vertexCount = mesh.meshlets[i].vertexCount;
+			fileMeshlets[i].triangleCount = mesh.meshlets[i].triangleCount;
+			fileMeshlets[i].padding = 0;
+			size += MeshletDataSize(mesh.meshlets[i].vertexCount, mesh.meshlets[i].triangleCount);
+		}
+		chunk.size = (unsigned int)size;
+
+		std::vector<unsigned char> data((size_t)RoundUp(size, pageSize), 0);
+		memcpy(data.data(), meshletNodes.data(), meshletNodes.size() * sizeof(Mesh::LinkedNode));
+		memcpy(&data[meshletNodes.size() * sizeof(Mesh::LinkedNode)], fileMeshlets.data(), fileMeshlets.size() * sizeof(FileMeshlet));
+		for (size_t i = 0; i < mesh.meshlets.size(); i++)
+		{
+			const Mesh::Meshlet& meshlet = mesh.meshlets[i];
+			Mesh::VertexPosition* positions = (Mesh::VertexPosition*)&data[fileMeshlets[i].offset];
+			Mesh::CompressedVertexAttribute* attributes = (Mesh::CompressedVertexAttribute*)(positions + meshlet.vertexCount);
+			unsigned char* indices = (unsigned char*)(attributes + meshlet.vertexCount);
+			for (unsigned int local = 0; local < meshlet.vertexCount; local++)
+			{
+				unsigned int vert = mesh.meshletVertices[meshlet.vertexOffset + local];
+				positions[local] = mesh.positions[vert];
+				attributes[local] = VertexCompression::Compress(mesh.attributes[vert]);
+			}
+			memcpy(indices, &mesh.meshletIndices[meshlet.triangleOffset * 3], meshlet.triangleCount * 3);
+		}
+
+		file.seekp((std::streamoff)offset);
+		file.write((const char*)data.data(), data.size());
+		offset += data.size();
+		chunks.push_back(chunk);
+		writtenTriangles += mesh.triangles.size();
+		writtenMeshlets += mesh.meshlets.size();
+		return file.good();
+	}
+
+	bool PagedMesh::Write(const char* sourcePath, const char* path, unsigned int chunkTriangles, unsigned int pageSize)
+	{
+		Writer writer(path, false, chunkTriangles, pageSize);
+		if (!MeshDecoder::StreamAsciiStl(sourcePath, [&](Mesh::Vertex vertices[3]) { writer.AddTriangle(vertices); }))
+		{
+			return false;
+		}
+		return writer.Finish();
+	}
+
+	PagedMesh::PagedMesh(const char* path, size_t cacheBudgetBytes) : cacheBudget(cacheBudgetBytes)
+	{
+		file.open(path, std::ios::binary);
+		if (!file.is_open())
+		{
+			DEBUGERROR("PagedMesh Failed: Could not open file")
+			return;
+		}
+
+		file.read((char*)&header, sizeof(header));
+		if (!file.good() || memcmp(header.magic, pagedMeshMagic, sizeof(header.magic)) != 0 || header.version != pagedMeshVersion)
+		{
+			DEBUGERROR("PagedMesh Failed: Not a paged mesh file")
+			return;
+		}
+
+		nodes.resize(header.nodeCount);
+		chunks.resize(header.chunkCount);
+		file.seekg((std::streamoff)header.tableOffset);
+		file.read((char*)nodes.data(), nodes.size() * sizeof(Mesh::LinkedNode));
+		file.read((char*)chunks.data(), chunks.size() * sizeof(FileChunk));
+		if (!file.good())
+		{
+			DEBUGERROR("PagedMesh Failed: File is truncated")
+			return;
+		}
+
+		open = true;
+		prefetchThread = std::thread(&PagedMesh::PrefetchLoop, this);
+	}
+
+	PagedMesh::~PagedMesh()
+	{
+		{
+			std::lock_guard<std::mutex> lock(cacheMutex);
+			stopPrefetching = true;
+		}
+		prefetchCondition.notify_all();
+		if (prefetchThread.joinable())
+		{
+			prefetchThread.join();
+		}
+	}
+
+	bool PagedMesh::IsOpen() const
+	{
+		return open;
+	}
+
+	size_t PagedMesh::GetTriangleCount() const
+	{
+		return open ? (size_t)header.triangleCount : 0;
+	}
+
+	size_t PagedMesh::GetResidentHierarchyBytes() const
+	{
+		return nodes.size() * sizeof(Mesh::LinkedNode) + chunks.size() * sizeof(FileChunk);
+	}
+
+	PagedMesh::PageStatistics PagedMesh::GetPageStatistics() const
+	{
+		std::lock_guard<std::mutex> lock(cacheMutex);
+		return pageStatistics;
+	}
+
+	std::shared_ptr<const PagedMesh::Chunk> PagedMesh::AcquireChunk(unsigned int chunk)
+	{
+		{
+			std::lock_guard<std::mutex> lock(cacheMutex);
+			auto entry = cache.find(chunk);
+			if (entry != cache.end())
+			{
+				lru.splice(lru.begin(), lru, entry->second.lruPosition);
+				pageStatistics.hits++;
+				return entry->second.chunk;
+			}
+		}
+
+		//Chunks are written in traversal order, so the next one is likely needed soon
+		if (chunk + 1 < chunks.size())
+		{
+			RequestPrefetch(chunk + 1);
+		}
+
+		return InsertChunk(chunk, LoadChunk(chunk), false);
+	}
+
+	std::shared_ptr<const PagedMesh::Chunk> PagedMesh::LoadChunk(unsigned int chunk)
+	{
+		std::shared_ptr<Chunk> data = std::make_shared<Chunk>();
+		data->data.resize(chunks[chunk].size);
+
+		std::lock_guard<std::mutex> lock(fileMutex);
+		file.seekg((std::streamoff)chunks[chunk].offset);
+		file.read((char*)data->data.data(), data->data.size());
+		if (!file.good())
+		{
+			DEBUGERROR("PagedMesh Failed: Error reading chunk")
+			file.clear();
+			memset(data->data.data(), 0, data->data.size());
+		}
+		return data;
+	}
+
+	std::shared_ptr<const PagedMesh::Chunk> PagedMesh::InsertChunk(unsigned int chunk, std::shared_ptr<const Chunk> data, bool prefetched)
+	{
+		std::lock_guard<std::mutex> lock(cacheMutex);
+
+		auto existing = cache.find(chunk);
+		if (existing != cache.end()) //Another thread loaded it first
+		{
+			lru.splice(lru.begin(), lru, existing->second.lruPosition);
+			return existing->second.chunk;
+		}
+
+		lru.push_front(chunk);
+		cache[chunk] = { data, lru.begin() };
+		pageStatistics.residentBytes += data->data.size();
+		pageStatistics.bytesRead += data->data.size();
+		if (prefetched)
+		{
+			pageStatistics.prefetches++;
+		}
+		else
+		{
+			pageStatistics.misses++;
+		}
+
+		//Evict least recently used chunks, rays still holding one keep it alive until they finish with it
+		while (pageStatistics.residentBytes > cacheBudget && lru.size() > 1)
+		{
+			unsigned int evicted = lru.back();
+			lru.pop_back();
+			pageStatistics.residentBytes -= cache[evicted].chunk->data.size();
+			cache.erase(evicted);
+			pageStatistics.evictions++;
+		}
+		pageStatistics.peakResidentBytes = std::max(pageStatistics.peakResidentBytes, pageStatistics.residentBytes);
+
+		return data;
+	}
+
+	void PagedMesh::RequestPrefetch(unsigned int chunk)
+	{
+		{
+			std::lock_guard<std::mutex> lock(cacheMutex);
+			if (cache.find(chunk) != cache.end())
+			{
+				return;
+			}
+			prefetchQueue.push_back(chunk);
+		}
+		prefetchCondition.notify_one();
+	}
+
+	void PagedMesh::PrefetchLoop()
+	{
+		while (true)
+		{
+			unsigned int chunk;
+			{
+				std::unique_lock<std::mutex> lock(cacheMutex);
+				prefetchCondition.wait(lock, [this]() { return stopPrefetching || prefetchQueue.size() > 0; });
+				if (stopPrefetching)
+				{
+					return;
+				}
+
+				chunk = prefetchQueue.front();
+				prefetchQueue.pop_front();
+				if (cache.find(chunk) != cache.end())
+				{
+					continue;
+				}
+			}
+
+			InsertChunk(chunk, LoadChunk(chunk), true);
+		}
+	}
+
+	MeshTracer::Hit PagedMesh::Trace(const MeshTracer::Ray& ray, MeshTracer::Statistics* statistics)
+	{
+		MeshTracer::Hit hit;
+		hit.distance = INFINITY;
+		hit.position[0] = 0;
+		hit.position[1] = 0;
+		hit.position[2] = 0;
+		hit.normal[0] = 0;
+		hit.normal[1] = 0;
+		hit.normal[2] = 0;
+		hit.UV[0] = 0;
+		hit.UV[1] = 0;
+		hit.triangleIndex = 4294967295;
+
+		if (!open)
+		{
+			return hit;
+		}
+
+		float inverseDirection[3] = { 1.0f / ray.direction[0], 1.0f / ray.direction[1], 1.0f / ray.direction[2] };
+		float barycentrics[3] = { 0, 0, 0 };
+		unsigned char hitIndices[3] = { 0, 0, 0 };
+		std::shared_ptr<const Chunk> hitChunk; //Kept until the hit's attributes are decoded
+		const Mesh::CompressedVertexAttribute* hitAttributes = nullptr;
+		unsigned long long nodesVisited = 0;
+		unsigned long long positionFetches = 0;
+
+		unsigned int currentIndex = header.rootIndex;
+		while (currentIndex != 4294967294)
+		{
+			const Mesh::LinkedNode& node = nodes[currentIndex];
+			nodesVisited++;
+
+			if (BoxIntersect(ray.origin, inverseDirection, node.aabb, hit.distance))
+			{
+				if (node.isLeaf == 1) //Continue into the chunk's own meshlet hierarchy
+				{
+					const FileChunk& fileChunk = chunks[node.triangleIndex];
+					std::shared_ptr<const Chunk> chunk = AcquireChunk(node.triangleIndex);
+					const Mesh::LinkedNode* chunkNodes = (const Mesh::LinkedNode*)chunk->data.data();
+					const FileMeshlet* chunkMeshlets = (const FileMeshlet*)(chunkNodes + fileChunk.nodeCount);
+
+					unsigned int chunkIndex = fileChunk.rootIndex;
+					while (chunkIndex != 4294967294)
+					{
+						const Mesh::LinkedNode& chunkNode = chunkNodes[chunkIndex];
+						nodesVisited++;
+
+						if (!BoxIntersect(ray.origin, inverseDirection, chunkNode.aabb, hit.distance))
+						{
+							chunkIndex = chunkNode.missLink;
+							continue;
+						}
+						chunkIndex = chunkNode.hitLink;
+						if (chunkNode.isLeaf != 1)
+						{
+							continue;
+						}
+
+						const FileMeshlet& meshlet = chunkMeshlets[chunkNode.triangleIndex];
+						const Mesh::VertexPosition* positions = (const Mesh::VertexPosition*)&chunk->data[meshlet.offset];
+						const Mesh::CompressedVertexAttribute* attributes = (const Mesh::CompressedVertexAttribute*)(positions + meshlet.vertexCount);
+						const unsigned char* indices = (const unsigned char*)(attributes + meshlet.vertexCount);
+						for (unsigned int triangle = 0; triangle < meshlet.triangleCount; triangle++)
+						{
+							const unsigned char* localIndices = &indices[triangle * 3];
+							positionFetches += 3;
+
+							float intersect[4];
+							TriangleIntersect(ray.origin, ray.direction, positions[localIndices[0]].position, positions[localIndices[1]].position, positions[localIndices[2]].position, intersect);
+							if (intersect[0] < hit.distance)
+							{
+								hit.distance = intersect[0];
+								hit.triangleIndex = (unsigned int)(fileChunk.firstTriangle + meshlet.firstTriangle + triangle);
+								barycentrics[0] = intersect[1];
+								barycentrics[1] = intersect[2];
+								barycentrics[2] = intersect[3];
+								hitIndices[0] = localIndices[0];
+								hitIndices[1] = localIndices[1];
+								hitIndices[2] = localIndices[2];
+								hitChunk = chunk;
+								hitAttributes = attributes;
+							}
+						}
+					}
+				}
+				currentIndex = node.hitLink;
+			}
+			else
+			{
+				currentIndex = node.missLink;
+			}
+		}
+
+		if (hit.triangleIndex != 4294967295)
+		{
+			Mesh::VertexAttribute a0 = VertexCompression::Decompress(hitAttributes[hitIndices[0]]);
+			Mesh::VertexAttribute a1 = VertexCompression::Decompress(hitAttributes[hitIndices[1]]);
+			Mesh::VertexAttribute a2 = VertexCompression::Decompress(hitAttributes[hitIndices[2]]);
+
+			for (int i = 0; i < 3; i++)
+			{
+				hit.position[i] = ray.origin[i] + ray.direction[i] * hit.distance;
+				hit.normal[i] = a1.normal[i] * barycentrics[0] + a2.normal[i] * barycentrics[1] + a0.normal[i] * barycentrics[2];
+			}
+			hit.UV[0] = a1.UV[0] * barycentrics[0] + a2.UV[0] * barycentrics[1] + a0.UV[0] * barycentrics[2];
+			hit.UV[1] = a1.UV[1] * barycentrics[0] + a2.UV[1] * barycentrics[1] + a0.UV[1] * barycentrics[2];
+
+			float magnitude = sqrtf(hit.normal[0] * hit.normal[0] + hit.normal[1] * hit.normal[1] + hit.normal[2] * hit.normal[2]);
+			if (magnitude > 0)
+			{
+				hit.normal[0] /= magnitude;
+				hit.normal[1] /= magnitude;
+				hit.normal[2] /= magnitude;
+			}
+		}
+
+		if (statistics != nullptr)
+		{
+			statistics->rays++;
+			statistics->nodesVisited += nodesVisited;
+			statistics->positionFetches += positionFetches;
+			statistics->attributeFetches += (hit.triangleIndex != 4294967295) ? 3 : 0;
+		}
+
+		return hit;
+	}
+
+	bool PagedMesh::Occluded(const MeshTracer::Ray& ray, MeshTracer::Statistics* statistics)
+	{
+		if (!open)
+		{
+			return false;
+		}
+
+		float inverseDirection[3] = { 1.0f / ray.direction[0], 1.0f / ray.direction[1], 1.0f / ray.direction[2] };
+		unsigned long long nodesVisited = 0;
+		unsigned long long positionFetches = 0;
+		bool occluded = false;
+
+		unsigned int currentIndex = header.rootIndex;
+		while (currentIndex != 4294967294 && !occluded)
+		{
+			const Mesh::LinkedNode& node = nodes[currentIndex];
+			nodesVisited++;
+
+			if (BoxIntersect(ray.origin, inverseDirection, node.aabb, INFINITY))
+			{
+				if (node.isLeaf == 1)
+				{
+					const FileChunk& fileChunk = chunks[node.triangleIndex];
+					std::shared_ptr<const Chunk> chunk = AcquireChunk(node.triangleIndex);
+					const Mesh::LinkedNode* chunkNodes = (const Mesh::LinkedNode*)chunk->data.data();
+					const FileMeshlet* chunkMeshlets = (const FileMeshlet*)(chunkNodes + fileChunk.nodeCount);
+
+					unsigned int chunkIndex = fileChunk.rootIndex;
+					while (chunkIndex != 4294967294 && !occluded)
+					{
+						const Mesh::LinkedNode& chunkNode = chunkNodes[chunkIndex];
+						nodesVisited++;
+
+						if (!BoxIntersect(ray.origin, inverseDirection, chunkNode.aabb, INFINITY))
+						{
+							chunkIndex = chunkNode.missLink;
+							continue;
+						}
+						chunkIndex = chunkNode.hitLink;
+						if (chunkNode.isLeaf != 1)
+						{
+							continue;
+						}
+
+						const FileMeshlet& meshlet = chunkMeshlets[chunkNode.triangleIndex];
+						const Mesh::VertexPosition* positions = (const Mesh::VertexPosition*)&chunk->data[meshlet.offset];
+						const unsigned char* indices = (const unsigned char*)(positions + meshlet.vertexCount) + meshlet.vertexCount * sizeof(Mesh::CompressedVertexAttribute);
+						for (unsigned int triangle = 0; triangle < meshlet.triangleCount && !occluded; triangle++)
+						{
+							const unsigned char* localIndices = &indices[triangle * 3];
+							positionFetches += 3;
+
+							float intersect[4];
+							TriangleIntersect(ray.origin, ray.direction, positions[localIndices[0]].position, positions[localIndices[1]].position, positions[localIndices[2]].position, intersect);
+							occluded = intersect[0] != INFINITY;
+						}
+					}
+				}
+				currentIndex = node.hitLink;
+			}
+			else
+			{
+				currentIndex = node.missLink;
+			}
+		}
+
+		if (statistics != nullptr)
+		{
+			statistics->rays++;
+			statistics->nodesVisited += nodesVisited;
+			statistics->positionFetches += positionFetches;
+		}
+
+		return occluded;
+	}
+}
@@ -0,0 +1,170 @@
+#pragma once
+
+#include "Mesh.h"
+#include "MeshTracer.h"
+
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace MeshManagement
+{
+	//Out of core mesh for tracing geometry that doesn't fit in memory. Triangles are split into spatially compact groups of at most
+	//chunkTriangles, and each group's meshlet hierarchy, meshlet table, vertices and local indices are stored together in a page
+	//aligned chunk of a file. Only the top levels of the hierarchy, down to one leaf per chunk, and the chunk table stay resident,
+	//chunks are loaded through an LRU cache of bounded size.
+	class __declspec(dllexport) PagedMesh
+	{
+	public:
+		struct FileHeader
+		{
+			char magic[8];
+			unsigned int version;
+			unsigned int pageSize;
+			unsigned int nodeCount; //Resident top levels of the hierarchy, leaf triangleIndex is a chunk index
+			unsigned int rootIndex;
+			unsigned int chunkCount;
+			unsigned int padding;
+			unsigned long long triangleCount;
+			unsigned long long meshletCount;
+			unsigned long long tableOffset; //Resident nodes followed by the chunk table, written after the chunks
+		};
+		struct FileChunk
+		{
+			unsigned long long offset; //Multiple of the page size
+			unsigned long long firstTriangle; //Triangle numbering continues across chunks
+			unsigned int size;
+			unsigned int nodeCount; //Chunk's meshlet hierarchy at the start of its data, leaf triangleIndex is a meshlet index
+			unsigned int rootIndex; //4294967294 for a chunk without triangles
+			unsigned int meshletCount; //FileMeshlet after the nodes
+		};
+		struct FileMeshlet
+		{
+			unsigned int offset; //Byte offset of the meshlet's data inside its chunk
+			unsigned int firstTriangle; //Within the chunk
+			unsigned char vertexCount;
+			unsigned char triangleCount;
+			unsigned short padding;
+		};
+	public:
+		//Builds a paged mesh file from triangles handed to it one at a time. They are spilled to temporary files next to path and
+		//partitioned there, so memory use is bounded by chunkTriangles rather than the size of the mesh. Vertex indices are local
+		//to a chunk, which lifts the 20 bit limit of Mesh::Triangle.
+		class __declspec(dllexport) Writer
+		{
+		public:
+			//Without hasNormals, normals are generated from the triangles of each chunk. Chunks are padded to pageSize.
+			Writer(const char* path, bool hasNormals, unsigned int chunkTriangles = 16384, unsigned int pageSize = 65536);
+			~Writer();
+			Writer(const Writer&) = delete;
+			Writer& operator=(const Writer&) = delete;
+		public:
+			void AddTriangle(const Mesh::Vertex vertices[3]);
+			bool Finish(); //Partitions the triangles and writes the file, no triangles can be added after
+		private:
+			//Triangles in a temporary file and the node of the top hierarchy they belong to
+			struct Group
+			{
+				std::string path;
+				unsigned long long triangleCount = 0;
+				Mesh::AABB bounds;
+				float centroidMinimum[3];
+				float centroidMaximum[3];
+				unsigned int node = 0;
+			};
+		private:
+			std::string TemporaryPath();
+			bool Split(const Group& group, Group children[2]);
+			bool WriteChunk(const Group& group, std::ofstream& file, unsigned long long& offset);
+		private:
+			bool hasNormals;
+			unsigned int chunkTriangles;
+			unsigned int pageSize;
+			bool failed = false;
+			bool finished = false;
+			unsigned int temporaryFiles = 0;
+			unsigned long long writtenTriangles = 0;
+			unsigned long long writtenMeshlets = 0;
+#pragma warning(push)
+#pragma warning(disable:4251)
+			std::string path;
+			std::ofstream triangleFile;
+			Group root;
+			std::vector<Mesh::Node> nodes; //Top levels of the hierarchy, a leaf for each group small enough to be a chunk
+			std::vector<FileChunk> chunks;
+#pragma warning(pop)
+		};
+	public:
+		//Streams an ASCII STL file straight into a paged mesh file, the whole mesh is never in memory at once
+		static bool Write(const char* sourcePath, const char* path, unsigned int chunkTriangles = 16384, unsigned int pageSize = 65536);
+	public:
+		PagedMesh(const char* path, size_t cacheBudgetBytes);
+		~PagedMesh();
+		PagedMesh(const PagedMesh&) = delete;
+		PagedMesh& operator=(const PagedMesh&) = delete;
+	public:
+		struct PageStatistics
+		{
+			unsigned long long hits = 0;
+			unsigned long long misses = 0; //Chunks loaded while a ray waited
+			unsigned long long prefetches = 0; //Chunks loaded ahead of time by the background thread
+			unsigned long long evictions = 0;
+			unsigned long long bytesRead = 0;
+			size_t residentBytes = 0;
+			size_t peakResidentBytes = 0;
+		};
+	public:
+		bool IsOpen() const;
+		size_t GetTriangleCount() const;
+		size_t GetResidentHierarchyBytes() const;
+		PageStatistics GetPageStatistics() const;
+		//Thread safe, any number of threads may trace at once
+		MeshTracer::Hit Trace(const MeshTracer::Ray& ray, MeshTracer::Statistics* statistics = nullptr);
+		bool Occluded(const MeshTracer::Ray& ray, MeshTracer::Statistics* statistics = nullptr);
+	private:
+		struct Chunk
+		{
+			std::vector<unsigned char> data; //Nodes, meshlets, then per meshlet: positions, compressed attributes and local indices
+		};
+		struct CacheEntry
+		{
+			std::shared_ptr<const Chunk> chunk;
+			std::list<unsigned int>::iterator lruPosition;
+		};
+	private:
+		std::shared_ptr<const Chunk> AcquireChunk(unsigned int chunk);
+		std::shared_ptr<const Chunk> LoadChunk(unsigned int chunk);
+		std::shared_ptr<const Chunk> InsertChunk(unsigned int chunk, std::shared_ptr<const Chunk> data, bool prefetched);
+		void RequestPrefetch(unsigned int chunk);
+		void PrefetchLoop();
+	private:
+		bool open = false;
+		FileHeader header;
+#pragma warning(push)
+#pragma warning(disable:4251)
+		std::vector<Mesh::LinkedNode> nodes;
+		std::vector<FileChunk> chunks;
+
+		std::ifstream file;
+		std::mutex fileMutex;
+
+		size_t cacheBudget;
+		mutable std::mutex cacheMutex;
+		std::unordered_map<unsigned int, CacheEntry> cache;
+		std::list<unsigned int> lru; //Most recently used at the front
+		PageStatistics pageStatistics;
+
+		std::thread prefetchThread;
+		std::condition_variable prefetchCondition;
+		std::deque<unsigned int> prefetchQueue;
+		bool stopPrefetching = false;
+#pragma warning(pop)
+	};
+}
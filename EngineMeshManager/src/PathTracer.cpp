@@ -0,0 +1,334 @@
+#include "PathTracer.h"
+#include "RayBatch.h"
+#include "RenderScene.h"
+#include "EngineStandard/Parallel.h"
+
+#include <algorithm>
+#include <math.h>
+
+namespace MeshManagement
+{
+	namespace
+	{
+		const unsigned int rouletteDimensions = 64; //Roulette draws start here, so each bounce direction keeps a whole dimension pair
+
+		//Cosine weighted direction around normal, using the tangent frame of Duff et al. 2017
+		void CosineSampleHemisphere(const float normal[3], float u1, float u2, float direction[3])
+		{
+			float sign = normal[2] >= 0 ? 1.0f : -1.0f;
+			float a = -1.0f / (sign + normal[2]);
+			float b = normal[0] * normal[1] * a;
+			float tangent[3] = { 1.0f + sign * normal[0] * normal[0] * a, sign * b, -sign * normal[0] };
+			float bitangent[3] = { b, sign + normal[1] * normal[1] * a, -normal[1] };
+
+			float radius = sqrtf(u1);
+			float phi = 6.28318531f * u2;
+			float x = radius * cosf(phi);
+			float y = radius * sinf(phi);
+			float z = sqrtf(std::max(1.0f - u1, 0.0f));
+			for (int i = 0; i < 3; i++)
+			{
+				direction[i] = tangent[i] * x + bitangent[i] * y + normal[i] * z;
+			}
+		}
+	}
+
+	void PathTracer::PathQueue::Resize(size_t capacity)
+	{
+		std::vector<float>* floats[] = { &originX, &originY, &originZ, &directionX, &directionY, &directionZ, &throughputR, &throughputG, &throughputB, &radianceR, &radianceG, &radianceB };
+		for (size_t i = 0; i < sizeof(floats) / sizeof(floats[0]); i++)
+		{
+			floats[i]->resize(capacity);
+		}
+		pixels.resize(capacity);
+		outputs.resize(capacity);
+		samples.resize(capacity);
+		depths.resize(capacity);
+	}
+
+	void PathTracer::PathQueue::Copy(size_t from, PathQueue& destination, size_t to) const
+	{
+		destination.originX[to] = originX[from];
+		destination.originY[to] = originY[from];
+		destination.originZ[to] = originZ[from];
+		destination.directionX[to] = directionX[from];
+		destination.directionY[to] = directionY[from];
+		destination.directionZ[to] = directionZ[from];
+		destination.throughputR[to] = throughputR[from];
+		destination.throughputG[to] = throughputG[from];
+		destination.throughputB[to] = throughputB[from];
+		destination.radianceR[to] = radianceR[from];
+		destination.radianceG[to] = radianceG[from];
+		destination.radianceB[to] = radianceB[from];
+		destination.pixels[to] = pixels[from];
+		destination.outputs[to] = outputs[from];
+		destination.samples[to] = samples[from];
+		destination.depths[to] = depths[from];
+	}
+
+	MeshTracer::Ray PathTracer::PathQueue::GetRay(size_t index) const
+	{
+		MeshTracer::Ray ray;
+		ray.origin[0] = originX[index];
+		ray.origin[1] = originY[index];
+		ray.origin[2] = originZ[index];
+		ray.direction[0] = directionX[index];
+		ray.direction[1] = directionY[index];
+		ray.direction[2] = directionZ[index];
+		return ray;
+	}
+
+	PathTracer::PathTracer(const InstanceTracer& tracer, unsigned int threadCount, size_t wavefrontSize) : tracer(&tracer), threadCount(threadCount == 0 ? ESL::ThreadCount() : threadCount), wavefrontSize(wavefrontSize)
+	{
+		paths.Resize(wavefrontSize);
+		compactedPaths.Resize(wavefrontSize);
+		intersections.resize(wavefrontSize);
+		pathAlive.resize(wavefrontSize);
+		shadowPending.resize(wavefrontSize);
+		shadowR.resize(wavefrontSize);
+		shadowG.resize(wavefrontSize);
+		shadowB.resize(wavefrontSize);
+	}
+
+	void PathTracer::Render(const WavefrontRenderer::View& view, const Settings& settings, float* image, Statistics* statistics)
+	{
+		RenderPixels(view, settings, nullptr, (size_t)view.width * view.height, image, statistics);
+	}
+
+	void PathTracer::RenderPixels(const WavefrontRenderer::View& view, const Settings& settings, const unsigned int* pixels, size_t pixelCount, float* values, Statistics* statistics)
+	{
+		std::fill(values, values + pixelCount * 3, 0.0f);
+		pixelList = pixels;
+
+		std::vector<MeshTracer::Statistics> threadStatistics(threadCount);
+		Statistics frameStatistics;
+		unsigned long long pathCount = (unsigned long long)pixelCount * settings.samplesPerPixel;
+		nextPath = 0;
+		paths.count = 0;
+		while (nextPath < pathCount || paths.count > 0)
+		{
+			if (settings.regeneratePaths || paths.count == 0)
+			{
+				unsigned long long started = nextPath;
+				Regenerate(view, settings, pathCount);
+				frameStatistics.paths += nextPath - started;
+			}
+			frameStatistics.iterations++;
+			frameStatistics.activePaths += paths.count;
+			frameStatistics.extensionRays += paths.count;
+
+			Extend(threadStatistics);
+			Shade(view, settings, threadStatistics);
+			for (size_t i = 0; i < paths.count; i++)
+			{
+				frameStatistics.shadowRays += shadowPending[i];
+			}
+			Shadow(threadStatistics);
+			Retire(settings, values);
+		}
+		pixelList = nullptr;
+
+		if (statistics != nullptr)
+		{
+			RayBatch::AddStatistics(frameStatistics.traversal, threadStatistics);
+			statistics->paths += frameStatistics.paths;
+			statistics->extensionRays += frameStatistics.extensionRays;
+			statistics->shadowRays += frameStatistics.shadowRays;
+			statistics->iterations += frameStatistics.iterations;
+			statistics->activePaths += frameStatistics.activePaths;
+			statistics->traversal.rays += frameStatistics.traversal.rays;
+			statistics->traversal.nodesVisited += frameStatistics.traversal.nodesVisited;
+			statistics->traversal.positionFetches += frameStatistics.traversal.positionFetches;
+			statistics->traversal.attributeFetches += frameStatistics.traversal.attributeFetches;
+		}
+	}
+
+	void PathTracer::Regenerate(const WavefrontRenderer::View& view, const Settings& settings, unsigned long long pathCount)
+	{
+		//New camera paths go after the live ones, each with its own sub pixel position
+		size_t first = paths.count;
+		size_t added = (size_t)std::min((unsigned long long)(wavefrontSize - first), pathCount - nextPath);
+		unsigned long long firstPath = nextPath;
+		RayBatch::ForEachChunk(added, RayBatch::stageChunkSize, threadCount, [&](size_t begin, size_t end, unsigned int)
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				unsigned long long path = firstPath + i;
+				unsigned int output = (unsigned int)(path / settings.samplesPerPixel);
+				unsigned int pixel = pixelList != nullptr ? pixelList[output] : output;
+				unsigned int sample = settings.frame * settings.samplesPerPixel + (unsigned int)(path % settings.samplesPerPixel);
+				unsigned int x = pixel % view.width;
+				unsigned int y = pixel / view.width;
+				float offsetX = Sampler::SampleSequence(settings.sampler, x, y, sample, 0);
+				float offsetY = Sampler::SampleSequence(settings.sampler, x, y, sample, 1);
+				MeshTracer::Ray ray = WavefrontRenderer::CameraRay(view, x, y, offsetX, offsetY);
+
+				size_t slot = first + i;
+				paths.originX[slot] = ray.origin[0];
+				paths.originY[slot] = ray.origin[1];
+				paths.originZ[slot] = ray.origin[2];
+				paths.directionX[slot] = ray.direction[0];
+				paths.directionY[slot] = ray.direction[1];
+				paths.directionZ[slot] = ray.direction[2];
+				paths.throughputR[slot] = 1;
+				paths.throughputG[slot] = 1;
+				paths.throughputB[slot] = 1;
+				paths.radianceR[slot] = 0;
+				paths.radianceG[slot] = 0;
+				paths.radianceB[slot] = 0;
+				paths.pixels[slot] = pixel;
+				paths.outputs[slot] = output;
+				paths.samples[slot] = sample;
+				paths.depths[slot] = 0;
+			}
+		});
+		paths.count += added;
+		nextPath += added;
+	}
+
+	void PathTracer::Extend(std::vector<MeshTracer::Statistics>& threadStatistics)
+	{
+		RayBatch::ForEachChunk(paths.count, RayBatch::stageChunkSize, threadCount, [&](size_t begin, size_t end, unsigned int thread)
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				intersections[i] = tracer->Intersect(paths.GetRay(i), &threadStatistics[thread]);
+			}
+		});
+	}
+
+	void PathTracer::Shade(const WavefrontRenderer::View& view, const Settings& settings, std::vector<MeshTracer::Statistics>& threadStatistics)
+	{
+		RayBatch::ForEachChunk(paths.count, RayBatch::stageChunkSize, threadCount, [&](size_t begin, size_t end, unsigned int thread)
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				MeshTracer::Ray ray = paths.GetRay(i);
+				InstanceTracer::Hit hit = tracer->GetHit(ray, intersections[i], &threadStatistics[thread]);
+				float albedo[3] = { RenderScene::meshAlbedo[0], RenderScene::meshAlbedo[1], RenderScene::meshAlbedo[2] };
+				if (RenderScene::IntersectGround(ray, hit))
+				{
+					albedo[0] = albedo[1] = albedo[2] = RenderScene::GroundAlbedo(hit.position[0], hit.position[2]);
+				}
+
+				shadowPending[i] = 0;
+				pathAlive[i] = 0;
+				if (hit.distance == INFINITY)
+				{
+					paths.radianceR[i] += paths.throughputR[i] * RenderScene::skyRadiance[0];
+					paths.radianceG[i] += paths.throughputG[i] * RenderScene::skyRadiance[1];
+					paths.radianceB[i] += paths.throughputB[i] * RenderScene::skyRadiance[2];
+					continue;
+				}
+
+				//Shading happens on the side the ray arrived from
+				if (hit.normal[0] * ray.direction[0] + hit.normal[1] * ray.direction[1] + hit.normal[2] * ray.direction[2] > 0)
+				{
+					hit.normal[0] = -hit.normal[0];
+					hit.normal[1] = -hit.normal[1];
+					hit.normal[2] = -hit.normal[2];
+				}
+				paths.originX[i] = hit.position[0] + hit.normal[0] * RenderScene::shadowBias;
+				paths.originY[i] = hit.position[1] + hit.normal[1] * RenderScene::shadowBias;
+				paths.originZ[i] = hit.position[2] + hit.normal[2] * RenderScene::shadowBias;
+
+				//Next event estimation towards the sun, whose irradiance is pi so a lit surface reflects albedo * cos
+				float cosine = hit.normal[0] * RenderScene::lightDirection[0] + hit.normal[1] * RenderScene::lightDirection[1] + hit.normal[2] * RenderScene::lightDirection[2];
+				if (cosine > 0)
+				{
+					shadowPending[i] = 1;
+					shadowR[i] = paths.throughputR[i] * albedo[0] * cosine;
+					shadowG[i] = paths.throughputG[i] * albedo[1] * cosine;
+					shadowB[i] = paths.throughputB[i] * albedo[2] * cosine;
+				}
+
+				unsigned int depth = ++paths.depths[i];
+				if (depth >= settings.maxDepth)
+				{
+					continue;
+				}
+				paths.throughputR[i] *= albedo[0];
+				paths.throughputG[i] *= albedo[1];
+				paths.throughputB[i] *= albedo[2];
+
+				unsigned int x = paths.pixels[i] % view.width;
+				unsigned int y = paths.pixels[i] / view.width;
+				unsigned int sample = paths.samples[i];
+				if (depth >= settings.rouletteDepth)
+				{
+					float survival = std::min(std::max(paths.throughputR[i], std::max(paths.throughputG[i], paths.throughputB[i])), 0.95f);
+					if (Sampler::SampleSequence(settings.sampler, x, y, sample, rouletteDimensions + depth) >= survival)
+					{
+						continue;
+					}
+					paths.throughputR[i] /= survival;
+					paths.throughputG[i] /= survival;
+					paths.throughputB[i] /= survival;
+				}
+
+				float direction[3];
+				float u1 = Sampler::SampleSequence(settings.sampler, x, y, sample, 2 * depth);
+				float u2 = Sampler::SampleSequence(settings.sampler, x, y, sample, 2 * depth + 1);
+				CosineSampleHemisphere(hit.normal, u1, u2, direction);
+				paths.directionX[i] = direction[0];
+				paths.directionY[i] = direction[1];
+				paths.directionZ[i] = direction[2];
+				pathAlive[i] = 1;
+			}
+		});
+	}
+
+	void PathTracer::Shadow(std::vector<MeshTracer::Statistics>& threadStatistics)
+	{
+		RayBatch::ForEachChunk(paths.count, RayBatch::stageChunkSize, threadCount, [&](size_t begin, size_t end, unsigned int thread)
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				if (shadowPending[i] == 0)
+				{
+					continue;
+				}
+
+				MeshTracer::Ray shadowRay;
+				shadowRay.origin[0] = paths.originX[i];
+				shadowRay.origin[1] = paths.originY[i];
+				shadowRay.origin[2] = paths.originZ[i];
+				shadowRay.direction[0] = RenderScene::lightDirection[0];
+				shadowRay.direction[1] = RenderScene::lightDirection[1];
+				shadowRay.direction[2] = RenderScene::lightDirection[2];
+				if (!tracer->Occluded(shadowRay, &threadStatistics[thread]))
+				{
+					paths.radianceR[i] += shadowR[i];
+					paths.radianceG[i] += shadowG[i];
+					paths.radianceB[i] += shadowB[i];
+				}
+			}
+		});
+	}
+
+	void PathTracer::Retire(const Settings& settings, float* values)
+	{
+		//Ended paths are added to their pixel in queue order on one thread, so the sums don't depend on the thread count
+		float weight = 1.0f / (float)settings.samplesPerPixel;
+		for (size_t i = 0; i < paths.count; i++)
+		{
+			if (pathAlive[i] == 0)
+			{
+				float* pixel = values + (size_t)paths.outputs[i] * 3;
+				pixel[0] += paths.radianceR[i] * weight;
+				pixel[1] += paths.radianceG[i] * weight;
+				pixel[2] += paths.radianceB[i] * weight;
+			}
+		}
+
+		//Live paths are compacted to the front in order, leaving the tail free for Regenerate
+		compactedPaths.count = RayBatch::Compact(paths.count, threadCount, chunkOffsets, [&](size_t i)
+		{
+			return pathAlive[i] != 0;
+		}, [&](size_t i, size_t output)
+		{
+			paths.Copy(i, compactedPaths, output);
+		});
+		std::swap(paths, compactedPaths);
+	}
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "WavefrontRenderer.h"
+#include "Sampler.h"
+
+#include <vector>
+
+namespace MeshManagement
+{
+	//Multi bounce path tracer over the RenderCompute.hlsl scene, mirroring its PATH_TRACING mode. Surfaces are diffuse, lit by the
+	//sun through a shadow ray at every bounce and by the sky when a path escapes.
+	//Paths run as a wavefront: every iteration extends all live paths by one bounce. Paths that ended are compacted out and the
+	//freed slots refilled with new camera paths, so the queue stays full while path lengths differ.
+	class __declspec(dllexport) PathTracer
+	{
+	public:
+		PathTracer(const InstanceTracer& tracer, unsigned int threadCount = 0, size_t wavefrontSize = 65536);
+	public:
+		struct Settings
+		{
+			unsigned int samplesPerPixel = 1;
+			unsigned int maxDepth = 4; //Surface hits per path, 1 is direct lighting only
+			unsigned int rouletteDepth = 2; //Hits after which Russian roulette may end a path
+			unsigned int frame = 0; //Offsets the sample indices, so each frame gets different random numbers
+			unsigned int sampler = Sampler::samplerSobol; //Sequence for sub pixel positions, bounces and roulette
+			bool regeneratePaths = true; //Refill ended paths every iteration, otherwise new paths only start once the queue is empty
+		};
+		struct Statistics
+		{
+			unsigned long long paths = 0;
+			unsigned long long extensionRays = 0;
+			unsigned long long shadowRays = 0;
+			unsigned long long iterations = 0;
+			unsigned long long activePaths = 0; //Summed over iterations, over iterations * wavefront size is the queue occupancy
+			MeshTracer::Statistics traversal;
+		};
+	public:
+		//Writes width * height RGB values, row major, each the mean of samplesPerPixel paths. The result doesn't depend on the
+		//thread count.
+		void Render(const WavefrontRenderer::View& view, const Settings& settings, float* image, Statistics* statistics = nullptr);
+		//Traces only the listed pixels, writing the RGB mean of each to values in list order
+		void RenderPixels(const WavefrontRenderer::View& view, const Settings& settings, const unsigned int* pixels, size_t pixelCount, float* values, Statistics* statistics = nullptr);
+		size_t GetWavefrontSize() const
+		{
+			return wavefrontSize;
+		}
+	private:
+		//Structure of arrays path state, only the first count entries are live
+		struct PathQueue
+		{
+			std::vector<float> originX, originY, originZ;
+			std::vector<float> directionX, directionY, directionZ;
+			std::vector<float> throughputR, throughputG, throughputB;
+			std::vector<float> radianceR, radianceG, radianceB;
+			std::vector<unsigned int> pixels;
+			std::vector<unsigned int> outputs; //Index of the path's pixel in the list being rendered
+			std::vector<unsigned int> samples;
+			std::vector<unsigned int> depths;
+			size_t count = 0;
+
+			void Resize(size_t capacity);
+			void Copy(size_t from, PathQueue& destination, size_t to) const;
+			MeshTracer::Ray GetRay(size_t index) const;
+		};
+	private:
+		void Regenerate(const WavefrontRenderer::View& view, const Settings& settings, unsigned long long pathCount);
+		void Extend(std::vector<MeshTracer::Statistics>& threadStatistics);
+		void Shade(const WavefrontRenderer::View& view, const Settings& settings, std::vector<MeshTracer::Statistics>& threadStatistics);
+		void Shadow(std::vector<MeshTracer::Statistics>& threadStatistics);
+		void Retire(const Settings& settings, float* values);
+	private:
+		const InstanceTracer* tracer;
+		unsigned int threadCount;
+		size_t wavefrontSize;
+		unsigned long long nextPath = 0; //Paths of the frame are numbered pixel major, this is the next one to start
+		const unsigned int* pixelList = nullptr; //Pixels being rendered, nullptr for every pixel in order
+#pragma warning(push)
+#pragma warning(disable:4251)
+		PathQueue paths;
+		PathQueue compactedPaths; //Live paths are copied here after each iteration, then swapped with paths
+		std::vector<InstanceTracer::Intersection> intersections;
+		std::vector<unsigned char> pathAlive; //Set by Shade for paths that continue
+		std::vector<unsigned char> shadowPending; //Set by Shade for paths whose new origin sees the sun unless occluded
+		std::vector<float> shadowR, shadowG, shadowB; //Radiance those paths gain if the shadow ray is unoccluded
+		std::vector<size_t> chunkOffsets; //Scratch for RayBatch::Compact
+#pragma warning(pop)
+	};
+}
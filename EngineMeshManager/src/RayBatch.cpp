@@ -0,0 +1,77 @@
+#include "RayBatch.h"
+
+#include <math.h>
+
+namespace MeshManagement
+{
+	namespace
+	{
+		//Spreads the low 10 bits of value out to every third bit
+		unsigned int SpreadBits(unsigned int value)
+		{
+			value &= 0x3FF;
+			value = (value | (value << 16)) & 0x030000FF;
+			value = (value | (value << 8)) & 0x0300F00F;
+			value = (value | (value << 4)) & 0x030C30C3;
+			value = (value | (value << 2)) & 0x09249249;
+			return value;
+		}
+	}
+
+	std::vector<unsigned int> RayBatch::CoherentOrder(const MeshTracer::Ray* rays, size_t rayCount, unsigned int threadCount)
+	{
+		float minimum[3] = { INFINITY, INFINITY, INFINITY };
+		float maximum[3] = { -INFINITY, -INFINITY, -INFINITY };
+		for (size_t i = 0; i < rayCount; i++)
+		{
+			for (int axis = 0; axis < 3; axis++)
+			{
+				minimum[axis] = fminf(minimum[axis], rays[i].origin[axis]);
+				maximum[axis] = fmaxf(maximum[axis], rays[i].origin[axis]);
+			}
+		}
+		float scale[3];
+		for (int axis = 0; axis < 3; axis++)
+		{
+			scale[axis] = maximum[axis] > minimum[axis] ? 1023.0f / (maximum[axis] - minimum[axis]) : 0.0f;
+		}
+
+		//Octant in the top bits, the origin's 30 bit Morton code below
+		std::vector<std::pair<unsigned long long, unsigned int>> keys(rayCount);
+		ESL::ParallelFor(rayCount, [&](size_t begin, size_t end, unsigned int)
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				const MeshTracer::Ray& ray = rays[i];
+				unsigned long long octant = (ray.direction[0] < 0 ? 1 : 0) | (ray.direction[1] < 0 ? 2 : 0) | (ray.direction[2] < 0 ? 4 : 0);
+				unsigned int morton = 0;
+				for (int axis = 0; axis < 3; axis++)
+				{
+					float cell = (ray.origin[axis] - minimum[axis]) * scale[axis];
+					morton |= SpreadBits(cell > 0 ? (unsigned int)cell : 0) << axis;
+				}
+				keys[i] = { (octant << 30) | morton, (unsigned int)i };
+			}
+		}, threadCount);
+
+		ESL::ParallelSort(keys.begin(), keys.end(), [](const std::pair<unsigned long long, unsigned int>& a, const std::pair<unsigned long long, unsigned int>& b) { return a < b; }, threadCount);
+
+		std::vector<unsigned int> order(rayCount);
+		for (size_t i = 0; i < rayCount; i++)
+		{
+			order[i] = keys[i].second;
+		}
+		return order;
+	}
+
+	void RayBatch::AddStatistics(MeshTracer::Statistics& total, const std::vector<MeshTracer::Statistics>& threadStatistics)
+	{
+		for (size_t i = 0; i < threadStatistics.size(); i++)
+		{
+			total.rays += threadStatistics[i].rays;
+			total.nodesVisited += threadStatistics[i].nodesVisited;
+			total.positionFetches += threadStatistics[i].positionFetches;
+			total.attributeFetches += threadStatistics[i].attributeFetches;
+		}
+	}
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "MeshTracer.h"
+#include "EngineStandard/Parallel.h"
+
+#include <atomic>
+#include <vector>
+
+namespace MeshManagement
+{
+	//Closest hit returned by the batched ray queries
+	struct BatchHit
+	{
+		float distance; //maxDistance on a miss
+		float barycentrics[2]; //Weights of the triangle's second and third vertex, the first gets 1 - u - v
+		unsigned int triangleIndex; //4294967295 on a miss
+		unsigned int instanceIndex; //4294967295 on a miss and for single mesh queries
+	};
+
+	//Shared scheduling for the IntersectBatch and OccludedBatch queries of MeshTracer and InstanceTracer
+	class __declspec(dllexport) RayBatch
+	{
+	public:
+		static constexpr size_t minimumSortedBatch = 256; //Smaller batches are traced in order on the calling thread
+		static constexpr size_t chunkSize = 64; //Consecutive sorted rays a thread claims at a time
+		static constexpr size_t stageChunkSize = 1024; //Queue entries a wavefront stage thread claims at a time, also the unit of Compact
+	public:
+		//Ray indices grouped by direction octant, so neighbouring rays walk the hierarchy in the same order, then sorted along a
+		//Morton curve through the batch's origins
+		static std::vector<unsigned int> CoherentOrder(const MeshTracer::Ray* rays, size_t rayCount, unsigned int threadCount);
+
+		//Calls trace(rayIndex) once for every ray. Large batches run in coherent order, in chunks spread across threadCount threads.
+		template <class Function> static void Run(const MeshTracer::Ray* rays, size_t rayCount, unsigned int threadCount, const Function& trace)
+		{
+			if (threadCount == 0)
+			{
+				threadCount = ESL::ThreadCount();
+			}
+			if (rayCount < minimumSortedBatch)
+			{
+				for (size_t i = 0; i < rayCount; i++)
+				{
+					trace((unsigned int)i);
+				}
+				return;
+			}
+
+			std::vector<unsigned int> order = CoherentOrder(rays, rayCount, threadCount);
+			ForEachChunk(rayCount, chunkSize, threadCount, [&](size_t begin, size_t end, unsigned int)
+			{
+				for (size_t i = begin; i < end; i++)
+				{
+					trace(order[i]);
+				}
+			});
+		}
+
+		//Sums the per thread statistics of a stage into total
+		static void AddStatistics(MeshTracer::Statistics& total, const std::vector<MeshTracer::Statistics>& threadStatistics);
+
+		//Calls move(from, to) for every index of [0, count) live(index) accepts, packing them to the front of another queue in
+		//order. Each stageChunkSize chunk counts its live entries in parallel, a prefix sum over chunkOffsets gives every chunk
+		//its first output, then the chunks move in parallel. chunkOffsets is scratch the caller keeps between calls. Returns the
+		//number of live entries.
+		template <class Live, class Move> static size_t Compact(size_t count, unsigned int threadCount, std::vector<size_t>& chunkOffsets, const Live& live, const Move& move)
+		{
+			size_t chunkCount = (count + stageChunkSize - 1) / stageChunkSize;
+			chunkOffsets.resize(chunkCount + 1);
+			ForEachChunk(count, stageChunkSize, threadCount, [&](size_t begin, size_t end, unsigned int)
+			{
+				size_t alive = 0;
+				for (size_t i = begin; i < end; i++)
+				{
+					alive += live(i) ? 1 : 0;
+				}
+				chunkOffsets[begin / stageChunkSize + 1] = alive;
+			});
+			chunkOffsets[0] = 0;
+			for (size_t chunk = 0; chunk < chunkCount; chunk++)
+			{
+				chunkOffsets[chunk + 1] += chunkOffsets[chunk];
+			}
+
+			ForEachChunk(count, stageChunkSize, threadCount, [&](size_t begin, size_t end, unsigned int)
+			{
+				size_t output = chunkOffsets[begin / stageChunkSize];
+				for (size_t i = begin; i < end; i++)
+				{
+					if (live(i))
+					{
+						move(i, output++);
+					}
+				}
+			});
+			return chunkOffsets[chunkCount];
+		}
+
+		//Calls function(begin, end, threadIndex) for every chunkSize range of [0, count). Threads claim the next range as they
+		//finish one, so uneven ranges don't leave threads idle.
+		template <class Function> static void ForEachChunk(size_t count, size_t chunkSize, unsigned int threadCount, const Function& function)
+		{
+			std::atomic<size_t> nextChunk(0);
+			size_t chunkCount = (count + chunkSize - 1) / chunkSize;
+			ESL::ParallelFor(chunkCount < threadCount ? chunkCount : threadCount, [&](size_t, size_t, unsigned int thread)
+			{
+				for (size_t chunk = nextChunk++; chunk < chunkCount; chunk = nextChunk++)
+				{
+					size_t end = (chunk + 1) * chunkSize < count ? (chunk + 1) * chunkSize : count;
+					function(chunk * chunkSize, end, thread);
+				}
+			}, threadCount);
+		}
+	};
+}
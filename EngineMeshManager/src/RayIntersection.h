@@ -0,0 +1,64 @@
+#pragma once
+
+#include "Mesh.h"
+
+#include <math.h>
+
+namespace MeshManagement
+{
+	//Same as triIntersect in RenderCompute.hlsl, returns (t, u, v, w) or t = INFINITY on a miss
+	inline void TriangleIntersect(const float origin[3], const float direction[3], const float v0[3], const float v1[3], const float v2[3], float result[4])
+	{
+		result[0] = INFINITY;
+
+		float v1v0[3] = { v1[0] - v0[0], v1[1] - v0[1], v1[2] - v0[2] };
+		float v2v0[3] = { v2[0] - v0[0], v2[1] - v0[1], v2[2] - v0[2] };
+		float rov0[3] = { origin[0] - v0[0], origin[1] - v0[1], origin[2] - v0[2] };
+
+		float n[3] = { v1v0[1] * v2v0[2] - v1v0[2] * v2v0[1], v1v0[2] * v2v0[0] - v1v0[0] * v2v0[2], v1v0[0] * v2v0[1] - v1v0[1] * v2v0[0] };
+		float d = direction[0] * n[0] + direction[1] * n[1] + direction[2] * n[2];
+		if (fabsf(d) < 0.0000001f)
+		{
+			return;
+		}
+		d = 1.0f / d;
+
+		float q[3] = { rov0[1] * direction[2] - rov0[2] * direction[1], rov0[2] * direction[0] - rov0[0] * direction[2], rov0[0] * direction[1] - rov0[1] * direction[0] };
+		float u = d * -(q[0] * v2v0[0] + q[1] * v2v0[1] + q[2] * v2v0[2]);
+		if (u < 0 || u > 1)
+		{
+			return;
+		}
+		float v = d * (q[0] * v1v0[0] + q[1] * v1v0[1] + q[2] * v1v0[2]);
+		if (v < 0 || u + v > 1)
+		{
+			return;
+		}
+		float t = d * -(n[0] * rov0[0] + n[1] * rov0[1] + n[2] * rov0[2]);
+		if (t < 0)
+		{
+			return;
+		}
+
+		result[0] = t;
+		result[1] = u;
+		result[2] = v;
+		result[3] = 1 - u - v;
+	}
+
+	//Same as boxIntersection in RenderCompute.hlsl
+	inline bool BoxIntersect(const float origin[3], const float inverseDirection[3], const Mesh::AABB& aabb, float minDistance)
+	{
+		float tx1 = (aabb.ax - origin[0]) * inverseDirection[0];
+		float tx2 = (aabb.bx - origin[0]) * inverseDirection[0];
+		float ty1 = (aabb.ay - origin[1]) * inverseDirection[1];
+		float ty2 = (aabb.by - origin[1]) * inverseDirection[1];
+		float tz1 = (aabb.az - origin[2]) * inverseDirection[2];
+		float tz2 = (aabb.bz - origin[2]) * inverseDirection[2];
+
+		float minT = fmaxf(fmaxf(fminf(tx1, tx2), fminf(ty1, ty2)), fminf(tz1, tz2));
+		float maxT = fminf(fminf(fmaxf(tx1, tx2), fmaxf(ty1, ty2)), fmaxf(tz1, tz2));
+
+		return maxT >= minT && minT < minDistance;
+	}
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "InstanceTracer.h"
+
+#include <math.h>
+
+namespace MeshManagement
+{
+	//The lighting and ground disc RenderCompute.hlsl places around the mesh, shared by the CPU renderers
+	namespace RenderScene
+	{
+		const float lightDirection[3] = { 0.57735f, 0.57735f, 0.57735f };
+		const float groundRadius = 6.0f;
+		const float shadowBias = 0.01f; //Distance secondary rays start off the surface along its normal
+		const float ambient = 0.05f; //Added to every lit surface by the direct lighting model
+		const float meshAlbedo[3] = { 0.2f, 0.8f, 1.0f };
+		const float skyRadiance[3] = { 0.5f, 0.5f, 0.5f };
+
+		//Ids the shader writes to GeomertyHistoryBuffer for what a primary ray hit
+		const unsigned int skyID = 0;
+		const unsigned int meshID = 1;
+		const unsigned int groundID = 2;
+		const float skyDistance = 10000.0f; //Distance the shader stores for primary rays that hit nothing
+
+		//Replaces hit with the ground disc at y = 0 if ray reaches the disc first, returns whether it did
+		inline bool IntersectGround(const MeshTracer::Ray& ray, InstanceTracer::Hit& hit)
+		{
+			float groundDistance = -ray.origin[1] / ray.direction[1];
+			float groundX = ray.origin[0] + ray.direction[0] * groundDistance;
+			float groundZ = ray.origin[2] + ray.direction[2] * groundDistance;
+			if (!(groundDistance > 0 && groundDistance < hit.distance && sqrtf(groundX * groundX + groundZ * groundZ) < groundRadius))
+			{
+				return false;
+			}
+
+			hit.distance = groundDistance;
+			hit.position[0] = groundX;
+			hit.position[1] = 0;
+			hit.position[2] = groundZ;
+			hit.normal[0] = 0;
+			hit.normal[1] = 1;
+			hit.normal[2] = 0;
+			hit.triangleIndex = 4294967295;
+			hit.instanceIndex = 4294967295;
+			return true;
+		}
+
+		//Checker pattern of the shader's filteredChecker, two squares per unit
+		inline float GroundAlbedo(float x, float z)
+		{
+			bool upperHalfX = x - floorf(x) > 0.5f;
+			bool upperHalfZ = z - floorf(z) > 0.5f;
+			return upperHalfX != upperHalfZ ? 1.0f : 0.5f;
+		}
+	}
+}
@@ -0,0 +1,92 @@
+#include "ResolutionGovernor.h"
+#include "EngineStandard/Parallel.h"
+
+#include <algorithm>
+#include <math.h>
+
+namespace MeshManagement
+{
+	ResolutionGovernor::ResolutionGovernor(unsigned int outputWidth, unsigned int outputHeight, const Settings& settings) : settings(settings), outputWidth(std::max(outputWidth, 1u)), outputHeight(std::max(outputHeight, 1u))
+	{
+		SetScale(settings.maximumScale);
+	}
+
+	void ResolutionGovernor::EndFrame(double milliseconds)
+	{
+		statistics.frames++;
+		framesSinceChange++;
+		statistics.averageMilliseconds = framesSinceChange == 1 ? milliseconds : statistics.averageMilliseconds + (milliseconds - statistics.averageMilliseconds) * settings.smoothing;
+		if (framesSinceChange < std::max(settings.cooldownFrames, 1u))
+		{
+			return;
+		}
+
+		bool overBudget = statistics.averageMilliseconds > settings.targetMilliseconds * (1.0 + settings.hysteresis);
+		bool underBudget = statistics.averageMilliseconds < settings.targetMilliseconds * (1.0 - settings.hysteresis);
+		if (!overBudget && !underBudget)
+		{
+			return;
+		}
+
+		//Frame time follows the pixel count, the square of the scale
+		unsigned int previousWidth = statistics.renderWidth;
+		SetScale(statistics.scale * (float)sqrt(settings.targetMilliseconds / std::max(statistics.averageMilliseconds, 1e-3)));
+		if (statistics.renderWidth != previousWidth)
+		{
+			statistics.scaleChanges++;
+			framesSinceChange = 0;
+		}
+	}
+
+	void ResolutionGovernor::SetOutputSize(unsigned int width, unsigned int height)
+	{
+		outputWidth = std::max(width, 1u);
+		outputHeight = std::max(height, 1u);
+		SetScale(statistics.scale);
+	}
+
+	void ResolutionGovernor::SetSettings(const Settings& settings)
+	{
+		this->settings = settings;
+		SetScale(statistics.scale);
+	}
+
+	void ResolutionGovernor::SetScale(float scale)
+	{
+		scale = std::min(std::max(scale, settings.minimumScale), std::min(settings.maximumScale, 1.0f));
+		unsigned int granularity = std::max(settings.granularity, 1u);
+		unsigned int width = (unsigned int)((float)outputWidth * scale / (float)granularity + 0.5f) * granularity;
+		statistics.renderWidth = std::min(std::max(width, std::min(granularity, outputWidth)), outputWidth);
+		statistics.renderHeight = std::max((unsigned int)((double)outputHeight * statistics.renderWidth / outputWidth + 0.5), 1u);
+		statistics.scale = (float)statistics.renderWidth / (float)outputWidth;
+	}
+
+	void ResolutionGovernor::Upscale(const float* image, unsigned int width, unsigned int height, unsigned int channels, float* output, unsigned int outputWidth, unsigned int outputHeight, unsigned int threadCount)
+	{
+		float scaleX = (float)width / (float)outputWidth;
+		float scaleY = (float)height / (float)outputHeight;
+		ESL::ParallelFor(outputHeight, [&](size_t begin, size_t end, unsigned int)
+		{
+			for (size_t y = begin; y < end; y++)
+			{
+				float sourceY = std::min(std::max(((float)y + 0.5f) * scaleY - 0.5f, 0.0f), (float)(height - 1));
+				unsigned int y0 = (unsigned int)sourceY;
+				unsigned int y1 = std::min(y0 + 1, height - 1);
+				float fractionY = sourceY - (float)y0;
+				for (unsigned int x = 0; x < outputWidth; x++)
+				{
+					float sourceX = std::min(std::max(((float)x + 0.5f) * scaleX - 0.5f, 0.0f), (float)(width - 1));
+					unsigned int x0 = (unsigned int)sourceX;
+					unsigned int x1 = std::min(x0 + 1, width - 1);
+					float fractionX = sourceX - (float)x0;
+					for (unsigned int channel = 0; channel < channels; channel++)
+					{
+						float top = image[((size_t)y0 * width + x0) * channels + channel] + (image[((size_t)y0 * width + x1) * channels + channel] - image[((size_t)y0 * width + x0) * channels + channel]) * fractionX;
+						float bottom = image[((size_t)y1 * width + x0) * channels + channel] + (image[((size_t)y1 * width + x1) * channels + channel] - image[((size_t)y1 * width + x0) * channels + channel]) * fractionX;
+						output[(y * outputWidth + x) * channels + channel] = top + (bottom - top) * fractionY;
+					}
+				}
+			}
+		}, threadCount == 0 ? ESL::ThreadCount() : threadCount);
+	}
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+namespace MeshManagement
+{
+	//Picks the internal render resolution that keeps frames within a time budget, for the CPU renderers and Graphics alike. Each
+	//frame's time goes into a running average, and once that leaves a band of hysteresis either side of the target the scale is
+	//set to the one predicted to hit it, assuming frame time follows the pixel count. After a change the average restarts and
+	//the scale is held for cooldownFrames, so a single slow frame or the settling of the new scale can't make it oscillate.
+	//The frame is rendered at GetRenderWidth by GetRenderHeight and stretched to the output size with Upscale.
+	class __declspec(dllexport) ResolutionGovernor
+	{
+	public:
+		struct Settings
+		{
+			double targetMilliseconds = 1000.0 / 60.0;
+			float minimumScale = 0.5f; //Render width over output width
+			float maximumScale = 1.0f;
+			float hysteresis = 0.1f; //Fraction of the target the average has to be over or under it by before the scale changes
+			float smoothing = 0.2f; //Weight of the newest frame in the running average
+			unsigned int cooldownFrames = 8; //Frames at a new scale before it can change again
+			unsigned int granularity = 8; //Render widths are multiples of this many pixels
+		};
+		struct Statistics
+		{
+			float scale = 1.0f; //Render width over output width, after rounding to the granularity
+			unsigned int renderWidth = 0;
+			unsigned int renderHeight = 0;
+			double averageMilliseconds = 0.0;
+			unsigned long long frames = 0;
+			unsigned long long scaleChanges = 0;
+		};
+	public:
+		ResolutionGovernor(unsigned int outputWidth, unsigned int outputHeight, const Settings& settings);
+	public:
+		//Records how long the last frame took, which may change the render size of the next one
+		void EndFrame(double milliseconds);
+		//Keeps the current scale for the new size
+		void SetOutputSize(unsigned int width, unsigned int height);
+		void SetSettings(const Settings& settings);
+
+		unsigned int GetRenderWidth() const
+		{
+			return statistics.renderWidth;
+		}
+		unsigned int GetRenderHeight() const
+		{
+			return statistics.renderHeight;
+		}
+		const Statistics& GetStatistics() const
+		{
+			return statistics;
+		}
+
+		//Bilinearly resamples width * height pixels of channels floats each, row major, to outputWidth * outputHeight. Pixel
+		//centres line up, like Shaders/Upscale.hlsl.
+		static void Upscale(const float* image, unsigned int width, unsigned int height, unsigned int channels, float* output, unsigned int outputWidth, unsigned int outputHeight, unsigned int threadCount = 0);
+	private:
+		void SetScale(float scale);
+	private:
+		Settings settings;
+		Statistics statistics;
+		unsigned int outputWidth;
+		unsigned int outputHeight;
+		unsigned int framesSinceChange = 0;
+	};
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+namespace MeshManagement
+{
+	//CPU build of the shader's sample sequences in Engine/Graphics/Shaders/Sampler.hlsli, use SampleSequence with one of the
+	//sampler constants
+	namespace Sampler
+	{
+#include "Engine/Graphics/Shaders/Sampler.hlsli"
+	}
+}
@@ -0,0 +1,190 @@
+#include "TemporalAccumulator.h"
+#include "RenderScene.h"
+#include "EngineStandard/Parallel.h"
+
+#include <algorithm>
+#include <math.h>
+
+namespace MeshManagement
+{
+	namespace
+	{
+		const float offScreen = -10000.0f; //Previous position given to hits behind the previous camera, so nothing is reprojected
+		const float minimumHistoryWeight = 0.01f; //Bilinear weight of the valid taps below which the history counts as disoccluded
+	}
+
+	TemporalAccumulator::TemporalAccumulator(unsigned int threadCount) : threadCount(threadCount == 0 ? ESL::ThreadCount() : threadCount)
+	{
+	}
+
+	void TemporalAccumulator::Accumulate(const WavefrontRenderer::View& view, const Denoiser::Guides& guides, const float* image, const Settings& settings, float* output)
+	{
+		size_t pixelCount = (size_t)guides.width * guides.height;
+		ComputeMotionVectors(view, hasHistory ? previousView : view, guides);
+		history.resize(pixelCount * 3);
+		historyLengths.resize(pixelCount);
+
+		//Checkerboard patterns leave too few traced pixels in a 3x3 block for a box
+		int boxRadius = settings.checkerboard == Checkerboard::checkerboardFull ? 1 : 2;
+		ESL::ParallelFor(guides.height, [&](size_t begin, size_t end, unsigned int)
+		{
+			for (int y = (int)begin; y < (int)end; y++)
+			{
+				for (int x = 0; x < (int)guides.width; x++)
+				{
+					size_t pixel = (size_t)y * guides.width + x;
+
+					//Colour box of the neighbourhood's samples
+					float mean[3] = { 0, 0, 0 };
+					float meanSquare[3] = { 0, 0, 0 };
+					float count = 0;
+					for (int neighbourY = std::max(y - boxRadius, 0); neighbourY <= std::min(y + boxRadius, (int)guides.height - 1); neighbourY++)
+					{
+						for (int neighbourX = std::max(x - boxRadius, 0); neighbourX <= std::min(x + boxRadius, (int)guides.width - 1); neighbourX++)
+						{
+							if (!Checkerboard::CheckerboardTraced(settings.checkerboard, (unsigned int)neighbourX, (unsigned int)neighbourY, settings.frame))
+							{
+								continue;
+							}
+							const float* color = &image[((size_t)neighbourY * guides.width + neighbourX) * 3];
+							for (int channel = 0; channel < 3; channel++)
+							{
+								mean[channel] += color[channel];
+								meanSquare[channel] += color[channel] * color[channel];
+							}
+							count++;
+						}
+					}
+
+					//Bilinear history from the taps that saw the same surface
+					float previous[3] = { 0, 0, 0 };
+					float previousLength = 0;
+					float weightSum = 0;
+					if (hasHistory)
+					{
+						float previousX = (float)x + motionVectors[pixel * 2];
+						float previousY = (float)y + motionVectors[pixel * 2 + 1];
+						float baseX = floorf(previousX);
+						float baseY = floorf(previousY);
+						float fractionX = previousX - baseX;
+						float fractionY = previousY - baseY;
+						for (int tap = 0; tap < 4; tap++)
+						{
+							int tapX = (int)baseX + (tap & 1);
+							int tapY = (int)baseY + (tap >> 1);
+							if (tapX < 0 || tapY < 0 || tapX >= (int)previousGuides.width || tapY >= (int)previousGuides.height)
+							{
+								continue;
+							}
+							size_t tapPixel = (size_t)tapY * previousGuides.width + tapX;
+							if (previousGuides.meshIDs[tapPixel] != guides.meshIDs[pixel])
+							{
+								continue;
+							}
+							float cosine = previousGuides.normalX[tapPixel] * guides.normalX[pixel] + previousGuides.normalY[tapPixel] * guides.normalY[pixel] + previousGuides.normalZ[tapPixel] * guides.normalZ[pixel];
+							if (guides.meshIDs[pixel] != (float)RenderScene::skyID && cosine < settings.normalThreshold)
+							{
+								continue;
+							}
+
+							float weight = ((tap & 1) ? fractionX : 1.0f - fractionX) * ((tap >> 1) ? fractionY : 1.0f - fractionY);
+							for (int channel = 0; channel < 3; channel++)
+							{
+								previous[channel] += previousHistory[tapPixel * 3 + channel] * weight;
+							}
+							previousLength += previousHistoryLengths[tapPixel] * weight;
+							weightSum += weight;
+						}
+					}
+
+					//Pixels the frame didn't trace carry their history over unchanged, the box is only checked when a sample arrives
+					bool traced = Checkerboard::CheckerboardTraced(settings.checkerboard, (unsigned int)x, (unsigned int)y, settings.frame);
+					float length = 0;
+					if (weightSum > minimumHistoryWeight)
+					{
+						float clampedSquare = 0;
+						float boxSquare = 0;
+						for (int channel = 0; channel < 3; channel++)
+						{
+							float channelMean = mean[channel] / count;
+							float deviation = sqrtf(std::max(meanSquare[channel] / count - channelMean * channelMean, 0.0f)) * settings.colorBoxScale;
+							float value = previous[channel] / weightSum;
+							previous[channel] = traced ? std::min(std::max(value, channelMean - deviation), channelMean + deviation) : value;
+							clampedSquare += (previous[channel] - value) * (previous[channel] - value);
+							boxSquare += 4.0f * deviation * deviation;
+						}
+						length = previousLength / weightSum * (1.0f - std::min(sqrtf(clampedSquare / std::max(boxSquare, 1e-8f)), 1.0f));
+					}
+
+					if (traced)
+					{
+						length = std::min(length + 1.0f, (float)settings.maxHistoryLength);
+						float alpha = 1.0f / length;
+						for (int channel = 0; channel < 3; channel++)
+						{
+							history[pixel * 3 + channel] = previous[channel] + (image[pixel * 3 + channel] - previous[channel]) * alpha;
+						}
+					}
+					else
+					{
+						for (int channel = 0; channel < 3; channel++)
+						{
+							history[pixel * 3 + channel] = weightSum > minimumHistoryWeight ? previous[channel] : image[pixel * 3 + channel];
+						}
+					}
+					historyLengths[pixel] = length;
+				}
+			}
+		}, threadCount);
+
+		//Neighbourhoods read image, so output is only written once every pixel is done
+		std::copy(history.begin(), history.end(), output);
+		previousHistory.swap(history);
+		previousHistoryLengths = historyLengths;
+		previousGuides = guides;
+		previousView = view;
+		hasHistory = true;
+	}
+
+	void TemporalAccumulator::Reset()
+	{
+		hasHistory = false;
+	}
+
+	void TemporalAccumulator::ComputeMotionVectors(const WavefrontRenderer::View& view, const WavefrontRenderer::View& previous, const Denoiser::Guides& guides)
+	{
+		motionVectors.resize((size_t)guides.width * guides.height * 2);
+		ESL::ParallelFor(guides.height, [&](size_t begin, size_t end, unsigned int)
+		{
+			for (unsigned int y = (unsigned int)begin; y < (unsigned int)end; y++)
+			{
+				for (unsigned int x = 0; x < guides.width; x++)
+				{
+					size_t pixel = (size_t)y * guides.width + x;
+					MeshTracer::Ray ray = WavefrontRenderer::CameraRay(view, x, y);
+
+					//Hit position in the previous camera's space, then back through the projection CameraRay uses
+					float camera[3] = { 0, 0, 0 };
+					for (int i = 0; i < 3; i++)
+					{
+						float offset = ray.origin[i] + ray.direction[i] * guides.distances[pixel] - previous.origin[i];
+						camera[0] += offset * previous.cameraToWorld[i];
+						camera[1] += offset * previous.cameraToWorld[3 + i];
+						camera[2] += offset * previous.cameraToWorld[6 + i];
+					}
+					float previousX = offScreen;
+					float previousY = offScreen;
+					if (camera[2] < 0)
+					{
+						float u = -previous.focalLength * camera[0] / camera[2];
+						float v = previous.focalLength * camera[1] / camera[2];
+						previousX = (u * (float)previous.height + (float)previous.width) * 0.5f - 0.5f;
+						previousY = (v * (float)previous.height + (float)previous.height) * 0.5f - 0.5f;
+					}
+					motionVectors[pixel * 2] = previousX - (float)x;
+					motionVectors[pixel * 2 + 1] = previousY - (float)y;
+				}
+			}
+		}, threadCount);
+	}
+}
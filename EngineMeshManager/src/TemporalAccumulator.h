@@ -0,0 +1,64 @@
+#pragma once
+
+#include "Denoiser.h"
+#include "Checkerboard.h"
+
+#include <vector>
+
+namespace MeshManagement
+{
+	//Accumulates path traced frames over time, the CPU version of Shaders/Temporal.hlsl. Each pixel's primary hit is projected
+	//into the previous view to find where it was last frame, its motion vector, and the history there is fetched bilinearly from
+	//the taps that saw the same mesh with a similar normal. That history is clamped to the colour box of the current frame's 3x3
+	//neighbourhood, mean plus or minus colorBoxScale standard deviations, so colour that no longer belongs to the pixel can't
+	//linger as ghosting. The blend weight is one over the pixel's history length, which grows by one every frame up to
+	//maxHistoryLength, restarts on disocclusion and shrinks in proportion to how far the history had to be clamped.
+	//With a checkerboard pattern the pixels the frame didn't trace hold CheckerboardResolver's spatial fill rather than a sample,
+	//so they carry their history over unchanged and only take the fill where the history was lost. The box is then built from the
+	//traced pixels of a 5x5 neighbourhood.
+	//The view may change size between frames, as under ResolutionGovernor. Motion vectors point into the previous frame's pixels,
+	//so the history carries over at the new resolution.
+	class __declspec(dllexport) TemporalAccumulator
+	{
+	public:
+		TemporalAccumulator(unsigned int threadCount = 0);
+	public:
+		struct Settings
+		{
+			unsigned int maxHistoryLength = 64; //The blend weight never drops below one over this
+			float colorBoxScale = 1.25f;
+			float normalThreshold = 0.9f; //Cosine between normals above which a history tap counts as the same surface
+			unsigned int checkerboard = Checkerboard::checkerboardFull; //Pattern the frame was traced with
+			unsigned int frame = 0; //Picks the pixels checkerboard traced
+		};
+	public:
+		//Blends image, guides.width * guides.height RGB values row major, into the history and writes the result to output.
+		//guides are the primary hits of view, as from Denoiser::TraceGuides. image and output may be the same.
+		void Accumulate(const WavefrontRenderer::View& view, const Denoiser::Guides& guides, const float* image, const Settings& settings, float* output);
+		void Reset(); //Forgets the history, the next frame starts over
+
+		const std::vector<float>& GetMotionVectors() const //Two per pixel, the offset in pixels to where its hit was last frame
+		{
+			return motionVectors;
+		}
+		const std::vector<float>& GetHistoryLengths() const //Frames blended into each pixel, including the latest
+		{
+			return historyLengths;
+		}
+	private:
+		void ComputeMotionVectors(const WavefrontRenderer::View& view, const WavefrontRenderer::View& previous, const Denoiser::Guides& guides);
+	private:
+		unsigned int threadCount;
+		bool hasHistory = false;
+		WavefrontRenderer::View previousView;
+#pragma warning(push)
+#pragma warning(disable:4251)
+		Denoiser::Guides previousGuides;
+		std::vector<float> history; //RGB, row major
+		std::vector<float> previousHistory;
+		std::vector<float> historyLengths;
+		std::vector<float> previousHistoryLengths;
+		std::vector<float> motionVectors;
+#pragma warning(pop)
+	};
+}
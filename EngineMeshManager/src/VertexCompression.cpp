@@ -0,0 +1,183 @@
+#include "VertexCompression.h"
+
+#include <math.h>
+#include <string.h>
+
+namespace MeshManagement
+{
+	namespace
+	{
+		float SignNotZero(float value)
+		{
+			return value >= 0.0f ? 1.0f : -1.0f;
+		}
+
+		//Maps an octahedron projection back to the unit sphere
+		void OctahedronToNormal(float x, float y, float normal[3])
+		{
+			float z = 1.0f - fabsf(x) - fabsf(y);
+			if (z < 0)
+			{
+				float wrappedX = (1.0f - fabsf(y)) * SignNotZero(x);
+				float wrappedY = (1.0f - fabsf(x)) * SignNotZero(y);
+				x = wrappedX;
+				y = wrappedY;
+			}
+
+			float magnitude = sqrtf(x * x + y * y + z * z);
+			normal[0] = x / magnitude;
+			normal[1] = y / magnitude;
+			normal[2] = z / magnitude;
+		}
+
+		unsigned int PackSnorm(float x, float y)
+		{
+			unsigned int packedX = (unsigned int)(unsigned short)(short)x;
+			unsigned int packedY = (unsigned int)(unsigned short)(short)y;
+			return packedX | (packedY << 16);
+		}
+	}
+
+	unsigned int VertexCompression::EncodeNormal(const float normal[3])
+	{
+		float l1Norm = fabsf(normal[0]) + fabsf(normal[1]) + fabsf(normal[2]);
+		if (l1Norm == 0)
+		{
+			return PackSnorm(0, 0);
+		}
+
+		float x = normal[0] / l1Norm;
+		float y = normal[1] / l1Norm;
+		if (normal[2] < 0) //Fold the lower hemisphere over the diagonals
+		{
+			float foldedX = (1.0f - fabsf(y)) * SignNotZero(x);
+			float foldedY = (1.0f - fabsf(x)) * SignNotZero(y);
+			x = foldedX;
+			y = foldedY;
+		}
+
+		//Test the four surrounding quantized points and keep the one that decodes closest to the input
+		float baseX = floorf(fminf(fmaxf(x, -1.0f), 1.0f) * 32767.0f);
+		float baseY = floorf(fminf(fmaxf(y, -1.0f), 1.0f) * 32767.0f);
+
+		unsigned int best = 0;
+		float bestDot = -INFINITY;
+		for (int i = 0; i < 4; i++)
+		{
+			float candidateX = fminf(baseX + (float)(i & 1), 32767.0f);
+			float candidateY = fminf(baseY + (float)(i >> 1), 32767.0f);
+
+			float decoded[3];
+			OctahedronToNormal(candidateX / 32767.0f, candidateY / 32767.0f, decoded);
+			float dot = decoded[0] * normal[0] + decoded[1] * normal[1] + decoded[2] * normal[2];
+			if (dot > bestDot)
+			{
+				bestDot = dot;
+				best = PackSnorm(candidateX, candidateY);
+			}
+		}
+
+		return best;
+	}
+
+	void VertexCompression::DecodeNormal(unsigned int encoded, float normal[3])
+	{
+		float x = fmaxf((float)(short)(unsigned short)(encoded & 0xffff) / 32767.0f, -1.0f);
+		float y = fmaxf((float)(short)(unsigned short)(encoded >> 16) / 32767.0f, -1.0f);
+		OctahedronToNormal(x, y, normal);
+	}
+
+	unsigned short VertexCompression::FloatToHalf(float value)
+	{
+		unsigned int bits;
+		memcpy(&bits, &value, sizeof(bits));
+
+		unsigned int sign = (bits >> 16) & 0x8000;
+		unsigned int floatExponent = (bits >> 23) & 0xff;
+		unsigned int mantissa = bits & 0x007fffff;
+
+		if (floatExponent == 0xff) //Infinity or NaN
+		{
+			return (unsigned short)(sign | 0x7c00 | (mantissa != 0 ? 0x0200 : 0));
+		}
+
+		int exponent = (int)floatExponent - 127 + 15;
+		if (exponent >= 31) //Too large, round to infinity
+		{
+			return (unsigned short)(sign | 0x7c00);
+		}
+
+		if (exponent <= 0) //Subnormal half or zero
+		{
+			if (exponent < -10)
+			{
+				return (unsigned short)sign;
+			}
+
+			mantissa |= 0x00800000;
+			unsigned int shift = (unsigned int)(14 - exponent);
+			unsigned int half = mantissa >> shift;
+			unsigned int remainder = mantissa & ((1u << shift) - 1);
+			unsigned int halfway = 1u << (shift - 1);
+			if (remainder > halfway || (remainder == halfway && (half & 1) != 0))
+			{
+				half++;
+			}
+			return (unsigned short)(sign | half);
+		}
+
+		//Round to nearest even, a carry out of the mantissa correctly bumps the exponent
+		unsigned int half = sign | ((unsigned int)exponent << 10) | (mantissa >> 13);
+		unsigned int remainder = mantissa & 0x1fff;
+		if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1) != 0))
+		{
+			half++;
+		}
+		return (unsigned short)half;
+	}
+
+	float VertexCompression::HalfToFloat(unsigned short value)
+	{
+		unsigned int sign = ((unsigned int)value & 0x8000) << 16;
+		unsigned int exponent = ((unsigned int)value >> 10) & 0x1f;
+		unsigned int mantissa = (unsigned int)value & 0x03ff;
+
+		if (exponent == 0) //Zero or subnormal
+		{
+			float result = ldexpf((float)mantissa, -24);
+			return sign != 0 ? -result : result;
+		}
+
+		unsigned int bits;
+		if (exponent == 31)
+		{
+			bits = sign | 0x7f800000 | (mantissa << 13);
+		}
+		else
+		{
+			bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+		}
+
+		float result;
+		memcpy(&result, &bits, sizeof(result));
+		return result;
+	}
+
+	Mesh::CompressedVertexAttribute VertexCompression::Compress(const Mesh::VertexAttribute& attribute)
+	{
+		Mesh::CompressedVertexAttribute compressed;
+		compressed.normal = EncodeNormal(attribute.normal);
+		compressed.UV[0] = FloatToHalf(attribute.UV[0]);
+		compressed.UV[1] = FloatToHalf(attribute.UV[1]);
+		return compressed;
+	}
+
+	Mesh::VertexAttribute VertexCompression::Decompress(const Mesh::CompressedVertexAttribute& attribute)
+	{
+		Mesh::VertexAttribute decompressed;
+		DecodeNormal(attribute.normal, decompressed.normal);
+		decompressed.UV[0] = HalfToFloat(attribute.UV[0]);
+		decompressed.UV[1] = HalfToFloat(attribute.UV[1]);
+		return decompressed;
+	}
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "Mesh.h"
+
+namespace MeshManagement
+{
+	//Error bounds for a CompressedVertexAttribute round trip:
+	//  Normal: at most 0.01 degrees between the unit input normal and the decoded normal
+	//  UV: at most 2^-11 relative to the coordinate (half precision rounding), or 2^-25 absolute for coordinates below 2^-14
+	class __declspec(dllexport) VertexCompression
+	{
+	public:
+		static constexpr double maxNormalErrorDegrees = 0.01;
+		static constexpr double maxUVRelativeError = 1.0 / 2048.0;
+		static constexpr double maxUVAbsoluteError = 1.0 / 33554432.0;
+	public:
+		static unsigned int EncodeNormal(const float normal[3]);
+		static void DecodeNormal(unsigned int encoded, float normal[3]);
+		static unsigned short FloatToHalf(float value);
+		static float HalfToFloat(unsigned short value);
+	public:
+		static Mesh::CompressedVertexAttribute Compress(const Mesh::VertexAttribute& attribute);
+		static Mesh::VertexAttribute Decompress(const Mesh::CompressedVertexAttribute& attribute);
+	};
+}
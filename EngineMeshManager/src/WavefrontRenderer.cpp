@@ -0,0 +1,281 @@
+#include "WavefrontRenderer.h"
+#include "RayBatch.h"
+#include "RenderScene.h"
+#include "EngineStandard/Parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <math.h>
+
+namespace MeshManagement
+{
+	namespace
+	{
+		//Finds the visible surface from the mesh intersection and the ground disc. For a hit, returns the shadow ray towards the
+		//light, the unshadowed diffuse term and the surface's albedo.
+		bool ShadeSurface(const InstanceTracer& tracer, const MeshTracer::Ray& ray, const InstanceTracer::Intersection& intersection, MeshTracer::Statistics* statistics, MeshTracer::Ray& shadowRay, float& diffuse, float albedo[3])
+		{
+			InstanceTracer::Hit hit = tracer.GetHit(ray, intersection, statistics);
+			bool ground = RenderScene::IntersectGround(ray, hit);
+			if (hit.distance == INFINITY)
+			{
+				return false;
+			}
+
+			for (int i = 0; i < 3; i++)
+			{
+				shadowRay.origin[i] = hit.position[i] + hit.normal[i] * RenderScene::shadowBias;
+				shadowRay.direction[i] = RenderScene::lightDirection[i];
+			}
+			diffuse = hit.normal[0] * RenderScene::lightDirection[0] + hit.normal[1] * RenderScene::lightDirection[1] + hit.normal[2] * RenderScene::lightDirection[2];
+			diffuse = std::min(std::max(diffuse, 0.0f), 1.0f);
+			for (int i = 0; i < 3; i++)
+			{
+				albedo[i] = ground ? RenderScene::GroundAlbedo(hit.position[0], hit.position[2]) : RenderScene::meshAlbedo[i];
+			}
+			return true;
+		}
+
+		double SecondsSince(std::chrono::steady_clock::time_point start)
+		{
+			return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		}
+	}
+
+	void WavefrontRenderer::RayQueue::Resize(size_t capacity)
+	{
+		originX.resize(capacity);
+		originY.resize(capacity);
+		originZ.resize(capacity);
+		directionX.resize(capacity);
+		directionY.resize(capacity);
+		directionZ.resize(capacity);
+		pixels.resize(capacity);
+	}
+
+	MeshTracer::Ray WavefrontRenderer::RayQueue::GetRay(size_t index) const
+	{
+		MeshTracer::Ray ray;
+		ray.origin[0] = originX[index];
+		ray.origin[1] = originY[index];
+		ray.origin[2] = originZ[index];
+		ray.direction[0] = directionX[index];
+		ray.direction[1] = directionY[index];
+		ray.direction[2] = directionZ[index];
+		return ray;
+	}
+
+	WavefrontRenderer::WavefrontRenderer(const InstanceTracer& tracer, unsigned int threadCount, size_t wavefrontSize) : tracer(&tracer), threadCount(threadCount == 0 ? ESL::ThreadCount() : threadCount), wavefrontSize(wavefrontSize)
+	{
+		primaryQueue.Resize(wavefrontSize);
+		intersections.resize(wavefrontSize);
+		shadeOutput.Resize(wavefrontSize);
+		shadeDiffuse.resize(wavefrontSize);
+		shadeAlbedo.resize(wavefrontSize * 3);
+		shadeEmitted.resize(wavefrontSize);
+		shadowQueue.Resize(wavefrontSize);
+		shadowDiffuse.resize(wavefrontSize);
+		shadowAlbedo.resize(wavefrontSize * 3);
+	}
+
+	MeshTracer::Ray WavefrontRenderer::CameraRay(const View& view, unsigned int x, unsigned int y, float offsetX, float offsetY)
+	{
+		float u = (2.0f * ((float)x + offsetX) - (float)view.width) / (float)view.height;
+		float v = (2.0f * ((float)y + offsetY) - (float)view.height) / (float)view.height;
+
+		MeshTracer::Ray ray;
+		float lengthSquared = 0;
+		for (int i = 0; i < 3; i++)
+		{
+			ray.origin[i] = view.origin[i];
+			ray.direction[i] = u * view.cameraToWorld[i] - v * view.cameraToWorld[3 + i] - view.focalLength * view.cameraToWorld[6 + i];
+			lengthSquared += ray.direction[i] * ray.direction[i];
+		}
+		float length = sqrtf(lengthSquared);
+		for (int i = 0; i < 3; i++)
+		{
+			ray.direction[i] /= length;
+		}
+		return ray;
+	}
+
+	void WavefrontRenderer::Render(const View& view, float* image, Statistics* statistics)
+	{
+		std::vector<MeshTracer::Statistics> threadStatistics(threadCount);
+		Statistics stageStatistics;
+		size_t pixelCount = (size_t)view.width * view.height;
+		for (size_t firstPixel = 0; firstPixel < pixelCount; firstPixel += wavefrontSize)
+		{
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			Generate(view, firstPixel, std::min(wavefrontSize, pixelCount - firstPixel));
+			stageStatistics.generateSeconds += SecondsSince(start);
+			stageStatistics.primaryRays += primaryQueue.count;
+
+			start = std::chrono::steady_clock::now();
+			Extend(threadStatistics);
+			stageStatistics.extendSeconds += SecondsSince(start);
+
+			start = std::chrono::steady_clock::now();
+			Shade(image, threadStatistics);
+			stageStatistics.shadeSeconds += SecondsSince(start);
+			stageStatistics.shadowRays += shadowQueue.count;
+
+			start = std::chrono::steady_clock::now();
+			Shadow(image, threadStatistics);
+			stageStatistics.shadowSeconds += SecondsSince(start);
+		}
+
+		if (statistics != nullptr)
+		{
+			RayBatch::AddStatistics(stageStatistics.traversal, threadStatistics);
+			statistics->primaryRays += stageStatistics.primaryRays;
+			statistics->shadowRays += stageStatistics.shadowRays;
+			statistics->generateSeconds += stageStatistics.generateSeconds;
+			statistics->extendSeconds += stageStatistics.extendSeconds;
+			statistics->shadeSeconds += stageStatistics.shadeSeconds;
+			statistics->shadowSeconds += stageStatistics.shadowSeconds;
+			statistics->traversal.rays += stageStatistics.traversal.rays;
+			statistics->traversal.nodesVisited += stageStatistics.traversal.nodesVisited;
+			statistics->traversal.positionFetches += stageStatistics.traversal.positionFetches;
+			statistics->traversal.attributeFetches += stageStatistics.traversal.attributeFetches;
+		}
+	}
+
+	void WavefrontRenderer::RenderPerPixel(const View& view, float* image, Statistics* statistics)
+	{
+		//Rows are handed out one at a time since rows through the mesh cost far more than rows of sky
+		std::vector<MeshTracer::Statistics> threadStatistics(threadCount);
+		std::vector<unsigned long long> threadShadowRays(threadCount, 0);
+		std::atomic<unsigned int> nextRow(0);
+		ESL::ParallelFor(threadCount, [&](size_t, size_t, unsigned int thread)
+		{
+			for (unsigned int y = nextRow++; y < view.height; y = nextRow++)
+			{
+				for (unsigned int x = 0; x < view.width; x++)
+				{
+					MeshTracer::Ray ray = CameraRay(view, x, y);
+					InstanceTracer::Intersection intersection = tracer->Intersect(ray, &threadStatistics[thread]);
+
+					MeshTracer::Ray shadowRay;
+					float diffuse;
+					float albedo[3];
+					float* pixel = image + ((size_t)y * view.width + x) * 3;
+					if (!ShadeSurface(*tracer, ray, intersection, &threadStatistics[thread], shadowRay, diffuse, albedo))
+					{
+						std::copy(RenderScene::skyRadiance, RenderScene::skyRadiance + 3, pixel);
+						continue;
+					}
+					threadShadowRays[thread]++;
+					float lighting = (tracer->Occluded(shadowRay, &threadStatistics[thread]) ? 0.0f : diffuse) + RenderScene::ambient;
+					for (int channel = 0; channel < 3; channel++)
+					{
+						pixel[channel] = albedo[channel] * lighting;
+					}
+				}
+			}
+		}, threadCount);
+
+		if (statistics != nullptr)
+		{
+			statistics->primaryRays += (unsigned long long)view.width * view.height;
+			for (unsigned int i = 0; i < threadCount; i++)
+			{
+				statistics->shadowRays += threadShadowRays[i];
+			}
+			RayBatch::AddStatistics(statistics->traversal, threadStatistics);
+		}
+	}
+
+	void WavefrontRenderer::Generate(const View& view, size_t firstPixel, size_t pixelCount)
+	{
+		primaryQueue.count = pixelCount;
+		RayBatch::ForEachChunk(pixelCount, RayBatch::stageChunkSize, threadCount, [&](size_t begin, size_t end, unsigned int)
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				unsigned int pixel = (unsigned int)(firstPixel + i);
+				MeshTracer::Ray ray = CameraRay(view, pixel % view.width, pixel / view.width);
+				primaryQueue.originX[i] = ray.origin[0];
+				primaryQueue.originY[i] = ray.origin[1];
+				primaryQueue.originZ[i] = ray.origin[2];
+				primaryQueue.directionX[i] = ray.direction[0];
+				primaryQueue.directionY[i] = ray.direction[1];
+				primaryQueue.directionZ[i] = ray.direction[2];
+				primaryQueue.pixels[i] = pixel;
+			}
+		});
+	}
+
+	void WavefrontRenderer::Extend(std::vector<MeshTracer::Statistics>& threadStatistics)
+	{
+		RayBatch::ForEachChunk(primaryQueue.count, RayBatch::stageChunkSize, threadCount, [&](size_t begin, size_t end, unsigned int thread)
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				intersections[i] = tracer->Intersect(primaryQueue.GetRay(i), &threadStatistics[thread]);
+			}
+		});
+	}
+
+	void WavefrontRenderer::Shade(float* image, std::vector<MeshTracer::Statistics>& threadStatistics)
+	{
+		//Misses are written straight to the image as the sky, hits leave a shadow ray at their own index
+		RayBatch::ForEachChunk(primaryQueue.count, RayBatch::stageChunkSize, threadCount, [&](size_t begin, size_t end, unsigned int thread)
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				MeshTracer::Ray shadowRay;
+				float diffuse;
+				shadeEmitted[i] = ShadeSurface(*tracer, primaryQueue.GetRay(i), intersections[i], &threadStatistics[thread], shadowRay, diffuse, &shadeAlbedo[i * 3]) ? 1 : 0;
+				if (shadeEmitted[i] == 0)
+				{
+					std::copy(RenderScene::skyRadiance, RenderScene::skyRadiance + 3, image + (size_t)primaryQueue.pixels[i] * 3);
+					continue;
+				}
+
+				shadeOutput.originX[i] = shadowRay.origin[0];
+				shadeOutput.originY[i] = shadowRay.origin[1];
+				shadeOutput.originZ[i] = shadowRay.origin[2];
+				shadeOutput.directionX[i] = shadowRay.direction[0];
+				shadeOutput.directionY[i] = shadowRay.direction[1];
+				shadeOutput.directionZ[i] = shadowRay.direction[2];
+				shadeDiffuse[i] = diffuse;
+			}
+		});
+
+		//Compact the shadow rays so the shadow stage only walks live entries, keeping their primary ray order
+		shadowQueue.count = RayBatch::Compact(primaryQueue.count, threadCount, chunkOffsets, [&](size_t i)
+		{
+			return shadeEmitted[i] != 0;
+		}, [&](size_t i, size_t output)
+		{
+			shadowQueue.originX[output] = shadeOutput.originX[i];
+			shadowQueue.originY[output] = shadeOutput.originY[i];
+			shadowQueue.originZ[output] = shadeOutput.originZ[i];
+			shadowQueue.directionX[output] = shadeOutput.directionX[i];
+			shadowQueue.directionY[output] = shadeOutput.directionY[i];
+			shadowQueue.directionZ[output] = shadeOutput.directionZ[i];
+			shadowQueue.pixels[output] = primaryQueue.pixels[i];
+			shadowDiffuse[output] = shadeDiffuse[i];
+			std::copy(&shadeAlbedo[i * 3], &shadeAlbedo[i * 3] + 3, &shadowAlbedo[output * 3]);
+		});
+	}
+
+	void WavefrontRenderer::Shadow(float* image, std::vector<MeshTracer::Statistics>& threadStatistics)
+	{
+		RayBatch::ForEachChunk(shadowQueue.count, RayBatch::stageChunkSize, threadCount, [&](size_t begin, size_t end, unsigned int thread)
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				bool occluded = tracer->Occluded(shadowQueue.GetRay(i), &threadStatistics[thread]);
+				float lighting = (occluded ? 0.0f : shadowDiffuse[i]) + RenderScene::ambient;
+				float* pixel = image + (size_t)shadowQueue.pixels[i] * 3;
+				for (int channel = 0; channel < 3; channel++)
+				{
+					pixel[channel] = shadowAlbedo[i * 3 + channel] * lighting;
+				}
+			}
+		});
+	}
+}
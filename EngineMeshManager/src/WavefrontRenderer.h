@@ -0,0 +1,81 @@
+#pragma once
+
+#include "InstanceTracer.h"
+
+#include <vector>
+
+namespace MeshManagement
+{
+	//Renders the RenderCompute.hlsl shading model on the CPU as separate stages over ray queues instead of one pass per pixel:
+	//generate camera rays, extend them to their closest hit, shade the hits into shadow rays, and test the shadow rays for
+	//occlusion. Every stage finishes the whole queue on all threads before the next starts, so each one keeps only its own data
+	//in cache. Pixels are processed wavefrontSize at a time to bound the queues' memory.
+	class __declspec(dllexport) WavefrontRenderer
+	{
+	public:
+		WavefrontRenderer(const InstanceTracer& tracer, unsigned int threadCount = 0, size_t wavefrontSize = 262144);
+	public:
+		struct View
+		{
+			float origin[3];
+			float cameraToWorld[9]; //Row major, rows are the camera's right, up and backward axes as in Graphics::Camera
+			float focalLength = 1.5f;
+			unsigned int width = 0;
+			unsigned int height = 0;
+		};
+		struct Statistics
+		{
+			unsigned long long primaryRays = 0;
+			unsigned long long shadowRays = 0;
+			double generateSeconds = 0;
+			double extendSeconds = 0;
+			double shadeSeconds = 0;
+			double shadowSeconds = 0;
+			MeshTracer::Statistics traversal;
+		};
+	public:
+		//Writes width * height RGB values, row major: the albedo of the surface times its diffuse and ambient light, or the sky's
+		//radiance where nothing was hit
+		void Render(const View& view, float* image, Statistics* statistics = nullptr);
+		//Same image traced one pixel at a time from camera ray to shadow ray, like main in RenderCompute.hlsl. Kept for comparison.
+		void RenderPerPixel(const View& view, float* image, Statistics* statistics = nullptr);
+		//Through the point offset into pixel (x, y), the centre by default
+		static MeshTracer::Ray CameraRay(const View& view, unsigned int x, unsigned int y, float offsetX = 0.5f, float offsetY = 0.5f);
+	private:
+		//Structure of arrays ray queue, only the first count entries are live
+		struct RayQueue
+		{
+			std::vector<float> originX, originY, originZ;
+			std::vector<float> directionX, directionY, directionZ;
+			std::vector<unsigned int> pixels;
+			size_t count = 0;
+
+			void Resize(size_t capacity);
+			MeshTracer::Ray GetRay(size_t index) const;
+		};
+	private:
+		void Generate(const View& view, size_t firstPixel, size_t pixelCount);
+		void Extend(std::vector<MeshTracer::Statistics>& threadStatistics);
+		void Shade(float* image, std::vector<MeshTracer::Statistics>& threadStatistics);
+		void Shadow(float* image, std::vector<MeshTracer::Statistics>& threadStatistics);
+	private:
+		const InstanceTracer* tracer;
+		unsigned int threadCount;
+		size_t wavefrontSize;
+#pragma warning(push)
+#pragma warning(disable:4251)
+		RayQueue primaryQueue;
+		std::vector<InstanceTracer::Intersection> intersections; //Extend results, aligned with primaryQueue
+
+		//Shade writes a shadow ray for every hit at its primary ray's index, then the live ones are compacted into shadowQueue
+		RayQueue shadeOutput;
+		std::vector<float> shadeDiffuse;
+		std::vector<float> shadeAlbedo; //RGB
+		std::vector<unsigned char> shadeEmitted;
+		std::vector<size_t> chunkOffsets; //Scratch for RayBatch::Compact
+		RayQueue shadowQueue;
+		std::vector<float> shadowDiffuse; //Lighting of each shadow ray's pixel if it turns out unoccluded
+		std::vector<float> shadowAlbedo; //RGB albedo of the surface each shadow ray leaves
+#pragma warning(pop)
+	};
+}